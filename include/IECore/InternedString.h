@@ -51,6 +51,9 @@ namespace IECore
 /// multiple different objects with the same string value. It does this
 /// by keeping a static table with the actual values in it, with
 /// the object instances just referencing the values in the table.
+/// The table is split into independently locked shards and each thread
+/// also keeps a small cache of the strings it interned recently, so that
+/// construction scales well when many threads intern strings at once.
 /// \ingroup utilityGroup
 class IECORE_API InternedString
 {
@@ -86,6 +89,13 @@ class IECORE_API InternedString
 
 		static size_t numUniqueStrings();
 
+		/// Interns numStrings strings in a single operation, storing the results
+		/// in internedStrings, which must have room for numStrings elements. This
+		/// is faster than constructing the InternedStrings one by one when there
+		/// are many of them, for instance when loading string tables from files,
+		/// because the table is locked far fewer times.
+		static void internStrings( const std::string *strings, size_t numStrings, InternedString *internedStrings );
+
 	private :
 
 		static const std::string *internedString( const char *value );
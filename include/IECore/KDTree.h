@@ -42,6 +42,8 @@ IECORE_PUSH_DEFAULT_VISIBILITY
 #include "OpenEXR/ImathVec.h"
 IECORE_POP_DEFAULT_VISIBILITY
 
+#include "tbb/task.h"
+
 #include <set>
 #include <vector>
 
@@ -51,6 +53,11 @@ namespace IECore
 /// The KDTree class provides accelerated searching of pointsets. It is
 /// templated so that it can operate on a wide variety of datatypes, and uses
 /// the VectorTraits.h and VectorOps.h functionality to assist in this.
+///
+/// Large trees are built in parallel, and the tree keeps its own copy of
+/// the points, arranged so that the points in each leaf are contiguous in
+/// memory. Batched forms of the queries are provided for processing many
+/// query points in parallel.
 /// \ingroup mathGroup
 template<class PointIterator>
 class KDTree
@@ -78,7 +85,9 @@ class KDTree
 		/// must remain valid and unchanged as long as the tree is in use.
 		/// This method can be called again to rebuild the tree at any time.
 		/// \threading This can't be called while other threads are
-		/// making queries.
+		/// making queries. Large trees are built using TBB tasks, so care
+		/// must be taken not to call this while holding a lock which those
+		/// tasks might also try to acquire.
 		void init( PointIterator first, PointIterator last, int maxLeafSize=4  );
 
 		/// Returns an iterator to the nearest neighbour to the point p.
@@ -92,6 +101,13 @@ class KDTree
 		/// the constructor).
 		/// \threading May be called by multiple concurrent threads.
 		PointIterator nearestNeighbour( const Point &p, BaseType &distSquared ) const;
+		/// Finds the nearest neighbour to each of the points in the range [first, last),
+		/// placing the results in nearestNeighbours, which is resized to match. Equivalent
+		/// to calling nearestNeighbour() for each point in turn, but the queries are
+		/// performed in parallel.
+		/// \threading May be called by multiple concurrent threads provided they are each using a different vector for the result.
+		template<typename QueryIterator>
+		void nearestNeighbour( QueryIterator first, QueryIterator last, std::vector<PointIterator> &nearestNeighbours ) const;
 
 		/// Populates the passed vector of iterators with the neighbours of point p which are closer than radius r. Returns the number of points found.
 		/// \todo There should be a form where nearNeighbours is an output iterator, to allow any container to be filled.
@@ -103,6 +119,13 @@ class KDTree
 		/// Populates the passed vector with the N closest neighbours to p, sorted with the closest first. Returns the number found.
 		/// \threading May be called by multiple concurrent threads provided they are each using a different vector for the result.
 		unsigned int nearestNNeighbours( const Point &p, unsigned int numNeighbours, std::vector<Neighbour> &nearNeighbours ) const;
+		/// Finds the N closest neighbours to each of the points in the range [first, last), performing the
+		/// queries in parallel. The same number of neighbours is found for every query point, and this number
+		/// is returned. The neighbours of the ith query point are placed in nearNeighbours starting at index
+		/// i * numFound, sorted with the closest first, exactly as they would be by the single point form.
+		/// \threading May be called by multiple concurrent threads provided they are each using a different vector for the result.
+		template<typename QueryIterator>
+		unsigned int nearestNNeighbours( QueryIterator first, QueryIterator last, unsigned int numNeighbours, std::vector<Neighbour> &nearNeighbours ) const;
 
 		/// Finds all the points contained by the specified bound, outputting them to the specified iterator.
 		/// \threading May be called by multiple concurrent threads.
@@ -132,8 +155,13 @@ class KDTree
 
 		class AxisSort;
 
-		unsigned char majorAxis( PermutationConstIterator permFirst, PermutationConstIterator permLast );
-		void build( NodeIndex nodeIndex, PermutationIterator permFirst, PermutationIterator permLast );
+		// Ranges larger than this are processed in parallel
+		// when building the tree.
+		static const int parallelBuildThreshold = 50000;
+
+		NodeIndex maxNodeIndex( NodeIndex nodeIndex, size_t numPoints ) const;
+		unsigned char majorAxis( PermutationConstIterator permFirst, PermutationConstIterator permLast, tbb::task_group_context &taskGroupContext );
+		void build( NodeIndex nodeIndex, PermutationIterator permFirst, PermutationIterator permLast, tbb::task_group_context &taskGroupContext );
 
 		void nearestNeighbourWalk( NodeIndex nodeIndex, const Point &p, PointIterator &closestPoint, BaseType &distSquared ) const;
 
@@ -145,6 +173,9 @@ class KDTree
 		void nearestNNeighboursWalk( NodeIndex nodeIndex, const Point &p, unsigned int numNeighbours, std::vector<Neighbour> &nearNeighbours, BaseType &maxDistSquared ) const;
 
 		Permutation m_perm;
+		// A copy of the points, in the same order as m_perm, so
+		// that the points in each leaf are contiguous in memory.
+		std::vector<Point> m_points;
 		NodeVector m_nodes;
 		int m_maxLeafSize;
 		PointIterator m_lastPoint;
@@ -37,7 +37,14 @@
 
 #include "OpenEXR/ImathLimits.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/parallel_for.h"
+#include "tbb/parallel_invoke.h"
+#include "tbb/parallel_reduce.h"
+
 #include <algorithm>
+#include <cassert>
 
 namespace IECore
 {
@@ -135,32 +142,105 @@ void KDTree<PointIterator>::init( PointIterator first, PointIterator last, int m
 		m_perm[i++] = it;
 	}
 
-	/// \todo Can we reserve() enough space for m_nodes before doing this?
-	build( rootIndex(), m_perm.begin(), m_perm.end() );
+	// The index of each node depends only on the number of points,
+	// so we can allocate all the nodes up front, and then build
+	// separate subtrees in parallel.
+	m_nodes.clear();
+	m_nodes.resize( maxNodeIndex( rootIndex(), m_perm.size() ) + 1 );
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	build( rootIndex(), m_perm.begin(), m_perm.end(), taskGroupContext );
+
+	m_points.resize( m_perm.size() );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, m_perm.size() ),
+		[this]( const tbb::blocked_range<size_t> &range ) {
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				m_points[i] = *m_perm[i];
+			}
+		},
+		taskGroupContext
+	);
 }
 
 template<class PointIterator>
-unsigned char KDTree<PointIterator>::majorAxis( PermutationConstIterator permFirst, PermutationConstIterator permLast )
+typename KDTree<PointIterator>::NodeIndex KDTree<PointIterator>::maxNodeIndex( NodeIndex nodeIndex, size_t numPoints ) const
 {
-	Point min, max;
+	// The high child always has at least as many points as the low
+	// child, so the last node is found by following the high children.
+	while( (ptrdiff_t)numPoints > m_maxLeafSize )
+	{
+		nodeIndex = highChildIndex( nodeIndex );
+		numPoints -= numPoints / 2;
+	}
+	return nodeIndex;
+}
+
+template<class PointIterator>
+unsigned char KDTree<PointIterator>::majorAxis( PermutationConstIterator permFirst, PermutationConstIterator permLast, tbb::task_group_context &taskGroupContext )
+{
+	typedef std::pair<Point, Point> Bound;
+
+	Bound emptyBound;
 	for( unsigned char i=0; i<VectorTraits<Point>::dimensions(); i++ ) {
-		min[i] = Imath::limits<BaseType>::max();
-		max[i] = Imath::limits<BaseType>::min();
+		emptyBound.first[i] = Imath::limits<BaseType>::max();
+		emptyBound.second[i] = Imath::limits<BaseType>::min();
 	}
-	for( PermutationConstIterator it=permFirst; it!=permLast; it++ )
-	{
-		for( unsigned char i=0; i<VectorTraits<Point>::dimensions(); i++ )
+
+	auto extend = [] ( PermutationConstIterator first, PermutationConstIterator last, Bound &b ) {
+		for( PermutationConstIterator it=first; it!=last; it++ )
 		{
-			if( (**it)[i] < min[i] )
-			{
-				min[i] = (**it)[i];
-			}
-			if( (**it)[i] > max[i] )
+			for( unsigned char i=0; i<VectorTraits<Point>::dimensions(); i++ )
 			{
-				max[i] = (**it)[i];
+				if( (**it)[i] < b.first[i] )
+				{
+					b.first[i] = (**it)[i];
+				}
+				if( (**it)[i] > b.second[i] )
+				{
+					b.second[i] = (**it)[i];
+				}
 			}
 		}
+	};
+
+	Bound bound = emptyBound;
+	if( permLast - permFirst > parallelBuildThreshold )
+	{
+		bound = tbb::parallel_reduce(
+			tbb::blocked_range<PermutationConstIterator>( permFirst, permLast ),
+			emptyBound,
+			[&extend] ( const tbb::blocked_range<PermutationConstIterator> &range, Bound b ) {
+				extend( range.begin(), range.end(), b );
+				return b;
+			},
+			[] ( Bound a, const Bound &b ) {
+				for( unsigned char i=0; i<VectorTraits<Point>::dimensions(); i++ )
+				{
+					if( b.first[i] < a.first[i] )
+					{
+						a.first[i] = b.first[i];
+					}
+					if( b.second[i] > a.second[i] )
+					{
+						a.second[i] = b.second[i];
+					}
+				}
+				return a;
+			},
+			tbb::auto_partitioner(),
+			taskGroupContext
+		);
+	}
+	else
+	{
+		extend( permFirst, permLast, bound );
 	}
+
+	const Point &min = bound.first;
+	const Point &max = bound.second;
+
 	unsigned char major = 0;
 	Point size = max - min;
 	for( unsigned char i=1; i<VectorTraits<Point>::dimensions(); i++ )
@@ -174,25 +254,35 @@ unsigned char KDTree<PointIterator>::majorAxis( PermutationConstIterator permFir
 }
 
 template<class PointIterator>
-void KDTree<PointIterator>::build( NodeIndex nodeIndex, PermutationIterator permFirst, PermutationIterator permLast )
+void KDTree<PointIterator>::build( NodeIndex nodeIndex, PermutationIterator permFirst, PermutationIterator permLast, tbb::task_group_context &taskGroupContext )
 {
-	// make room for the new node
-	if( nodeIndex>=m_nodes.size() )
-	{
-		m_nodes.resize( nodeIndex+1 );
-	}
+	assert( nodeIndex < m_nodes.size() );
 
 	if( permLast - permFirst > m_maxLeafSize )
 	{
-		unsigned int cutAxis = majorAxis( permFirst, permLast );
+		unsigned int cutAxis = majorAxis( permFirst, permLast, taskGroupContext );
 		PermutationIterator permMid = permFirst  + (permLast - permFirst)/2;
 		std::nth_element( permFirst, permMid, permLast, AxisSort( cutAxis ) );
 		BaseType cutValue = (**permMid)[cutAxis];
 		// insert node
 		m_nodes[nodeIndex].makeBranch( cutAxis, cutValue );
 
-		build( lowChildIndex( nodeIndex ), permFirst, permMid );
-		build( highChildIndex( nodeIndex ), permMid, permLast );
+		if( permLast - permFirst > parallelBuildThreshold )
+		{
+			// The subtrees use disjoint ranges of the permutation and
+			// of the nodes, so can be built concurrently. The result is
+			// identical to that of a serial build.
+			tbb::parallel_invoke(
+				[this, nodeIndex, permFirst, permMid, &taskGroupContext] { build( lowChildIndex( nodeIndex ), permFirst, permMid, taskGroupContext ); },
+				[this, nodeIndex, permMid, permLast, &taskGroupContext] { build( highChildIndex( nodeIndex ), permMid, permLast, taskGroupContext ); },
+				taskGroupContext
+			);
+		}
+		else
+		{
+			build( lowChildIndex( nodeIndex ), permFirst, permMid, taskGroupContext );
+			build( highChildIndex( nodeIndex ), permMid, permLast, taskGroupContext );
+		}
 	}
 	else
 	{
@@ -220,6 +310,26 @@ PointIterator KDTree<PointIterator>::nearestNeighbour( const Point &p, BaseType
 	return closestPoint;
 }
 
+template<class PointIterator>
+template<typename QueryIterator>
+void KDTree<PointIterator>::nearestNeighbour( QueryIterator first, QueryIterator last, std::vector<PointIterator> &nearestNeighbours ) const
+{
+	nearestNeighbours.resize( last - first );
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, nearestNeighbours.size() ),
+		[this, first, &nearestNeighbours]( const tbb::blocked_range<size_t> &range ) {
+			QueryIterator it = first + range.begin();
+			for( size_t i = range.begin(); i != range.end(); ++i, ++it )
+			{
+				nearestNeighbours[i] = nearestNeighbour( *it );
+			}
+		},
+		taskGroupContext
+	);
+}
+
 template<class PointIterator>
 unsigned int KDTree<PointIterator>::nearestNeighbours( const Point &p, BaseType r, std::vector<PointIterator> &nearNeighbours ) const
 {
@@ -252,6 +362,44 @@ unsigned int KDTree<PointIterator>::nearestNNeighbours( const Point &p, unsigned
 	return nearNeighbours.size();
 }
 
+template<class PointIterator>
+template<typename QueryIterator>
+unsigned int KDTree<PointIterator>::nearestNNeighbours( QueryIterator first, QueryIterator last, unsigned int numNeighbours, std::vector<Neighbour> &nearNeighbours ) const
+{
+	// Until numNeighbours have been found, every point is accepted
+	// regardless of distance, so each query finds the same number.
+	const size_t numQueries = last - first;
+	const unsigned int numFound = std::min<size_t>( numNeighbours, m_perm.size() );
+	nearNeighbours.assign( numQueries * numFound, Neighbour( m_lastPoint, 0 ) );
+	if( !numFound )
+	{
+		return 0;
+	}
+
+	// Scratch space for the heaps, reused for all the queries made
+	// by each thread.
+	tbb::enumerable_thread_specific<std::vector<Neighbour> > scratch;
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numQueries ),
+		[this, first, numNeighbours, numFound, &nearNeighbours, &scratch]( const tbb::blocked_range<size_t> &range ) {
+			std::vector<Neighbour> &neighbours = scratch.local();
+			neighbours.reserve( numFound );
+			QueryIterator it = first + range.begin();
+			for( size_t i = range.begin(); i != range.end(); ++i, ++it )
+			{
+				nearestNNeighbours( *it, numNeighbours, neighbours );
+				assert( neighbours.size() == numFound );
+				std::copy( neighbours.begin(), neighbours.end(), nearNeighbours.begin() + i * numFound );
+			}
+		},
+		taskGroupContext
+	);
+
+	return numFound;
+}
+
 template<class PointIterator>
 void KDTree<PointIterator>::nearestNeighbourWalk( NodeIndex nodeIndex, const Point &p, PointIterator &closestPoint, BaseType &distSquared ) const
 {
@@ -259,10 +407,10 @@ void KDTree<PointIterator>::nearestNeighbourWalk( NodeIndex nodeIndex, const Poi
 	if( node.isLeaf() )
 	{
 		PointIterator *permLast = node.permLast();
-		for( PointIterator *perm = node.permFirst(); perm!=permLast; perm++ )
+		const Point *pp = m_points.data() + ( node.permFirst() - m_perm.data() );
+		for( PointIterator *perm = node.permFirst(); perm!=permLast; perm++, pp++ )
 		{
-			const Point &pp = **perm;
-			BaseType dist2 = vecDistance2( p, pp );
+			BaseType dist2 = vecDistance2( p, *pp );
 
 			if( dist2 < distSquared )
 			{
@@ -302,10 +450,10 @@ void KDTree<PointIterator>::nearestNeighboursWalk( NodeIndex nodeIndex, const Po
 	if( node.isLeaf() )
 	{
 		PointIterator *permLast = node.permLast();
-		for( PointIterator *perm = node.permFirst(); perm!=permLast; perm++ )
+		const Point *pp = m_points.data() + ( node.permFirst() - m_perm.data() );
+		for( PointIterator *perm = node.permFirst(); perm!=permLast; perm++, pp++ )
 		{
-			const Point &pp = **perm;
-			BaseType dist2 = vecDistance2( p, pp );
+			BaseType dist2 = vecDistance2( p, *pp );
 
 			if (dist2 < r2 )
 			{
@@ -344,10 +492,10 @@ void KDTree<PointIterator>::nearestNNeighboursWalk( NodeIndex nodeIndex, const P
 	if( node.isLeaf() )
 	{
 		PointIterator *permLast = node.permLast();
-		for( PointIterator *perm = node.permFirst(); perm!=permLast; perm++ )
+		const Point *pp = m_points.data() + ( node.permFirst() - m_perm.data() );
+		for( PointIterator *perm = node.permFirst(); perm!=permLast; perm++, pp++ )
 		{
-			const Point &pp = **perm;
-			BaseType dist2 = vecDistance2( p, pp );
+			BaseType dist2 = vecDistance2( p, *pp );
 
 			if( dist2 < maxDistSquared || nearNeighbours.size() < numNeighbours )
 			{
@@ -408,10 +556,10 @@ void KDTree<PointIterator>::enclosedPointsWalk( NodeIndex nodeIndex, const Box &
 	if( node.isLeaf() )
 	{
 		PointIterator *permLast = node.permLast();
-		for( PointIterator *perm = node.permFirst(); perm!=permLast; perm++ )
+		const Point *pp = m_points.data() + ( node.permFirst() - m_perm.data() );
+		for( PointIterator *perm = node.permFirst(); perm!=permLast; perm++, pp++ )
 		{
-			const Point &pp = **perm;
-			if( boxIntersects( bound, pp ) )
+			if( boxIntersects( bound, *pp ) )
 			{
 				*it++ = *perm;
 			}
@@ -39,6 +39,8 @@
 #include "boost/noncopyable.hpp"
 #include "boost/variant.hpp"
 
+#include "tbb/atomic.h"
+
 namespace IECore
 {
 
@@ -58,6 +60,37 @@ class Serial;
 template<typename LRUCache>
 class Parallel;
 
+/// Threadsafe, `get()` collaborates with any other thread
+/// already computing the value, by executing the TBB tasks
+/// spawned by its GetterFunction, rather than blocking. This
+/// is the best choice when the GetterFunction itself uses TBB.
+/// A GetterFunction which calls `get()` recursively for the
+/// key it is computing, either directly or from the tasks
+/// it spawns, results in an Exception rather than a deadlock.
+/// Key type must have a `hash_value` implementation as
+/// described in the boost documentation.
+template<typename LRUCache>
+class TaskParallel;
+
+/// Threadsafe, and otherwise as Parallel, but resistant to
+/// scans. Items which are requested only once are evicted
+/// before the more frequently used ones, so that a single
+/// traversal of many items doesn't evict the working set
+/// of the other clients of the cache. Key type must have a
+/// `hash_value` implementation as described in the boost
+/// documentation.
+template<typename LRUCache>
+class ScanResistant;
+
+namespace Detail
+{
+
+// Implementation shared by the threadsafe policies.
+template<typename LRUCache, typename ItemState>
+class Binned;
+
+} // namespace Detail
+
 } // namespace LRUCachePolicy
 
 /// A mapping from keys to values, where values are computed from keys using a user
@@ -136,6 +169,24 @@ class LRUCache : private boost::noncopyable
 		/// Returns the current cost of all cached items.
 		Cost currentCost() const;
 
+		/// Counters describing the usage of the cache.
+		struct Statistics
+		{
+			Statistics() : hits( 0 ), misses( 0 ), evictions( 0 ) {}
+
+			/// Number of calls to get() served from the cache.
+			size_t hits;
+			/// Number of calls to get() which called the GetterFunction.
+			size_t misses;
+			/// Number of items discarded to stay within the maximum cost.
+			size_t evictions;
+		};
+
+		/// Returns the counters accumulated since the cache was
+		/// constructed or resetStatistics() was last called.
+		Statistics statistics() const;
+		void resetStatistics();
+
 	private :
 
 		// Data
@@ -143,6 +194,8 @@ class LRUCache : private boost::noncopyable
 
 		// Give Policy access to CacheEntry definitions.
 		friend class Policy<LRUCache>;
+		template<typename, typename>
+		friend class LRUCachePolicy::Detail::Binned;
 
 		// A function for computing values, and one for notifying of removals.
 		GetterFunction m_getter;
@@ -182,6 +235,10 @@ class LRUCache : private boost::noncopyable
 
 		Cost m_maxCost;
 
+		tbb::atomic<size_t> m_hits;
+		tbb::atomic<size_t> m_misses;
+		tbb::atomic<size_t> m_evictions;
+
 		// Methods
 		// =======
 
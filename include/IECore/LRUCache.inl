@@ -46,10 +46,18 @@
 
 #include "tbb/spin_mutex.h"
 #include "tbb/spin_rw_mutex.h"
+#include "tbb/task_arena.h"
+#include "tbb/task_group.h"
+#include "tbb/task_scheduler_observer.h"
 #include "tbb/tbb_thread.h"
 
+#include <algorithm>
 #include <cassert>
+#include <deque>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <set>
 #include <tuple>
 #include <vector>
 
@@ -175,6 +183,15 @@ class Serial
 				}
 			}
 
+			// Executes a function which computes the value
+			// for the entry. Policies may use this to control
+			// how the GetterFunction is run.
+			template<typename F>
+			void execute( const F &f )
+			{
+				f();
+			}
+
 			private :
 
 				void init( MapIterator it )
@@ -269,20 +286,28 @@ class Serial
 
 };
 
-// Uses a binned map to allow concurrent map operations, and
+namespace Detail
+{
+
+// The storage and locking shared by the Parallel, TaskParallel and
+// ScanResistant policies. Uses a binned map to allow concurrent map operations, and
 // uses a second-chance algorithm to avoid the serial operations
-// associated with managing an LRU list.
-template<typename LRUCache>
-class Parallel
+// associated with managing an LRU list. Policies derive from Binned,
+// passing any additional state they need for each item as ItemState,
+// and define a Handle deriving from HandleBase, which implements
+// `execute()`.
+template<typename LRUCache, typename ItemState>
+class Binned
 {
 
 	public :
 
 		typedef typename LRUCache::CacheEntry CacheEntry;
 		typedef typename LRUCache::KeyType Key;
-		typedef tbb::atomic<typename LRUCache::Cost> AtomicCost;
+		typedef typename LRUCache::Cost Cost;
+		typedef tbb::atomic<Cost> AtomicCost;
 
-		struct Item
+		struct Item : public ItemState
 		{
 			Item() : recentlyUsed() {}
 			Item( const Key &key ) : key( key ), recentlyUsed() {}
@@ -337,7 +362,7 @@ class Parallel
 
 		typedef std::vector<Bin> Bins;
 
-		Parallel()
+		Binned()
 		{
 			m_bins.resize( tbb::tbb_thread::hardware_concurrency() );
 			m_popBinIndex = 0;
@@ -345,124 +370,58 @@ class Parallel
 			currentCost = 0;
 		}
 
-		struct Handle : private boost::noncopyable
+		class HandleBase : private boost::noncopyable
 		{
 
-			Handle()
-				:	m_item( nullptr ), m_writable( false )
-			{
-			}
-
-			~Handle()
-			{
-			}
-
-			const CacheEntry &readable()
-			{
-				return m_item->cacheEntry;
-			}
+			public :
 
-			CacheEntry &writable()
-			{
-				assert( m_writable );
-				return m_item->cacheEntry;
-			}
-
-			void release()
-			{
-				if( m_item )
+				HandleBase()
+					:	m_bin( nullptr ), m_item( nullptr ), m_writable( false )
 				{
-					m_itemLock.release();
-					m_item = nullptr;
 				}
-			}
-
-			private :
 
-				bool acquire( Bin &bin, const Key &key, AcquireMode mode )
+				const CacheEntry &readable()
 				{
-					assert( !m_item );
+					return m_item->cacheEntry;
+				}
 
-					// Acquiring a handle requires taking two
-					// locks, first the lock for the Bin, and
-					// second the lock for the Item. We must be
-					// careful to avoid deadlock in the case of
-					// a GetterFunction which reenters the cache.
+				CacheEntry &writable()
+				{
+					assert( m_writable );
+					return m_item->cacheEntry;
+				}
 
-					typename Bin::Mutex::scoped_lock binLock;
-					while( true )
+				void release()
+				{
+					if( m_item )
 					{
-						// Acquire a lock on the bin, and get an iterator
-						// from the key. We optimistically assume the item
-						// may already be in the cache and first do a find()
-						// using a bin read lock. This gives us much better
-						// performance when many threads contend for items
-						// that are already in the cache.
-						binLock.acquire( bin.mutex, /* write = */ false );
-						MapIterator it = bin.map.find( key );
-						bool inserted = false;
-						if( it == bin.map.end() )
-						{
-							if( mode != Insert && mode != InsertWritable )
-							{
-								return false;
-							}
-							binLock.upgrade_to_writer();
-							std::tie<MapIterator, bool>( it, inserted ) = bin.map.insert( Item( key ) );
-						}
-						// Now try to get a lock on the item we want to
-						// acquire. When we've just inserted a new item
-						// we take a write lock directly, because we know
-						// we'll need to write to the new item. When insertion
-						// found a pre-existing item we optimistically take
-						// just a read lock, because it is faster when
-						// many threads just need to read from the same
-						// cached item.
-						m_writable = inserted || mode == FindWritable || mode == InsertWritable;
-
-						if( m_itemLock.try_acquire( it->mutex, /* write = */ m_writable ) )
-						{
-							if( !m_writable && mode == Insert && it->cacheEntry.status() == LRUCache::Uncached )
-							{
-								// We found an old item that doesn't have
-								// a value. This can either be because it
-								// was erased but hasn't been popped yet,
-								// or because the item was too big to fit
-								// in the cache. Upgrade to writer status
-								// so it can be updated in get().
-								m_itemLock.upgrade_to_writer();
-								m_writable = true;
-							}
-							// Success!
-							m_item = &*it;
-							return true;
-						}
-						else
-						{
-							// The Item lock is held by another thread.
-							// We must release the Bin lock and retry. This
-							// avoids deadlock when the GetterFunction holding
-							// the Item lock calls back into the cache and tries to
-							// access another item in the same Bin.
-							binLock.release();
-						}
+						m_itemLock.release();
+						m_item = nullptr;
 					}
 				}
 
-				friend class Parallel;
+			protected :
 
+				friend class Binned;
+
+				Bin *m_bin;
 				const Item *m_item;
 				typename Item::Mutex::scoped_lock m_itemLock;
 				bool m_writable;
 
 		};
 
-		bool acquire( const Key &key, Handle &handle, AcquireMode mode )
+		bool acquire( const Key &key, HandleBase &handle, AcquireMode mode )
 		{
-			return handle.acquire( bin( key ), key, mode );
+			// The Item lock is held by another thread. We
+			// must release the Bin lock and retry. This
+			// avoids deadlock when the GetterFunction holding
+			// the Item lock calls back into the cache and tries to
+			// access another item in the same Bin.
+			return acquire( key, handle, mode, []( const Item &, typename Bin::Mutex::scoped_lock &binLock ) { binLock.release(); } );
 		}
 
-		void push( Handle &handle )
+		void push( HandleBase &handle )
 		{
 			// Simply mark the item as having been used
 			// recently. We will then give it a second chance
@@ -486,6 +445,95 @@ class Parallel
 				return false;
 			}
 
+			return popSecondChance(
+				key, cacheEntry,
+				[]( const Item & ) { return false; },
+				std::numeric_limits<size_t>::max()
+			);
+		}
+
+		AtomicCost currentCost;
+
+	protected :
+
+		// As above, but calling `contended( item, binLock )` when
+		// the Item lock is held by another thread. This must release
+		// the Bin lock, and may wait for the other thread before
+		// the acquisition is retried.
+		template<typename Contended>
+		bool acquire( const Key &key, HandleBase &handle, AcquireMode mode, const Contended &contended )
+		{
+			assert( !handle.m_item );
+
+			// Acquiring a handle requires taking two
+			// locks, first the lock for the Bin, and
+			// second the lock for the Item. We must be
+			// careful to avoid deadlock in the case of
+			// a GetterFunction which reenters the cache.
+
+			Bin &bin = this->bin( key );
+			typename Bin::Mutex::scoped_lock binLock;
+			while( true )
+			{
+				// Acquire a lock on the bin, and get an iterator
+				// from the key. We optimistically assume the item
+				// may already be in the cache and first do a find()
+				// using a bin read lock. This gives us much better
+				// performance when many threads contend for items
+				// that are already in the cache.
+				binLock.acquire( bin.mutex, /* write = */ false );
+				MapIterator it = bin.map.find( key );
+				bool inserted = false;
+				if( it == bin.map.end() )
+				{
+					if( mode != Insert && mode != InsertWritable )
+					{
+						return false;
+					}
+					binLock.upgrade_to_writer();
+					std::tie<MapIterator, bool>( it, inserted ) = bin.map.insert( Item( key ) );
+				}
+				// Now try to get a lock on the item we want to
+				// acquire. When we've just inserted a new item
+				// we take a write lock directly, because we know
+				// we'll need to write to the new item. When insertion
+				// found a pre-existing item we optimistically take
+				// just a read lock, because it is faster when
+				// many threads just need to read from the same
+				// cached item.
+				handle.m_writable = inserted || mode == FindWritable || mode == InsertWritable;
+
+				if( handle.m_itemLock.try_acquire( it->mutex, /* write = */ handle.m_writable ) )
+				{
+					if( !handle.m_writable && mode == Insert && it->cacheEntry.status() == LRUCache::Uncached )
+					{
+						// We found an old item that doesn't have
+						// a value. This can either be because it
+						// was erased but hasn't been popped yet,
+						// or because the item was too big to fit
+						// in the cache. Upgrade to writer status
+						// so it can be updated in get().
+						handle.m_itemLock.upgrade_to_writer();
+						handle.m_writable = true;
+					}
+					// Success!
+					handle.m_bin = &bin;
+					handle.m_item = &*it;
+					return true;
+				}
+				else
+				{
+					contended( *it, binLock );
+				}
+			}
+		}
+
+		// Implements pop(), passing over any items for which `skip( item )`
+		// returns true, and giving up after moving to the next bin `maxBins`
+		// times. Must be called with m_popMutex held.
+		template<typename Skip>
+		bool popSecondChance( Key &key, CacheEntry &cacheEntry, const Skip &skip, size_t maxBins )
+		{
 			Bin *bin = &m_bins[m_popBinIndex];
 			typename Bin::Mutex::scoped_lock binLock( bin->mutex );
 
@@ -498,6 +546,10 @@ class Parallel
 				while( m_popIterator == bin->map.end() )
 				{
 					binLock.release();
+					if( !--maxBins )
+					{
+						return false;
+					}
 					m_popBinIndex = ( m_popBinIndex + 1 ) % m_bins.size();
 					bin = &m_bins[m_popBinIndex];
 					binLock.acquire( bin->mutex );
@@ -511,7 +563,11 @@ class Parallel
 
 				if( itemLock.try_acquire( m_popIterator->mutex ) )
 				{
-					if( !m_popIterator->recentlyUsed )
+					if( skip( *m_popIterator ) )
+					{
+						itemLock.release();
+					}
+					else if( !m_popIterator->recentlyUsed )
 					{
 						// Pop this item.
 						key = m_popIterator->key;
@@ -547,18 +603,18 @@ class Parallel
 			}
 		}
 
-		AtomicCost currentCost;
-
-	private :
-
-		Bins m_bins;
+		size_t binIndex( const Key &key ) const
+		{
+			return boost::hash<Key>()( key ) % m_bins.size();
+		}
 
 		Bin &bin( const Key &key )
 		{
-			size_t binIndex = boost::hash<Key>()( key ) % m_bins.size();
-			return m_bins[binIndex];
+			return m_bins[binIndex( key )];
 		};
 
+		Bins m_bins;
+
 		typedef tbb::spin_mutex PopMutex;
 		PopMutex m_popMutex;
 		size_t m_popBinIndex;
@@ -566,6 +622,484 @@ class Parallel
 
 };
 
+// Keeps track of the threads working in an arena.
+class ArenaObserver : public tbb::task_scheduler_observer
+{
+
+	public :
+
+		ArenaObserver( tbb::task_arena &arena )
+			:	tbb::task_scheduler_observer( arena )
+		{
+			arena.initialize();
+			observe( true );
+		}
+
+		~ArenaObserver() override
+		{
+			observe( false );
+		}
+
+		bool containsThisThread()
+		{
+			Mutex::scoped_lock lock( m_mutex );
+			return m_threads.count( tbb::this_tbb_thread::get_id() );
+		}
+
+	private :
+
+		void on_scheduler_entry( bool ) override
+		{
+			Mutex::scoped_lock lock( m_mutex );
+			m_threads.insert( tbb::this_tbb_thread::get_id() );
+		}
+
+		void on_scheduler_exit( bool ) override
+		{
+			Mutex::scoped_lock lock( m_mutex );
+			std::multiset<tbb::tbb_thread::id>::iterator it = m_threads.find( tbb::this_tbb_thread::get_id() );
+			if( it != m_threads.end() )
+			{
+				m_threads.erase( it );
+			}
+		}
+
+		typedef tbb::spin_mutex Mutex;
+		Mutex m_mutex;
+		std::multiset<tbb::tbb_thread::id> m_threads;
+
+};
+
+// The state shared by the thread computing an item
+// and the threads waiting for it.
+struct Computation
+{
+	Computation() : observer( arena ) {}
+	tbb::task_arena arena;
+	// Used to detect recursion - any thread working
+	// in the arena is working for the GetterFunction.
+	ArenaObserver observer;
+	tbb::task_group taskGroup;
+};
+
+typedef std::shared_ptr<Computation> ComputationPtr;
+
+// The additional state of the items of the TaskParallel policy.
+struct ComputationState
+{
+	// Set while the value is being computed. Protected
+	// by the Bin mutex rather than the Item mutex, because
+	// the Item mutex is held throughout the computation.
+	mutable ComputationPtr computation;
+};
+
+struct NoState
+{
+};
+
+// The additional state of the items of the ScanResistant
+// policy, protected by the Item mutex.
+template<typename Cost>
+struct AdmissionState
+{
+	AdmissionState() : admission( Pending ), probationCost( 0 ) {}
+
+	// The part of the cache an item belongs to.
+	enum Admission
+	{
+		// Not decided yet, because no value has been stored.
+		Pending,
+		// In the probation queue.
+		Probation,
+		// In the main part of the cache.
+		Main
+	};
+
+	mutable Admission admission;
+	// The cost accounted for in ScanResistant::m_probationCost.
+	mutable Cost probationCost;
+};
+
+} // namespace Detail
+
+// Uses Detail::Binned directly, blocking while another thread
+// computes the item it needs.
+template<typename LRUCache>
+class Parallel : public Detail::Binned<LRUCache, Detail::NoState>
+{
+
+	public :
+
+		struct Handle : public Detail::Binned<LRUCache, Detail::NoState>::HandleBase
+		{
+
+			template<typename F>
+			void execute( const F &f )
+			{
+				f();
+			}
+
+		};
+
+};
+
+// As for Parallel, but a thread needing an item which is being computed
+// by another thread collaborates on the computation rather than blocking.
+// The GetterFunction is run within a task_arena dedicated to the item,
+// and waiting threads enter the arena and help execute the TBB tasks it
+// spawns until the computation is complete. Because the arena is isolated,
+// waiting threads only ever pick up work for the item they need, and never
+// an unrelated outer task which might try to acquire a lock they hold.
+template<typename LRUCache>
+class TaskParallel : public Detail::Binned<LRUCache, Detail::ComputationState>
+{
+
+	typedef Detail::Binned<LRUCache, Detail::ComputationState> Base;
+
+	public :
+
+		typedef typename Base::Key Key;
+		typedef typename Base::Item Item;
+		typedef typename Base::Bin Bin;
+
+		struct Handle : public Base::HandleBase
+		{
+
+			// Runs f in a task_arena which other threads waiting
+			// for the item can join to help with the computation.
+			template<typename F>
+			void execute( const F &f )
+			{
+				assert( this->m_writable );
+				Detail::ComputationPtr computation( new Detail::Computation );
+				setComputation( computation );
+				try
+				{
+					computation->arena.execute(
+						[&computation, &f] {
+							computation->taskGroup.run_and_wait( f );
+						}
+					);
+				}
+				catch( ... )
+				{
+					setComputation( Detail::ComputationPtr() );
+					throw;
+				}
+				setComputation( Detail::ComputationPtr() );
+			}
+
+			private :
+
+				void setComputation( const Detail::ComputationPtr &computation )
+				{
+					typename Bin::Mutex::scoped_lock binLock( this->m_bin->mutex, /* write = */ true );
+					this->m_item->computation = computation;
+				}
+
+		};
+
+		bool acquire( const Key &key, Handle &handle, AcquireMode mode )
+		{
+			return Base::acquire(
+				key, handle, mode,
+				[]( const Item &item, typename Bin::Mutex::scoped_lock &binLock ) {
+					// The Item lock is held by another thread. We
+					// must release the Bin lock before waiting, but
+					// first take a reference to the computation, if
+					// there is one, so we can join in with it.
+					Detail::ComputationPtr computation = item.computation;
+					binLock.release();
+					if( computation )
+					{
+						if( computation->observer.containsThisThread() )
+						{
+							// We are working for the GetterFunction, either as the
+							// thread which called it or by executing one of its tasks,
+							// so we would be waiting for ourselves forever.
+							throw IECore::Exception( "LRUCache : Recursive call to get() for an item being computed" );
+						}
+						computation->arena.execute(
+							[&computation] {
+								computation->taskGroup.wait();
+							}
+						);
+					}
+					else
+					{
+						tbb::this_tbb_thread::yield();
+					}
+				}
+			);
+		}
+
+};
+
+// As for Parallel, but protecting frequently used items from being
+// evicted by a scan through many items which are each used only once,
+// as happens when a whole file is traversed by a batch process sharing
+// the cache with an interactive session. New items are admitted on
+// probation, in a FIFO queue which is chosen for eviction while it
+// holds more than a tenth of the total cost. A probationary item only
+// joins the main part of the cache if it is requested again before
+// leaving the queue, otherwise it is evicted without disturbing the
+// main part, which uses the same second-chance algorithm as the
+// Parallel policy. The keys of the evicted probationary items are
+// remembered for a while as "ghosts", so that items which are needed
+// again soon after are admitted directly to the main part. This is
+// the S3-FIFO design described by Yang et al. in "FIFO queues are all
+// you need for cache eviction".
+template<typename LRUCache>
+class ScanResistant : public Detail::Binned<LRUCache, Detail::AdmissionState<typename LRUCache::Cost>>
+{
+
+	typedef Detail::Binned<LRUCache, Detail::AdmissionState<typename LRUCache::Cost>> Base;
+
+	public :
+
+		typedef typename Base::CacheEntry CacheEntry;
+		typedef typename Base::Key Key;
+		typedef typename Base::Cost Cost;
+		typedef typename Base::AtomicCost AtomicCost;
+		typedef typename Base::Item Item;
+		typedef typename Base::Bin Bin;
+		typedef typename Base::MapIterator MapIterator;
+
+		ScanResistant()
+		{
+			m_probationCost = 0;
+			m_ghostCost = 0;
+		}
+
+		struct Handle : public Base::HandleBase
+		{
+
+			template<typename F>
+			void execute( const F &f )
+			{
+				f();
+			}
+
+			private :
+
+				friend class ScanResistant;
+
+		};
+
+		void push( Handle &handle )
+		{
+			const Item *item = handle.m_item;
+			if( !handle.m_writable )
+			{
+				// The item has been found in the cache. This
+				// promotes it if it is on probation.
+				item->recentlyUsed = true;
+				return;
+			}
+
+			// A value has just been stored for the item.
+			const Cost cost = item->cacheEntry.status() == LRUCache::Cached ? item->cacheEntry.cost : 0;
+			switch( item->admission )
+			{
+				case Item::Pending :
+					if( removeGhost( item->key ) )
+					{
+						// Evicted from probation recently, so this is
+						// at least the second time it has been needed.
+						item->admission = Item::Main;
+						item->recentlyUsed = true;
+					}
+					else
+					{
+						item->admission = Item::Probation;
+						item->probationCost = cost;
+						m_probationCost += cost;
+						ProbationMutex::scoped_lock lock( m_probationMutex );
+						m_probation.push_back( item->key );
+					}
+					break;
+				case Item::Probation :
+					m_probationCost -= item->probationCost;
+					m_probationCost += cost;
+					item->probationCost = cost;
+					break;
+				case Item::Main :
+					item->recentlyUsed = true;
+					break;
+			}
+		}
+
+		bool pop( Key &key, CacheEntry &cacheEntry )
+		{
+			typename Base::PopMutex::scoped_lock lock;
+			if( !lock.try_acquire( this->m_popMutex ) )
+			{
+				return false;
+			}
+
+			if( m_probationCost * 10 > this->currentCost && popProbation( key, cacheEntry ) )
+			{
+				return true;
+			}
+
+			// Fall back to the probation queue when nothing can be
+			// evicted from the main part of the cache.
+			return popMain( key, cacheEntry ) || popProbation( key, cacheEntry );
+		}
+
+	private :
+
+		// Records the keys of the items recently evicted from probation,
+		// so that they are admitted directly to the main part of the cache
+		// if they are requested again. We only store the hash of the key
+		// because it is cheaper, and an occasional collision merely admits
+		// an item to the main part unnecessarily.
+		struct Ghost
+		{
+			Ghost( size_t hash, Cost cost ) : hash( hash ), cost( cost ) {}
+			size_t hash;
+			Cost cost;
+		};
+
+		typedef boost::multi_index::multi_index_container<
+			Ghost,
+			boost::multi_index::indexed_by<
+				boost::multi_index::sequenced<>,
+				boost::multi_index::hashed_non_unique<
+					boost::multi_index::member<Ghost, size_t, &Ghost::hash>
+				>
+			>
+		> Ghosts;
+
+		// Returns true if the key was recently evicted from probation,
+		// forgetting about it so that it must earn its place again
+		// next time.
+		bool removeGhost( const Key &key )
+		{
+			typename Ghosts::template nth_index<1>::type &hashIndex = m_ghosts.template get<1>();
+			GhostMutex::scoped_lock lock( m_ghostMutex );
+			typename Ghosts::template nth_index<1>::type::iterator it = hashIndex.find( boost::hash<Key>()( key ) );
+			if( it == hashIndex.end() )
+			{
+				return false;
+			}
+			m_ghostCost -= it->cost;
+			hashIndex.erase( it );
+			return true;
+		}
+
+		// Adds a ghost for an evicted item, keeping the
+		// total cost of the ghosts at or below the total
+		// cost of the cache, as in S3-FIFO.
+		void addGhost( const Key &key, Cost cost )
+		{
+			// We count ghosts as costing at least 1, so
+			// that zero cost items don't accumulate.
+			cost = std::max<Cost>( cost, 1 );
+			GhostMutex::scoped_lock lock( m_ghostMutex );
+			m_ghosts.push_back( Ghost( boost::hash<Key>()( key ), cost ) );
+			m_ghostCost += cost;
+			while( m_ghostCost > this->currentCost && !m_ghosts.empty() )
+			{
+				m_ghostCost -= m_ghosts.front().cost;
+				m_ghosts.pop_front();
+			}
+		}
+
+		// Evicts the oldest probationary item not requested since it
+		// was admitted, moving the requested ones to the main part of
+		// the cache. Must be called with m_popMutex held.
+		bool popProbation( Key &key, CacheEntry &cacheEntry )
+		{
+			size_t remaining;
+			{
+				ProbationMutex::scoped_lock lock( m_probationMutex );
+				remaining = m_probation.size();
+			}
+
+			for( ; remaining; --remaining )
+			{
+				Key candidate;
+				{
+					ProbationMutex::scoped_lock lock( m_probationMutex );
+					candidate = m_probation.front();
+					m_probation.pop_front();
+				}
+
+				const size_t binIndex = this->binIndex( candidate );
+				Bin &bin = this->m_bins[binIndex];
+				typename Bin::Mutex::scoped_lock binLock( bin.mutex );
+				MapIterator it = bin.map.find( candidate );
+				assert( it != bin.map.end() && it->admission == Item::Probation );
+
+				typename Item::Mutex::scoped_lock itemLock;
+				if( !itemLock.try_acquire( it->mutex ) )
+				{
+					// Another thread is busy with the item, so it is
+					// still in use. Give it another turn.
+					ProbationMutex::scoped_lock lock( m_probationMutex );
+					m_probation.push_back( candidate );
+					continue;
+				}
+
+				const Cost cost = it->probationCost;
+				m_probationCost -= cost;
+				it->probationCost = 0;
+
+				if( it->recentlyUsed )
+				{
+					// Keep the flag, so that it also gets
+					// a second chance in the main part.
+					it->admission = Item::Main;
+					continue;
+				}
+
+				key = it->key;
+				cacheEntry = it->cacheEntry;
+				// See Binned::pop() for why it is safe to
+				// release the item lock before erasing.
+				itemLock.release();
+				if( binIndex == this->m_popBinIndex && it == this->m_popIterator )
+				{
+					this->m_popIterator = bin.map.erase( it );
+				}
+				else
+				{
+					bin.map.erase( it );
+				}
+				binLock.release();
+
+				addGhost( key, cost );
+				return true;
+			}
+
+			return false;
+		}
+
+		// As Binned::pop(), but skipping probationary items, and
+		// giving up after two passes through all the items. Must be
+		// called with m_popMutex held.
+		bool popMain( Key &key, CacheEntry &cacheEntry )
+		{
+			return this->popSecondChance(
+				key, cacheEntry,
+				[]( const Item &item ) { return item.admission == Item::Probation; },
+				2 * this->m_bins.size() + 1
+			);
+		}
+
+		typedef tbb::spin_mutex ProbationMutex;
+		ProbationMutex m_probationMutex;
+		std::deque<Key> m_probation;
+		AtomicCost m_probationCost;
+
+		typedef tbb::spin_mutex GhostMutex;
+		GhostMutex m_ghostMutex;
+		Ghosts m_ghosts;
+		Cost m_ghostCost;
+
+};
+
 } // namespace LRUCachePolicy
 
 // CacheEntry
@@ -590,18 +1124,21 @@ template<typename Key, typename Value, template <typename> class Policy, typenam
 LRUCache<Key, Value, Policy, GetterKey>::LRUCache( GetterFunction getter )
 	:	m_getter( getter ), m_removalCallback( nullRemovalCallback ), m_maxCost( 500 )
 {
+	resetStatistics();
 }
 
 template<typename Key, typename Value, template <typename> class Policy, typename GetterKey>
 LRUCache<Key, Value, Policy, GetterKey>::LRUCache( GetterFunction getter, Cost maxCost )
 	:	m_getter( getter ), m_removalCallback( nullRemovalCallback ), m_maxCost( maxCost )
 {
+	resetStatistics();
 }
 
 template<typename Key, typename Value, template <typename> class Policy, typename GetterKey>
 LRUCache<Key, Value, Policy, GetterKey>::LRUCache( GetterFunction getter, RemovalCallback removalCallback, Cost maxCost )
 	:	m_getter( getter ), m_removalCallback( removalCallback ), m_maxCost( maxCost )
 {
+	resetStatistics();
 }
 
 template<typename Key, typename Value, template <typename> class Policy, typename GetterKey>
@@ -647,6 +1184,24 @@ typename LRUCache<Key, Value, Policy, GetterKey>::Cost LRUCache<Key, Value, Poli
 	return m_policy.currentCost;
 }
 
+template<typename Key, typename Value, template <typename> class Policy, typename GetterKey>
+typename LRUCache<Key, Value, Policy, GetterKey>::Statistics LRUCache<Key, Value, Policy, GetterKey>::statistics() const
+{
+	Statistics result;
+	result.hits = m_hits;
+	result.misses = m_misses;
+	result.evictions = m_evictions;
+	return result;
+}
+
+template<typename Key, typename Value, template <typename> class Policy, typename GetterKey>
+void LRUCache<Key, Value, Policy, GetterKey>::resetStatistics()
+{
+	m_hits = 0;
+	m_misses = 0;
+	m_evictions = 0;
+}
+
 template<typename Key, typename Value, template <typename> class Policy, typename GetterKey>
 Value LRUCache<Key, Value, Policy, GetterKey>::get( const GetterKey &key )
 {
@@ -657,11 +1212,12 @@ Value LRUCache<Key, Value, Policy, GetterKey>::get( const GetterKey &key )
 
 	if( status==Uncached )
 	{
+		++m_misses;
 		Value value = Value();
 		Cost cost = 0;
 		try
 		{
-			value = m_getter( key, cost );
+			handle.execute( [this, &key, &value, &cost] { value = m_getter( key, cost ); } );
 		}
 		catch( ... )
 		{
@@ -682,11 +1238,13 @@ Value LRUCache<Key, Value, Policy, GetterKey>::get( const GetterKey &key )
 	}
 	else if( status==Cached )
 	{
+		++m_hits;
 		m_policy.push( handle );
 		return boost::get<Value>( cacheEntry.state );
 	}
 	else
 	{
+		++m_hits;
 		std::rethrow_exception( boost::get<std::exception_ptr>( cacheEntry.state ) );
 	}
 }
@@ -773,7 +1331,10 @@ void LRUCache<Key, Value, Policy, GetterKey>::limitCost( Cost cost )
 			break;
 		}
 
-		eraseInternal( key, cacheEntry );
+		if( eraseInternal( key, cacheEntry ) )
+		{
+			++m_evictions;
+		}
 	}
 }
 
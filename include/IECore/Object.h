@@ -37,7 +37,9 @@
 
 #include "IECore/Export.h"
 #include "IECore/IndexedIO.h"
+#include "IECore/ObjectStatistics.h"
 #include "IECore/RunTimeTyped.h"
+#include "IECore/SmallObjectAllocator.h"
 
 #include <memory>
 #include <string>
@@ -52,6 +54,7 @@ class MurmurHash;
 #define IE_CORE_DECLAREOBJECTTYPEDESCRIPTION( TYPENAME )																\
 	private :																											\
 		static const IECore::Object::TypeDescription<TYPENAME> m_typeDescription;										\
+	IECORE_OBJECTSTATISTICS_COUNTINSTANCES( TYPENAME )																	\
 	public :																											\
 
 #define IE_CORE_DECLAREOBJECTMEMBERFNS( TYPENAME )																		\
@@ -90,6 +93,7 @@ class IECORE_API Object : public RunTimeTyped
 		~Object() override;
 
 		IE_CORE_DECLARERUNTIMETYPED( Object, RunTimeTyped );
+		IECORE_OBJECTSTATISTICS_COUNTINSTANCES( Object );
 
 		//! @name Object interface
 		/// The following functions define the interface to which
@@ -253,6 +257,8 @@ class IECORE_API Object : public RunTimeTyped
 		{
 			public :
 				LoadContext( ConstIndexedIOPtr ioInterface );
+				/// A LoadContext is created for every Object loaded.
+				IECORE_SMALLOBJECTALLOCATOR_OPERATORS
 				/// Returns an interface to the container created by SaveContext::container().
 				/// @param typeName The typename of your class.
 				/// @param ioVersion On entry this should contain the current file format version
@@ -41,6 +41,8 @@
 
 #include "boost/shared_ptr.hpp"
 
+#include <functional>
+
 namespace IECore
 {
 
@@ -93,6 +95,13 @@ class IECORE_API ObjectPool : public RefCounted
 		{
 			StoreCopy = 0,
 			StoreReference,
+			/// Stores a copy of the object, in which each Data buffer of significant size
+			/// shares its storage with an identical buffer already in the pool, using
+			/// lazy-copy-on-write. The buffers are found using the functions registered
+			/// with registerDeduplicateFn(), and are stored in the pool as objects in their
+			/// own right, so that their memory is counted only once. Note that the memory
+			/// of an evicted buffer is not freed while other objects in the pool use it.
+			StoreDeduplicated
 		};
 
 		/// Stores a reference to the object or a copy to the object in the pool, depending on the storeMode parameter.
@@ -101,6 +110,19 @@ class IECORE_API ObjectPool : public RefCounted
 		/// prevent affecting the contents of the pool and it's memoryUsage count.
 		ConstObjectPtr store( const Object *obj, StoreMode mode );
 
+		/// Function returning the object to be used in place of a child
+		/// of an object being stored with StoreDeduplicated.
+		typedef std::function<ObjectPtr ( const Object *child )> ChildFn;
+		/// Function replacing each child of object with the result of
+		/// calling childFn on it.
+		typedef void (*DeduplicateFn)( Object *object, const ChildFn &childFn );
+		/// Registers the function used to find the children of objects of the given
+		/// type when storing them with StoreDeduplicated. The functions registered for
+		/// the base types are called too, so each function need only deal with the
+		/// children added by its own type. Returns true, so that registration can be
+		/// done by initialising a static variable.
+		static bool registerDeduplicateFn( TypeId typeId, DeduplicateFn deduplicateFn );
+
 		/// Returns a static ObjectPool instance to be used by anything
 		/// wishing to share IECore::Object instances.
 		/// It makes sense to use this wherever possible to conserve memory. This initially
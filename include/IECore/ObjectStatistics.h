@@ -0,0 +1,234 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef IECORE_OBJECTSTATISTICS_H
+#define IECORE_OBJECTSTATISTICS_H
+
+#include "IECore/Export.h"
+#include "IECore/TypeIds.h"
+
+#include "boost/noncopyable.hpp"
+
+#include "tbb/atomic.h"
+
+#include <functional>
+#include <map>
+#include <string>
+
+namespace IECore
+{
+
+/// Provides a live breakdown of the memory used by Objects, by type,
+/// and of the memory held by the caches which own them. The accounting
+/// is only performed when IECore is built with OBJECT_STATISTICS=1,
+/// which defines IECORE_OBJECTSTATISTICS. Otherwise no counters are
+/// compiled into the classes at all, and snapshot() returns empty
+/// results. Because the counters change the layout of the classes,
+/// code using IECore must be compiled with the same setting.
+///
+/// Instances are counted for every class declared with the
+/// IE_CORE_DECLAREOBJECT or IE_CORE_DECLAREEXTENSIONOBJECT macros,
+/// and for every instantiation of TypedData. Instances of other
+/// classes are counted against their nearest counted base class, and
+/// GeometricTypedData are counted against their TypedData base, for
+/// instance V3fVectorDataBase. The storage of the TypedData is counted
+/// separately, once per buffer, so data sharing storage through
+/// lazy-copy-on-write don't inflate the totals.
+/// \ingroup coreGroup
+class IECORE_API ObjectStatistics
+{
+
+	public :
+
+		/// Returns true if the accounting was compiled in.
+		static bool enabled();
+
+		struct TypeStatistics
+		{
+			TypeStatistics();
+
+			/// The number of live instances of the type.
+			size_t instances;
+			/// The size of those instances, not including
+			/// any memory they reference.
+			size_t instanceMemory;
+			/// The number of live buffers holding TypedData
+			/// storage.
+			size_t buffers;
+			/// The total size of those buffers.
+			size_t bufferMemory;
+		};
+
+		struct Snapshot
+		{
+			std::map<TypeId, TypeStatistics> types;
+			/// The memory held by each registered Owner, summed by
+			/// name. Owners often share objects - the SceneCache
+			/// caches may store objects from the ObjectPool for
+			/// instance - so these totals may overlap.
+			std::map<std::string, size_t> owners;
+		};
+
+		/// Returns the current statistics. Counts are gathered
+		/// without stopping other threads, so are only approximate
+		/// while objects are being created or modified. The memory
+		/// of each buffer is that recorded when it was last accessed
+		/// after being modified - see Buffer::updateBuffer().
+		static Snapshot snapshot();
+
+		/// Registers something holding Objects, so that its memory usage
+		/// is reported in Snapshot::owners for the lifetime of the Owner.
+		class IECORE_API Owner : boost::noncopyable
+		{
+
+			public :
+
+				typedef std::function<size_t ()> MemoryUsageFunction;
+
+				Owner( const std::string &name, const MemoryUsageFunction &memoryUsage );
+				~Owner();
+
+				const std::string &name() const;
+				size_t memoryUsage() const;
+
+			private :
+
+				std::string m_name;
+				MemoryUsageFunction m_memoryUsage;
+
+		};
+
+		/// Counts the live instances of T. Used as a member of T by the
+		/// IECORE_OBJECTSTATISTICS_COUNTINSTANCES macro. The counts are
+		/// inclusive of derived classes, and are made exclusive by
+		/// snapshot().
+		template<typename T>
+		class InstanceCounter
+		{
+
+			public :
+
+				InstanceCounter() { counter()++; }
+				InstanceCounter( const InstanceCounter & ) { counter()++; }
+				InstanceCounter &operator = ( const InstanceCounter & ) { return *this; }
+				~InstanceCounter() { counter()--; }
+
+			private :
+
+				static tbb::atomic<size_t> &counter()
+				{
+					static tbb::atomic<size_t> *c = ObjectStatistics::instanceCounter( T::staticTypeId(), sizeof( T ) );
+					return *c;
+				}
+
+		};
+
+		/// The totals for the buffers of a single type. Used
+		/// internally by Buffer.
+		struct BufferCounter
+		{
+			TypeId typeId;
+			tbb::atomic<size_t> buffers;
+			tbb::atomic<size_t> memory;
+		};
+
+		/// Base class for the storage of TypedData, which records
+		/// the memory it uses so that snapshot() can report it.
+		/// The memory is summed into totals for each type as it
+		/// is recorded, so snapshot() never accesses the buffers
+		/// themselves.
+		class IECORE_API Buffer
+		{
+
+			protected :
+
+				Buffer();
+				~Buffer();
+
+				/// Must be called at the end of the constructor of the
+				/// derived class, with the memory initially in use. The
+				/// buffer is counted against T, which must be a RunTimeTyped
+				/// class.
+				template<typename T>
+				void registerBuffer( size_t memoryUsage );
+				/// Records a change in the memory used by the buffer. This is
+				/// typically called lazily by the next access following a
+				/// modification, since modifications can't be intercepted.
+				void updateBuffer( size_t memoryUsage );
+				/// Must be called at the start of the destructor of the
+				/// derived class.
+				void unregisterBuffer();
+
+			private :
+
+				BufferCounter *m_counter;
+				tbb::atomic<size_t> m_memoryUsage;
+
+		};
+
+	private :
+
+		static tbb::atomic<size_t> *instanceCounter( TypeId typeId, size_t size );
+		static BufferCounter *bufferCounter( TypeId typeId );
+
+};
+
+template<typename T>
+void ObjectStatistics::Buffer::registerBuffer( size_t memoryUsage )
+{
+	static BufferCounter *c = ObjectStatistics::bufferCounter( T::staticTypeId() );
+	m_counter = c;
+	m_memoryUsage = memoryUsage;
+	m_counter->buffers++;
+	m_counter->memory += memoryUsage;
+}
+
+#ifdef IECORE_OBJECTSTATISTICS
+
+/// Declares a member which counts the instances of TYPENAME.
+#define IECORE_OBJECTSTATISTICS_COUNTINSTANCES( TYPENAME )											\
+	private :																						\
+		IECore::ObjectStatistics::InstanceCounter<TYPENAME> m_instanceCounter;						\
+	public :																						\
+
+#else
+
+#define IECORE_OBJECTSTATISTICS_COUNTINSTANCES( TYPENAME )
+
+#endif // IECORE_OBJECTSTATISTICS
+
+} // namespace IECore
+
+#endif // IECORE_OBJECTSTATISTICS_H
@@ -48,6 +48,10 @@ namespace IECore
 /// A RadixSort implementation derived from Pierre Terdiman's OPCODE library, which has as "free for use in any commercial
 /// or non-commercial program" licence. The RadixSort class maintains state so that successive calls to it are able to exploit any coherence
 /// in the source data. Sorting is done in ascending order.
+///
+/// The sort is stable : equal values keep their order from the input, or for successive sorts of inputs of
+/// the same size, their order from the previous result. Large inputs and 64 bit values are sorted in parallel
+/// using TBB, with the result being identical to that of a sort on a single thread.
 /// \ingroup mathGroup
 class IECORE_API RadixSort
 {
@@ -75,6 +79,22 @@ class IECORE_API RadixSort
 		/// found in indices[3].
 		const std::vector<unsigned int> &operator()( const std::vector<int> &input );
 
+		/// Sort the given vector of doubles, returning a vector of indices as above.
+		const std::vector<unsigned int> &operator()( const std::vector<double> &input );
+
+		/// Sort the given vector of 64 bit unsigned ints, returning a vector of indices as above. This is
+		/// suitable for sorting by Morton codes, or by keys derived from a MurmurHash.
+		const std::vector<unsigned int> &operator()( const std::vector<uint64_t> &input );
+
+		/// Sort the given vector of 64 bit signed ints, returning a vector of indices as above.
+		const std::vector<unsigned int> &operator()( const std::vector<int64_t> &input );
+
+		/// Reorders values in place so that values[i] becomes values[indices[i]], where indices
+		/// is the result of a sort. This can be used to apply a sort to the keys themselves, or
+		/// to any payload associated with them. The reordering is performed in parallel.
+		template<typename T>
+		static void permute( const std::vector<unsigned int> &indices, std::vector<T> &values );
+
 	private:
 
 		template<typename T>
@@ -91,10 +111,15 @@ class IECORE_API RadixSort
 		template<typename T>
 		bool checkPassValidity( const std::vector<T> &input, unsigned int j, unsigned int* &curCount, unsigned char &uniqueVal );
 
+		template<typename T>
+		const std::vector<unsigned int> &parallelSort( const std::vector<T> &input );
+
 		void resize( unsigned int s );
 		void checkResize( unsigned int s );
 };
 
 } // namespace IECore
 
+#include "IECore/RadixSort.inl"
+
 #endif // IE_CORE_RADIXSORT_H
@@ -0,0 +1,143 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_SMALLOBJECTALLOCATOR_H
+#define IECORE_SMALLOBJECTALLOCATOR_H
+
+#include "IECore/Export.h"
+
+#include <cstddef>
+#include <new>
+
+namespace IECore
+{
+
+/// Allocates small blocks of memory from pools of fixed size blocks, for
+/// classes such as the TypedData which are created in great numbers when
+/// loading files. Freed blocks are kept in a small cache private to each
+/// thread, so most allocations and deallocations don't touch any shared
+/// state at all, and blocks are carved out of large slabs, so that far
+/// fewer calls are made to the system allocator.
+///
+/// Memory used by the pools is reused for new blocks of the same size,
+/// and is only returned to the system by trim(). Pooling may be disabled by setting
+/// the IECORE_SMALLOBJECTALLOCATOR environment variable to 0, in which case
+/// all blocks are allocated with ::operator new.
+/// \ingroup coreGroup
+class IECORE_API SmallObjectAllocator
+{
+
+	public :
+
+		/// Blocks larger than this are allocated with ::operator new.
+		static const size_t maxBlockSize = 256;
+
+		/// Allocates a block of at least size bytes, aligned suitably
+		/// for any type.
+		static void *allocate( size_t size );
+		/// Frees a block returned by allocate(). The size must be the
+		/// same as that passed to allocate().
+		static void deallocate( void *block, size_t size );
+		/// As above, but for when the size isn't known. This must search
+		/// all the pools for the block, so is much slower, and is only
+		/// intended for rare cases such as the placement delete called
+		/// when a constructor throws.
+		static void deallocate( void *block );
+
+		/// Returns to the system the slabs whose blocks are all free,
+		/// and returns the number of bytes released. The blocks held in
+		/// the private caches of other threads aren't considered free,
+		/// so the slabs containing them are kept. This takes the locks
+		/// of all the pools in turn, so shouldn't be called while
+		/// performance matters.
+		static size_t trim();
+
+		struct Statistics
+		{
+			/// The number of slabs allocated from the system.
+			size_t slabs;
+			/// The total size of those slabs, in bytes.
+			size_t slabMemory;
+		};
+
+		static Statistics statistics();
+
+};
+
+/// Defines class specific operator new and delete which use the
+/// SmallObjectAllocator. These are inherited by derived classes,
+/// and are used by `delete` via a virtual destructor, so any
+/// derived class too large for the pools is allocated normally.
+/// The placement and nothrow forms are defined too, because the
+/// class specific operators would otherwise hide the global ones.
+#define IECORE_SMALLOBJECTALLOCATOR_OPERATORS											\
+	static void *operator new( size_t size )											\
+	{																					\
+		return IECore::SmallObjectAllocator::allocate( size );							\
+	}																					\
+																						\
+	static void operator delete( void *p, size_t size )									\
+	{																					\
+		IECore::SmallObjectAllocator::deallocate( p, size );							\
+	}																					\
+																						\
+	static void *operator new( size_t size, const std::nothrow_t & ) noexcept			\
+	{																					\
+		try																				\
+		{																				\
+			return IECore::SmallObjectAllocator::allocate( size );						\
+		}																				\
+		catch( ... )																	\
+		{																				\
+			return nullptr;																\
+		}																				\
+	}																					\
+																						\
+	static void operator delete( void *p, const std::nothrow_t & ) noexcept			\
+	{																					\
+		IECore::SmallObjectAllocator::deallocate( p );									\
+	}																					\
+																						\
+	static void *operator new( size_t size, void *p ) noexcept							\
+	{																					\
+		return p;																		\
+	}																					\
+																						\
+	static void operator delete( void *p, void *place ) noexcept						\
+	{																					\
+	}																					\
+
+} // namespace IECore
+
+#endif // IECORE_SMALLOBJECTALLOCATOR_H
@@ -97,6 +97,24 @@ class IECORE_API StreamIndexedIO : public IndexedIO
 
 		void commit() override;
 
+		/// Array data of at least this many bytes is compressed when it is
+		/// written. The data is compressed in independent chunks, so that it
+		/// can be compressed and decompressed in parallel. The threshold applies
+		/// to the whole file, and the default of 0 disables compression. Note
+		/// that files containing compressed data can't be read by versions of
+		/// StreamIndexedIO which predate compression.
+		void setCompressionThreshold( size_t threshold );
+		size_t getCompressionThreshold() const;
+
+		/// When enabled, the index is written so that its strings and large
+		/// directories are loaded on demand, making big files much quicker
+		/// to open. This applies to the whole file, and is disabled by default
+		/// because files written this way can't be read by versions of
+		/// StreamIndexedIO which predate it. Appending to such a file keeps
+		/// it enabled.
+		void setOnDemandIndex( bool onDemandIndex );
+		bool getOnDemandIndex() const;
+
 		void write(const IndexedIO::EntryID &name, const float *x, unsigned long arrayLength) override;
 		void write(const IndexedIO::EntryID &name, const double *x, unsigned long arrayLength) override;
 		void write(const IndexedIO::EntryID &name, const half *x, unsigned long arrayLength) override;
@@ -169,6 +187,11 @@ class IECORE_API StreamIndexedIO : public IndexedIO
 				void seekp( size_t pos, std::ios_base::seekdir dir );
 				void read( char *buffer, size_t size );
 				void write( const char *buffer, size_t size );
+				/// Reads size bytes starting at pos. This is thread safe and
+				/// does not affect the position used by seekg() and read().
+				/// The default implementation serialises access via mutex(),
+				/// but derived classes may override it to read without locking.
+				virtual void read( char *buffer, size_t size, size_t pos );
 				Imf::Int64 tellg();
 				Imf::Int64 tellp();
 
@@ -74,6 +74,12 @@ class IECORE_EXPORT TypedData : public Data
 
 		IECORE_RUNTIMETYPED_DECLARETEMPLATE( TypedData<T>, Data );
 
+		/// TypedData are allocated with the SmallObjectAllocator, as
+		/// they're often small and created in large numbers.
+		IECORE_SMALLOBJECTALLOCATOR_OPERATORS
+
+		IECORE_OBJECTSTATISTICS_COUNTINSTANCES( TypedData<T> )
+
 		//! @name Object interface
 		////////////////////////////////////////////////////////////
 		//@{
@@ -36,10 +36,103 @@
 #define IECORE_TYPEDDATAINTERNALS_H
 
 #include "IECore/MurmurHash.h"
+#include "IECore/ObjectStatistics.h"
+#include "IECore/SmallObjectAllocator.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
 
 namespace IECore
 {
 
+namespace Detail
+{
+
+// Arrays larger than this are hashed as a series of chunks of this many
+// bytes. The chunks are hashed in parallel, and their hashes are then
+// combined to give the hash for the whole array. The chunk boundaries
+// depend only on the size of the array, so the result is the same
+// however many threads are used.
+static const size_t g_hashChunkBytes = 1024 * 1024;
+
+template<typename T>
+MurmurHash hashElements( const T *elements, size_t numElements )
+{
+	MurmurHash result;
+	const size_t chunkSize = std::max<size_t>( g_hashChunkBytes / sizeof( T ), 1 );
+	if( numElements <= chunkSize )
+	{
+		result.append( elements, numElements );
+		return result;
+	}
+
+	const size_t numChunks = ( numElements + chunkSize - 1 ) / chunkSize;
+	std::vector<MurmurHash> chunkHashes( numChunks );
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numChunks, 1 ),
+		[elements, numElements, chunkSize, &chunkHashes]( const tbb::blocked_range<size_t> &range ) {
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				const size_t begin = i * chunkSize;
+				chunkHashes[i].append( elements + begin, std::min( chunkSize, numElements - begin ) );
+			}
+		},
+		taskGroupContext
+	);
+
+	// The scheme and chunk size are included so that the result can't
+	// collide with a sequential hash or one using different chunks.
+	result.append( "IECore::Detail::hashElements" );
+	result.append( (uint64_t)g_hashChunkBytes );
+	result.append( (uint64_t)numElements );
+	for( std::vector<MurmurHash>::const_iterator it = chunkHashes.begin(); it != chunkHashes.end(); ++it )
+	{
+		result.append( *it );
+	}
+	return result;
+}
+
+#ifdef IECORE_OBJECTSTATISTICS
+
+// The memory used by the storage of a SharedDataHolder, as reported
+// to the ObjectStatistics. This doesn't include any memory referenced
+// by the elements themselves, except in the case of strings.
+template<typename T>
+size_t bufferMemoryUsage( const T &data )
+{
+	return sizeof( T );
+}
+
+template<typename T>
+size_t bufferMemoryUsage( const std::vector<T> &data )
+{
+	return sizeof( std::vector<T> ) + data.capacity() * sizeof( T );
+}
+
+inline size_t bufferMemoryUsage( const std::vector<std::string> &data )
+{
+	size_t result = sizeof( std::vector<std::string> ) + data.capacity() * sizeof( std::string );
+	for( std::vector<std::string>::const_iterator it = data.begin(); it != data.end(); ++it )
+	{
+		result += it->capacity();
+	}
+	return result;
+}
+
+#endif // IECORE_OBJECTSTATISTICS
+
+} // namespace Detail
+
+template<class T>
+class TypedData;
+
 template<class T>
 class IECORE_EXPORT SimpleDataHolder
 {
@@ -98,9 +191,23 @@ class IECORE_EXPORT SharedDataHolder
 		{
 		}
 
+		SharedDataHolder( const SharedDataHolder<T> &other )
+			: m_data( other.m_data )
+		{
+			other.updateMemoryUsage();
+		}
+
+		SharedDataHolder<T> &operator = ( const SharedDataHolder<T> &other )
+		{
+			other.updateMemoryUsage();
+			m_data = other.m_data;
+			return *this;
+		}
+
 		const T &readable() const
 		{
 			assert( m_data );
+			updateMemoryUsage();
 			return m_data->data;
 		}
 
@@ -113,6 +220,9 @@ class IECORE_EXPORT SharedDataHolder
 				m_data = new Shareable( m_data->data );
 			}
 			m_data->hashValid = false;
+#ifdef IECORE_OBJECTSTATISTICS
+			m_data->memoryUsageValid = false;
+#endif
 			return m_data->data;
 		}
 
@@ -134,6 +244,7 @@ class IECORE_EXPORT SharedDataHolder
 		// datatype has special needs.
 		void hash( MurmurHash &h ) const
 		{
+			updateMemoryUsage();
 			if( !m_data->hashValid )
 			{
 				m_data->hash = hash();
@@ -146,13 +257,59 @@ class IECORE_EXPORT SharedDataHolder
 
 		MurmurHash hash() const
 		{
-			MurmurHash result;
-			result.append( &(readable()[0]), readable().size() );
-			return result;
+			return Detail::hashElements( readable().data(), readable().size() );
 		}
 
 	private :
 
+#ifdef IECORE_OBJECTSTATISTICS
+
+		// Modifications made through writable() can't be intercepted, so
+		// the memory used by the data is recorded again on the next access.
+		// This is made by the thread accessing the data, so the statistics
+		// never need to read data which may be being modified.
+		void updateMemoryUsage() const
+		{
+			if( !m_data->memoryUsageValid )
+			{
+				m_data->memoryUsageValid = true;
+				m_data->updateBuffer( Detail::bufferMemoryUsage( m_data->data ) );
+			}
+		}
+
+		class IECORE_EXPORT Shareable : public RefCounted, public ObjectStatistics::Buffer
+		{
+			public :
+
+				Shareable() : data(), hashValid( false ) { initBuffer(); }
+				Shareable( const T &initData ) : data( initData ), hashValid( false ) { initBuffer(); }
+				~Shareable() override { unregisterBuffer(); }
+
+				IECORE_SMALLOBJECTALLOCATOR_OPERATORS
+
+				T data;
+				MurmurHash hash;
+				volatile bool hashValid;
+				tbb::atomic<bool> memoryUsageValid;
+
+				using ObjectStatistics::Buffer::updateBuffer;
+
+			private :
+
+				void initBuffer()
+				{
+					memoryUsageValid = true;
+					registerBuffer<TypedData<T>>( Detail::bufferMemoryUsage( data ) );
+				}
+
+		};
+
+#else
+
+		void updateMemoryUsage() const
+		{
+		}
+
 		class IECORE_EXPORT Shareable : public RefCounted
 		{
 			public :
@@ -160,12 +317,16 @@ class IECORE_EXPORT SharedDataHolder
 				Shareable() : data(), hashValid( false ) {}
 				Shareable( const T &initData ) : data( initData ), hashValid( false ) {}
 
+				IECORE_SMALLOBJECTALLOCATOR_OPERATORS
+
 				T data;
 				MurmurHash hash;
 				volatile bool hashValid;
 
 		};
 
+#endif // IECORE_OBJECTSTATISTICS
+
 		IE_CORE_DECLAREPTR( Shareable )
 		ShareablePtr m_data;
 
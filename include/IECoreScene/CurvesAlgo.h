@@ -38,6 +38,8 @@
 #include "IECoreScene/CurvesPrimitive.h"
 #include "IECoreScene/PrimitiveVariable.h"
 
+#include "OpenEXR/ImathMatrix.h"
+
 #include <utility>
 #include <vector>
 
@@ -53,6 +55,12 @@ IECORESCENE_API void resamplePrimitiveVariable( const CurvesPrimitive *curvesPri
 /// When invert is set then zeros in curvesToDelete indicate which curves should be deleted
 IECORESCENE_API CurvesPrimitivePtr deleteCurves( const CurvesPrimitive *curvesPrimitive, const PrimitiveVariable &curvesToDelete, bool invert = false );
 
+/// Merges the curves into a single CurvesPrimitive, copying the topology and primitive variables
+/// of each in parallel. All the inputs must have the same basis and periodicity. Primitive variables
+/// are merged as for MeshAlgo::merge(), with missing or conflicting variables filled with default
+/// values, and any `transforms` applied per input.
+IECORESCENE_API CurvesPrimitivePtr merge( const std::vector<const CurvesPrimitive *> &curvesPrimitives, const std::vector<Imath::M44f> &transforms = std::vector<Imath::M44f>() );
+
 /// Segment a CurvesPrimitve in to N CurvesPrimitives based on the N unique values contained in the segmentValues argument.
 /// If segmentValues isn't supplied then primitive is split into the unique values contained in the primitiveVariable.
 /// The primitiveVariable must have 'Uniform' iterpolation and match the base type of the VectorTypedData in the segmentValues.
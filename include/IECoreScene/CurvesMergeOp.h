@@ -62,8 +62,6 @@ class IECORESCENE_API CurvesMergeOp : public CurvesPrimitiveOp
 
 	private :
 
-		struct AppendPrimVars;
-
 		CurvesPrimitiveParameterPtr m_curvesParameter;
 
 };
@@ -39,7 +39,10 @@
 #include "IECoreScene/PointsPrimitive.h"
 #include "IECoreScene/PrimitiveVariable.h"
 
+#include "OpenEXR/ImathMatrix.h"
+
 #include <utility>
+#include <vector>
 
 namespace IECoreScene
 {
@@ -47,6 +50,25 @@ namespace IECoreScene
 namespace MeshAlgo
 {
 
+/// Specifies how face normals are weighted when they are accumulated onto vertices.
+enum NormalWeighting
+{
+	/// Each face contributes equally.
+	EqualWeighting = 0,
+	/// Faces are weighted by their interior angle at the vertex.
+	AngleWeighting = 1,
+	/// Faces are weighted by their area.
+	AreaWeighting = 2
+};
+
+/// Calculate normals for a mesh primitive from the V3f or V3d position variable. Vertex and Varying
+/// interpolation give smooth normals, accumulated from the surrounding faces using the specified
+/// weighting. Uniform and FaceVarying interpolation give faceted normals. The calculation is parallel,
+/// and the results are independent of the number of threads. If `destination` is the data from a
+/// previous calculation, and nothing else references it, it is reused, avoiding reallocation when
+/// recalculating normals for a deforming mesh. Data which is referenced elsewhere is never modified.
+IECORESCENE_API PrimitiveVariable calculateNormals( const MeshPrimitive *mesh, PrimitiveVariable::Interpolation interpolation = PrimitiveVariable::Vertex, NormalWeighting weighting = EqualWeighting, const std::string &position = "P", IECore::Data *destination = nullptr );
+
 /// Calculate the surface tangent vectors of a mesh primitive.
 IECORESCENE_API std::pair<PrimitiveVariable, PrimitiveVariable> calculateTangents( const MeshPrimitive *mesh, const std::string &uvSet = "uv", bool orthoTangents = true, const std::string &position = "P" );
 
@@ -76,6 +98,38 @@ IECORESCENE_API void reverseWinding( MeshPrimitive *meshPrimitive );
 /// vertex spacing, provided the UVs are well layed out.
 IECORESCENE_API PointsPrimitivePtr distributePoints( const MeshPrimitive *mesh, float density = 100.0, const Imath::V2f &offset = Imath::V2f( 0 ), const std::string &densityMask = "density", const std::string &uvSet = "uv", const std::string &position = "P" );
 
+/// Triangulates the mesh using a simple fan across each face. The work is done in parallel, and
+/// indexed primitive variables remain indexed, with only their indices being remapped. If
+/// `throwExceptions` is true, an exception is thrown if any faces are concave or non-planar,
+/// as determined using `tolerance`.
+IECORESCENE_API MeshPrimitivePtr triangulate( const MeshPrimitive *mesh, bool throwExceptions = false, float tolerance = 1e-6f );
+
+/// Returns the index of the original face for each of the triangles generated by triangulate(),
+/// without triangulating the mesh or copying its primitive variables. This may be used to map
+/// results from a triangulated mesh back onto the original.
+IECORESCENE_API IECore::IntVectorDataPtr triangulatedFaces( const MeshPrimitive *mesh );
+
+/// Merges the meshes into a single mesh, copying the topology and primitive variables of
+/// each in parallel. Primitive variables missing from some meshes are filled with default
+/// values. Where primitive variables conflict, the earlier meshes take priority : the first mesh
+/// with a primitive variable decides its interpolation, type and indexing, and later ones are
+/// cast to match if necessary. Variables which can't be cast or have a different interpolation
+/// are treated as missing. If `transforms` are supplied, there must be one per mesh, and each is
+/// applied to the Point, Vector and Normal primitive variables of its mesh.
+IECORESCENE_API MeshPrimitivePtr merge( const std::vector<const MeshPrimitive *> &meshes, const std::vector<Imath::M44f> &transforms = std::vector<Imath::M44f>() );
+
+/// Calculates a reordering of the faces and vertices of the mesh which improves memory locality.
+/// Faces are sorted along a Morton (Z-order) curve through their centroids, and vertices are sorted
+/// by the first face to use them. Returns the original index of each face and each vertex in their
+/// new order, for use with reorder(). The orders may be reused for any mesh with the same topology,
+/// such as other frames of a deforming animation, and for mapping data back to the original mesh.
+IECORESCENE_API std::pair<IECore::IntVectorDataPtr, IECore::IntVectorDataPtr> calculateLocalityOrder( const MeshPrimitive *mesh, const std::string &position = "P" );
+
+/// Returns a copy of the mesh with its faces and vertices reordered, where `faceOrder` and `vertexOrder`
+/// give the original index of each face and vertex in the result. Primitive variables are remapped in
+/// parallel, and indexed primitive variables remain indexed, with only their indices being remapped.
+IECORESCENE_API MeshPrimitivePtr reorder( const MeshPrimitive *mesh, const IECore::IntVectorData *faceOrder, const IECore::IntVectorData *vertexOrder );
+
 /// Segment the input mesh in to N meshes based on the N unique values contained in the segmentValues argument.
 /// If segmentValues isn't supplied then primitive is split into the unique values contained in the primitiveVariable.
 /// The primitiveVariable must have 'Uniform' iterpolation and match the base type of the VectorTypedData in the segmentValues.
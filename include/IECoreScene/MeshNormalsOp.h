@@ -43,7 +43,8 @@
 namespace IECoreScene
 {
 
-/// A MeshPrimitiveOp to calculate vertex normals.
+/// A MeshPrimitiveOp to calculate vertex normals. This is a thin wrapper
+/// around MeshAlgo::calculateNormals().
 /// \ingroup geometryProcessingGroup
 class IECORESCENE_API MeshNormalsOp : public MeshPrimitiveOp
 {
@@ -63,15 +64,13 @@ class IECORESCENE_API MeshNormalsOp : public MeshPrimitiveOp
 		IECore::IntParameter *interpolationParameter();
 		const IECore::IntParameter *interpolationParameter() const;
 
+		IECore::IntParameter *weightingParameter();
+		const IECore::IntParameter *weightingParameter() const;
+
 	protected:
 
 		void modifyTypedPrimitive( MeshPrimitive * mesh, const IECore::CompoundObject * operands ) override;
 
-	private :
-
-		struct CalculateNormals;
-		struct HandleErrors;
-
 };
 
 IE_CORE_DECLAREPTR( MeshNormalsOp );
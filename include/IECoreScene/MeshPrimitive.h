@@ -44,6 +44,7 @@ namespace IECoreScene
 {
 
 IE_CORE_FORWARDDECLARE( MeshPrimitive )
+IE_CORE_FORWARDDECLARE( MeshTopology )
 
 class PolygonIterator;
 
@@ -83,6 +84,11 @@ class IECORESCENE_API MeshPrimitive : public Primitive
 		void setInterpolation( const std::string &interpolation );
 		PolygonIterator faceBegin();
 		PolygonIterator faceEnd();
+		/// Returns connectivity information for the mesh, computing it if necessary.
+		/// Results are cached and shared between all meshes with the same topology,
+		/// so this is cheap to call repeatedly, even for a series of deformed copies
+		/// of a mesh. Include "IECoreScene/MeshTopology.h" to use the result.
+		ConstMeshTopologyPtr topology() const;
 		//@}
 
 		size_t variableSize( PrimitiveVariable::Interpolation interpolation ) const override;
@@ -37,6 +37,7 @@
 
 #include "IECoreScene/Export.h"
 #include "IECoreScene/MeshPrimitive.h"
+#include "IECoreScene/MeshTopology.h"
 #include "IECoreScene/PrimitiveEvaluator.h"
 
 #include "IECore/BoundedKDTree.h"
@@ -48,6 +49,13 @@
 namespace IECoreScene
 {
 
+namespace Private
+{
+
+class TriangleBVH;
+
+} // namespace Private
+
 /// An implementation of PrimitiveEvaluator to allow spatial queries to be performed on MeshPrimitive instances
 /// \ingroup geometryProcessingGroup
 class IECORESCENE_API MeshPrimitiveEvaluator : public PrimitiveEvaluator
@@ -106,7 +114,23 @@ class IECORESCENE_API MeshPrimitiveEvaluator : public PrimitiveEvaluator
 
 		static PrimitiveEvaluatorPtr create( ConstPrimitivePtr primitive );
 
-		MeshPrimitiveEvaluator( ConstMeshPrimitivePtr mesh );
+		/// The acceleration structure used for closestPoint() and
+		/// intersectionPoint() queries. The BVH is a 4-wide bounding volume
+		/// hierarchy built using the surface area heuristic, which tests
+		/// several boxes and triangles at once using SIMD instructions. It
+		/// is typically faster to query than the KDTree, particularly for
+		/// rays, and is recommended when many queries are to be made. It
+		/// is built in parallel, but is somewhat more expensive to build.
+		/// Queries using either structure give the same results, except
+		/// that ties between equidistant triangles may be broken differently,
+		/// and intersectionPoints() may return the hits in a different order.
+		enum Accelerator
+		{
+			KDTreeAccelerator,
+			BVHAccelerator
+		};
+
+		MeshPrimitiveEvaluator( ConstMeshPrimitivePtr mesh, Accelerator accelerator = KDTreeAccelerator );
 
 		~MeshPrimitiveEvaluator() override;
 
@@ -132,6 +156,16 @@ class IECORESCENE_API MeshPrimitiveEvaluator : public PrimitiveEvaluator
 
 		bool signedDistance( const Imath::V3f &p, float &distance, PrimitiveEvaluator::Result *result ) const override;
 
+		Accelerator accelerator() const;
+
+		/// Batched equivalents of closestPoint() and intersectionPoint(), which
+		/// perform all the queries in parallel. On return, results holds a Result
+		/// for each query, or null for queries which found nothing. All rays share
+		/// the same maxDistance.
+		void batchClosestPoint( const std::vector<Imath::V3f> &points, std::vector<PrimitiveEvaluator::ResultPtr> &results ) const;
+		void batchIntersectionPoint( const std::vector<Imath::V3f> &origins, const std::vector<Imath::V3f> &directions,
+			std::vector<PrimitiveEvaluator::ResultPtr> &results, float maxDistance = Imath::limits<float>::max() ) const;
+
 		float volume() const override;
 
 		Imath::V3f centerOfGravity() const override;
@@ -158,6 +192,7 @@ class IECORESCENE_API MeshPrimitiveEvaluator : public PrimitiveEvaluator
 		const TriangleBoundVector *triangleBounds() const;
 		/// Returns a pointer to a tree that can be used for performing fast spacial queries.
 		///  The iterators in this tree point to elements in the vector returned by triangleBounds().
+		/// Note that this function returns 0 if the evaluator was constructed to use the BVHAccelerator.
 		const TriangleBoundTree *triangleBoundTree() const;
 
 		/// A type for storing the uv bounding box for a triangle.
@@ -183,6 +218,7 @@ class IECORESCENE_API MeshPrimitiveEvaluator : public PrimitiveEvaluator
 
 		TriangleBoundVector m_triangles;
 		TriangleBoundTree *m_tree;
+		Private::TriangleBVH *m_bvh;
 
 		UVBoundVector m_uvTriangles;
 		UVBoundTree *m_uvTree;
@@ -211,10 +247,9 @@ class IECORESCENE_API MeshPrimitiveEvaluator : public PrimitiveEvaluator
 		mutable bool m_haveAverageNormals;
 		typedef int VertexIndex;
 		typedef int TriangleIndex;
-		typedef std::pair<VertexIndex, VertexIndex> Edge;
 
-		typedef std::map< Edge, Imath::V3f > EdgeAverageNormals;
-		mutable EdgeAverageNormals m_edgeAverageNormals;
+		mutable ConstMeshTopologyPtr m_topology;
+		mutable std::vector<Imath::V3f> m_edgeAverageNormals;
 
 		mutable IECore::V3fVectorDataPtr m_vertexAngleWeightedNormals;
 
@@ -0,0 +1,155 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef IECORESCENE_MESHTOPOLOGY_H
+#define IECORESCENE_MESHTOPOLOGY_H
+
+#include "IECoreScene/Export.h"
+#include "IECoreScene/MeshPrimitive.h"
+
+#include "IECore/RefCounted.h"
+
+#include "OpenEXR/ImathVec.h"
+
+#include <vector>
+
+namespace IECoreScene
+{
+
+/// Connectivity information derived from the topology of a MeshPrimitive, for
+/// use by algorithms which need to navigate between the faces, vertices and edges
+/// of a mesh. Instances are immutable, and are typically obtained using
+/// MeshPrimitive::topology(), which caches them and shares them between all meshes
+/// with the same topology.
+///
+/// Adjacency is stored in "compressed sparse row" form : the entries for element `i`
+/// are held in the range `[offsets[i], offsets[i+1])` of the corresponding array.
+/// \ingroup geometryProcessingGroup
+class IECORESCENE_API MeshTopology : public IECore::RefCounted
+{
+
+	public :
+
+		IE_CORE_DECLAREMEMBERPTR( MeshTopology );
+
+		/// Computes the topology for the mesh, using TBB to parallelise the work.
+		/// Prefer MeshPrimitive::topology(), which avoids recomputation.
+		MeshTopology( const MeshPrimitive *mesh );
+		~MeshTopology() override;
+
+		size_t numFaces() const;
+		size_t numVertices() const;
+		size_t numFaceVertices() const;
+		size_t numEdges() const;
+
+		//! @name Faces
+		//////////////////////////////////////////////////////////////////////////
+		//@{
+		/// The offset of the first face-vertex of each face, followed by the
+		/// total number of face-vertices. The face-vertices of face `f` are in
+		/// the range `[faceOffsets()[f], faceOffsets()[f+1])`.
+		const std::vector<int> &faceOffsets() const;
+		/// The face to which each face-vertex belongs.
+		const std::vector<int> &faceVertexFaces() const;
+		//@}
+
+		//! @name Vertices
+		//////////////////////////////////////////////////////////////////////////
+		//@{
+		/// Offsets into vertexFaceVertices() and vertexFaces(), with one entry per
+		/// vertex followed by the total number of face-vertices.
+		const std::vector<int> &vertexOffsets() const;
+		/// The face-vertices referencing each vertex, in ascending order.
+		const std::vector<int> &vertexFaceVertices() const;
+		/// The faces using each vertex, in ascending order. A face which uses the
+		/// same vertex more than once is listed once for each use.
+		const std::vector<int> &vertexFaces() const;
+		//@}
+
+		//! @name Edges
+		//////////////////////////////////////////////////////////////////////////
+		//@{
+		/// The unique edges of the mesh, in ascending order. Each edge is
+		/// stored with the lowest vertex id first.
+		const std::vector<Imath::V2i> &edges() const;
+		/// The edge from each face-vertex to the next face-vertex in the same face.
+		const std::vector<int> &faceVertexEdges() const;
+		/// Offsets into edgeFaces(), with one entry per edge followed by the
+		/// total number of face-vertices.
+		const std::vector<int> &edgeOffsets() const;
+		/// The faces adjacent to each edge, in ascending order. Manifold
+		/// edges have two faces and boundary edges have one.
+		const std::vector<int> &edgeFaces() const;
+		//@}
+
+		/// Returns the number of bytes used.
+		size_t memoryUsage() const;
+
+		//! @name Caching
+		/// Controls the cache used by MeshPrimitive::topology().
+		//////////////////////////////////////////////////////////////////////////
+		//@{
+		static void setCacheMemoryLimit( size_t bytes );
+		static size_t getCacheMemoryLimit();
+		static size_t cacheMemoryUsage();
+		//@}
+
+	private :
+
+		friend class MeshPrimitive;
+
+		static ConstMeshTopologyPtr cachedTopology( const MeshPrimitive *mesh );
+
+		size_t m_numVertices;
+
+		std::vector<int> m_faceOffsets;
+		std::vector<int> m_faceVertexFaces;
+
+		std::vector<int> m_vertexOffsets;
+		std::vector<int> m_vertexFaceVertices;
+		std::vector<int> m_vertexFaces;
+
+		std::vector<Imath::V2i> m_edges;
+		std::vector<int> m_faceVertexEdges;
+		std::vector<int> m_edgeOffsets;
+		std::vector<int> m_edgeFaces;
+
+};
+
+IE_CORE_DECLAREPTR( MeshTopology );
+
+} // namespace IECoreScene
+
+#endif // IECORESCENE_MESHTOPOLOGY_H
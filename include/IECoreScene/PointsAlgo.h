@@ -39,6 +39,10 @@
 #include "IECoreScene/PointsPrimitive.h"
 #include "IECoreScene/PrimitiveVariable.h"
 
+#include "OpenEXR/ImathMatrix.h"
+
+#include <vector>
+
 namespace IECoreScene
 {
 
@@ -54,7 +58,21 @@ IECORESCENE_API PointsPrimitivePtr deletePoints( const PointsPrimitive *meshPrim
 /// merge points primitives - when conflicting primitive variables are encountered earlier elements in the input vector take priority.
 /// constant interpolated primitive variables: first occurance of the primitive variable is used and others ignored.
 /// vertex interpolated primitive variables: type conversion is attempted where later primitives variables in the list are cast to earlier ones.
-IECORESCENE_API PointsPrimitivePtr mergePoints( const std::vector<const PointsPrimitive *> &pointsPrimitives );
+/// Throws if the same primitive variable has different interpolations, or types which can't be converted.
+/// Missing primitive variables are filled with default values, and the first primitive decides whether each is indexed. If `transforms`
+/// are supplied, there must be one per primitive, and each is applied to the Point, Vector and Normal primitive variables of
+/// its primitive. The primitive variables are copied in parallel.
+IECORESCENE_API PointsPrimitivePtr mergePoints( const std::vector<const PointsPrimitive *> &pointsPrimitives, const std::vector<Imath::M44f> &transforms = std::vector<Imath::M44f>() );
+
+/// Calculates a reordering of the points which improves memory locality, by sorting them along a
+/// Morton (Z-order) curve. Returns the original index of each point in its new order, for use with
+/// reorder(). The order may be reused for other primitives with the same number of points.
+IECORESCENE_API IECore::IntVectorDataPtr calculateLocalityOrder( const PointsPrimitive *points, const std::string &position = "P" );
+
+/// Returns a copy of the points with their order changed, where `pointOrder` gives the original index
+/// of each point in the result. Primitive variables are remapped in parallel, and indexed primitive
+/// variables remain indexed, with only their indices being remapped.
+IECORESCENE_API PointsPrimitivePtr reorder( const PointsPrimitive *points, const IECore::IntVectorData *pointOrder );
 
 /// Segment a PointsPrimitve in to N PointsPrimitives based on the N unique values contained in the segmentValues argument.
 /// If segmentValues isn't supplied then primitive is split into the unique values contained in the primitiveVariable.
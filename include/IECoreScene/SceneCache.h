@@ -136,9 +136,122 @@ class IECORESCENE_API SceneCache : public SampledSceneInterface
 
 		void hash( HashType hashType, double time, IECore::MurmurHash &h ) const override;
 
+		/// Traverses the file in parallel.
+		void readHierarchy( const IECore::PathMatcher &filter, double time, Hierarchy &hierarchy, int what = HierarchyAll ) const override;
+
 		/// tells you if this scene cache is read only or writable:
 		bool readOnly() const;
 
+		/// Enables the pipelined writing mode for the whole scene being written. In this mode,
+		/// writeObject(), writeTransform() and writeAttribute() only queue a copy of their samples,
+		/// which are saved to the file by a background thread while the caller carries on, and the
+		/// per-sample analysis needed to compute the bounds runs in parallel. Any error raised while
+		/// saving the queued samples is reported when the file is flushed. Disabling the mode waits
+		/// for all the queued samples to be saved. The resulting file is the same in both modes.
+		void setPipelinedWriting( bool pipelined );
+		bool getPipelinedWriting() const;
+
+		/// Flags specifying which kinds of data are loaded by prefetch().
+		enum PrefetchData
+		{
+			PrefetchTransforms = 1,
+			PrefetchAttributes = 2,
+			PrefetchObjects = 4,
+			PrefetchAll = PrefetchTransforms | PrefetchAttributes | PrefetchObjects
+		};
+
+		/// Handle to the background tasks launched by prefetch(). Destroying
+		/// the handle cancels any outstanding work and waits for it to stop.
+		class IECORESCENE_API Prefetch : public IECore::RefCounted
+		{
+
+			public :
+
+				IE_CORE_DECLAREMEMBERPTR( Prefetch );
+
+				~Prefetch() override;
+
+				/// Blocks until all the requested data has been loaded. Throws
+				/// the first error raised while traversing the hierarchy, if any.
+				void wait();
+				/// Stops loading any more data, returning once the running tasks have finished.
+				void cancel();
+				/// Returns true when there are no tasks left to run.
+				bool done() const;
+
+			private :
+
+				friend class SceneCache;
+
+				IE_CORE_FORWARDDECLARE( Implementation );
+
+				Prefetch( ImplementationPtr implementation );
+
+				ImplementationPtr m_implementation;
+
+		};
+
+		IE_CORE_DECLAREPTR( Prefetch );
+
+		/// Loads in background threads the data needed to read the locations matched by
+		/// paths at any time in the range [startTime, endTime], so that later calls to
+		/// readTransform(), readAttribute() and readObject() on this scene can be served
+		/// from memory. The paths are relative to this location and the what argument is
+		/// a combination of PrefetchData flags. Errors raised while loading are ignored,
+		/// as they will be reported again when the data is actually read. Errors raised
+		/// while traversing the hierarchy stop the traversal of the affected location and
+		/// are rethrown by Prefetch::wait(). Only available in read mode.
+		PrefetchPtr prefetch( const IECore::PathMatcher &paths, double startTime, double endTime, int what = PrefetchAll ) const;
+
+		/// Identifies the caches holding the data loaded from a file opened for reading.
+		/// All the locations of a scene opened by the same constructor share the caches.
+		enum CacheType
+		{
+			TransformCache,
+			AttributeCache,
+			ObjectCache
+		};
+
+		/// Usage counters of one of the caches.
+		struct IECORESCENE_API CacheStatistics
+		{
+			CacheStatistics();
+
+			/// Number of requests served from the cache.
+			size_t hits;
+			/// Number of requests not served from the cache.
+			size_t misses;
+			/// Number of items discarded from the cache.
+			size_t evictions;
+			/// Memory used by the items held in the cache, in bytes.
+			size_t memoryUsage;
+			/// Total time in seconds spent loading the missing items.
+			double loadTime;
+		};
+
+		/// Returns the usage counters of the given cache. Only available in read mode.
+		CacheStatistics cacheStatistics( CacheType cache ) const;
+		/// Limits the memory used by the given cache of this file, measured with
+		/// Object::memoryUsage(). Items are discarded as necessary to meet the limit.
+		/// Only available in read mode.
+		void setCacheMemoryLimit( CacheType cache, size_t bytes );
+		size_t getCacheMemoryLimit( CacheType cache ) const;
+		/// The memory limits used for the caches of the files opened from now on. These
+		/// are per file, and in addition to the ObjectPool memory limit, so they default
+		/// to just 1MB for transforms, 2MB for attributes and 16MB for objects. They may
+		/// be raised when only a few files are open at once.
+		static void setDefaultCacheMemoryLimit( CacheType cache, size_t bytes );
+		static size_t getDefaultCacheMemoryLimit( CacheType cache );
+		/// Enables the deduplication of the Data buffers loaded into the given cache of
+		/// this file, by storing them in the default ObjectPool with the StoreDeduplicated
+		/// mode. Buffers identical to ones already in the pool, such as the topology of a
+		/// deforming mesh, are then shared rather than duplicated. Only available in read mode.
+		void setCacheBufferDeduplication( CacheType cache, bool enabled );
+		bool getCacheBufferDeduplication( CacheType cache ) const;
+		/// The buffer deduplication used for the caches of the files opened from now on.
+		static void setDefaultCacheBufferDeduplication( CacheType cache, bool enabled );
+		static bool getDefaultCacheBufferDeduplication( CacheType cache );
+
 		// The attribute names used to mark animated topology and primitive variables
 		// when SceneCache objects are Primitives.
 		static const Name &animatedObjectTopologyAttribute;
@@ -278,6 +278,45 @@ class IECORESCENE_API SceneInterface : public IECore::RunTimeTyped
 		/// as well as add the time dependency as applicable.
 		virtual void hash( HashType hashType, double time, IECore::MurmurHash &h ) const;
 
+		/*
+		 * Bulk queries
+		 */
+
+		/// Flags specifying the data gathered by readHierarchy().
+		enum HierarchyData
+		{
+			HierarchyTransforms = 1,
+			HierarchyBounds = 2,
+			HierarchyObjectTypes = 4,
+			HierarchyAll = HierarchyTransforms | HierarchyBounds | HierarchyObjectTypes
+		};
+
+		/// A flattened description of part of the scene, as filled by readHierarchy(). Each
+		/// location is stored at the same index of all the arrays, and the locations are sorted
+		/// in depth first order so that parents always come before their children.
+		struct IECORESCENE_API Hierarchy
+		{
+			/// Paths of the locations, relative to the queried location.
+			std::vector<Path> paths;
+			/// Index of the closest ancestor in the hierarchy, or -1 if there is none.
+			std::vector<int> parentIndices;
+			/// The transform of each location.
+			std::vector<Imath::M44d> localTransforms;
+			/// The transform from each location to the parent space of the queried location.
+			std::vector<Imath::M44d> worldTransforms;
+			std::vector<Imath::Box3d> bounds;
+			/// Type of the object at each location, or InvalidTypeId if there's no object.
+			std::vector<IECore::TypeId> objectTypes;
+		};
+
+		/// Fills hierarchy with this location and its descendants matched by filter at the given
+		/// time. The what argument is a combination of HierarchyData flags, and the arrays of the
+		/// data not requested are left empty. This is much cheaper than querying each location
+		/// individually. The default implementation traverses the scene serially using the public
+		/// methods of this class, and derived classes may provide faster implementations, for
+		/// instance traversing in parallel where that is safe.
+		virtual void readHierarchy( const IECore::PathMatcher &filter, double time, Hierarchy &hierarchy, int what = HierarchyAll ) const;
+
 		/*
 		 * Utility functions
 		 */
@@ -46,7 +46,8 @@
 namespace IECoreScene
 {
 
-/// A MeshPrimitiveOp to perform triangulation of MeshPrimitives.
+/// A MeshPrimitiveOp to perform triangulation of MeshPrimitives. This is a
+/// thin wrapper around MeshAlgo::triangulate().
 /// \todo Currently we just do a simple "fan" across the face, but we eventually need
 /// to deal with concave polygons, polgons with holes, and non-planar polygons
 /// \ingroup geometryProcessingGroup
@@ -67,8 +68,6 @@ class IECORESCENE_API TriangulateOp : public TypedPrimitiveOp<MeshPrimitive>
 
 	protected:
 
-		struct TriangulateFn;
-
 		void modifyTypedPrimitive( MeshPrimitive * mesh, const IECore::CompoundObject * operands ) override;
 
 		IECore::BoolParameterPtr m_throwExceptionsParameter;
@@ -38,6 +38,11 @@
 
 #include "boost/filesystem/operations.hpp"
 
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+
 using namespace IECore;
 
 namespace fs = boost::filesystem;
@@ -59,6 +64,10 @@ class FileIndexedIO::StreamFile : public StreamIndexedIO::StreamFile
 
 		size_t m_endPosition;
 
+		/// A raw descriptor used for positional reads on read-only files.
+		/// It is -1 when reads must go through the shared stream instead.
+		int m_fileDescriptor;
+
 		StreamFile( const std::string &filename, IndexedIO::OpenMode mode );
 
 		~StreamFile() override;
@@ -67,9 +76,12 @@ class FileIndexedIO::StreamFile : public StreamIndexedIO::StreamFile
 
 		void flush( size_t endPosition ) override;
 
+		using StreamIndexedIO::StreamFile::read;
+		void read( char *buffer, size_t size, size_t pos ) override;
+
 };
 
-FileIndexedIO::StreamFile::StreamFile( const std::string &filename, IndexedIO::OpenMode mode ) : StreamIndexedIO::StreamFile(mode), m_filename( filename ), m_endPosition(0)
+FileIndexedIO::StreamFile::StreamFile( const std::string &filename, IndexedIO::OpenMode mode ) : StreamIndexedIO::StreamFile(mode), m_filename( filename ), m_endPosition(0), m_fileDescriptor(-1)
 {
 	if (mode & IndexedIO::Write)
 	{
@@ -144,6 +156,10 @@ FileIndexedIO::StreamFile::StreamFile( const std::string &filename, IndexedIO::O
 			throw IOException( "FileIndexedIO: Caught error reading file '" + filename + "'" );
 		}
 
+		// The file won't change while we're reading it, so we can use pread() on a
+		// separate descriptor and avoid serialising all reads on the stream mutex.
+		// If the descriptor can't be opened we simply fall back to the stream.
+		m_fileDescriptor = ::open( filename.c_str(), O_RDONLY );
 	}
 }
 
@@ -154,6 +170,11 @@ void FileIndexedIO::StreamFile::flush( size_t endPosition )
 
 FileIndexedIO::StreamFile::~StreamFile()
 {
+	if ( m_fileDescriptor >= 0 )
+	{
+		::close( m_fileDescriptor );
+	}
+
 	if ( m_openmode == IndexedIO::Write || m_openmode == IndexedIO::Append )
 	{
 		std::fstream *f = static_cast< std::fstream * >( m_stream );
@@ -174,6 +195,34 @@ FileIndexedIO::StreamFile::~StreamFile()
 	}
 }
 
+void FileIndexedIO::StreamFile::read( char *buffer, size_t size, size_t pos )
+{
+	if ( m_fileDescriptor < 0 )
+	{
+		StreamIndexedIO::StreamFile::read( buffer, size, pos );
+		return;
+	}
+
+	while ( size )
+	{
+		ssize_t count = ::pread( m_fileDescriptor, buffer, size, pos );
+		if ( count > 0 )
+		{
+			buffer += count;
+			pos += count;
+			size -= count;
+		}
+		else if ( count < 0 && errno == EINTR )
+		{
+			continue;
+		}
+		else
+		{
+			throw IOException( "FileIndexedIO: Error reading file '" + m_filename + "'" );
+		}
+	}
+}
+
 bool FileIndexedIO::StreamFile::canRead( const std::string &path )
 {
 	std::fstream d( path.c_str(), std::ios::binary | std::ios::in);
@@ -41,7 +41,10 @@
 #include "tbb/concurrent_hash_map.h"
 #include "tbb/spin_rw_mutex.h"
 
+#include <algorithm>
+#include <stdlib.h>
 #include <string.h>
+#include <vector>
 
 namespace IECore
 {
@@ -125,6 +128,35 @@ struct Equal
 
 };
 
+// Hash which returns a value computed in advance, so that the
+// string needn't be hashed again when looking it up in a HashSet.
+struct PrecomputedHash
+{
+
+	PrecomputedHash( size_t hash ) : hash( hash )
+	{
+	}
+
+	template<typename T>
+	size_t operator()( const T & ) const
+	{
+		return hash;
+	}
+
+	size_t hash;
+
+};
+
+inline std::string makeString( const char *value )
+{
+	return std::string( value );
+}
+
+inline std::string makeString( const CharRange &range )
+{
+	return std::string( range.first, range.second );
+}
+
 typedef boost::multi_index::multi_index_container<
 	std::string,
 	boost::multi_index::indexed_by<
@@ -140,59 +172,173 @@ typedef HashSet::nth_index<0>::type Index;
 typedef HashSet::nth_index_const_iterator<0>::type ConstIterator;
 typedef tbb::spin_rw_mutex Mutex;
 
-static HashSet *hashSet()
+// The table of strings is split into shards, each with its own lock,
+// so that threads interning different strings rarely contend. The shards
+// are aligned to cache lines so their locks don't share them either.
+static const size_t g_numShards = 64;
+
+struct alignas( 64 ) Shard
+{
+	Mutex mutex;
+	HashSet hashSet;
+};
+
+static Shard *shards()
 {
-	static HashSet g_hashSet;
-	return &g_hashSet;
+	static Shard g_shards[g_numShards];
+	return g_shards;
 }
 
-static Mutex *mutex()
+inline size_t shardIndex( size_t hash )
 {
-	static Detail::Mutex g_mutex;
-	return &g_mutex;
+	// the hash set uses the low bits to choose its buckets, so we mix in some high ones.
+	return ( hash ^ ( hash >> 13 ) ) & ( g_numShards - 1 );
 }
 
-} // namespace Detail
+// Small cache of recently interned strings, private to each thread.
+// Hits avoid touching the locks of the shared table entirely, which
+// matters for the handful of names (primitive variables, attributes...)
+// that are interned over and over again by all the threads. It can be
+// disabled by setting the IECORE_INTERNEDSTRING_THREADCACHE environment
+// variable to 0.
+struct ThreadCache
+{
 
-const std::string *InternedString::internedString( const char *value )
+	struct Entry
+	{
+		size_t hash;
+		const std::string *value;
+	};
+
+	static const size_t size = 256;
+	Entry entries[size];
+
+};
+
+static thread_local ThreadCache g_threadCache;
+
+static bool threadCacheEnabled()
+{
+	const char *e = getenv( "IECORE_INTERNEDSTRING_THREADCACHE" );
+	return !e || strcmp( e, "0" ) != 0;
+}
+
+static const bool g_threadCacheEnabled = threadCacheEnabled();
+
+template<typename Key>
+const std::string *internedString( const Key &key )
 {
-	Detail::HashSet *hashSet = Detail::hashSet();
-	Detail::Index &hashIndex = hashSet->get<0>();
-	Detail::Mutex::scoped_lock lock( *Detail::mutex(), false ); // read-only lock
-	Detail::HashSet::const_iterator it = hashIndex.find( value );
-	if( it!=hashIndex.end() )
+	const size_t hash = Hash()( key );
+
+	ThreadCache::Entry *cacheEntry = nullptr;
+	if( g_threadCacheEnabled )
 	{
-		return &(*it);
+		cacheEntry = &g_threadCache.entries[hash & ( ThreadCache::size - 1 )];
+		if( cacheEntry->value && cacheEntry->hash == hash && Equal()( key, *cacheEntry->value ) )
+		{
+			return cacheEntry->value;
+		}
 	}
-	else
+
+	Shard &shard = shards()[shardIndex( hash )];
+	const std::string *result = nullptr;
 	{
-		lock.upgrade_to_writer();
-		return &(*(hashSet->insert( std::string( value ) ).first ) );
+		Mutex::scoped_lock lock( shard.mutex, false ); // read-only lock
+		Index &index = shard.hashSet.get<0>();
+		ConstIterator it = index.find( key, PrecomputedHash( hash ), Equal() );
+		if( it != index.end() )
+		{
+			result = &(*it);
+		}
+		else
+		{
+			lock.upgrade_to_writer();
+			result = &(*( shard.hashSet.insert( makeString( key ) ).first ) );
+		}
 	}
+
+	if( cacheEntry )
+	{
+		cacheEntry->hash = hash;
+		cacheEntry->value = result;
+	}
+
+	return result;
+}
+
+} // namespace Detail
+
+const std::string *InternedString::internedString( const char *value )
+{
+	return Detail::internedString( value );
 }
 
 const std::string *InternedString::internedString( const char *value, size_t length )
 {
-	Detail::HashSet *hashSet = Detail::hashSet();
-	Detail::Index &hashIndex = hashSet->get<0>();
-	Detail::Mutex::scoped_lock lock( *Detail::mutex(), false ); // read-only lock
-	Detail::HashSet::const_iterator it = hashIndex.find( Detail::CharRange( value, value + length ) );
-	if( it!=hashIndex.end() )
+	return Detail::internedString( Detail::CharRange( value, value + length ) );
+}
+
+void InternedString::internStrings( const std::string *strings, size_t numStrings, InternedString *internedStrings )
+{
+	// Sort the strings by shard, so that we lock each shard only once.
+	std::vector<size_t> hashes( numStrings );
+	std::vector<std::pair<size_t, size_t> > order( numStrings ); // ( shard, string index ) pairs
+	for( size_t i = 0; i < numStrings; ++i )
 	{
-		return &(*it);
+		hashes[i] = Detail::Hash()( strings[i].c_str() );
+		order[i] = std::make_pair( Detail::shardIndex( hashes[i] ), i );
 	}
-	else
+	std::sort( order.begin(), order.end() );
+
+	std::vector<size_t> missing;
+	for( size_t begin = 0, end = 0; begin < numStrings; begin = end )
 	{
-		lock.upgrade_to_writer();
-		return &(*(hashSet->insert( std::string( value, length ) ).first ) );
+		const size_t shardIndex = order[begin].first;
+		while( end < numStrings && order[end].first == shardIndex )
+		{
+			++end;
+		}
+
+		Detail::Shard &shard = Detail::shards()[shardIndex];
+		Detail::Mutex::scoped_lock lock( shard.mutex, false ); // read-only lock
+		Detail::Index &index = shard.hashSet.get<0>();
+
+		missing.clear();
+		for( size_t i = begin; i < end; ++i )
+		{
+			const size_t stringIndex = order[i].second;
+			Detail::ConstIterator it = index.find( strings[stringIndex].c_str(), Detail::PrecomputedHash( hashes[stringIndex] ), Detail::Equal() );
+			if( it != index.end() )
+			{
+				internedStrings[stringIndex].m_value = &(*it);
+			}
+			else
+			{
+				missing.push_back( stringIndex );
+			}
+		}
+
+		if( missing.size() )
+		{
+			lock.upgrade_to_writer();
+			for( std::vector<size_t>::const_iterator it = missing.begin(); it != missing.end(); ++it )
+			{
+				internedStrings[*it].m_value = &(*( shard.hashSet.insert( std::string( strings[*it].c_str() ) ).first ) );
+			}
+		}
 	}
 }
 
 size_t InternedString::numUniqueStrings()
 {
-	Detail::Mutex::scoped_lock lock( *Detail::mutex(), false ); // read-only lock
-	Detail::HashSet *hashSet = Detail::hashSet();
-	return hashSet->size();
+	size_t result = 0;
+	for( size_t i = 0; i < Detail::g_numShards; ++i )
+	{
+		Detail::Shard &shard = Detail::shards()[i];
+		Detail::Mutex::scoped_lock lock( shard.mutex, false ); // read-only lock
+		result += shard.hashSet.size();
+	}
+	return result;
 }
 
 static InternedString g_emptyString("");
@@ -287,11 +287,11 @@ ObjectPtr Object::LoadContext::loadObjectOrReference( const IndexedIO *container
 				pathParts.push_back( *t );
 			}
 		}
-		std::pair<LoadedObjects::iterator, bool> ret = m_loadedObjects->insert( std::pair<IndexedIO::EntryIDList, ObjectPtr>( pathParts, nullptr ) );
+		std::pair<LoadedObjects::iterator, bool> ret = m_loadedObjects->emplace( std::move( pathParts ), nullptr );
 		if ( ret.second )
 		{
 			// jump to the path..
-			ConstIndexedIOPtr ioObject = m_ioInterface->directory( pathParts );
+			ConstIndexedIOPtr ioObject = m_ioInterface->directory( ret.first->first );
 			// add the loaded object to the map.
 			ret.first->second = loadObject( ioObject.get() );
 		}
@@ -304,7 +304,7 @@ ObjectPtr Object::LoadContext::loadObjectOrReference( const IndexedIO *container
 		IndexedIO::EntryIDList pathParts;
 		ioObject->path( pathParts );
 
-		std::pair<LoadedObjects::iterator, bool> ret = m_loadedObjects->insert( std::pair<IndexedIO::EntryIDList, ObjectPtr>( pathParts, nullptr ) );
+		std::pair<LoadedObjects::iterator, bool> ret = m_loadedObjects->emplace( std::move( pathParts ), nullptr );
 		if ( ret.second )
 		{
 			// add the loaded object to the map.
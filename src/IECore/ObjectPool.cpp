@@ -34,12 +34,75 @@
 
 #include "IECore/ObjectPool.h"
 
+#include "IECore/CompoundData.h"
+#include "IECore/CompoundObject.h"
 #include "IECore/LRUCache.h"
+#include "IECore/ObjectStatistics.h"
+#include "IECore/ObjectVector.h"
 
 #include "boost/lexical_cast.hpp"
 
+#include <map>
+
 using namespace IECore;
 
+namespace
+{
+
+typedef std::map<TypeId, ObjectPool::DeduplicateFn> DeduplicateFns;
+
+DeduplicateFns &deduplicateFns()
+{
+	static DeduplicateFns *g_deduplicateFns = new DeduplicateFns();
+	return *g_deduplicateFns;
+}
+
+// Data smaller than this isn't worth the cost of a separate
+// entry in the pool.
+const size_t g_minDeduplicatedMemoryUsage = 1024;
+
+void deduplicateCompoundObject( Object *object, const ObjectPool::ChildFn &childFn )
+{
+	CompoundObject::ObjectMap &members = static_cast<CompoundObject *>( object )->members();
+	for( CompoundObject::ObjectMap::iterator it = members.begin(); it != members.end(); ++it )
+	{
+		if( it->second )
+		{
+			it->second = childFn( it->second.get() );
+		}
+	}
+}
+
+void deduplicateCompoundData( Object *object, const ObjectPool::ChildFn &childFn )
+{
+	CompoundDataMap &members = static_cast<CompoundData *>( object )->writable();
+	for( CompoundDataMap::iterator it = members.begin(); it != members.end(); ++it )
+	{
+		if( it->second )
+		{
+			it->second = boost::static_pointer_cast<Data>( childFn( it->second.get() ) );
+		}
+	}
+}
+
+void deduplicateObjectVector( Object *object, const ObjectPool::ChildFn &childFn )
+{
+	ObjectVector::MemberContainer &members = static_cast<ObjectVector *>( object )->members();
+	for( ObjectVector::MemberContainer::iterator it = members.begin(); it != members.end(); ++it )
+	{
+		if( *it )
+		{
+			*it = childFn( it->get() );
+		}
+	}
+}
+
+bool g_compoundObjectRegistration = ObjectPool::registerDeduplicateFn( CompoundObjectTypeId, deduplicateCompoundObject );
+bool g_compoundDataRegistration = ObjectPool::registerDeduplicateFn( CompoundDataTypeId, deduplicateCompoundData );
+bool g_objectVectorRegistration = ObjectPool::registerDeduplicateFn( ObjectVectorTypeId, deduplicateObjectVector );
+
+} // namespace
+
 ////////////////////////////////////////////////////////////////////////
 // MemberData
 ////////////////////////////////////////////////////////////////////////
@@ -51,7 +114,14 @@ struct ObjectPool::MemberData
 	{
 	}
 
-	LRUCache< MurmurHash, ConstObjectPtr > cache;
+	// The pool is shared by all clients, so we use the ScanResistant
+	// policy to stop one client reading through many objects once
+	// from evicting the objects everyone else is using.
+	LRUCache< MurmurHash, ConstObjectPtr, LRUCachePolicy::ScanResistant > cache;
+
+#ifdef IECORE_OBJECTSTATISTICS
+	ObjectStatistics::Owner owner{ "ObjectPool", [this] { return cache.currentCost(); } };
+#endif
 
 	/// our getter always returns NULL
 	static ConstObjectPtr getter( const MurmurHash &h, size_t &cost )
@@ -59,6 +129,52 @@ struct ObjectPool::MemberData
 		cost = 0;
 		return nullptr;
 	}
+
+	/// Returns a copy of object in which the large Data share their storage
+	/// with identical Data in the pool, storing them in the pool if necessary.
+	/// The pooled Data are appended to buffers.
+	ObjectPtr deduplicate( const Object *object, std::vector<ConstObjectPtr> &buffers )
+	{
+		const DeduplicateFns &fns = deduplicateFns();
+
+		ObjectPtr result;
+		for( TypeId typeId = object->typeId(); typeId != InvalidTypeId; typeId = RunTimeTyped::baseTypeId( typeId ) )
+		{
+			DeduplicateFns::const_iterator it = fns.find( typeId );
+			if( it == fns.end() )
+			{
+				continue;
+			}
+			if( !result )
+			{
+				// The copy shares the storage of any Data with the
+				// original, so children must be replaced rather
+				// than modified in place.
+				result = object->copy();
+			}
+			it->second( result.get(), [this, &buffers]( const Object *child ) { return deduplicate( child, buffers ); } );
+		}
+
+		if( result )
+		{
+			return result;
+		}
+
+		if( !runTimeCast<const Data>( object ) || object->memoryUsage() < g_minDeduplicatedMemoryUsage )
+		{
+			return object->copy();
+		}
+
+		const MurmurHash h = object->hash();
+		ConstObjectPtr pooled = cache.get( h );
+		if( !pooled )
+		{
+			pooled = object->copy();
+			cache.set( h, pooled, pooled->memoryUsage() );
+		}
+		buffers.push_back( pooled );
+		return pooled->copy();
+	}
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -101,6 +217,28 @@ ConstObjectPtr ObjectPool::store( const Object *obj, StoreMode mode )
 		m_data->cache.set( h, obj, obj->memoryUsage() );
 		return obj;
 	}
+	else if ( mode == StoreDeduplicated )
+	{
+		std::vector<ConstObjectPtr> buffers;
+		cachedObj = m_data->deduplicate( obj, buffers );
+		if( ConstObjectPtr buffer = m_data->cache.get( h ) )
+		{
+			// The object was a buffer itself, and
+			// deduplicate() has already stored it.
+			return buffer;
+		}
+		// The pooled buffers have their own entries, so we
+		// only count the memory which isn't shared with them.
+		Object::MemoryAccumulator accumulator;
+		for( std::vector<ConstObjectPtr>::const_iterator it = buffers.begin(); it != buffers.end(); ++it )
+		{
+			accumulator.accumulate( it->get() );
+		}
+		const size_t buffersMemoryUsage = accumulator.total();
+		accumulator.accumulate( cachedObj.get() );
+		m_data->cache.set( h, cachedObj, accumulator.total() - buffersMemoryUsage );
+		return cachedObj;
+	}
 	else
 	{
 		throw Exception( "Invalid store mode!" );
@@ -137,6 +275,12 @@ size_t ObjectPool::memoryUsage() const
 	return m_data->cache.currentCost();
 }
 
+bool ObjectPool::registerDeduplicateFn( TypeId typeId, DeduplicateFn deduplicateFn )
+{
+	deduplicateFns()[typeId] = deduplicateFn;
+	return true;
+}
+
 ObjectPool *ObjectPool::defaultObjectPool()
 {
 	static ObjectPoolPtr c = nullptr;
@@ -0,0 +1,272 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "IECore/ObjectStatistics.h"
+
+#include "IECore/RunTimeTyped.h"
+
+#include <mutex>
+#include <set>
+#include <vector>
+
+using namespace IECore;
+
+//////////////////////////////////////////////////////////////////////////
+// Internal registries
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+struct Counter
+{
+	TypeId typeId;
+	size_t size;
+	tbb::atomic<size_t> count;
+};
+
+// The registries are allocated on first use and deliberately never
+// destroyed, because counted objects may outlive static destruction.
+struct Registry
+{
+
+	std::mutex countersMutex;
+	std::vector<Counter *> counters;
+
+	std::vector<ObjectStatistics::BufferCounter *> bufferCounters;
+
+	std::mutex ownersMutex;
+	std::set<const ObjectStatistics::Owner *> owners;
+
+};
+
+Registry &registry()
+{
+	static Registry *r = new Registry;
+	return *r;
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// ObjectStatistics
+//////////////////////////////////////////////////////////////////////////
+
+ObjectStatistics::TypeStatistics::TypeStatistics()
+	:	instances( 0 ), instanceMemory( 0 ), buffers( 0 ), bufferMemory( 0 )
+{
+}
+
+bool ObjectStatistics::enabled()
+{
+#ifdef IECORE_OBJECTSTATISTICS
+	return true;
+#else
+	return false;
+#endif
+}
+
+ObjectStatistics::Snapshot ObjectStatistics::snapshot()
+{
+	Registry &r = registry();
+	Snapshot result;
+
+	// Instances. The counters include the instances of derived
+	// classes, so we subtract each counter from that of its nearest
+	// counted base class. Counters are read independently of one
+	// another, so we must guard against transiently negative results.
+
+	std::map<TypeId, std::pair<const Counter *, int64_t> > counts;
+	{
+		std::lock_guard<std::mutex> lock( r.countersMutex );
+		for( const Counter *c : r.counters )
+		{
+			counts[c->typeId] = std::make_pair( c, (int64_t)c->count );
+		}
+	}
+
+	std::map<TypeId, int64_t> exclusiveCounts;
+	for( const auto &count : counts )
+	{
+		exclusiveCounts[count.first] += count.second.second;
+		for( TypeId t = RunTimeTyped::baseTypeId( count.first ); t != InvalidTypeId; t = RunTimeTyped::baseTypeId( t ) )
+		{
+			if( counts.find( t ) != counts.end() )
+			{
+				exclusiveCounts[t] -= count.second.second;
+				break;
+			}
+		}
+	}
+
+	for( const auto &count : exclusiveCounts )
+	{
+		if( count.second <= 0 )
+		{
+			continue;
+		}
+		TypeStatistics &s = result.types[count.first];
+		s.instances = count.second;
+		s.instanceMemory = count.second * counts[count.first].first->size;
+	}
+
+	// Buffers
+
+	{
+		std::lock_guard<std::mutex> lock( r.countersMutex );
+		for( const BufferCounter *c : r.bufferCounters )
+		{
+			if( !c->buffers )
+			{
+				continue;
+			}
+			TypeStatistics &s = result.types[c->typeId];
+			s.buffers = c->buffers;
+			s.bufferMemory = c->memory;
+		}
+	}
+
+	// Owners
+
+	{
+		std::lock_guard<std::mutex> lock( r.ownersMutex );
+		for( const Owner *o : r.owners )
+		{
+			result.owners[o->name()] += o->memoryUsage();
+		}
+	}
+
+	return result;
+}
+
+tbb::atomic<size_t> *ObjectStatistics::instanceCounter( TypeId typeId, size_t size )
+{
+	Registry &r = registry();
+	std::lock_guard<std::mutex> lock( r.countersMutex );
+	// Each library using a counted class may have its own copy of
+	// the counter's static pointer, so they must all share the same
+	// counter for the type.
+	for( Counter *c : r.counters )
+	{
+		if( c->typeId == typeId )
+		{
+			return &c->count;
+		}
+	}
+
+	Counter *c = new Counter;
+	c->typeId = typeId;
+	c->size = size;
+	c->count = 0;
+	r.counters.push_back( c );
+	return &c->count;
+}
+
+ObjectStatistics::BufferCounter *ObjectStatistics::bufferCounter( TypeId typeId )
+{
+	Registry &r = registry();
+	std::lock_guard<std::mutex> lock( r.countersMutex );
+	for( BufferCounter *c : r.bufferCounters )
+	{
+		if( c->typeId == typeId )
+		{
+			return c;
+		}
+	}
+
+	BufferCounter *c = new BufferCounter;
+	c->typeId = typeId;
+	c->buffers = 0;
+	c->memory = 0;
+	r.bufferCounters.push_back( c );
+	return c;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Owner
+//////////////////////////////////////////////////////////////////////////
+
+ObjectStatistics::Owner::Owner( const std::string &name, const MemoryUsageFunction &memoryUsage )
+	:	m_name( name ), m_memoryUsage( memoryUsage )
+{
+	Registry &r = registry();
+	std::lock_guard<std::mutex> lock( r.ownersMutex );
+	r.owners.insert( this );
+}
+
+ObjectStatistics::Owner::~Owner()
+{
+	Registry &r = registry();
+	std::lock_guard<std::mutex> lock( r.ownersMutex );
+	r.owners.erase( this );
+}
+
+const std::string &ObjectStatistics::Owner::name() const
+{
+	return m_name;
+}
+
+size_t ObjectStatistics::Owner::memoryUsage() const
+{
+	return m_memoryUsage();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Buffer
+//////////////////////////////////////////////////////////////////////////
+
+ObjectStatistics::Buffer::Buffer()
+	:	m_counter( nullptr )
+{
+	m_memoryUsage = 0;
+}
+
+ObjectStatistics::Buffer::~Buffer()
+{
+}
+
+void ObjectStatistics::Buffer::updateBuffer( size_t memoryUsage )
+{
+	// Accesses may update the same buffer concurrently, so we must
+	// apply the difference from the value we actually replaced.
+	const size_t previous = m_memoryUsage.fetch_and_store( memoryUsage );
+	m_counter->memory += memoryUsage - previous;
+}
+
+void ObjectStatistics::Buffer::unregisterBuffer()
+{
+	m_counter->buffers--;
+	m_counter->memory -= m_memoryUsage.fetch_and_store( 0 );
+}
@@ -38,6 +38,12 @@
 
 #include "boost/static_assert.hpp"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/parallel_reduce.h"
+
+#include <algorithm>
+
 #include <string.h>
 
 using namespace IECore;
@@ -45,6 +51,80 @@ using namespace IECore;
 BOOST_STATIC_ASSERT( sizeof(int) == 4 );
 BOOST_STATIC_ASSERT( sizeof(unsigned int) == 4 );
 BOOST_STATIC_ASSERT( sizeof(float) == 4 );
+BOOST_STATIC_ASSERT( sizeof(double) == 8 );
+
+namespace
+{
+
+// 32 bit inputs at least this size are sorted by parallelSort() rather
+// than the serial implementation.
+const size_t g_parallelSortThreshold = 65536;
+
+// parallelSort() divides the input into blocks of this size. Each block
+// is histogrammed and then scattered by a single task, so that the
+// scatter needs no synchronisation and preserves the order of equal
+// digits.
+const size_t g_parallelSortBlockSize = 16384;
+
+// Maps values to unsigned integers of the same size which sort in
+// the same order.
+template<typename T>
+struct RadixKey;
+
+template<>
+struct RadixKey<unsigned int>
+{
+	typedef uint32_t Type;
+	static Type key( unsigned int v ) { return v; }
+};
+
+template<>
+struct RadixKey<int>
+{
+	typedef uint32_t Type;
+	static Type key( int v ) { return uint32_t( v ) ^ 0x80000000; }
+};
+
+template<>
+struct RadixKey<float>
+{
+	typedef uint32_t Type;
+	static Type key( float v )
+	{
+		uint32_t k;
+		memcpy( &k, &v, sizeof( k ) );
+		// negative values are ordered by decreasing magnitude
+		return ( k & 0x80000000 ) ? ~k : k | 0x80000000;
+	}
+};
+
+template<>
+struct RadixKey<uint64_t>
+{
+	typedef uint64_t Type;
+	static Type key( uint64_t v ) { return v; }
+};
+
+template<>
+struct RadixKey<int64_t>
+{
+	typedef uint64_t Type;
+	static Type key( int64_t v ) { return uint64_t( v ) ^ 0x8000000000000000ull; }
+};
+
+template<>
+struct RadixKey<double>
+{
+	typedef uint64_t Type;
+	static Type key( double v )
+	{
+		uint64_t k;
+		memcpy( &k, &v, sizeof( k ) );
+		return ( k & 0x8000000000000000ull ) ? ~k : k | 0x8000000000000000ull;
+	}
+};
+
+} // namespace
 
 RadixSort::RadixSort() : m_currentSize( 0 ), m_ranks( nullptr ), m_ranks2( nullptr )
 {
@@ -107,6 +187,11 @@ const std::vector<unsigned int> &RadixSort::operator()( const std::vector<float>
 		return m_ranks->readable();
 	}
 
+	if( nb >= g_parallelSortThreshold )
+	{
+		return parallelSort( input2 );
+	}
+
 	const unsigned int *input = ( const unsigned int * ) &input2[0];
 
 	bool alreadySorted = createHistograms< float >( input2 );
@@ -267,6 +352,11 @@ const std::vector<unsigned int> &RadixSort::operator()( const std::vector<unsign
 	{
 		return m_ranks->readable();
 	}
+
+	if( nb >= g_parallelSortThreshold )
+	{
+		return parallelSort( input2 );
+	}
 	const unsigned int *input = &input2[0];
 
 	bool alreadySorted = createHistograms< unsigned int >( input2 );
@@ -331,6 +421,11 @@ const std::vector<unsigned int> &RadixSort::operator()( const std::vector<int> &
 	{
 		return m_ranks->readable();
 	}
+
+	if( nb >= g_parallelSortThreshold )
+	{
+		return parallelSort( input2 );
+	}
 	const unsigned int *input = ( const unsigned int * ) &input2[0];
 
 	bool alreadySorted = createHistograms< int >( input2 );
@@ -408,6 +503,147 @@ const std::vector<unsigned int> &RadixSort::operator()( const std::vector<int> &
 	return m_ranks->readable();
 }
 
+const std::vector<unsigned int> &RadixSort::operator()( const std::vector<double> &input )
+{
+	checkResize( input.size() );
+	return parallelSort( input );
+}
+
+const std::vector<unsigned int> &RadixSort::operator()( const std::vector<uint64_t> &input )
+{
+	checkResize( input.size() );
+	return parallelSort( input );
+}
+
+const std::vector<unsigned int> &RadixSort::operator()( const std::vector<int64_t> &input )
+{
+	checkResize( input.size() );
+	return parallelSort( input );
+}
+
+template<typename T>
+const std::vector<unsigned int> &RadixSort::parallelSort( const std::vector<T> &input )
+{
+	typedef typename RadixKey<T>::Type Key;
+
+	const size_t size = input.size();
+	std::vector<unsigned int> &ranks = m_ranks->writable();
+	std::vector<unsigned int> &ranks2 = m_ranks2->writable();
+	if( !size )
+	{
+		return m_ranks->readable();
+	}
+
+	// Start from the previous result if we have one, exploiting
+	// any coherence with the previous input. The keys are sorted
+	// along with the ranks, so that each pass reads them in order.
+
+	const bool haveRanks = !( m_currentSize & 0x80000000 );
+	std::vector<Key> keys( size );
+	std::vector<Key> keys2( size );
+	const bool alreadySorted = tbb::parallel_reduce(
+		tbb::blocked_range<size_t>( 0, size ), true,
+		[&]( const tbb::blocked_range<size_t> &range, bool sorted ) {
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				if( !haveRanks )
+				{
+					ranks[i] = i;
+				}
+				keys[i] = RadixKey<T>::key( input[ranks[i]] );
+				sorted = sorted && ( i == range.begin() || keys[i-1] <= keys[i] );
+			}
+			if( sorted && range.begin() )
+			{
+				// compare with the last key of the previous range
+				sorted = RadixKey<T>::key( input[haveRanks ? ranks[range.begin()-1] : range.begin()-1] ) <= keys[range.begin()];
+			}
+			return sorted;
+		},
+		[]( bool a, bool b ) { return a && b; }
+	);
+
+	m_currentSize &= 0x7fffffff;
+	if( alreadySorted )
+	{
+		return m_ranks->readable();
+	}
+
+	// LSD sort, one pass per byte. Each block counts its digits, and
+	// the counts are then turned into the position each block starts
+	// writing each digit at, ordered first by digit and then by block.
+	// Scattering the blocks in parallel then gives a stable pass.
+
+	const size_t numBlocks = ( size + g_parallelSortBlockSize - 1 ) / g_parallelSortBlockSize;
+	std::vector<size_t> offsets( numBlocks * 256 );
+
+	for( size_t pass = 0; pass < sizeof( Key ); ++pass )
+	{
+		const size_t shift = pass * 8;
+
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, numBlocks, 1 ),
+			[&]( const tbb::blocked_range<size_t> &range ) {
+				for( size_t block = range.begin(); block != range.end(); ++block )
+				{
+					size_t *counts = &offsets[block * 256];
+					std::fill( counts, counts + 256, 0 );
+					const size_t end = std::min( size, ( block + 1 ) * g_parallelSortBlockSize );
+					for( size_t i = block * g_parallelSortBlockSize; i < end; ++i )
+					{
+						counts[( keys[i] >> shift ) & 0xff]++;
+					}
+				}
+			}
+		);
+
+		size_t offset = 0;
+		bool uniqueDigit = false;
+		for( size_t digit = 0; digit < 256; ++digit )
+		{
+			const size_t digitStart = offset;
+			for( size_t block = 0; block < numBlocks; ++block )
+			{
+				const size_t count = offsets[block * 256 + digit];
+				offsets[block * 256 + digit] = offset;
+				offset += count;
+			}
+			if( offset - digitStart == size )
+			{
+				// all keys share this digit, so the pass would not change anything
+				uniqueDigit = true;
+				break;
+			}
+		}
+
+		if( uniqueDigit )
+		{
+			continue;
+		}
+
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, numBlocks, 1 ),
+			[&]( const tbb::blocked_range<size_t> &range ) {
+				for( size_t block = range.begin(); block != range.end(); ++block )
+				{
+					size_t *blockOffsets = &offsets[block * 256];
+					const size_t end = std::min( size, ( block + 1 ) * g_parallelSortBlockSize );
+					for( size_t i = block * g_parallelSortBlockSize; i < end; ++i )
+					{
+						const size_t o = blockOffsets[( keys[i] >> shift ) & 0xff]++;
+						keys2[o] = keys[i];
+						ranks2[o] = ranks[i];
+					}
+				}
+			}
+		);
+
+		keys.swap( keys2 );
+		ranks.swap( ranks2 );
+	}
+
+	return m_ranks->readable();
+}
 
 template<typename T>
 bool RadixSort::createHistograms( const std::vector<T> &input )
@@ -0,0 +1,408 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "IECore/SmallObjectAllocator.h"
+
+#include "tbb/atomic.h"
+#include "tbb/spin_mutex.h"
+
+#include <algorithm>
+#include <new>
+#include <vector>
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace IECore;
+
+namespace
+{
+
+// Block sizes are multiples of this, which is also
+// the alignment of the blocks.
+const size_t g_granularity = 16;
+const size_t g_numSizeClasses = SmallObjectAllocator::maxBlockSize / g_granularity;
+
+// Size of the slabs blocks are carved from.
+const size_t g_slabSize = 64 * 1024;
+
+// Number of free blocks a thread may hold for each size, before
+// passing half of them back to be shared with the other threads.
+const size_t g_maxThreadBlocks = 256;
+
+struct FreeBlock
+{
+	FreeBlock *next;
+};
+
+struct FreeList
+{
+	FreeBlock *head;
+	size_t size;
+};
+
+// Free blocks shared by all threads, as a list of lists.
+struct SizeClass
+{
+
+	typedef tbb::spin_mutex Mutex;
+	Mutex mutex;
+	std::vector<FreeList> freeLists;
+	// The slabs the blocks were carved from, so
+	// that trim() can return them to the system.
+	std::vector<char *> slabs;
+
+};
+
+// Never destroyed, because blocks may be freed
+// during static destruction.
+SizeClass *sizeClasses()
+{
+	static SizeClass *g_sizeClasses = new SizeClass[g_numSizeClasses];
+	return g_sizeClasses;
+}
+
+tbb::atomic<size_t> g_slabs;
+
+bool enabled()
+{
+	static const bool g_enabled = []() {
+		const char *e = getenv( "IECORE_SMALLOBJECTALLOCATOR" );
+		return !e || strcmp( e, "0" ) != 0;
+	}();
+	return g_enabled;
+}
+
+// The free blocks private to a thread. This is trivially
+// destructible so that it remains usable for the whole life
+// of the thread, however late blocks are freed.
+struct ThreadCache
+{
+	FreeList freeLists[g_numSizeClasses];
+	// Whether g_threadExitHandler has been constructed. We
+	// keep this here rather than in the handler, because the
+	// handler mustn't be touched again once it is destroyed.
+	bool exitHandlerRegistered;
+	bool exited;
+};
+
+thread_local ThreadCache g_threadCache;
+
+void releaseBlocks( size_t sizeClass, FreeList &freeList, size_t count )
+{
+	FreeList released = { nullptr, 0 };
+	while( released.size < count && freeList.head )
+	{
+		FreeBlock *block = freeList.head;
+		freeList.head = block->next;
+		freeList.size--;
+		block->next = released.head;
+		released.head = block;
+		released.size++;
+	}
+
+	if( released.size )
+	{
+		SizeClass &c = sizeClasses()[sizeClass];
+		SizeClass::Mutex::scoped_lock lock( c.mutex );
+		c.freeLists.push_back( released );
+	}
+}
+
+// Returns the blocks held by a thread when it exits, so that
+// they can be used by other threads.
+struct ThreadExitHandler
+{
+
+	~ThreadExitHandler()
+	{
+		for( size_t i = 0; i < g_numSizeClasses; ++i )
+		{
+			releaseBlocks( i, g_threadCache.freeLists[i], g_threadCache.freeLists[i].size );
+		}
+		g_threadCache.exited = true;
+	}
+
+	bool registered;
+
+};
+
+thread_local ThreadExitHandler g_threadExitHandler;
+
+// Makes sure the exit handler is constructed for this thread.
+void registerThreadExitHandler()
+{
+	if( !g_threadCache.exitHandlerRegistered )
+	{
+		g_threadCache.exitHandlerRegistered = true;
+		g_threadExitHandler.registered = true;
+	}
+}
+
+size_t blockSize( size_t sizeClass )
+{
+	return ( sizeClass + 1 ) * g_granularity;
+}
+
+// Refills an empty thread cache, from the shared free
+// blocks if there are any, and otherwise from a new slab.
+void refill( size_t sizeClass, FreeList &freeList )
+{
+	registerThreadExitHandler();
+
+	SizeClass &c = sizeClasses()[sizeClass];
+	{
+		SizeClass::Mutex::scoped_lock lock( c.mutex );
+		if( c.freeLists.size() )
+		{
+			freeList = c.freeLists.back();
+			c.freeLists.pop_back();
+			return;
+		}
+	}
+
+	const size_t size = blockSize( sizeClass );
+	char *slab = static_cast<char *>( ::operator new( g_slabSize ) );
+	g_slabs++;
+	for( size_t offset = 0; offset + size <= g_slabSize; offset += size )
+	{
+		FreeBlock *block = reinterpret_cast<FreeBlock *>( slab + offset );
+		block->next = freeList.head;
+		freeList.head = block;
+		freeList.size++;
+	}
+
+	SizeClass::Mutex::scoped_lock lock( c.mutex );
+	c.slabs.push_back( slab );
+}
+
+// Returns the index of the slab containing block, given
+// slabs sorted by address.
+size_t slabIndex( const std::vector<char *> &slabs, const FreeBlock *block )
+{
+	const char *c = reinterpret_cast<const char *>( block );
+	return std::upper_bound( slabs.begin(), slabs.end(), c ) - slabs.begin() - 1;
+}
+
+} // namespace
+
+void *SmallObjectAllocator::allocate( size_t size )
+{
+	if( size > maxBlockSize || !enabled() )
+	{
+		return ::operator new( size );
+	}
+
+	const size_t sizeClass = size ? ( size - 1 ) / g_granularity : 0;
+	if( g_threadCache.exited )
+	{
+		// Allocations during thread exit are rare enough
+		// that we don't bother pooling them.
+		FreeList freeList = { nullptr, 0 };
+		refill( sizeClass, freeList );
+		FreeBlock *block = freeList.head;
+		freeList.head = block->next;
+		freeList.size--;
+		releaseBlocks( sizeClass, freeList, freeList.size );
+		return block;
+	}
+
+	FreeList &freeList = g_threadCache.freeLists[sizeClass];
+	if( !freeList.head )
+	{
+		refill( sizeClass, freeList );
+	}
+
+	FreeBlock *block = freeList.head;
+	freeList.head = block->next;
+	freeList.size--;
+	return block;
+}
+
+void SmallObjectAllocator::deallocate( void *block, size_t size )
+{
+	if( size > maxBlockSize || !enabled() )
+	{
+		::operator delete( block );
+		return;
+	}
+
+	const size_t sizeClass = size ? ( size - 1 ) / g_granularity : 0;
+	FreeBlock *freeBlock = static_cast<FreeBlock *>( block );
+	if( g_threadCache.exited )
+	{
+		FreeList freeList = { freeBlock, 1 };
+		freeBlock->next = nullptr;
+		releaseBlocks( sizeClass, freeList, 1 );
+		return;
+	}
+
+	FreeList &freeList = g_threadCache.freeLists[sizeClass];
+	if( !freeList.head )
+	{
+		// This thread may not have allocated anything, but
+		// it must still return its blocks when it exits.
+		registerThreadExitHandler();
+	}
+	freeBlock->next = freeList.head;
+	freeList.head = freeBlock;
+	freeList.size++;
+	if( freeList.size > g_maxThreadBlocks )
+	{
+		releaseBlocks( sizeClass, freeList, g_maxThreadBlocks / 2 );
+	}
+}
+
+void SmallObjectAllocator::deallocate( void *block )
+{
+	const char *c = static_cast<const char *>( block );
+	for( size_t i = 0; i < g_numSizeClasses; ++i )
+	{
+		SizeClass &sizeClass = sizeClasses()[i];
+		bool found = false;
+		{
+			SizeClass::Mutex::scoped_lock lock( sizeClass.mutex );
+			for( const char *slab : sizeClass.slabs )
+			{
+				if( c >= slab && c < slab + g_slabSize )
+				{
+					found = true;
+					break;
+				}
+			}
+		}
+
+		if( found )
+		{
+			deallocate( block, blockSize( i ) );
+			return;
+		}
+	}
+
+	// Not from a slab, so it must have been too big for the
+	// pools, or allocated while pooling was disabled.
+	::operator delete( block );
+}
+
+size_t SmallObjectAllocator::trim()
+{
+	size_t released = 0;
+	for( size_t i = 0; i < g_numSizeClasses; ++i )
+	{
+		// Share our own blocks, so that they count as free.
+		if( !g_threadCache.exited )
+		{
+			releaseBlocks( i, g_threadCache.freeLists[i], g_threadCache.freeLists[i].size );
+		}
+
+		SizeClass &c = sizeClasses()[i];
+		SizeClass::Mutex::scoped_lock lock( c.mutex );
+		if( c.slabs.empty() )
+		{
+			continue;
+		}
+
+		// Count the free blocks in each slab.
+
+		std::sort( c.slabs.begin(), c.slabs.end() );
+		std::vector<size_t> freeCounts( c.slabs.size(), 0 );
+		for( const FreeList &freeList : c.freeLists )
+		{
+			for( FreeBlock *block = freeList.head; block; block = block->next )
+			{
+				freeCounts[slabIndex( c.slabs, block )]++;
+			}
+		}
+
+		// Rebuild the shared free lists without the blocks of the
+		// completely free slabs, in batches of the size threads
+		// normally share them in.
+
+		const size_t blocksPerSlab = g_slabSize / blockSize( i );
+		std::vector<FreeList> freeLists;
+		FreeList batch = { nullptr, 0 };
+		for( const FreeList &freeList : c.freeLists )
+		{
+			FreeBlock *next = nullptr;
+			for( FreeBlock *block = freeList.head; block; block = next )
+			{
+				next = block->next;
+				if( freeCounts[slabIndex( c.slabs, block )] == blocksPerSlab )
+				{
+					continue;
+				}
+				block->next = batch.head;
+				batch.head = block;
+				if( ++batch.size == g_maxThreadBlocks / 2 )
+				{
+					freeLists.push_back( batch );
+					batch = { nullptr, 0 };
+				}
+			}
+		}
+		if( batch.size )
+		{
+			freeLists.push_back( batch );
+		}
+		c.freeLists.swap( freeLists );
+
+		// Free the slabs.
+
+		std::vector<char *> slabs;
+		for( size_t j = 0; j < c.slabs.size(); ++j )
+		{
+			if( freeCounts[j] == blocksPerSlab )
+			{
+				::operator delete( c.slabs[j] );
+				g_slabs--;
+				released += g_slabSize;
+			}
+			else
+			{
+				slabs.push_back( c.slabs[j] );
+			}
+		}
+		c.slabs.swap( slabs );
+	}
+
+	return released;
+}
+
+SmallObjectAllocator::Statistics SmallObjectAllocator::statistics()
+{
+	Statistics result;
+	result.slabs = g_slabs;
+	result.slabMemory = result.slabs * g_slabSize;
+	return result;
+}
@@ -50,19 +50,32 @@
 #include "boost/optional.hpp"
 #include "boost/tokenizer.hpp"
 
+#include "tbb/atomic.h"
+#include "tbb/blocked_range.h"
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/mutex.h"
+#include "tbb/parallel_for.h"
 #include "tbb/spin_rw_mutex.h"
+#include "tbb/task_arena.h"
+
+#include "zlib.h"
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include <list>
 #include <map>
+#include <memory>
 #include <set>
+#include <type_traits>
+#include <vector>
 
 #include <stdint.h>
 
 #define HARDLINK				127
 #define SUBINDEX_DIR			126
+#define COMPRESSED_FILE			125
 
 static const Imf::Int64 g_unversionedMagicNumber = 0x0B00B1E5;
 static const Imf::Int64 g_versionedMagicNumber = 0xB00B1E50;
@@ -72,27 +85,52 @@ static const Imf::Int64 g_versionedMagicNumber = 0xB00B1E50;
 /// Version 5: introduced subindex as zipped data blocks (to reduce size of the main index).
 ///            Hard links are represented as regular data nodes, that points to same data on file (no removal of data ever).
 ///            Removed the linkCount field on the data nodes.
+/// Version 6: introduced compressed data nodes. Files without compressed data remain readable by version 5 readers.
+/// Version 7: the StringCache is stored as independently compressed chunks in the Data block, and only the table
+///            of chunks is kept in the main index, so strings can be loaded on demand. Large directories are moved
+///            to subindexes when the file is closed, so the main index stays small. Only written when the on demand
+///            index is enabled, because older readers can't detect the new layout.
 /// \todo Store SubIndexSize and NodeCount as unsigned 64bit integers
-static const Imf::Int64 g_currentVersion = 5;
+static const Imf::Int64 g_currentVersion = 7;
+/// The version written when the on demand index is disabled.
+static const Imf::Int64 g_defaultVersion = 6;
 
 /// FileFormat ::= Data Index IndexOffset Version MagicNumber
 /// Data ::= DataEntry*
-/// Index ::= zip(StringCache NodeTree FreePages)
+/// Index ::= zip(StringTable NodeTree FreePages) ( version 7 onwards )
+///           zip(StringCache NodeTree FreePages) ( prior to version 7 )
 
 /// DataEntry ::= Stores data from nodes:
 ///                [Data nodes] binary data indexed by DataOffset/DataSize and
+///                [Compressed data nodes] CompressedData indexed by DataOffset/StoredSize and
 ///                [Subindex]   SubIndexSize zip(NodeCount NodeTree*) indexed by SubIndexOffset.
+///                [StringChunk] StringChunkSize zip(ChunkString*) indexed by StringChunkOffset.
 /// SubIndexSize :: = uint32 - number of bytes in the zipped subindex that follows
+/// StringChunkSize :: = uint32 - number of bytes in the zipped string chunk that follows
+/// CompressedData ::= ElementSize ChunkSize NumChunks CompressedChunkSize* CompressedChunk*
+/// ElementSize ::= uint32 ( size of the elements in the array, used by the shuffling codec )
+/// ChunkSize ::= uint32 ( number of uncompressed bytes in each chunk - the last chunk may be smaller )
+/// NumChunks ::= uint32
+/// CompressedChunkSize ::= uint32
+/// CompressedChunk ::= zip(Chunk) ( each chunk is compressed independently, optionally after shuffling its bytes )
+
+/// StringTable ::= NumStringIds NumStringChunks StringChunkOffset*
+/// NumStringIds ::= int64 ( the largest string id plus one )
+/// NumStringChunks ::= int64 ( NumStringIds divided by the number of strings per chunk (4096), rounded up )
+/// StringChunkOffset ::= int64 ( offset in the Data block of the chunk )
+/// ChunkString ::= StringLength char* ( the string ids are implicit from the position in the chunk, unused ids are stored as empty strings )
 
 /// StringCache ::= NumStrings String*
 /// NumStrings ::= int64
-/// String ::= StringLength char*
+/// String ::= StringLength char* StringId
 /// StringLength ::= int64
+/// StringId ::= int64
 
 /// NodeTree Node* ( A Directory node followed by it's child nodes )
 /// Node ::= EntryType EntryStringCacheID NodeCount ( if EntryType == Directory )
 ///          EntryType EntryStringCacheID DataType ArrayLength DataOffset DataSize ( if EntryType == File )
 ///			 EntryType EntryStringCacheID SubIndexOffset ( If EntryType == SUBINDEX_DIR )
+///          EntryType EntryStringCacheID DataType ArrayLength Codec DataOffset StoredSize DataSize ( If EntryType == COMPRESSED_FILE )
 /// EntryType ::= char ( value from IndexedIO::EntryType )
 /// EntryStringCacheID ::= int64 ( index in StringCache )
 /// DataType ::= char ( value from IndexedIO::DataType )
@@ -100,7 +138,9 @@ static const Imf::Int64 g_currentVersion = 5;
 /// NodeID ::= int64 ( unique Id of this node in the file )
 /// ParentNodeID ::= int64 ( Id for the parent node )
 /// DataOffset ::= int64 ( this is offset where the data is located )
-/// DataSize ::= int64 ( number of bytes stored in the data section )
+/// DataSize ::= int64 ( number of bytes stored in the data section, or the uncompressed size for compressed data )
+/// StoredSize ::= int64 ( number of bytes of compressed data stored in the data section )
+/// Codec ::= char ( value from the Codec enum )
 /// NodeCount ::= uint32 ( number of child nodes in the directory - stored right after this node leading to recursive definition of a tree )
 /// SubIndexOffset :: = int64 ( offset in the Data block where there's a zipped index that contains all the child nodes from this node - and possibly other nodes )
 
@@ -143,26 +183,233 @@ void readLittleEndian( F &f, T &n )
 	}
 }
 
+namespace
+{
+
+// Per-thread buffer for reads which need to unflatten their data, so that
+// concurrent reads don't have to share StreamFile::ioBuffer(). Callers must
+// not wait on TBB work while the buffer is in use, since the waiting thread
+// could run another read which reuses it - see decompressData().
+typedef tbb::enumerable_thread_specific< std::vector<char> > ScratchBuffer;
+ScratchBuffer g_scratchBuffer;
+
+char *scratchBuffer( size_t size )
+{
+	std::vector<char> &buffer = g_scratchBuffer.local();
+	if ( buffer.size() < size )
+	{
+		buffer.resize( size );
+	}
+	return buffer.data();
+}
+
+// Codecs used to compress the data of individual entries.
+enum Codec
+{
+	NoCodec = 0,
+	// Chunks compressed with zlib.
+	ZLibCodec = 1,
+	// Chunks compressed with zlib after grouping together the
+	// first byte of every element, then the second byte and so on.
+	// This greatly improves the compression of float arrays.
+	ShuffledZLibCodec = 2
+};
+
+// Number of uncompressed bytes in each independently compressed chunk.
+const size_t g_compressionChunkSize = 1024 * 1024;
+
+// Number of strings in each independently compressed chunk of the string cache.
+const size_t g_stringChunkLength = 4096;
+
+// Directories with at least this number of nodes in the main index are moved
+// to subindexes when closing the file.
+const size_t g_subIndexNodeCount = 1024;
+
+void shuffle( const char *data, size_t size, size_t elementSize, char *result )
+{
+	const size_t numElements = size / elementSize;
+	for ( size_t b = 0; b < elementSize; ++b )
+	{
+		char *r = result + b * numElements;
+		for ( size_t i = 0; i < numElements; ++i )
+		{
+			r[i] = data[i * elementSize + b];
+		}
+	}
+	// any trailing partial element is stored as is
+	const size_t shuffledSize = numElements * elementSize;
+	memcpy( result + shuffledSize, data + shuffledSize, size - shuffledSize );
+}
+
+void unshuffle( const char *data, size_t size, size_t elementSize, char *result )
+{
+	const size_t numElements = size / elementSize;
+	for ( size_t b = 0; b < elementSize; ++b )
+	{
+		const char *d = data + b * numElements;
+		for ( size_t i = 0; i < numElements; ++i )
+		{
+			result[i * elementSize + b] = d[i];
+		}
+	}
+	const size_t shuffledSize = numElements * elementSize;
+	memcpy( result + shuffledSize, data + shuffledSize, size - shuffledSize );
+}
+
+template<typename T>
+void appendLittleEndian( std::vector<char> &v, T n )
+{
+	const T nl = asLittleEndian<>( n );
+	v.insert( v.end(), (const char *)&nl, (const char *)&nl + sizeof( T ) );
+}
+
+template<typename T>
+T consumeLittleEndian( const char *&p )
+{
+	T n;
+	memcpy( &n, p, sizeof( T ) );
+	p += sizeof( T );
+	return asLittleEndian<>( n );
+}
+
+void compressData( const char *data, size_t size, size_t elementSize, Codec codec, std::vector<char> &result )
+{
+	const size_t chunkSize = std::max<size_t>( g_compressionChunkSize / elementSize, 1 ) * elementSize;
+	const size_t numChunks = ( size + chunkSize - 1 ) / chunkSize;
+
+	std::vector< std::vector<char> > chunks( numChunks );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numChunks ),
+		[&]( const tbb::blocked_range<size_t> &r )
+		{
+			std::vector<char> shuffled;
+			for ( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				const char *chunk = data + i * chunkSize;
+				const size_t thisChunkSize = std::min( chunkSize, size - i * chunkSize );
+				if ( codec == ShuffledZLibCodec )
+				{
+					shuffled.resize( thisChunkSize );
+					shuffle( chunk, thisChunkSize, elementSize, shuffled.data() );
+					chunk = shuffled.data();
+				}
+
+				uLongf compressedSize = compressBound( thisChunkSize );
+				chunks[i].resize( compressedSize );
+				if ( compress2( (Bytef *)chunks[i].data(), &compressedSize, (const Bytef *)chunk, thisChunkSize, Z_DEFAULT_COMPRESSION ) != Z_OK )
+				{
+					throw IOException( "StreamIndexedIO: Error compressing data" );
+				}
+				chunks[i].resize( compressedSize );
+			}
+		}
+	);
+
+	result.clear();
+	appendLittleEndian<uint32_t>( result, elementSize );
+	appendLittleEndian<uint32_t>( result, chunkSize );
+	appendLittleEndian<uint32_t>( result, numChunks );
+	for ( const auto &chunk : chunks )
+	{
+		appendLittleEndian<uint32_t>( result, chunk.size() );
+	}
+	for ( const auto &chunk : chunks )
+	{
+		result.insert( result.end(), chunk.begin(), chunk.end() );
+	}
+}
+
+void decompressData( const char *data, size_t size, Codec codec, char *result, size_t resultSize )
+{
+	const char *p = data;
+	const size_t elementSize = consumeLittleEndian<uint32_t>( p );
+	const size_t chunkSize = consumeLittleEndian<uint32_t>( p );
+	const size_t numChunks = consumeLittleEndian<uint32_t>( p );
+
+	if ( !elementSize || !chunkSize || numChunks != ( resultSize + chunkSize - 1 ) / chunkSize || p + numChunks * sizeof( uint32_t ) > data + size )
+	{
+		throw IOException( "StreamIndexedIO: Invalid compressed data" );
+	}
+
+	// find where each chunk starts, so we can decompress them in parallel
+	std::vector<const char *> chunks( numChunks + 1 );
+	chunks[0] = p + numChunks * sizeof( uint32_t );
+	for ( size_t i = 0; i < numChunks; ++i )
+	{
+		chunks[i+1] = chunks[i] + consumeLittleEndian<uint32_t>( p );
+	}
+	if ( chunks[numChunks] > data + size )
+	{
+		throw IOException( "StreamIndexedIO: Invalid compressed data" );
+	}
+
+	// The result is often the scratchBuffer() of the calling thread. Isolating
+	// the wait prevents the thread from picking up unrelated tasks meanwhile,
+	// which could perform another read and reuse the buffer underneath us.
+	tbb::this_task_arena::isolate(
+		[&]
+		{
+			tbb::parallel_for(
+				tbb::blocked_range<size_t>( 0, numChunks ),
+				[&]( const tbb::blocked_range<size_t> &r )
+				{
+					std::vector<char> shuffled;
+					for ( size_t i = r.begin(); i != r.end(); ++i )
+					{
+						const size_t thisChunkSize = std::min( chunkSize, resultSize - i * chunkSize );
+						char *chunkResult = result + i * chunkSize;
+						if ( codec == ShuffledZLibCodec )
+						{
+							shuffled.resize( thisChunkSize );
+							chunkResult = shuffled.data();
+						}
+
+						uLongf uncompressedSize = thisChunkSize;
+						if (
+							uncompress( (Bytef *)chunkResult, &uncompressedSize, (const Bytef *)chunks[i], chunks[i+1] - chunks[i] ) != Z_OK ||
+							uncompressedSize != thisChunkSize
+						)
+						{
+							throw IOException( "StreamIndexedIO: Error decompressing data" );
+						}
+
+						if ( codec == ShuffledZLibCodec )
+						{
+							unshuffle( shuffled.data(), thisChunkSize, elementSize, result + i * chunkSize );
+						}
+					}
+				}
+			);
+		}
+	);
+}
+
+} // namespace
+
 class StreamIndexedIO::StringCache
 {
 	public:
 
-		StringCache() : m_prevId(0), m_ioBuffer(nullptr), m_ioBufferLen(0)
+		StringCache() : m_prevId(0), m_stream(nullptr)
 		{
 			m_idToStringMap.reserve(100);
 		}
 
+		/// Reads the whole string cache, as stored in the main index by files prior to version 7.
 		template < typename F >
-		StringCache( F &f ) : m_prevId(0), m_ioBuffer(nullptr), m_ioBufferLen(0)
+		void read( F &f )
 		{
+			clear();
+
 			Imf::Int64 sz;
 			readLittleEndian(f,sz);
 
 			m_idToStringMap.reserve(sz + 100);
 
+			std::vector<char> buffer;
 			for (Imf::Int64 i = 0; i < sz; ++i)
 			{
-				const char *s = read(f);
+				const char *s = read(f, buffer);
 
 				Imf::Int64 id;
 				readLittleEndian( f,id );
@@ -178,6 +425,8 @@ class StreamIndexedIO::StringCache
 			}
 		}
 
+		/// Writes the whole string cache, as stored in the main index by files prior to version 7.
+		/// All the strings must have been loaded.
 		template < typename F >
 		void write( F &f ) const
 		{
@@ -193,6 +442,102 @@ class StreamIndexedIO::StringCache
 			}
 		}
 
+		/// Reads the table of string chunks stored in the main index by version 7 files.
+		/// The chunks are loaded on demand by findById(), unless loadAll is true, in which
+		/// case they are all loaded in parallel right away. Loading all the chunks is required
+		/// to add more strings to the cache.
+		template < typename F >
+		void readTable( F &f, StreamFile *stream, bool loadAll )
+		{
+			clear();
+
+			Imf::Int64 numStrings, numChunks;
+			readLittleEndian( f, numStrings );
+			readLittleEndian( f, numChunks );
+
+			if ( numChunks != ( numStrings + g_stringChunkLength - 1 ) / g_stringChunkLength )
+			{
+				throw IOException( "StringCache: corrupted string table!" );
+			}
+
+			m_chunkOffsets.resize( numChunks );
+			for ( Imf::Int64 i = 0; i < numChunks; ++i )
+			{
+				readLittleEndian( f, m_chunkOffsets[i] );
+			}
+
+			m_stream = stream;
+			m_prevId = numStrings ? numStrings - 1 : 0;
+			m_idToStringMap.resize( numStrings );
+			m_loadedChunks.reset( new tbb::atomic<bool>[numChunks] );
+			for ( Imf::Int64 i = 0; i < numChunks; ++i )
+			{
+				m_loadedChunks[i] = false;
+			}
+
+			if ( !loadAll )
+			{
+				return;
+			}
+
+			tbb::parallel_for(
+				tbb::blocked_range<size_t>( 0, numChunks ),
+				[this]( const tbb::blocked_range<size_t> &range )
+				{
+					for ( size_t i = range.begin(); i != range.end(); ++i )
+					{
+						loadChunk( i );
+					}
+				}
+			);
+
+			for ( Imf::Int64 id = 0; id < numStrings; ++id )
+			{
+				// skipping the unused ids, stored as empty strings
+				if ( m_idToStringMap[id].string().size() )
+				{
+					m_stringToIdMap[ m_idToStringMap[id] ] = id;
+				}
+			}
+
+			// everything is loaded now, so findById() doesn't need to check
+			m_loadedChunks.reset();
+			m_chunkOffsets.clear();
+		}
+
+		/// Returns the number of chunks required to store all the strings.
+		size_t numChunks() const
+		{
+			return ( m_idToStringMap.size() + g_stringChunkLength - 1 ) / g_stringChunkLength;
+		}
+
+		/// Writes all the strings in the given chunk, in the order of their ids.
+		/// Can be called concurrently for different chunks.
+		template < typename F >
+		void writeChunk( F &f, size_t chunk ) const
+		{
+			size_t begin = chunk * g_stringChunkLength;
+			size_t end = std::min( begin + g_stringChunkLength, m_idToStringMap.size() );
+			for ( size_t id = begin; id < end; ++id )
+			{
+				write( f, m_idToStringMap[id].string() );
+			}
+		}
+
+		/// Writes the table of string chunks, given the offsets where they were stored.
+		template < typename F >
+		void writeTable( F &f, const std::vector<Imf::Int64> &chunkOffsets ) const
+		{
+			assert( chunkOffsets.size() == numChunks() );
+
+			writeLittleEndian<F,Imf::Int64>( f, m_idToStringMap.size() );
+			writeLittleEndian<F,Imf::Int64>( f, chunkOffsets.size() );
+			for ( std::vector<Imf::Int64>::const_iterator it = chunkOffsets.begin(); it != chunkOffsets.end(); ++it )
+			{
+				writeLittleEndian( f, *it );
+			}
+		}
+
 		Imf::Int64 find( const IndexedIO::EntryID &s ) const
 		{
 			StringToIdMap::const_iterator it = m_stringToIdMap.find( s );
@@ -237,6 +582,21 @@ class StreamIndexedIO::StringCache
 			{
 				throw IOException( (boost::format ( "StringCache: invalid string ID %d!" ) % id ).str() );
 			}
+
+			if ( m_loadedChunks )
+			{
+				size_t chunk = id / g_stringChunkLength;
+				if ( !m_loadedChunks[chunk] )
+				{
+					ChunkMutex::scoped_lock lock( m_chunkMutex );
+					if ( !m_loadedChunks[chunk] )
+					{
+						loadChunk( chunk );
+						m_loadedChunks[chunk] = true;
+					}
+				}
+			}
+
 			return m_idToStringMap[id];
 		}
 
@@ -252,6 +612,46 @@ class StreamIndexedIO::StringCache
 
 	protected:
 
+		void clear()
+		{
+			m_prevId = 0;
+			m_stringToIdMap.clear();
+			m_idToStringMap.clear();
+			m_chunkOffsets.clear();
+			m_loadedChunks.reset();
+		}
+
+		// Decompresses the strings of a chunk into m_idToStringMap. Each chunk
+		// fills in a different range, so chunks can be loaded concurrently.
+		void loadChunk( size_t chunk ) const
+		{
+			uint32_t chunkSize = 0;
+			m_stream->read( (char*)&chunkSize, sizeof(chunkSize), m_chunkOffsets[chunk] );
+			chunkSize = asLittleEndian<>( chunkSize );
+
+			// not using scratchBuffer(), since we may be called while a subindex is being decompressed from it.
+			std::vector<char> data( chunkSize );
+			m_stream->read( &data[0], chunkSize, m_chunkOffsets[chunk] + sizeof(chunkSize) );
+
+			io::filtering_istream decompressingStream;
+			MemoryStreamSource source( &data[0], chunkSize, false );
+			decompressingStream.push( io::gzip_decompressor() );
+			decompressingStream.push( source );
+			assert( decompressingStream.is_complete() );
+
+			std::vector<char> buffer;
+			size_t begin = chunk * g_stringChunkLength;
+			size_t end = std::min( begin + g_stringChunkLength, m_idToStringMap.size() );
+			std::vector<std::string> strings( end - begin );
+			for ( size_t id = begin; id < end; ++id )
+			{
+				strings[id - begin] = read( decompressingStream, buffer );
+			}
+
+			// interning the whole chunk at once is much cheaper than one string at a time.
+			InternedString::internStrings( strings.data(), strings.size(), &m_idToStringMap[begin] );
+		}
+
 		template < typename F >
 		void write( F &f, const std::string &s ) const
 		{
@@ -263,23 +663,15 @@ class StreamIndexedIO::StringCache
 		}
 
 		template < typename F >
-		const char *read( F &f ) const
+		static const char *read( F &f, std::vector<char> &buffer )
 		{
 			Imf::Int64 sz;
 			readLittleEndian( f, sz );
 
-			if ( m_ioBufferLen < sz + 1 )
-			{
-				if ( m_ioBuffer )
-				{
-					delete [] m_ioBuffer;
-				}
-				m_ioBufferLen = sz+1;
-				m_ioBuffer = new char[m_ioBufferLen];
-			}
-			f.read( m_ioBuffer, sz*sizeof(char));
-			m_ioBuffer[sz] = '\0';
-			return m_ioBuffer;
+			buffer.resize( sz + 1 );
+			f.read( &buffer[0], sz*sizeof(char));
+			buffer[sz] = '\0';
+			return &buffer[0];
 		}
 
 		Imf::Int64 m_prevId;
@@ -288,10 +680,15 @@ class StreamIndexedIO::StringCache
 		typedef std::vector< IndexedIO::EntryID > IdToStringMap;
 
 		StringToIdMap m_stringToIdMap;
-		IdToStringMap m_idToStringMap;
+		// mutable because the chunks of version 7 files are loaded on demand by findById()
+		mutable IdToStringMap m_idToStringMap;
+
+		typedef tbb::mutex ChunkMutex;
 
-		mutable char *m_ioBuffer;
-		mutable unsigned long m_ioBufferLen;
+		StreamFile *m_stream;
+		std::vector< Imf::Int64 > m_chunkOffsets;
+		std::unique_ptr< tbb::atomic<bool>[] > m_loadedChunks;
+		mutable ChunkMutex m_chunkMutex;
 };
 
 /// NodeBase is a base class for nodes representing the index
@@ -308,7 +705,8 @@ class NodeBase
 			SmallData,
 			Data,
 			Directory,
-			SubIndex
+			SubIndex,
+			CompressedData
 		} NodeType;
 
 		NodeBase( NodeType type, IndexedIO::EntryID name ) : m_name(name), m_nodeType(type) {}
@@ -443,6 +841,57 @@ class DataNode : public NodeBase
 
 };
 
+/// Class that represents Data nodes whose data was compressed when written
+class CompressedDataNode : public NodeBase
+{
+	public :
+
+		CompressedDataNode( IndexedIO::EntryID name, IndexedIO::DataType dataType, char codec, Imf::Int64 arrayLength, Imf::Int64 size, Imf::Int64 storedSize, Imf::Int64 offset ) :
+			NodeBase(NodeBase::CompressedData, name), m_dataType(dataType), m_codec(codec), m_arrayLength(arrayLength), m_size(size), m_storedSize(storedSize), m_offset(offset) {}
+
+		inline IndexedIO::DataType dataType()
+		{
+			return static_cast<IndexedIO::DataType>(m_dataType);
+		}
+
+		inline char codec()
+		{
+			return m_codec;
+		}
+
+		inline Imf::Int64 arrayLength()
+		{
+			return m_arrayLength;
+		}
+
+		/// The size of the data once decompressed
+		inline Imf::Int64 size()
+		{
+			return m_size;
+		}
+
+		/// The size of the compressed data within the file
+		inline Imf::Int64 storedSize()
+		{
+			return m_storedSize;
+		}
+
+		inline Imf::Int64 offset()
+		{
+			return m_offset;
+		}
+
+	protected :
+
+		const char m_dataType;
+		const char m_codec;
+		const Imf::Int64 m_arrayLength;
+		const Imf::Int64 m_size;
+		const Imf::Int64 m_storedSize;
+		const Imf::Int64 m_offset;
+
+};
+
 /// A compressed subindex node
 class SubIndexNode : public NodeBase
 {
@@ -581,11 +1030,12 @@ class StreamIndexedIO::Node
 
 		// Returns the named child directory node or NULL if not existent. Loads the subindex for the child nodes (if applicable).
 		DirectoryNode* directoryChild( const IndexedIO::EntryID &name ) const;
-		/// returns information about the Data node
-		inline bool dataChildInfo( const IndexedIO::EntryID &name, size_t &offset, size_t &size ) const;
+		/// returns information about the Data node. The size is the size of the data once decompressed, and storedSize
+		/// is the number of bytes it occupies in the file.
+		inline bool dataChildInfo( const IndexedIO::EntryID &name, size_t &offset, size_t &size, char &codec, size_t &storedSize ) const;
 
 		DirectoryNode* addChild( const IndexedIO::EntryID & childName );
-		void addDataChild( const IndexedIO::EntryID & childName, IndexedIO::DataType dataType, size_t arrayLen, size_t offset, size_t size );
+		void addDataChild( const IndexedIO::EntryID & childName, IndexedIO::DataType dataType, size_t arrayLen, size_t offset, size_t size, char codec = NoCodec, size_t storedSize = 0 );
 
 		void removeChild( const IndexedIO::EntryID &childName, bool throwException = true );
 
@@ -628,12 +1078,33 @@ class StreamIndexedIO::Index : public RefCounted
 		/// \param prefixSize If true than it will prepend to the block, the size of it
 		Imf::Int64 writeUniqueData( const char *data, size_t size, bool prefixSize = false );
 
+		/// As above, but compresses array data if it is larger than the compression threshold.
+		/// Returns the codec used and the number of bytes written to the file.
+		Imf::Int64 writeArrayData( const char *data, size_t size, size_t elementSize, char &codec, size_t &storedSize );
+
+		/// Reads the data written by writeArrayData(), decompressing it as necessary.
+		void readData( char *buffer, size_t size, size_t offset, char codec, size_t storedSize ) const;
+
+		void setCompressionThreshold( size_t threshold );
+		size_t getCompressionThreshold() const;
+
+		void setOnDemandIndex( bool onDemandIndex );
+		bool getOnDemandIndex() const;
+
 		/// flushes the children of the given directory node to a subindex in the file
 		void commitNodeToSubIndex( DirectoryNode *n );
 
-		/// read the subindex that contains the children of the given node
+		/// read the subindex that contains the children of the given node.
+		/// The file is accessed with positional reads, so this doesn't block
+		/// other threads reading data. If the node is already part of the tree
+		/// then the caller must hold a lock on subIndexMutex().
 		void readNodeFromSubIndex( DirectoryNode *n );
 
+		typedef tbb::mutex SubIndexMutex;
+		/// Guards the loading of directory nodes that were committed to a
+		/// subindex while they were still reachable from the tree.
+		SubIndexMutex &subIndexMutex() const;
+
 		typedef tbb::spin_rw_mutex Mutex;
 		typedef Mutex::scoped_lock MutexLock;
 		/// Returns an appropriate mutex scoped lock to access the given Directory node.
@@ -647,6 +1118,8 @@ class StreamIndexedIO::Index : public RefCounted
 		/// defines a pool of mutexes for thread-safe access to the Node hierarchy
 		mutable Mutex m_mutexes[ MAX_MUTEXES ];
 
+		mutable SubIndexMutex m_subIndexMutex;
+
 		DirectoryNode *m_root;
 
 		/// we keep all the removed nodes alive until the Index destruction
@@ -659,6 +1132,11 @@ class StreamIndexedIO::Index : public RefCounted
 		Imf::Int64 m_offset;
 		Imf::Int64 m_next;
 
+		size_t m_compressionThreshold;
+
+		/// Whether or not the index is written in the version 7 layout.
+		bool m_onDemandIndex;
+
 		// only used on Version <= 4
 		typedef std::vector< NodeBase* > IndexToNodeMap;
 		IndexToNodeMap m_indexToNodeMap;
@@ -696,6 +1174,13 @@ class StreamIndexedIO::Index : public RefCounted
 		/// Write the index to the file stream
 		Imf::Int64 write();
 
+		/// Write the compressed chunks of the string cache to the data block, returning their offsets
+		void writeStringChunks( std::vector<Imf::Int64> &offsets );
+
+		/// Commits to subindexes the descendant directories of n that would leave too many nodes in
+		/// the main index. Returns the number of descendant nodes left in the main index.
+		size_t commitLargeDirectories( DirectoryNode *n );
+
 		/// Write the node (and all child nodes) to a stream
 		template < typename F >
 		void writeNode( DirectoryNode *n, F &f );
@@ -708,6 +1193,10 @@ class StreamIndexedIO::Index : public RefCounted
 		template < typename F, typename D >
 		void writeDataNode( D *n, F &f );
 
+		/// Write the compressed data node to a stream
+		template < typename F >
+		void writeDataNode( CompressedDataNode *n, F &f );
+
 		/// Serialize all the node's children to a stream
 		template < typename F >
 		void writeNodeChildren( DirectoryNode *n, F &f );
@@ -768,6 +1257,12 @@ void NodeBase::destroy( NodeBase *n )
 				delete dn;
 				break;
 			}
+		case NodeBase::CompressedData :
+			{
+				CompressedDataNode *dn = static_cast< CompressedDataNode *>(n);
+				delete dn;
+				break;
+			}
 		default:
 			throw Exception("Unknown node type!");
 	}
@@ -880,6 +1375,7 @@ DirectoryNode* StreamIndexedIO::Node::directoryChild( const IndexedIO::EntryID &
 				}
 
 				// this can occur when the user flushed a directory and right after tries to access it.
+				Index::SubIndexMutex::scoped_lock subIndexLock( m_idx->subIndexMutex() );
 				m_idx->readNodeFromSubIndex( dir );
 			}
 			return dir;
@@ -918,7 +1414,7 @@ DirectoryNode* StreamIndexedIO::Node::directoryChild( const IndexedIO::EntryID &
 	return nullptr;
 }
 
-bool StreamIndexedIO::Node::dataChildInfo( const IndexedIO::EntryID &name, size_t &offset, size_t &size ) const
+bool StreamIndexedIO::Node::dataChildInfo( const IndexedIO::EntryID &name, size_t &offset, size_t &size, char &codec, size_t &storedSize ) const
 {
 	Index::MutexLock lock;
 	m_idx->lockDirectory( lock, m_node );
@@ -932,14 +1428,25 @@ bool StreamIndexedIO::Node::dataChildInfo( const IndexedIO::EntryID &name, size_
 		{
 			DataNode *n = static_cast< DataNode *>( p );
 			offset = n->offset();
-			size = n->size();
+			size = storedSize = n->size();
+			codec = NoCodec;
 			return true;
 		}
 		else if ( p->nodeType() == NodeBase::SmallData )
 		{
 			SmallDataNode *n = static_cast< SmallDataNode *>( p );
 			offset = n->offset();
+			size = storedSize = n->size();
+			codec = NoCodec;
+			return true;
+		}
+		else if ( p->nodeType() == NodeBase::CompressedData )
+		{
+			CompressedDataNode *n = static_cast< CompressedDataNode *>( p );
+			offset = n->offset();
 			size = n->size();
+			codec = n->codec();
+			storedSize = n->storedSize();
 			return true;
 		}
 	}
@@ -972,7 +1479,7 @@ DirectoryNode* StreamIndexedIO::Node::addChild( const IndexedIO::EntryID &childN
 	return child;
 }
 
-void StreamIndexedIO::Node::addDataChild( const IndexedIO::EntryID &childName, IndexedIO::DataType dataType, size_t arrayLen, size_t offset, size_t size )
+void StreamIndexedIO::Node::addDataChild( const IndexedIO::EntryID &childName, IndexedIO::DataType dataType, size_t arrayLen, size_t offset, size_t size, char codec, size_t storedSize )
 {
 	if ( m_node->subindex() )
 	{
@@ -986,7 +1493,12 @@ void StreamIndexedIO::Node::addDataChild( const IndexedIO::EntryID &childName, I
 
 	m_idx->m_stringCache.add( childName );
 
-	if ( arrayLen <= SmallDataNode::maxArrayLength && size <= SmallDataNode::maxSize )
+	if ( codec != NoCodec )
+	{
+		CompressedDataNode* child = new CompressedDataNode(childName, dataType, codec, arrayLen, size, storedSize, offset);
+		m_node->registerChild( child );
+	}
+	else if ( arrayLen <= SmallDataNode::maxArrayLength && size <= SmallDataNode::maxSize )
 	{
 		SmallDataNode* child = new SmallDataNode(childName, dataType, arrayLen, size, offset);
 		if ( !child )
@@ -1078,13 +1590,30 @@ void StreamIndexedIO::Node::removeChild( const IndexedIO::EntryID &childName, bo
 //
 ///////////////////////////////////////////////
 
-StreamIndexedIO::Index::Index( StreamIndexedIO::StreamFilePtr stream ) : m_root(nullptr), m_version(g_currentVersion), m_hasChanged(false), m_offset(0), m_next(0), m_stream(stream)
+StreamIndexedIO::Index::Index( StreamIndexedIO::StreamFilePtr stream ) : m_root(nullptr), m_version(g_currentVersion), m_hasChanged(false), m_offset(0), m_next(0), m_compressionThreshold(0), m_onDemandIndex(false), m_stream(stream)
 {
 	m_stringCache.add(IndexedIO::rootName);
 }
 
 StreamIndexedIO::Index::~Index()
 {
+	if ( m_hasChanged && m_onDemandIndex )
+	{
+		// There can't be any StreamIndexedIO pointing to our nodes anymore, so we can
+		// move the big directories to subindexes, making the file quicker to open.
+		if ( commitLargeDirectories( m_root ) >= g_subIndexNodeCount )
+		{
+			// the root can't be moved to a subindex, so we move all of its directories instead.
+			for ( DirectoryNode::ChildMap::const_iterator it = m_root->children().begin(); it != m_root->children().end(); ++it )
+			{
+				if ( (*it)->nodeType() == NodeBase::Directory && static_cast< DirectoryNode * >( *it )->children().size() )
+				{
+					commitNodeToSubIndex( static_cast< DirectoryNode * >( *it ) );
+				}
+			}
+		}
+	}
+
 	flush();
 
 	assert( m_freePagesOffset.size() == m_freePagesSize.size() );
@@ -1152,6 +1681,9 @@ void StreamIndexedIO::Index::openStream()
 
 		f.seekg( m_offset, std::ios::beg );
 
+		// appending to a version 7 file keeps its layout
+		m_onDemandIndex = m_version >= 7;
+
 		if (m_version >= 2 )
 		{
 			io::filtering_istream decompressingStream;
@@ -1385,6 +1917,24 @@ NodeBase *StreamIndexedIO::Index::readNode( F &f )
 		SubIndexNode *n = new SubIndexNode( m_stringCache.findById( stringId ), offset );
 		return n;
 	}
+	else if ( entryType == COMPRESSED_FILE )
+	{
+		char t, codec;
+		f.read( &t, sizeof(char) );
+		Imf::Int64 arrayLength, offset, storedSize, size;
+		readLittleEndian( f, arrayLength );
+		f.read( &codec, sizeof(char) );
+		readLittleEndian( f, offset );
+		readLittleEndian( f, storedSize );
+		readLittleEndian( f, size );
+
+		if ( codec != ZLibCodec && codec != ShuffledZLibCodec )
+		{
+			throw IOException( "Unsupported compression codec!" );
+		}
+
+		return new CompressedDataNode( m_stringCache.findById( stringId ), (IndexedIO::DataType)t, codec, arrayLength, size, storedSize, offset );
+	}
 	else
 	{
 		throw IOException( "Invalid EntryType!" );
@@ -1394,9 +1944,14 @@ NodeBase *StreamIndexedIO::Index::readNode( F &f )
 template < typename F >
 void StreamIndexedIO::Index::read( F &f )
 {
-	if (m_version >= 1)
+	if ( m_version >= 7 )
+	{
+		// the string chunks can only be loaded on demand when we are not going to add more strings.
+		m_stringCache.readTable( f, m_stream.get(), m_stream->openMode() & IndexedIO::Append );
+	}
+	else if (m_version >= 1)
 	{
-		m_stringCache = StringCache( f );
+		m_stringCache.read( f );
 	}
 
 	if ( m_version >= 5 )
@@ -1512,6 +2067,27 @@ void StreamIndexedIO::Index::writeDataNode( D *node, F &f )
 	writeLittleEndian<F,Imf::Int64>(f, node->size());
 }
 
+template < typename F >
+void StreamIndexedIO::Index::writeDataNode( CompressedDataNode *node, F &f )
+{
+	char t = COMPRESSED_FILE;
+	f.write( &t, sizeof(char) );
+
+	Imf::Int64 id = m_stringCache.find( node->name() );
+	writeLittleEndian( f, id );
+
+	t = node->dataType();
+	f.write( &t, sizeof(char) );
+	writeLittleEndian<F,Imf::Int64>( f, node->arrayLength() );
+
+	t = node->codec();
+	f.write( &t, sizeof(char) );
+
+	writeLittleEndian<F,Imf::Int64>( f, node->offset() );
+	writeLittleEndian<F,Imf::Int64>( f, node->storedSize() );
+	writeLittleEndian<F,Imf::Int64>( f, node->size() );
+}
+
 template < typename F >
 void StreamIndexedIO::Index::writeNode( SubIndexNode *node, F &f )
 {
@@ -1547,6 +2123,12 @@ void StreamIndexedIO::Index::writeNodeChildren( DirectoryNode *n, F &f )
 				writeDataNode( childNode, f );
 				break;
 			}
+			case NodeBase::CompressedData :
+			{
+				CompressedDataNode *childNode = static_cast< CompressedDataNode * >(p);
+				writeDataNode( childNode, f );
+				break;
+			}
 			case NodeBase::Directory :
 			{
 				DirectoryNode *childNode = static_cast< DirectoryNode *>(p);
@@ -1588,6 +2170,13 @@ Imf::Int64 StreamIndexedIO::Index::write()
 {
 	StreamIndexedIO::StreamFile &f = *m_stream;
 
+	// Write the strings first, so that the index goes at the end
+	std::vector<Imf::Int64> stringChunkOffsets;
+	if ( m_onDemandIndex )
+	{
+		writeStringChunks( stringChunkOffsets );
+	}
+
 	/// Write index at end
 	std::streampos indexStart = m_next;
 
@@ -1601,7 +2190,14 @@ Imf::Int64 StreamIndexedIO::Index::write()
 	compressingStream.push( sink );
 	assert( compressingStream.is_complete() );
 
-	m_stringCache.write( compressingStream );
+	if ( m_onDemandIndex )
+	{
+		m_stringCache.writeTable( compressingStream, stringChunkOffsets );
+	}
+	else
+	{
+		m_stringCache.write( compressingStream );
+	}
 
 	writeNode( m_root, compressingStream );
 
@@ -1631,7 +2227,7 @@ Imf::Int64 StreamIndexedIO::Index::write()
 	f.write( data, sz );
 
 	writeLittleEndian( f, m_offset );
-	writeLittleEndian( f, g_currentVersion );
+	writeLittleEndian( f, m_onDemandIndex ? g_currentVersion : g_defaultVersion );
 	writeLittleEndian( f, g_versionedMagicNumber );
 
 	m_hasChanged = false;
@@ -1882,6 +2478,59 @@ Imf::Int64 StreamIndexedIO::Index::writeUniqueData( const char *data, size_t siz
 	return loc;
 }
 
+Imf::Int64 StreamIndexedIO::Index::writeArrayData( const char *data, size_t size, size_t elementSize, char &codec, size_t &storedSize )
+{
+	if ( m_compressionThreshold && size >= m_compressionThreshold )
+	{
+		codec = elementSize > 1 ? ShuffledZLibCodec : ZLibCodec;
+		std::vector<char> compressed;
+		compressData( data, size, elementSize, (Codec)codec, compressed );
+		// there's no point storing the compressed version if it is bigger
+		if ( compressed.size() < size )
+		{
+			storedSize = compressed.size();
+			return writeUniqueData( compressed.data(), storedSize );
+		}
+	}
+
+	codec = NoCodec;
+	storedSize = size;
+	return writeUniqueData( data, size );
+}
+
+void StreamIndexedIO::Index::readData( char *buffer, size_t size, size_t offset, char codec, size_t storedSize ) const
+{
+	if ( codec == NoCodec )
+	{
+		m_stream->read( buffer, size, offset );
+		return;
+	}
+
+	std::vector<char> compressed( storedSize );
+	m_stream->read( compressed.data(), storedSize, offset );
+	decompressData( compressed.data(), storedSize, (Codec)codec, buffer, size );
+}
+
+void StreamIndexedIO::Index::setCompressionThreshold( size_t threshold )
+{
+	m_compressionThreshold = threshold;
+}
+
+size_t StreamIndexedIO::Index::getCompressionThreshold() const
+{
+	return m_compressionThreshold;
+}
+
+void StreamIndexedIO::Index::setOnDemandIndex( bool onDemandIndex )
+{
+	m_onDemandIndex = onDemandIndex;
+}
+
+bool StreamIndexedIO::Index::getOnDemandIndex() const
+{
+	return m_onDemandIndex;
+}
+
 void StreamIndexedIO::Index::deallocateWalk( NodeBase* n )
 {
 	assert(n);
@@ -1938,26 +2587,91 @@ void StreamIndexedIO::Index::commitNodeToSubIndex( DirectoryNode *n )
 	}
 }
 
-void StreamIndexedIO::Index::readNodeFromSubIndex( DirectoryNode *n )
+size_t StreamIndexedIO::Index::commitLargeDirectories( DirectoryNode *n )
 {
-	/// guarantees thread safe access to the file and also to the m_subindex variable
-	StreamFile::MutexLock lock( m_stream->mutex() );
+	size_t numNodes = 0;
+	for ( DirectoryNode::ChildMap::const_iterator it = n->children().begin(); it != n->children().end(); ++it )
+	{
+		numNodes++;
+		if ( (*it)->nodeType() != NodeBase::Directory )
+		{
+			continue;
+		}
+
+		DirectoryNode *child = static_cast< DirectoryNode * >( *it );
+		if ( child->subindex() != DirectoryNode::NoSubIndex )
+		{
+			continue;
+		}
+
+		size_t numChildNodes = commitLargeDirectories( child );
+		if ( numChildNodes >= g_subIndexNodeCount )
+		{
+			commitNodeToSubIndex( child );
+		}
+		else
+		{
+			numNodes += numChildNodes;
+		}
+	}
+	return numNodes;
+}
 
+void StreamIndexedIO::Index::writeStringChunks( std::vector<Imf::Int64> &offsets )
+{
+	// compressing the chunks is independent, so we do it in parallel.
+	std::vector< std::vector<char> > chunks( m_stringCache.numChunks() );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, chunks.size() ),
+		[this, &chunks]( const tbb::blocked_range<size_t> &range )
+		{
+			for ( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				MemoryStreamSink sink;
+				io::filtering_ostream compressingStream;
+				compressingStream.push( io::gzip_compressor() );
+				compressingStream.push( sink );
+				assert( compressingStream.is_complete() );
+
+				m_stringCache.writeChunk( compressingStream, i );
+
+				compressingStream.pop();
+				compressingStream.pop();
+
+				char *data=nullptr;
+				std::streamsize sz;
+				sink.get( data, sz );
+				chunks[i].assign( data, data + sz );
+			}
+		}
+	);
+
+	// unchanged chunks are deduplicated, so flushing again doesn't grow the file
+	offsets.resize( chunks.size() );
+	for ( size_t i = 0; i < chunks.size(); ++i )
+	{
+		offsets[i] = writeUniqueData( chunks[i].data(), chunks[i].size(), true );
+	}
+}
+
+void StreamIndexedIO::Index::readNodeFromSubIndex( DirectoryNode *n )
+{
 	if ( n->subindex() == DirectoryNode::LoadedSubIndex )
 	{
 		return;
 	}
 
-	m_stream->seekg( n->offset(), std::ios::beg );
-
 	uint32_t subindexSize = 0;
-	readLittleEndian( *m_stream, subindexSize );
+	m_stream->read( (char*)&subindexSize, sizeof(subindexSize), n->offset() );
+	subindexSize = asLittleEndian<>( subindexSize );
 
-	char *data = m_stream->ioBuffer(subindexSize);
-	m_stream->read( data, subindexSize );
+	// Not using scratchBuffer(), since reading the nodes may load string
+	// chunks, and we don't want to depend on that never waiting on TBB.
+	std::vector<char> data( subindexSize );
+	m_stream->read( data.data(), subindexSize, n->offset() + sizeof(subindexSize) );
 
 	io::filtering_istream decompressingStream;
-	MemoryStreamSource source( data, subindexSize, false );
+	MemoryStreamSource source( data.data(), subindexSize, false );
 	decompressingStream.push( io::gzip_decompressor() );
 	decompressingStream.push( source );
 	assert( decompressingStream.is_complete() );
@@ -1979,6 +2693,11 @@ void StreamIndexedIO::Index::readNodeFromSubIndex( DirectoryNode *n )
 	n->recoveredSubIndex();
 }
 
+StreamIndexedIO::Index::SubIndexMutex &StreamIndexedIO::Index::subIndexMutex() const
+{
+	return m_subIndexMutex;
+}
+
 void StreamIndexedIO::Index::lockDirectory( MutexLock &lock, const DirectoryNode *n, bool writeAccess ) const
 {
 	if ( n->subindexChildren() )
@@ -2116,6 +2835,13 @@ void StreamIndexedIO::StreamFile::write( const char *buffer, size_t size )
 	m_stream->write( buffer, size );
 }
 
+void StreamIndexedIO::StreamFile::read( char *buffer, size_t size, size_t pos )
+{
+	MutexLock lock( m_mutex );
+	m_stream->seekg( pos, std::ios::beg );
+	m_stream->read( buffer, size );
+}
+
 ///////////////////////////////////////////////
 //
 // StreamIndexedIO::StreamFile (end)
@@ -2374,6 +3100,12 @@ IndexedIO::Entry StreamIndexedIO::entry(const IndexedIO::EntryID &name) const
 				return IndexedIO::Entry( dn->name(), IndexedIO::File, dn->dataType(), dn->arrayLength() );
 			}
 
+		case NodeBase::CompressedData:
+			{
+				CompressedDataNode *dn = static_cast< CompressedDataNode * >(node);
+				return IndexedIO::Entry( dn->name(), IndexedIO::File, dn->dataType(), dn->arrayLength() );
+			}
+
 		case NodeBase::Directory:
 		case NodeBase::SubIndex:
 			return IndexedIO::Entry( node->name(), IndexedIO::Directory, IndexedIO::Invalid, 0 );
@@ -2452,6 +3184,26 @@ void StreamIndexedIO::commit()
 	m_node->m_idx->commitNodeToSubIndex( m_node->m_node );
 }
 
+void StreamIndexedIO::setCompressionThreshold( size_t threshold )
+{
+	m_node->m_idx->setCompressionThreshold( threshold );
+}
+
+size_t StreamIndexedIO::getCompressionThreshold() const
+{
+	return m_node->m_idx->getCompressionThreshold();
+}
+
+void StreamIndexedIO::setOnDemandIndex( bool onDemandIndex )
+{
+	m_node->m_idx->setOnDemandIndex( onDemandIndex );
+}
+
+bool StreamIndexedIO::getOnDemandIndex() const
+{
+	return m_node->m_idx->getOnDemandIndex();
+}
+
 void StreamIndexedIO::write(const IndexedIO::EntryID &name, const InternedString *x, unsigned long arrayLength)
 {
 	writable(name);
@@ -2476,9 +3228,11 @@ void StreamIndexedIO::write(const IndexedIO::EntryID &name, const InternedString
 
 	IndexedIO::DataFlattenTraits<Imf::Int64*>::flatten(constIds, arrayLength, data);
 
-	size_t offset = index->writeUniqueData( data, size );
+	char codec;
+	size_t storedSize;
+	size_t offset = index->writeArrayData( data, size, sizeof(Imf::Int64), codec, storedSize );
 
-	m_node->addDataChild( name, dataType, arrayLength, offset, size );
+	m_node->addDataChild( name, dataType, arrayLength, offset, size, codec, storedSize );
 
 	delete [] ids;
 }
@@ -2488,28 +3242,24 @@ void StreamIndexedIO::read(const IndexedIO::EntryID &name, InternedString *&x, u
 	assert( m_node );
 	readable(name);
 
-	Imf::Int64 dataOffset(0), dataSize(0);
+	Imf::Int64 dataOffset(0), dataSize(0), storedSize(0);
+	char codec = NoCodec;
 
-	if ( !m_node->dataChildInfo( name, dataOffset, dataSize ) )
+	if ( !m_node->dataChildInfo( name, dataOffset, dataSize, codec, storedSize ) )
 	{
 		throw IOException( "StreamIndexedIO::read : Data entry not found '" + name.value() + "'" );
 	}
 
 	Imf::Int64 *ids = new Imf::Int64[arrayLength];
 
-	StreamIndexedIO::StreamFile &f = streamFile();
-	{
-		StreamFile::MutexLock lock( f.mutex() );
-		f.seekg( dataOffset, std::ios::beg );
+	const Index *index = m_node->m_idx.get();
 
 #ifdef IE_CORE_LITTLE_ENDIAN
-		// raw read
-		f.read( (char*)ids, dataSize );
-	}
+	// raw read
+	index->readData( (char*)ids, dataSize, dataOffset, codec, storedSize );
 #else
-		char *data = f.ioBuffer(dataSize);
-		f.read( data, dataSize );
-	}
+	char *data = scratchBuffer( dataSize );
+	index->readData( data, dataSize, dataOffset, codec, storedSize );
 	IndexedIO::DataFlattenTraits<Imf::Int64*>::unflatten( data, ids, arrayLength );
 #endif
 
@@ -2539,9 +3289,14 @@ void StreamIndexedIO::write(const IndexedIO::EntryID &name, const T *x, unsigned
 	assert(data);
 	IndexedIO::DataFlattenTraits<T*>::flatten(x, arrayLength, data);
 
-	Imf::Int64 offset = m_node->m_idx->writeUniqueData( data, size );
+	// strings are flattened into variable length records, so there is nothing to gain from shuffling them
+	const size_t elementSize = std::is_same<T, std::string>::value ? 1 : sizeof( T );
+
+	char codec;
+	size_t storedSize;
+	Imf::Int64 offset = m_node->m_idx->writeArrayData( data, size, elementSize, codec, storedSize );
 
-	m_node->addDataChild( name, dataType, arrayLength, offset, size );
+	m_node->addDataChild( name, dataType, arrayLength, offset, size, codec, storedSize );
 }
 
 template<typename T>
@@ -2553,9 +3308,11 @@ void StreamIndexedIO::rawWrite(const IndexedIO::EntryID &name, const T *x, unsig
 	unsigned long size = IndexedIO::DataSizeTraits<T*>::size(x, arrayLength);
 	IndexedIO::DataType dataType = IndexedIO::DataTypeTraits<T*>::type();
 
-	Imf::Int64 offset =  m_node->m_idx->writeUniqueData( (char*)x, size );
+	char codec;
+	size_t storedSize;
+	Imf::Int64 offset = m_node->m_idx->writeArrayData( (char*)x, size, sizeof( T ), codec, storedSize );
 
-	m_node->addDataChild( name, dataType, arrayLength, offset, size );
+	m_node->addDataChild( name, dataType, arrayLength, offset, size, codec, storedSize );
 }
 
 template<typename T>
@@ -2596,21 +3353,17 @@ void StreamIndexedIO::read(const IndexedIO::EntryID &name, T *&x, unsigned long
 	assert( m_node );
 	readable(name);
 
-	Imf::Int64 dataOffset(0), dataSize(0);
+	Imf::Int64 dataOffset(0), dataSize(0), storedSize(0);
+	char codec = NoCodec;
 
-	if ( !m_node->dataChildInfo( name, dataOffset, dataSize ) )
+	if ( !m_node->dataChildInfo( name, dataOffset, dataSize, codec, storedSize ) )
 	{
 		throw IOException( "StreamIndexedIO::read: Data entry not found '" + name.value() + "'" );
 	}
 
-	StreamIndexedIO::StreamFile &f = streamFile();
-	{
-		StreamFile::MutexLock lock( f.mutex() );
-		char *data = f.ioBuffer(dataSize);
-		f.seekg( dataOffset, std::ios::beg );
-		f.read( data, dataSize );
-		IndexedIO::DataFlattenTraits<T*>::unflatten( data, x, arrayLength );
-	}
+	char *data = scratchBuffer( dataSize );
+	m_node->m_idx->readData( data, dataSize, dataOffset, codec, storedSize );
+	IndexedIO::DataFlattenTraits<T*>::unflatten( data, x, arrayLength );
 }
 
 template<typename T>
@@ -2619,9 +3372,10 @@ void StreamIndexedIO::rawRead(const IndexedIO::EntryID &name, T *&x, unsigned lo
 	assert( m_node );
 	readable(name);
 
-	Imf::Int64 dataOffset(0), dataSize(0);
+	Imf::Int64 dataOffset(0), dataSize(0), storedSize(0);
+	char codec = NoCodec;
 
-	if ( !m_node->dataChildInfo( name, dataOffset, dataSize ) )
+	if ( !m_node->dataChildInfo( name, dataOffset, dataSize, codec, storedSize ) )
 	{
 		throw IOException( "StreamIndexedIO::rawRead: Data entry not found '" + name.value() + "'" );
 	}
@@ -2631,12 +3385,7 @@ void StreamIndexedIO::rawRead(const IndexedIO::EntryID &name, T *&x, unsigned lo
 		x = new T[arrayLength];
 	}
 
-	StreamIndexedIO::StreamFile &f = streamFile();
-	{
-		StreamFile::MutexLock lock( f.mutex() );
-		f.seekg( dataOffset, std::ios::beg );
-		f.read( (char*)x, dataSize );
-	}
+	m_node->m_idx->readData( (char*)x, dataSize, dataOffset, codec, storedSize );
 }
 
 template<typename T>
@@ -2645,21 +3394,17 @@ void StreamIndexedIO::read(const IndexedIO::EntryID &name, T &x) const
 	assert( m_node );
 	readable(name);
 
-	Imf::Int64 dataOffset(0), dataSize(0);
+	Imf::Int64 dataOffset(0), dataSize(0), storedSize(0);
+	char codec = NoCodec;
 
-	if ( !m_node->dataChildInfo( name, dataOffset, dataSize ) )
+	if ( !m_node->dataChildInfo( name, dataOffset, dataSize, codec, storedSize ) )
 	{
 		throw IOException( "StreamIndexedIO::read Data entry not found '" + name.value() + "'" );
 	}
 
-	StreamIndexedIO::StreamFile &f = streamFile();
-	{
-		StreamFile::MutexLock lock( f.mutex() );
-		char *data = f.ioBuffer(dataSize);
-		f.seekg( dataOffset, std::ios::beg );
-		f.read( data, dataSize );
-		IndexedIO::DataFlattenTraits<T>::unflatten( data, x );
-	}
+	char *data = scratchBuffer( dataSize );
+	m_node->m_idx->readData( data, dataSize, dataOffset, codec, storedSize );
+	IndexedIO::DataFlattenTraits<T>::unflatten( data, x );
 }
 
 template<typename T>
@@ -2668,19 +3413,15 @@ void StreamIndexedIO::rawRead(const IndexedIO::EntryID &name, T &x) const
 	assert( m_node );
 	readable(name);
 
-	Imf::Int64 dataOffset(0), dataSize(0);
+	Imf::Int64 dataOffset(0), dataSize(0), storedSize(0);
+	char codec = NoCodec;
 
-	if ( !m_node->dataChildInfo( name, dataOffset, dataSize ) )
+	if ( !m_node->dataChildInfo( name, dataOffset, dataSize, codec, storedSize ) )
 	{
 		throw IOException( "StreamIndexedIO::rawRead: Data entry not found '" + name.value() + "'" );
 	}
 
-	StreamIndexedIO::StreamFile &f = streamFile();
-	{
-		StreamFile::MutexLock lock( f.mutex() );
-		f.seekg( dataOffset, std::ios::beg );
-		f.read( (char*)&x, dataSize );
-	}
+	m_node->m_idx->readData( (char*)&x, dataSize, dataOffset, codec, storedSize );
 }
 
 #ifdef IE_CORE_LITTLE_ENDIAN
@@ -233,9 +233,7 @@ MurmurHash SharedDataHolder<std::vector<bool> >::hash() const
 			p[i/8] |= 1 << (i % 8);
 		}
 	}
-	MurmurHash result;
-	result.append( &(p[0]), p.size() );
-	return result;
+	return Detail::hashElements( p.data(), p.size() );
 }
 
 template<>
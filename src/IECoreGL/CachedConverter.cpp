@@ -38,6 +38,7 @@
 
 #include "IECore/LRUCache.h"
 #include "IECore/MurmurHash.h"
+#include "IECore/ObjectStatistics.h"
 
 #include "boost/bind.hpp"
 #include "boost/bind/placeholders.hpp"
@@ -117,6 +118,10 @@ struct CachedConverter::MemberData
 	Cache cache;
 	std::vector<IECore::RunTimeTypedPtr> deferredRemovals;
 
+#ifdef IECORE_OBJECTSTATISTICS
+	IECore::ObjectStatistics::Owner owner{ "IECoreGL.CachedConverter", [this] { return cache.currentCost(); } };
+#endif
+
 };
 
 CachedConverter::CachedConverter( size_t maxMemory )
@@ -47,6 +47,9 @@
 #include "IECore/SimpleTypedData.h"
 #include "IECore/VectorTypedData.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include <cassert>
 #include <iostream>
 
@@ -407,9 +410,61 @@ void bindIndexedIOBase()
 
 }
 
+namespace
+{
+
+std::vector<std::string> readStrings( ConstIndexedIOPtr io )
+{
+	const size_t length = io->entry( "strings" ).arrayLength();
+	std::vector<std::string> result( length );
+	std::string *strings = result.data();
+	io->read( "strings", strings, length );
+	return result;
+}
+
+// Reads the "strings" entry of every directory of `io` from many tasks at once.
+// The reads decompress their data in parallel themselves, so this exercises
+// reads made by threads which are waiting on other reads.
+void testStreamIndexedIOConcurrentNestedReads( ConstIndexedIOPtr io, size_t numIterations )
+{
+	IndexedIO::EntryIDList directories;
+	io->entryIds( directories, IndexedIO::Directory );
+
+	std::vector<std::vector<std::string>> expected;
+	for( const auto &d : directories )
+	{
+		expected.push_back( readStrings( io->subdirectory( d ) ) );
+	}
+
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numIterations, 1 ),
+		[&]( const tbb::blocked_range<size_t> &r )
+		{
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				const size_t d = i % directories.size();
+				if( readStrings( io->subdirectory( directories[d] ) ) != expected[d] )
+				{
+					throw Exception( "Unexpected result" );
+				}
+			}
+		}
+	);
+}
+
+} // namespace
+
 void bindStreamIndexedIO()
 {
-	IECorePython::RunTimeTypedClass<StreamIndexedIO>();
+	/// \todo If we create an IECoreTest module, move this into it.
+	def( "testStreamIndexedIOConcurrentNestedReads", &testStreamIndexedIOConcurrentNestedReads );
+
+	IECorePython::RunTimeTypedClass<StreamIndexedIO>()
+		.def( "setCompressionThreshold", &StreamIndexedIO::setCompressionThreshold )
+		.def( "getCompressionThreshold", &StreamIndexedIO::getCompressionThreshold )
+		.def( "setOnDemandIndex", &StreamIndexedIO::setOnDemandIndex )
+		.def( "getOnDemandIndex", &StreamIndexedIO::getOnDemandIndex )
+	;
 }
 
 void bindFileIndexedIO()
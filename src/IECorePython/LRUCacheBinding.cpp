@@ -149,6 +149,7 @@ class PythonLRUCache : public LRUCache<object, object>
 };
 
 typedef LRUCache<int, int> TestCache;
+typedef LRUCache<int, int, LRUCachePolicy::ScanResistant> ScanResistantTestCache;
 
 int get( int key, size_t &cost )
 {
@@ -156,11 +157,12 @@ int get( int key, size_t &cost )
 	return key;
 }
 
+template<typename Cache>
 struct GetFromTestCache
 {
 	public :
 
-		GetFromTestCache( TestCache &cache, size_t numValues, size_t clearFrequency )
+		GetFromTestCache( Cache &cache, size_t numValues, size_t clearFrequency )
 			:	m_cache( cache ), m_numValues( numValues ), m_clearFrequency( clearFrequency )
 		{
 		}
@@ -189,20 +191,21 @@ struct GetFromTestCache
 
 	private :
 
-		TestCache &m_cache;
+		Cache &m_cache;
 		size_t m_numValues;
 		size_t m_clearFrequency;
 
 };
 
+template<typename Cache>
 void testLRUCacheThreading( int numIterations, int numValues, int maxCost, int clearFrequency = 0 )
 {
 	// do lots of parallel cache accesses. then clear the cache in the main
 	// thread and check that it has emptied successfully, to ensure that the
 	// cost counting has been accurate.
 
-	TestCache cache( get, maxCost );
-	parallel_for( blocked_range<size_t>( 0, numIterations ), GetFromTestCache( cache, numValues, clearFrequency ) );
+	Cache cache( get, maxCost );
+	parallel_for( blocked_range<size_t>( 0, numIterations ), GetFromTestCache<Cache>( cache, numValues, clearFrequency ) );
 
 	if( cache.currentCost() > cache.getMaxCost() )
 	{
@@ -217,8 +220,8 @@ void testLRUCacheThreading( int numIterations, int numValues, int maxCost, int c
 
 	// as above, but using setMaxCost( 0 ) to clear the cache.
 
-	TestCache cache2( get, maxCost );
-	parallel_for( blocked_range<size_t>( 0, numIterations ), GetFromTestCache( cache2, numValues, clearFrequency ) );
+	Cache cache2( get, maxCost );
+	parallel_for( blocked_range<size_t>( 0, numIterations ), GetFromTestCache<Cache>( cache2, numValues, clearFrequency ) );
 
 	if( cache2.currentCost() > cache2.getMaxCost() )
 	{
@@ -234,6 +237,7 @@ void testLRUCacheThreading( int numIterations, int numValues, int maxCost, int c
 
 typedef LRUCache<int, int, LRUCachePolicy::Serial> SerialTestCache;
 typedef LRUCache<int, int, LRUCachePolicy::Parallel> ParallelTestCache;
+typedef LRUCache<int, int, LRUCachePolicy::TaskParallel> TaskParallelTestCache;
 
 template<typename Cache>
 Cache &recursiveCache();
@@ -262,11 +266,12 @@ Cache &recursiveCache()
 	return c;
 }
 
+template<typename Cache>
 struct GetFromParallelRecursiveCache
 {
 	public :
 
-		GetFromParallelRecursiveCache( ParallelTestCache &cache, size_t numValues )
+		GetFromParallelRecursiveCache( Cache &cache, size_t numValues )
 			:	m_cache( cache ), m_numValues( numValues )
 		{
 		}
@@ -281,7 +286,7 @@ struct GetFromParallelRecursiveCache
 
 	private :
 
-		ParallelTestCache &m_cache;
+		Cache &m_cache;
 		size_t m_numValues;
 
 };
@@ -297,12 +302,166 @@ void testSerialLRUCacheRecursion( int maxCost )
 	}
 }
 
+template<typename Cache>
 void testParallelLRUCacheRecursion( int numIterations, size_t numValues, int maxCost )
 {
-	ParallelTestCache &cache = recursiveCache<ParallelTestCache>();
+	Cache &cache = recursiveCache<Cache>();
 	cache.clear();
 	cache.setMaxCost( maxCost );
-	parallel_for( blocked_range<size_t>( 0, numIterations ), GetFromParallelRecursiveCache( cache, numValues ) );
+	parallel_for( blocked_range<size_t>( 0, numIterations ), GetFromParallelRecursiveCache<Cache>( cache, numValues ) );
+}
+
+// Getter which uses TBB itself, so that threads waiting for
+// the value can collaborate on its computation.
+int getParallelSum( int key, size_t &cost )
+{
+	cost = 1;
+	return parallel_reduce(
+		blocked_range<int>( 0, 10000 ), 0,
+		[key]( const blocked_range<int> &r, int sum ) {
+			for( int i = r.begin(); i != r.end(); ++i )
+			{
+				sum += ( i + key ) % 3;
+			}
+			return sum;
+		},
+		std::plus<int>()
+	);
+}
+
+void testTaskParallelLRUCacheCollaboration( int numIterations, int numValues, int maxCost )
+{
+	TaskParallelTestCache cache( getParallelSum, maxCost );
+	parallel_for(
+		blocked_range<size_t>( 0, numIterations ),
+		[&cache, numValues]( const blocked_range<size_t> &r ) {
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				const int key = i % numValues;
+				size_t cost;
+				if( cache.get( key ) != getParallelSum( key, cost ) )
+				{
+					throw Exception( "Incorrect LRUCache value" );
+				}
+			}
+		}
+	);
+
+	if( cache.currentCost() > cache.getMaxCost() )
+	{
+		throw Exception( "LRUCache exceeds maximum cost" );
+	}
+}
+
+TaskParallelTestCache &selfRecursiveCache();
+
+int getSelfRecursive( int key, size_t &cost )
+{
+	cost = 1;
+	// Request the same key from inside the TBB tasks spawned by the
+	// getter, as well as from the getter itself.
+	parallel_for(
+		blocked_range<int>( 0, 100 ),
+		[key]( const blocked_range<int> & ) {
+			selfRecursiveCache().get( key );
+		}
+	);
+	return selfRecursiveCache().get( key );
+}
+
+TaskParallelTestCache &selfRecursiveCache()
+{
+	static TaskParallelTestCache c( getSelfRecursive );
+	return c;
+}
+
+void testTaskParallelLRUCacheRecursionDetection()
+{
+	TaskParallelTestCache &cache = selfRecursiveCache();
+	cache.clear();
+	try
+	{
+		cache.get( 1 );
+	}
+	catch( const Exception & )
+	{
+		return;
+	}
+	throw Exception( "Recursion not detected" );
+}
+
+void testScanResistantLRUCacheScan()
+{
+	// Make a working set filling most of the cache, and
+	// use it a few times.
+	ScanResistantTestCache cache( get, 100 );
+	for( int i = 0; i < 3; ++i )
+	{
+		for( int k = 0; k < 80; ++k )
+		{
+			cache.get( k );
+		}
+	}
+
+	// Scan through many more items than fit in the cache.
+	// They should be evicted in preference to the working set.
+	for( int k = 1000; k < 20000; ++k )
+	{
+		cache.get( k );
+	}
+
+	for( int k = 0; k < 80; ++k )
+	{
+		if( !cache.cached( k ) )
+		{
+			throw Exception( boost::str( boost::format( "Item %d evicted by scan" ) % k ) );
+		}
+	}
+
+	// Items needed twice in quick succession join the
+	// working set too, and are protected from the next
+	// scan. Here the working set fills the 90% of the
+	// cost not reserved for probation.
+	for( int i = 0; i < 2; ++i )
+	{
+		for( int k = 2000; k < 2010; ++k )
+		{
+			cache.get( k );
+		}
+	}
+	for( int k = 3000; k < 4000; ++k )
+	{
+		cache.get( k );
+	}
+	for( int k = 0; k < 80; ++k )
+	{
+		if( !cache.cached( k ) )
+		{
+			throw Exception( boost::str( boost::format( "Item %d evicted by scan" ) % k ) );
+		}
+	}
+	for( int k = 2000; k < 2010; ++k )
+	{
+		if( !cache.cached( k ) )
+		{
+			throw Exception( boost::str( boost::format( "Item %d not admitted" ) % k ) );
+		}
+	}
+
+	if( cache.currentCost() > cache.getMaxCost() )
+	{
+		throw Exception( "LRUCache exceeds maximum cost" );
+	}
+}
+
+dict statistics( const PythonLRUCache &cache )
+{
+	const PythonLRUCache::Statistics s = cache.statistics();
+	dict result;
+	result["hits"] = s.hits;
+	result["misses"] = s.misses;
+	result["evictions"] = s.evictions;
+	return result;
 }
 
 } // namespace
@@ -321,12 +480,25 @@ void IECorePython::bindLRUCache()
 		.def( "get", &PythonLRUCache::get )
 		.def( "set", &PythonLRUCache::set )
 		.def( "cached", &PythonLRUCache::cached )
+		.def( "statistics", &statistics )
+		.def( "resetStatistics", &PythonLRUCache::resetStatistics )
 	;
 
 	/// \todo If we create an IECoreTest module, move these into it.
 	def(
 		"testLRUCacheThreading",
-		testLRUCacheThreading,
+		testLRUCacheThreading<TestCache>,
+		(
+			boost::python::arg( "numIterations" ),
+			boost::python::arg( "numValues" ),
+			boost::python::arg( "maxCost" ),
+			boost::python::arg( "clearFrequency" ) = 0
+		)
+	);
+
+	def(
+		"testScanResistantLRUCacheThreading",
+		testLRUCacheThreading<ScanResistantTestCache>,
 		(
 			boost::python::arg( "numIterations" ),
 			boost::python::arg( "numValues" ),
@@ -336,6 +508,11 @@ void IECorePython::bindLRUCache()
 	);
 
 	def( "testSerialLRUCacheRecursion", testSerialLRUCacheRecursion );
-	def( "testParallelLRUCacheRecursion", testParallelLRUCacheRecursion );
+	def( "testParallelLRUCacheRecursion", testParallelLRUCacheRecursion<ParallelTestCache> );
+	def( "testTaskParallelLRUCacheRecursion", testParallelLRUCacheRecursion<TaskParallelTestCache> );
+	def( "testTaskParallelLRUCacheCollaboration", testTaskParallelLRUCacheCollaboration );
+	def( "testTaskParallelLRUCacheRecursionDetection", testTaskParallelLRUCacheRecursionDetection );
+	def( "testScanResistantLRUCacheRecursion", testParallelLRUCacheRecursion<ScanResistantTestCache> );
+	def( "testScanResistantLRUCacheScan", testScanResistantLRUCacheScan );
 
 }
@@ -81,6 +81,7 @@ void bindObjectPool()
 		enum_< ObjectPool::StoreMode > ("StoreMode")
 			.value("StoreCopy", ObjectPool::StoreCopy)
 			.value("StoreReference", ObjectPool::StoreReference)
+			.value("StoreDeduplicated", ObjectPool::StoreDeduplicated)
 			.export_values()
 		;
 	}
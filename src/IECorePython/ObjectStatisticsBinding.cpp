@@ -0,0 +1,92 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+// This include needs to be the very first to prevent problems with warnings
+// regarding redefinition of _POSIX_C_SOURCE
+#include "boost/python.hpp"
+
+#include "IECorePython/ObjectStatisticsBinding.h"
+
+#include "IECore/ObjectStatistics.h"
+#include "IECore/RunTimeTyped.h"
+
+using namespace boost::python;
+using namespace IECore;
+
+namespace IECorePython
+{
+
+static dict snapshot()
+{
+	ObjectStatistics::Snapshot s = ObjectStatistics::snapshot();
+
+	dict types;
+	for( const auto &t : s.types )
+	{
+		types[RunTimeTyped::typeNameFromTypeId( t.first )] = t.second;
+	}
+
+	dict owners;
+	for( const auto &o : s.owners )
+	{
+		owners[o.first] = o.second;
+	}
+
+	dict result;
+	result["types"] = types;
+	result["owners"] = owners;
+	return result;
+}
+
+void bindObjectStatistics()
+{
+	class_<ObjectStatistics> c( "ObjectStatistics", no_init );
+
+	{
+		scope s( c );
+
+		class_<ObjectStatistics::TypeStatistics>( "TypeStatistics" )
+			.def_readonly( "instances", &ObjectStatistics::TypeStatistics::instances )
+			.def_readonly( "instanceMemory", &ObjectStatistics::TypeStatistics::instanceMemory )
+			.def_readonly( "buffers", &ObjectStatistics::TypeStatistics::buffers )
+			.def_readonly( "bufferMemory", &ObjectStatistics::TypeStatistics::bufferMemory )
+		;
+	}
+
+	c.def( "enabled", &ObjectStatistics::enabled ).staticmethod( "enabled" );
+	c.def( "snapshot", &snapshot ).staticmethod( "snapshot" );
+}
+
+} // namespace IECorePython
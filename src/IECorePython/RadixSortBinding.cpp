@@ -66,6 +66,9 @@ void bindRadixSort()
 		.def( "sort", &RadixSortWrapper::sort<int> )
 		.def( "sort", &RadixSortWrapper::sort<unsigned int> )
 		.def( "sort", &RadixSortWrapper::sort<float> )
+		.def( "sort", &RadixSortWrapper::sort<double> )
+		.def( "sort", &RadixSortWrapper::sort<int64_t> )
+		.def( "sort", &RadixSortWrapper::sort<uint64_t> )
 	;
 }
 
@@ -148,6 +148,7 @@
 #include "IECorePython/LensModelBinding.h"
 #include "IECorePython/StandardRadialLensModelBinding.h"
 #include "IECorePython/ObjectPoolBinding.h"
+#include "IECorePython/ObjectStatisticsBinding.h"
 #include "IECorePython/DataAlgoBinding.h"
 #include "IECorePython/BoxAlgoBinding.h"
 #include "IECorePython/RandomAlgoBinding.h"
@@ -287,6 +288,7 @@ BOOST_PYTHON_MODULE(_IECore)
 	bindLensModel();
 	bindStandardRadialLensModel();
 	bindObjectPool();
+	bindObjectStatistics();
 	bindDataAlgo();
 	bindBoxAlgo();
 	bindRandomAlgo();
@@ -0,0 +1,90 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "IECoreScene/CurvesAlgo.h"
+
+#include "ExclusiveScan.h"
+#include "PrimitiveMerge.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task.h"
+
+#include <algorithm>
+
+using namespace Imath;
+using namespace IECore;
+using namespace IECoreScene;
+
+CurvesPrimitivePtr IECoreScene::CurvesAlgo::merge( const std::vector<const CurvesPrimitive *> &curvesPrimitives, const std::vector<M44f> &transforms )
+{
+	for( const auto &curves : curvesPrimitives )
+	{
+		if( curves->basis() != curvesPrimitives[0]->basis() || curves->periodic() != curvesPrimitives[0]->periodic() )
+		{
+			throw InvalidArgumentException( "CurvesAlgo::merge : Curves must all have the same basis and periodicity" );
+		}
+	}
+
+	std::vector<int> curveOffsets;
+	Private::exclusiveScan( curvesPrimitives.size(), [&]( size_t i ) { return (int)curvesPrimitives[i]->numCurves(); }, curveOffsets );
+
+	IntVectorDataPtr verticesPerCurveData = new IntVectorData;
+	std::vector<int> &verticesPerCurve = verticesPerCurveData->writable();
+	verticesPerCurve.resize( curveOffsets.back() );
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, curvesPrimitives.size() ),
+		[&]( const tbb::blocked_range<size_t> &range )
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				const std::vector<int> &curvesVerticesPerCurve = curvesPrimitives[i]->verticesPerCurve()->readable();
+				std::copy( curvesVerticesPerCurve.begin(), curvesVerticesPerCurve.end(), verticesPerCurve.begin() + curveOffsets[i] );
+			}
+		},
+		taskGroupContext
+	);
+
+	CurvesPrimitivePtr result = curvesPrimitives.empty() ?
+		new CurvesPrimitive( verticesPerCurveData ) :
+		new CurvesPrimitive( verticesPerCurveData, curvesPrimitives[0]->basis(), curvesPrimitives[0]->periodic() )
+	;
+
+	Private::mergePrimitiveVariables( std::vector<const Primitive *>( curvesPrimitives.begin(), curvesPrimitives.end() ), transforms, result.get(), Private::LenientMerge );
+
+	return result;
+}
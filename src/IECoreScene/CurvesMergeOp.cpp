@@ -34,12 +34,10 @@
 
 #include "IECoreScene/CurvesMergeOp.h"
 
+#include "IECoreScene/CurvesAlgo.h"
+
 #include "IECore/CompoundParameter.h"
-#include "IECore/DespatchTypedData.h"
 #include "IECore/NullObject.h"
-#include "IECore/TypeTraits.h"
-
-#include <algorithm>
 
 using namespace IECore;
 using namespace IECoreScene;
@@ -73,60 +71,12 @@ const CurvesPrimitiveParameter * CurvesMergeOp::curvesParameter() const
 	return m_curvesParameter.get();
 }
 
-struct CurvesMergeOp::AppendPrimVars
-{
-	typedef void ReturnType;
-
-	AppendPrimVars( const CurvesPrimitive * curves2, const std::string &name )
-		:	m_curves2( curves2 ), m_name( name )
-	{
-	}
-
-	template<typename T>
-	ReturnType operator()( T * data )
-	{
-
-		PrimitiveVariableMap::const_iterator it = m_curves2->variables.find( m_name );
-		if( it!=m_curves2->variables.end() )
-		{
-			const T *data2 = runTimeCast<const T>( it->second.data.get() );
-			if( data2 )
-			{
-				data->writable().insert( data->writable().end(), data2->readable().begin(), data2->readable().end() );
-			}
-		}
-	}
-
-	private :
-
-		const CurvesPrimitive * m_curves2;
-		std::string m_name;
-
-};
-
 void CurvesMergeOp::modifyTypedPrimitive( CurvesPrimitive * curves, const CompoundObject * operands )
 {
 	const CurvesPrimitive *curves2 = static_cast<const CurvesPrimitive *>( m_curvesParameter->getValue() );
 
-	const vector<int> &verticesPerCurve1 = curves->verticesPerCurve()->readable();
-	const vector<int> &verticesPerCurve2 = curves2->verticesPerCurve()->readable();
-
-	IntVectorDataPtr verticesPerCurveData = new IntVectorData;
-	vector<int> &verticesPerCurve = verticesPerCurveData->writable();
-	verticesPerCurve.resize( verticesPerCurve1.size() + verticesPerCurve2.size() );
-
-	vector<int>::iterator it = copy( verticesPerCurve1.begin(), verticesPerCurve1.end(), verticesPerCurve.begin() );
-	copy( verticesPerCurve2.begin(), verticesPerCurve2.end(), it );
-
-	curves->setTopology( verticesPerCurveData, curves->basis(), curves->periodic() );
+	CurvesPrimitivePtr merged = CurvesAlgo::merge( { curves, curves2 } );
 
-	PrimitiveVariableMap::iterator pvIt;
-	for( pvIt=curves->variables.begin(); pvIt!=curves->variables.end(); pvIt++ )
-	{
-		if( pvIt->second.interpolation!=PrimitiveVariable::Constant )
-		{
-			AppendPrimVars f( curves2, pvIt->first );
-			despatchTypedData<AppendPrimVars, TypeTraits::IsVectorTypedData, DespatchTypedDataIgnoreError>( pvIt->second.data.get(), f );
-		}
-	}
+	curves->setTopology( merged->verticesPerCurve(), merged->basis(), merged->periodic() );
+	curves->variables = merged->variables;
 }
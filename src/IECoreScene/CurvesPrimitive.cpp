@@ -37,6 +37,7 @@
 #include "IECoreScene/Renderer.h"
 
 #include "IECore/MurmurHash.h"
+#include "IECore/ObjectPool.h"
 
 using namespace IECore;
 using namespace IECoreScene;
@@ -52,6 +53,18 @@ static IndexedIO::EntryID g_numFaceVaryingEntry("numFaceVarying");
 const unsigned int CurvesPrimitive::m_ioVersion = 0;
 IE_CORE_DEFINEOBJECTTYPEDESCRIPTION( CurvesPrimitive );
 
+static void deduplicateTopology( Object *object, const ObjectPool::ChildFn &childFn )
+{
+	CurvesPrimitive *curves = static_cast<CurvesPrimitive *>( object );
+	curves->setTopology(
+		boost::static_pointer_cast<IntVectorData>( childFn( curves->verticesPerCurve() ) ),
+		curves->basis(),
+		curves->periodic()
+	);
+}
+
+static bool g_deduplicateRegistration = ObjectPool::registerDeduplicateFn( CurvesPrimitiveTypeId, deduplicateTopology );
+
 CurvesPrimitive::CurvesPrimitive()
 	:
 		m_basis( CubicBasisf::linear() ),
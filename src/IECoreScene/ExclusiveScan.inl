@@ -0,0 +1,112 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef IECORESCENE_EXCLUSIVESCAN_INL
+#define IECORESCENE_EXCLUSIVESCAN_INL
+
+namespace IECoreScene
+{
+
+namespace Private
+{
+
+namespace Detail
+{
+
+// Body for `tbb::parallel_scan()`.
+template<typename Values>
+struct ExclusiveScanBody
+{
+
+	ExclusiveScanBody( const Values &values, int *sums )
+		:	sum( 0 ), m_values( values ), m_sums( sums )
+	{
+	}
+
+	ExclusiveScanBody( ExclusiveScanBody &other, tbb::split )
+		:	sum( 0 ), m_values( other.m_values ), m_sums( other.m_sums )
+	{
+	}
+
+	template<typename Tag>
+	void operator()( const tbb::blocked_range<size_t> &range, Tag )
+	{
+		int s = sum;
+		for( size_t i = range.begin(); i != range.end(); ++i )
+		{
+			if( Tag::is_final_scan() )
+			{
+				m_sums[i] = s;
+			}
+			s += m_values( i );
+		}
+		sum = s;
+	}
+
+	void reverse_join( ExclusiveScanBody &other )
+	{
+		sum += other.sum;
+	}
+
+	void assign( ExclusiveScanBody &other )
+	{
+		sum = other.sum;
+	}
+
+	int sum;
+
+	private :
+
+		const Values &m_values;
+		int *m_sums;
+
+};
+
+} // namespace Detail
+
+template<typename Values>
+void exclusiveScan( size_t size, const Values &values, std::vector<int> &sums )
+{
+	sums.resize( size + 1 );
+	Detail::ExclusiveScanBody<Values> body( values, sums.data() );
+	tbb::parallel_scan( tbb::blocked_range<size_t>( 0, size ), body );
+	sums.back() = body.sum;
+}
+
+} // namespace Private
+
+} // namespace IECoreScene
+
+#endif // IECORESCENE_EXCLUSIVESCAN_INL
@@ -0,0 +1,198 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef IECORESCENE_HIERARCHYALGO_H
+#define IECORESCENE_HIERARCHYALGO_H
+
+#include "IECoreScene/SceneInterface.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include <vector>
+
+namespace IECoreScene
+{
+
+namespace Private
+{
+
+/// Fills hierarchy as documented in SceneInterface::readHierarchy(), starting at the given location.
+/// The children of each location are visited in parallel if `parallel` is true, in which case the
+/// Accessor methods must be safe to call concurrently. The Accessor class abstracts the queries made to each location, so that implementations can skip
+/// the SceneInterface API where they have faster means. It must provide :
+///
+/// typedef ... LocationPtr;
+/// static void childNames( const LocationPtr &location, SceneInterface::NameList &childNames );
+/// static LocationPtr child( const LocationPtr &location, const SceneInterface::Name &name );
+/// static Imath::M44d transform( const LocationPtr &location, double time );
+/// static Imath::Box3d bound( const LocationPtr &location, double time );
+/// static IECore::TypeId objectType( const LocationPtr &location, double time );
+template<typename Accessor>
+void readHierarchy( const typename Accessor::LocationPtr &location, const IECore::PathMatcher &filter, double time, int what, bool parallel, SceneInterface::Hierarchy &hierarchy );
+
+namespace Detail
+{
+
+struct HierarchyNode
+{
+	HierarchyNode() : match( IECore::PathMatcher::NoMatch ), objectType( IECore::InvalidTypeId )
+	{
+	}
+
+	SceneInterface::Name name;
+	unsigned match;
+	Imath::M44d localTransform;
+	Imath::M44d worldTransform;
+	Imath::Box3d bound;
+	IECore::TypeId objectType;
+	std::vector<HierarchyNode> children;
+};
+
+template<typename Accessor>
+void hierarchyWalk( const typename Accessor::LocationPtr &location, const IECore::PathMatcher &filter, double time, int what, bool parallel, const SceneInterface::Path &path, const Imath::M44d &parentTransform, HierarchyNode &node )
+{
+	node.match = filter.match( path );
+
+	// transforms are needed for all the ancestors of the matching locations, to compute their world transforms.
+	if( what & SceneInterface::HierarchyTransforms )
+	{
+		node.localTransform = Accessor::transform( location, time );
+		node.worldTransform = node.localTransform * parentTransform;
+	}
+
+	if( node.match & IECore::PathMatcher::ExactMatch )
+	{
+		if( what & SceneInterface::HierarchyBounds )
+		{
+			node.bound = Accessor::bound( location, time );
+		}
+		if( what & SceneInterface::HierarchyObjectTypes )
+		{
+			node.objectType = Accessor::objectType( location, time );
+		}
+	}
+
+	if( !( node.match & IECore::PathMatcher::DescendantMatch ) )
+	{
+		return;
+	}
+
+	SceneInterface::NameList childNames;
+	Accessor::childNames( location, childNames );
+
+	SceneInterface::Path matchPath( path );
+	matchPath.push_back( IECore::InternedString() ); // room for the child name
+	for( SceneInterface::NameList::const_iterator it = childNames.begin(); it != childNames.end(); ++it )
+	{
+		matchPath.back() = *it;
+		if( filter.match( matchPath ) != IECore::PathMatcher::NoMatch )
+		{
+			node.children.push_back( HierarchyNode() );
+			node.children.back().name = *it;
+		}
+	}
+
+	auto walkChildren = [&]( const tbb::blocked_range<size_t> &range ) {
+		SceneInterface::Path childPath( path );
+		childPath.push_back( IECore::InternedString() );
+		for( size_t i = range.begin(); i != range.end(); ++i )
+		{
+			HierarchyNode &child = node.children[i];
+			childPath.back() = child.name;
+			hierarchyWalk<Accessor>( Accessor::child( location, child.name ), filter, time, what, parallel, childPath, node.worldTransform, child );
+		}
+	};
+
+	const tbb::blocked_range<size_t> range( 0, node.children.size() );
+	if( parallel )
+	{
+		tbb::parallel_for( range, walkChildren );
+	}
+	else
+	{
+		walkChildren( range );
+	}
+}
+
+inline void flattenHierarchy( const HierarchyNode &node, int what, int parentIndex, SceneInterface::Path &path, SceneInterface::Hierarchy &hierarchy )
+{
+	if( node.match & IECore::PathMatcher::ExactMatch )
+	{
+		const int index = (int)hierarchy.paths.size();
+		hierarchy.paths.push_back( path );
+		hierarchy.parentIndices.push_back( parentIndex );
+		if( what & SceneInterface::HierarchyTransforms )
+		{
+			hierarchy.localTransforms.push_back( node.localTransform );
+			hierarchy.worldTransforms.push_back( node.worldTransform );
+		}
+		if( what & SceneInterface::HierarchyBounds )
+		{
+			hierarchy.bounds.push_back( node.bound );
+		}
+		if( what & SceneInterface::HierarchyObjectTypes )
+		{
+			hierarchy.objectTypes.push_back( node.objectType );
+		}
+		parentIndex = index;
+	}
+
+	for( std::vector<HierarchyNode>::const_iterator it = node.children.begin(); it != node.children.end(); ++it )
+	{
+		path.push_back( it->name );
+		flattenHierarchy( *it, what, parentIndex, path, hierarchy );
+		path.pop_back();
+	}
+}
+
+} // namespace Detail
+
+template<typename Accessor>
+void readHierarchy( const typename Accessor::LocationPtr &location, const IECore::PathMatcher &filter, double time, int what, bool parallel, SceneInterface::Hierarchy &hierarchy )
+{
+	Detail::HierarchyNode root;
+	Detail::hierarchyWalk<Accessor>( location, filter, time, what, parallel, SceneInterface::Path(), Imath::M44d(), root );
+
+	hierarchy = SceneInterface::Hierarchy();
+	SceneInterface::Path path;
+	Detail::flattenHierarchy( root, what, -1, path, hierarchy );
+}
+
+} // namespace Private
+
+} // namespace IECoreScene
+
+#endif // IECORESCENE_HIERARCHYALGO_H
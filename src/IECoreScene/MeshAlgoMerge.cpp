@@ -0,0 +1,109 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "IECoreScene/MeshAlgo.h"
+
+#include "ExclusiveScan.h"
+#include "PrimitiveMerge.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task.h"
+
+#include <algorithm>
+
+using namespace Imath;
+using namespace IECore;
+using namespace IECoreScene;
+
+MeshPrimitivePtr IECoreScene::MeshAlgo::merge( const std::vector<const MeshPrimitive *> &meshes, const std::vector<M44f> &transforms )
+{
+	// Compute where each mesh goes in the merged topology.
+
+	std::vector<int> faceOffsets;
+	Private::exclusiveScan( meshes.size(), [&]( size_t i ) { return (int)meshes[i]->numFaces(); }, faceOffsets );
+
+	std::vector<int> vertexIdOffsets;
+	Private::exclusiveScan( meshes.size(), [&]( size_t i ) { return (int)meshes[i]->vertexIds()->readable().size(); }, vertexIdOffsets );
+
+	std::vector<int> vertexOffsets;
+	Private::exclusiveScan( meshes.size(), [&]( size_t i ) { return (int)meshes[i]->variableSize( PrimitiveVariable::Vertex ); }, vertexOffsets );
+
+	// Copy the topology of each mesh into place.
+
+	IntVectorDataPtr verticesPerFaceData = new IntVectorData;
+	std::vector<int> &verticesPerFace = verticesPerFaceData->writable();
+	verticesPerFace.resize( faceOffsets.back() );
+
+	IntVectorDataPtr vertexIdsData = new IntVectorData;
+	std::vector<int> &vertexIds = vertexIdsData->writable();
+	vertexIds.resize( vertexIdOffsets.back() );
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, meshes.size() ),
+		[&]( const tbb::blocked_range<size_t> &range )
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				const std::vector<int> &meshVerticesPerFace = meshes[i]->verticesPerFace()->readable();
+				std::copy( meshVerticesPerFace.begin(), meshVerticesPerFace.end(), verticesPerFace.begin() + faceOffsets[i] );
+
+				const std::vector<int> &meshVertexIds = meshes[i]->vertexIds()->readable();
+				const int vertexOffset = vertexOffsets[i];
+				std::transform(
+					meshVertexIds.begin(), meshVertexIds.end(), vertexIds.begin() + vertexIdOffsets[i],
+					[vertexOffset]( int id ) { return id + vertexOffset; }
+				);
+			}
+		},
+		taskGroupContext
+	);
+
+	// We can't use the MeshPrimitive constructor here, because it derives
+	// the number of vertices from the vertex ids, and that would drop any
+	// unused vertices from the last mesh.
+	MeshPrimitivePtr result = new MeshPrimitive;
+	result->setTopologyUnchecked(
+		verticesPerFaceData,
+		vertexIdsData,
+		vertexOffsets.back(),
+		meshes.empty() ? "linear" : meshes[0]->interpolation()
+	);
+
+	Private::mergePrimitiveVariables( std::vector<const Primitive *>( meshes.begin(), meshes.end() ), transforms, result.get(), Private::LenientMerge );
+
+	return result;
+}
@@ -0,0 +1,256 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "IECoreScene/MeshAlgo.h"
+#include "IECoreScene/MeshTopology.h"
+
+#include "IECore/DespatchTypedData.h"
+
+#include "boost/format.hpp"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task.h"
+
+#include <cmath>
+
+using namespace Imath;
+using namespace IECore;
+using namespace IECoreScene;
+
+//////////////////////////////////////////////////////////////////////////
+// Calculate normals
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+struct CalculateNormals
+{
+	typedef DataPtr ReturnType;
+
+	CalculateNormals( const MeshPrimitive *mesh, PrimitiveVariable::Interpolation interpolation, MeshAlgo::NormalWeighting weighting, Data *destination )
+		:	m_topology( mesh->topology() ), m_vertexIds( mesh->vertexIds()->readable() ), m_interpolation( interpolation ), m_weighting( weighting ), m_destination( destination )
+	{
+	}
+
+	template<typename T>
+	ReturnType operator()( const T *data )
+	{
+		typedef typename T::ValueType::value_type Vec;
+
+		const std::vector<Vec> &points = data->readable();
+
+		// Reuse the destination if we can, so that repeated calculations
+		// for a deforming mesh needn't reallocate. We may only modify it
+		// if nothing else references it though, since it could be shared
+		// by a copy of the mesh or held by a cache. We check the count
+		// before taking a reference of our own.
+		typename T::Ptr normalsData;
+		if( m_destination && m_destination->refCount() == 1 && m_destination != data )
+		{
+			normalsData = runTimeCast<T>( m_destination );
+		}
+		if( !normalsData )
+		{
+			normalsData = new T;
+		}
+		normalsData->setInterpretation( GeometricData::Normal );
+		std::vector<Vec> &normals = normalsData->writable();
+
+		const std::vector<int> &faceOffsets = m_topology->faceOffsets();
+
+		tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+
+		if( m_interpolation == PrimitiveVariable::Uniform || m_interpolation == PrimitiveVariable::FaceVarying )
+		{
+			const bool uniform = m_interpolation == PrimitiveVariable::Uniform;
+			normals.resize( uniform ? m_topology->numFaces() : m_topology->numFaceVertices() );
+			tbb::parallel_for(
+				tbb::blocked_range<size_t>( 0, m_topology->numFaces() ),
+				[&]( const tbb::blocked_range<size_t> &range )
+				{
+					for( size_t f = range.begin(); f != range.end(); ++f )
+					{
+						const Vec n = faceNormal( points, faceOffsets[f] );
+						if( uniform )
+						{
+							normals[f] = n;
+						}
+						else
+						{
+							std::fill( normals.begin() + faceOffsets[f], normals.begin() + faceOffsets[f+1], n );
+						}
+					}
+				},
+				taskGroupContext
+			);
+			return normalsData;
+		}
+
+		// Vertex normals. Rather than scattering face normals onto the
+		// vertices, which would require synchronisation, each vertex gathers
+		// from its faces. The faces are visited in order, so the result is
+		// independent of the number of threads, and matches a serial
+		// accumulation over the faces.
+
+		const std::vector<int> &vertexOffsets = m_topology->vertexOffsets();
+		const std::vector<int> &vertexFaceVertices = m_topology->vertexFaceVertices();
+		const std::vector<int> &faceVertexFaces = m_topology->faceVertexFaces();
+
+		normals.resize( points.size() );
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, normals.size() ),
+			[&]( const tbb::blocked_range<size_t> &range )
+			{
+				for( size_t v = range.begin(); v != range.end(); ++v )
+				{
+					Vec n( 0 );
+					if( v < m_topology->numVertices() )
+					{
+						for( int i = vertexOffsets[v]; i < vertexOffsets[v+1]; ++i )
+						{
+							const int faceVertex = vertexFaceVertices[i];
+							const int face = faceVertexFaces[faceVertex];
+							const int begin = faceOffsets[face];
+							switch( m_weighting )
+							{
+								case MeshAlgo::AngleWeighting :
+									n += faceNormal( points, begin ) * cornerAngle( points, faceVertex, begin, faceOffsets[face+1] );
+									break;
+								case MeshAlgo::AreaWeighting :
+									n += faceAreaNormal( points, begin, faceOffsets[face+1] );
+									break;
+								default :
+									// EqualWeighting
+									n += faceNormal( points, begin );
+							}
+						}
+					}
+					n.normalize();
+					normals[v] = n;
+				}
+			},
+			taskGroupContext
+		);
+
+		return normalsData;
+	}
+
+	private :
+
+		// Unit normal of the face starting at `begin`. Note that this method is very naive,
+		// and doesn't cope with colinear vertices or concave faces - we could use polygonNormal()
+		// from PolygonAlgo.h to deal with that, but currently we'd prefer to avoid the overhead.
+		template<typename Vec>
+		Vec faceNormal( const std::vector<Vec> &points, int begin ) const
+		{
+			const Vec &p0 = points[m_vertexIds[begin]];
+			const Vec &p1 = points[m_vertexIds[begin+1]];
+			const Vec &p2 = points[m_vertexIds[begin+2]];
+			Vec normal = (p2-p1).cross(p0-p1);
+			return normal.normalize();
+		}
+
+		// Normal of the face in `[begin, end)`, with length equal to twice its area.
+		template<typename Vec>
+		Vec faceAreaNormal( const std::vector<Vec> &points, int begin, int end ) const
+		{
+			const Vec &p0 = points[m_vertexIds[begin]];
+			Vec result( 0 );
+			for( int i = begin + 1; i < end - 1; ++i )
+			{
+				result += ( points[m_vertexIds[i]] - p0 ).cross( points[m_vertexIds[i+1]] - p0 );
+			}
+			return result;
+		}
+
+		// Interior angle of the face in `[begin, end)` at the specified face-vertex.
+		template<typename Vec>
+		typename Vec::BaseType cornerAngle( const std::vector<Vec> &points, int faceVertex, int begin, int end ) const
+		{
+			const int previous = faceVertex == begin ? end - 1 : faceVertex - 1;
+			const int next = faceVertex + 1 == end ? begin : faceVertex + 1;
+			const Vec &p = points[m_vertexIds[faceVertex]];
+			const Vec e0 = points[m_vertexIds[next]] - p;
+			const Vec e1 = points[m_vertexIds[previous]] - p;
+			return std::atan2( e0.cross( e1 ).length(), e0.dot( e1 ) );
+		}
+
+		ConstMeshTopologyPtr m_topology;
+		const std::vector<int> &m_vertexIds;
+		PrimitiveVariable::Interpolation m_interpolation;
+		MeshAlgo::NormalWeighting m_weighting;
+		Data *m_destination;
+
+};
+
+struct HandleNormalsErrors
+{
+	template<typename T, typename F>
+	void operator()( const T *d, const F &f )
+	{
+		std::string e = boost::str( boost::format( "MeshAlgo::calculateNormals : Position primitive variable has unsupported data type \"%s\"." ) % d->typeName() );
+		throw InvalidArgumentException( e );
+	}
+};
+
+} // namespace
+
+PrimitiveVariable IECoreScene::MeshAlgo::calculateNormals( const MeshPrimitive *mesh, PrimitiveVariable::Interpolation interpolation, NormalWeighting weighting, const std::string &position, Data *destination )
+{
+	PrimitiveVariableMap::const_iterator pIt = mesh->variables.find( position );
+	if( pIt == mesh->variables.end() || !pIt->second.data || ( pIt->second.interpolation != PrimitiveVariable::Vertex && pIt->second.interpolation != PrimitiveVariable::Varying ) || pIt->second.indices )
+	{
+		std::string e = boost::str( boost::format( "MeshAlgo::calculateNormals : MeshPrimitive has no Vertex \"%s\" primitive variable." ) % position );
+		throw InvalidArgumentException( e );
+	}
+
+	if( !mesh->isPrimitiveVariableValid( pIt->second ) )
+	{
+		std::string e = boost::str( boost::format( "MeshAlgo::calculateNormals : \"%s\" primitive variable is invalid." ) % position );
+		throw InvalidArgumentException( e );
+	}
+
+	if( interpolation != PrimitiveVariable::Vertex && interpolation != PrimitiveVariable::Varying && interpolation != PrimitiveVariable::Uniform && interpolation != PrimitiveVariable::FaceVarying )
+	{
+		throw InvalidArgumentException( "MeshAlgo::calculateNormals : Interpolation must be Vertex, Varying, Uniform or FaceVarying." );
+	}
+
+	CalculateNormals f( mesh, interpolation, weighting, destination );
+	DataPtr n = despatchTypedData<CalculateNormals, TypeTraits::IsVec3VectorTypedData, HandleNormalsErrors>( pIt->second.data.get(), f );
+
+	return PrimitiveVariable( interpolation, n );
+}
@@ -0,0 +1,270 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "IECoreScene/MeshAlgo.h"
+
+#include "IECoreScene/MeshTopology.h"
+
+#include "ExclusiveScan.h"
+#include "MortonOrder.h"
+#include "RemapData.h"
+
+#include "IECore/RadixSort.h"
+
+#include "boost/format.hpp"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task.h"
+
+#include <algorithm>
+
+using namespace Imath;
+using namespace IECore;
+using namespace IECoreScene;
+
+//////////////////////////////////////////////////////////////////////////
+// Reordering
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Returns the inverse of `order`, throwing if it isn't a permutation
+// of `[0, size)`.
+std::vector<int> invertOrder( const std::vector<int> &order, size_t size, const char *name )
+{
+	if( order.size() != size )
+	{
+		throw InvalidArgumentException( boost::str( boost::format( "MeshAlgo::reorder : Wrong number of elements in %s (%d but expected %d)" ) % name % order.size() % size ) );
+	}
+
+	std::vector<int> inverse( size, -1 );
+	for( size_t i = 0; i < size; ++i )
+	{
+		const int o = order[i];
+		if( o < 0 || o >= (int)size || inverse[o] != -1 )
+		{
+			throw InvalidArgumentException( boost::str( boost::format( "MeshAlgo::reorder : %s is not a valid permutation" ) % name ) );
+		}
+		inverse[o] = i;
+	}
+
+	return inverse;
+}
+
+} // namespace
+
+std::pair<IntVectorDataPtr, IntVectorDataPtr> MeshAlgo::calculateLocalityOrder( const MeshPrimitive *mesh, const std::string &position )
+{
+	const V3fVectorData *pData = mesh->variableData<V3fVectorData>( position, PrimitiveVariable::Vertex );
+	if( !pData )
+	{
+		throw InvalidArgumentException( boost::str( boost::format( "MeshAlgo::calculateLocalityOrder : MeshPrimitive has no \"%s\" primitive variable." ) % position ) );
+	}
+	const std::vector<V3f> &p = pData->readable();
+
+	ConstMeshTopologyPtr topology = mesh->topology();
+	const std::vector<int> &vertexIds = mesh->vertexIds()->readable();
+	const std::vector<int> &faceOffsets = topology->faceOffsets();
+	const size_t numFaces = mesh->numFaces();
+	const size_t numVertices = mesh->variableSize( PrimitiveVariable::Vertex );
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+
+	// Sort the faces along a Morton curve through their centroids.
+
+	std::vector<V3f> centroids( numFaces );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numFaces ),
+		[&]( const tbb::blocked_range<size_t> &range )
+		{
+			for( size_t f = range.begin(); f != range.end(); ++f )
+			{
+				V3f centroid( 0 );
+				for( int i = faceOffsets[f]; i < faceOffsets[f+1]; ++i )
+				{
+					centroid += p[vertexIds[i]];
+				}
+				const int numFaceVertices = faceOffsets[f+1] - faceOffsets[f];
+				centroids[f] = numFaceVertices ? centroid / (float)numFaceVertices : centroid;
+			}
+		},
+		taskGroupContext
+	);
+
+	IntVectorDataPtr faceOrderData = new IntVectorData;
+	std::vector<int> &faceOrder = faceOrderData->writable();
+	Private::mortonOrder( centroids, faceOrder );
+
+	// Order the vertices by the first of the sorted faces to use them,
+	// so that the vertices of neighbouring faces are neighbours in memory
+	// too. Unused vertices go at the end.
+
+	std::vector<int> faceRanks( numFaces );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numFaces ),
+		[&]( const tbb::blocked_range<size_t> &range )
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				faceRanks[faceOrder[i]] = i;
+			}
+		},
+		taskGroupContext
+	);
+
+	const std::vector<int> &vertexOffsets = topology->vertexOffsets();
+	const std::vector<int> &vertexFaces = topology->vertexFaces();
+	std::vector<unsigned int> vertexKeys( numVertices );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numVertices ),
+		[&]( const tbb::blocked_range<size_t> &range )
+		{
+			for( size_t v = range.begin(); v != range.end(); ++v )
+			{
+				unsigned int key = numFaces;
+				for( int i = vertexOffsets[v]; i < vertexOffsets[v+1]; ++i )
+				{
+					key = std::min( key, (unsigned int)faceRanks[vertexFaces[i]] );
+				}
+				vertexKeys[v] = key;
+			}
+		},
+		taskGroupContext
+	);
+
+	RadixSort sorter;
+	const std::vector<unsigned int> &sortedVertices = sorter( vertexKeys );
+
+	IntVectorDataPtr vertexOrderData = new IntVectorData;
+	vertexOrderData->writable().assign( sortedVertices.begin(), sortedVertices.end() );
+
+	return std::make_pair( faceOrderData, vertexOrderData );
+}
+
+MeshPrimitivePtr MeshAlgo::reorder( const MeshPrimitive *mesh, const IntVectorData *faceOrderData, const IntVectorData *vertexOrderData )
+{
+	if( !mesh->arePrimitiveVariablesValid() )
+	{
+		throw InvalidArgumentException( "MeshAlgo::reorder : Mesh has invalid primitive variables" );
+	}
+
+	const std::vector<int> &faceOrder = faceOrderData->readable();
+	const std::vector<int> &vertexOrder = vertexOrderData->readable();
+	invertOrder( faceOrder, mesh->numFaces(), "faceOrder" );
+	const std::vector<int> inverseVertexOrder = invertOrder( vertexOrder, mesh->variableSize( PrimitiveVariable::Vertex ), "vertexOrder" );
+
+	const std::vector<int> &verticesPerFace = mesh->verticesPerFace()->readable();
+	const std::vector<int> &vertexIds = mesh->vertexIds()->readable();
+	ConstMeshTopologyPtr topology = mesh->topology();
+	const std::vector<int> &faceOffsets = topology->faceOffsets();
+
+	// Reorder the topology, and compute the mapping
+	// for FaceVarying primitive variables.
+
+	std::vector<int> newFaceOffsets;
+	Private::exclusiveScan( faceOrder.size(), [&]( size_t i ) { return verticesPerFace[faceOrder[i]]; }, newFaceOffsets );
+
+	IntVectorDataPtr newVerticesPerFaceData = new IntVectorData;
+	std::vector<int> &newVerticesPerFace = newVerticesPerFaceData->writable();
+	newVerticesPerFace.resize( faceOrder.size() );
+
+	IntVectorDataPtr newVertexIdsData = new IntVectorData;
+	std::vector<int> &newVertexIds = newVertexIdsData->writable();
+	newVertexIds.resize( vertexIds.size() );
+
+	std::vector<int> faceVaryingOrder( vertexIds.size() );
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, faceOrder.size() ),
+		[&]( const tbb::blocked_range<size_t> &range )
+		{
+			for( size_t f = range.begin(); f != range.end(); ++f )
+			{
+				const int oldFace = faceOrder[f];
+				newVerticesPerFace[f] = verticesPerFace[oldFace];
+				for( int i = 0; i < verticesPerFace[oldFace]; ++i )
+				{
+					const int oldFaceVertex = faceOffsets[oldFace] + i;
+					newVertexIds[newFaceOffsets[f] + i] = inverseVertexOrder[vertexIds[oldFaceVertex]];
+					faceVaryingOrder[newFaceOffsets[f] + i] = oldFaceVertex;
+				}
+			}
+		},
+		taskGroupContext
+	);
+
+	// We can't use the MeshPrimitive constructor here, because it derives
+	// the number of vertices from the vertex ids, and that would drop any
+	// vertices not referenced by a face.
+	MeshPrimitivePtr result = new MeshPrimitive;
+	result->setTopologyUnchecked(
+		newVerticesPerFaceData,
+		newVertexIdsData,
+		mesh->variableSize( PrimitiveVariable::Vertex ),
+		mesh->interpolation()
+	);
+
+	// Remap the primitive variables. Indexed variables remain
+	// indexed, and only their indices are remapped.
+
+	Private::RemapData uniformRemap( faceOrder );
+	Private::RemapData vertexRemap( vertexOrder );
+	Private::RemapData faceVaryingRemap( faceVaryingOrder );
+	for( const auto &variable : mesh->variables )
+	{
+		PrimitiveVariable primitiveVariable = variable.second;
+		switch( primitiveVariable.interpolation )
+		{
+			case PrimitiveVariable::Uniform :
+				Private::remapPrimitiveVariable( primitiveVariable, uniformRemap );
+				break;
+			case PrimitiveVariable::Vertex :
+			case PrimitiveVariable::Varying :
+				Private::remapPrimitiveVariable( primitiveVariable, vertexRemap );
+				break;
+			case PrimitiveVariable::FaceVarying :
+				Private::remapPrimitiveVariable( primitiveVariable, faceVaryingRemap );
+				break;
+			default :
+				break;
+		}
+		result->variables[variable.first] = primitiveVariable;
+	}
+
+	return result;
+}
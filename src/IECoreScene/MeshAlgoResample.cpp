@@ -34,10 +34,15 @@
 
 #include "IECoreScene/FaceVaryingPromotionOp.h"
 #include "IECoreScene/MeshAlgo.h"
+#include "IECoreScene/MeshTopology.h"
 #include "IECoreScene/private/PrimitiveAlgoUtils.h"
 
 #include "IECore/DespatchTypedData.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task.h"
+
 using namespace Imath;
 using namespace IECore;
 using namespace IECoreScene;
@@ -49,11 +54,33 @@ using namespace IECoreScene;
 namespace
 {
 
+// Returns the offset of the first face-vertex of each face, followed by
+// the total number of face-vertices. The conversions to Uniform need only
+// this, so we compute it directly rather than build the full MeshTopology,
+// which is considerably more expensive the first time it is requested.
+std::vector<int> faceOffsets( const MeshPrimitive *mesh )
+{
+	const std::vector<int> &verticesPerFace = mesh->verticesPerFace()->readable();
+
+	std::vector<int> result;
+	result.reserve( verticesPerFace.size() + 1 );
+
+	int offset = 0;
+	for( std::vector<int>::const_iterator it = verticesPerFace.begin(); it != verticesPerFace.end(); ++it )
+	{
+		result.push_back( offset );
+		offset += *it;
+	}
+	result.push_back( offset );
+
+	return result;
+}
+
 struct MeshVertexToUniform
 {
 	typedef DataPtr ReturnType;
 
-	MeshVertexToUniform( const MeshPrimitive *mesh )	:	m_mesh( mesh )
+	MeshVertexToUniform( const MeshPrimitive *mesh )	:	m_mesh( mesh ), m_faceOffsets( faceOffsets( mesh ) )
 	{
 	}
 
@@ -63,37 +90,47 @@ struct MeshVertexToUniform
 		typename From::ValueType &trg = result->writable();
 		const typename From::ValueType &src = data->readable();
 
-		// TODO sipmlify this code by using polygon face & vertex iterators
-		trg.reserve( m_mesh->numFaces() );
+		trg.resize( m_mesh->numFaces() );
 
-		std::vector<int>::const_iterator vId = m_mesh->vertexIds()->readable().begin();
-		const std::vector<int> &verticesPerFace = m_mesh->verticesPerFace()->readable();
-		for( std::vector<int>::const_iterator it = verticesPerFace.begin(); it < verticesPerFace.end(); ++it )
-		{
-			// initialize with the first value to avoid
-			// ambiguitity during default construction
-			typename From::ValueType::value_type total = src[ *vId ];
-			++vId;
+		const std::vector<int> &vertexIds = m_mesh->vertexIds()->readable();
+		const std::vector<int> &faceOffsets = m_faceOffsets;
 
-			for( int j = 1; j < *it; ++j, ++vId )
+		tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, trg.size() ),
+			[&]( const tbb::blocked_range<size_t> &range )
 			{
-				total += src[ *vId ];
-			}
-
-			trg.push_back( total / *it );
-		}
+				for( size_t f = range.begin(); f != range.end(); ++f )
+				{
+					const int begin = faceOffsets[f];
+					const int end = faceOffsets[f+1];
+
+					// initialize with the first value to avoid
+					// ambiguitity during default construction
+					typename From::ValueType::value_type total = src[ vertexIds[begin] ];
+					for( int i = begin + 1; i < end; ++i )
+					{
+						total += src[ vertexIds[i] ];
+					}
+
+					trg[f] = total / ( end - begin );
+				}
+			},
+			taskGroupContext
+		);
 
 		return result;
 	}
 
 	const MeshPrimitive *m_mesh;
+	std::vector<int> m_faceOffsets;
 };
 
 struct MeshUniformToVertex
 {
 	typedef DataPtr ReturnType;
 
-	MeshUniformToVertex( const MeshPrimitive *mesh )	:	m_mesh( mesh )
+	MeshUniformToVertex( const MeshPrimitive *mesh )	:	m_topology( mesh->topology() )
 	{
 	}
 
@@ -103,40 +140,43 @@ struct MeshUniformToVertex
 		typename From::ValueType &trg = result->writable();
 		const typename From::ValueType &src = data->readable();
 
-		size_t numVerts = m_mesh->variableSize( PrimitiveVariable::Vertex );
-		std::vector<int> count( numVerts, 0 );
-		trg.resize( numVerts, typename From::ValueType::value_type( 0.0f ) );
+		trg.resize( m_topology->numVertices() );
 
-		typename From::ValueType::const_iterator srcIt = src.begin();
-		std::vector<int>::const_iterator vId = m_mesh->vertexIds()->readable().begin();
-		const std::vector<int> &verticesPerFace = m_mesh->verticesPerFace()->readable();
-		for( std::vector<int>::const_iterator it = verticesPerFace.begin(); it < verticesPerFace.end(); ++it, ++srcIt )
-		{
-			for( int j = 0; j < *it; ++j, ++vId )
-			{
-				trg[ *vId ] += *srcIt;
-				++count[ *vId ];
-			}
-		}
+		const std::vector<int> &vertexOffsets = m_topology->vertexOffsets();
+		const std::vector<int> &vertexFaces = m_topology->vertexFaces();
 
-		std::vector<int>::const_iterator cIt = count.begin();
-		typename From::ValueType::iterator trgIt = trg.begin(), trgEnd = trg.end();
-		for( trgIt = trg.begin(); trgIt != trgEnd ; ++trgIt, ++cIt )
-		{
-			*trgIt /= *cIt;
-		}
+		// Each vertex gathers from its faces in face order, so the result
+		// is independent of how the work is split between threads.
+		tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, trg.size() ),
+			[&]( const tbb::blocked_range<size_t> &range )
+			{
+				for( size_t v = range.begin(); v != range.end(); ++v )
+				{
+					typename From::ValueType::value_type total( 0.0f );
+					for( int i = vertexOffsets[v]; i < vertexOffsets[v+1]; ++i )
+					{
+						total += src[ vertexFaces[i] ];
+					}
+
+					trg[v] = total / ( vertexOffsets[v+1] - vertexOffsets[v] );
+				}
+			},
+			taskGroupContext
+		);
 
 		return result;
 	}
 
-	const MeshPrimitive *m_mesh;
+	ConstMeshTopologyPtr m_topology;
 };
 
 struct MeshFaceVaryingToVertex
 {
 	typedef DataPtr ReturnType;
 
-	MeshFaceVaryingToVertex( const MeshPrimitive *mesh )	:	m_mesh( mesh )
+	MeshFaceVaryingToVertex( const MeshPrimitive *mesh )	:	m_topology( mesh->topology() )
 	{
 	}
 
@@ -146,38 +186,41 @@ struct MeshFaceVaryingToVertex
 		typename From::ValueType &trg = result->writable();
 		const typename From::ValueType &src = data->readable();
 
-		size_t numVerts = m_mesh->variableSize( PrimitiveVariable::Vertex );
-		std::vector<int> count( numVerts, 0 );
-		trg.resize( numVerts, typename From::ValueType::value_type( 0.0f ) );
-
-		const std::vector<int>& vertexIds = m_mesh->vertexIds()->readable();
-		std::vector<int>::const_iterator vertexIdIt = vertexIds.begin();
-		typename From::ValueType::const_iterator srcIt = src.begin(), srcEnd = src.end();
+		trg.resize( m_topology->numVertices() );
 
-		for( ; srcIt != srcEnd ; ++srcIt, ++vertexIdIt )
-		{
-			trg[ *vertexIdIt ] += *srcIt;
-			++count[ *vertexIdIt ];
-		}
+		const std::vector<int> &vertexOffsets = m_topology->vertexOffsets();
+		const std::vector<int> &vertexFaceVertices = m_topology->vertexFaceVertices();
 
-		std::vector<int>::const_iterator cIt = count.begin();
-		typename From::ValueType::iterator trgIt = trg.begin(), trgEnd = trg.end();
-		for( trgIt = trg.begin(); trgIt != trgEnd ; ++trgIt, ++cIt )
-		{
-			*trgIt /= *cIt;
-		}
+		tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, trg.size() ),
+			[&]( const tbb::blocked_range<size_t> &range )
+			{
+				for( size_t v = range.begin(); v != range.end(); ++v )
+				{
+					typename From::ValueType::value_type total( 0.0f );
+					for( int i = vertexOffsets[v]; i < vertexOffsets[v+1]; ++i )
+					{
+						total += src[ vertexFaceVertices[i] ];
+					}
+
+					trg[v] = total / ( vertexOffsets[v+1] - vertexOffsets[v] );
+				}
+			},
+			taskGroupContext
+		);
 
 		return result;
 	}
 
-	const MeshPrimitive *m_mesh;
+	ConstMeshTopologyPtr m_topology;
 };
 
 struct MeshFaceVaryingToUniform
 {
 	typedef DataPtr ReturnType;
 
-	MeshFaceVaryingToUniform( const MeshPrimitive *mesh )	:	m_mesh( mesh )
+	MeshFaceVaryingToUniform( const MeshPrimitive *mesh )	:	m_faceOffsets( faceOffsets( mesh ) )
 	{
 	}
 
@@ -187,30 +230,38 @@ struct MeshFaceVaryingToUniform
 		typename From::ValueType &trg = result->writable();
 		const typename From::ValueType &src = data->readable();
 
-		trg.reserve( m_mesh->numFaces() );
+		trg.resize( m_faceOffsets.size() - 1 );
 
-		typename From::ValueType::const_iterator srcIt = src.begin();
-
-		const std::vector<int> &verticesPerFace = m_mesh->verticesPerFace()->readable();
-		for( std::vector<int>::const_iterator it = verticesPerFace.begin(); it < verticesPerFace.end(); ++it )
-		{
-			// initialize with the first value to avoid
-			// ambiguity during default construction
-			typename From::ValueType::value_type total = *srcIt;
-			++srcIt;
+		const std::vector<int> &faceOffsets = m_faceOffsets;
 
-			for( int j = 1; j < *it; ++j, ++srcIt )
+		tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, trg.size() ),
+			[&]( const tbb::blocked_range<size_t> &range )
 			{
-				total += *srcIt;
-			}
-
-			trg.push_back( total / *it );
-		}
+				for( size_t f = range.begin(); f != range.end(); ++f )
+				{
+					const int begin = faceOffsets[f];
+					const int end = faceOffsets[f+1];
+
+					// initialize with the first value to avoid
+					// ambiguity during default construction
+					typename From::ValueType::value_type total = src[begin];
+					for( int i = begin + 1; i < end; ++i )
+					{
+						total += src[i];
+					}
+
+					trg[f] = total / ( end - begin );
+				}
+			},
+			taskGroupContext
+		);
 
 		return result;
 	}
 
-	const MeshPrimitive *m_mesh;
+	std::vector<int> m_faceOffsets;
 };
 
 struct MeshAnythingToFaceVarying
@@ -33,6 +33,11 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "IECoreScene/MeshAlgo.h"
+#include "IECoreScene/MeshTopology.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task.h"
 
 using namespace Imath;
 using namespace IECore;
@@ -83,86 +88,102 @@ std::pair<PrimitiveVariable, PrimitiveVariable> IECoreScene::MeshAlgo::calculate
 
 	size_t numUVs = uvs.size();
 
-	std::vector<V3f> uTangents( numUVs, V3f( 0 ) );
-	std::vector<V3f> vTangents( numUVs, V3f( 0 ) );
-	std::vector<V3f> normals( numUVs, V3f( 0 ) );
-
-	for( size_t faceIndex = 0; faceIndex < vertsPerFace.size(); faceIndex++ )
+	// Each uv gathers the tangents from the faces that use it, visiting
+	// them in order. This lets us work in parallel, while giving the same
+	// result as a serial accumulation over the faces. We find the faces for
+	// each uv using the topology of the uv indices, which is cached in the
+	// same way as the topology of the mesh itself.
+	ConstMeshTopologyPtr uvTopology = mesh->topology();
+	if( uvIt->second.indices )
 	{
-		assert( vertsPerFace[faceIndex] == 3 );
-
-		// indices into the facevarying data for this face
-		size_t fvi0 = faceIndex * 3;
-		size_t fvi1 = fvi0 + 1;
-		size_t fvi2 = fvi1 + 1;
-		assert( fvi2 < vertIds.size() );
-		assert( fvi2 < uvIndices.size() );
-
-		// positions for each vertex of this face
-		const V3f &p0 = points[vertIds[fvi0]];
-		const V3f &p1 = points[vertIds[fvi1]];
-		const V3f &p2 = points[vertIds[fvi2]];
-
-		// uv coordinates for each vertex of this face
-		const V2f &uv0 = uvs[uvIndices[fvi0]];
-		const V2f &uv1 = uvs[uvIndices[fvi1]];
-		const V2f &uv2 = uvs[uvIndices[fvi2]];
-
-		// compute tangents and normal for this face
-		const V3f e0 = p1 - p0;
-		const V3f e1 = p2 - p0;
-
-		const V2f e0uv = uv1 - uv0;
-		const V2f e1uv = uv2 - uv0;
-
-		V3f tangent = ( e0 * -e1uv.y + e1 * e0uv.y ).normalized();
-		V3f bitangent = ( e0 * -e1uv.x + e1 * e0uv.x ).normalized();
-
-		V3f normal = ( p2 - p1 ).cross( p0 - p1 );
-		normal.normalize();
-
-		// and accumlate them into the computation so far
-		uTangents[uvIndices[fvi0]] += tangent;
-		uTangents[uvIndices[fvi1]] += tangent;
-		uTangents[uvIndices[fvi2]] += tangent;
-
-		vTangents[uvIndices[fvi0]] += bitangent;
-		vTangents[uvIndices[fvi1]] += bitangent;
-		vTangents[uvIndices[fvi2]] += bitangent;
-
-		normals[uvIndices[fvi0]] += normal;
-		normals[uvIndices[fvi1]] += normal;
-		normals[uvIndices[fvi2]] += normal;
-
+		MeshPrimitivePtr uvMesh = new MeshPrimitive( vertsPerFaceData->copy(), uvIt->second.indices->copy() );
+		uvTopology = uvMesh->topology();
 	}
 
-	// normalize and orthogonalize everything
-	for( size_t i = 0; i < uTangents.size(); i++ )
-	{
-		normals[i].normalize();
-
-		uTangents[i].normalize();
-		vTangents[i].normalize();
+	const std::vector<int> &uvOffsets = uvTopology->vertexOffsets();
+	const std::vector<int> &uvFaceVertices = uvTopology->vertexFaceVertices();
+	const size_t numReferencedUVs = std::min( numUVs, uvTopology->numVertices() );
 
-		// Make uTangent/vTangent orthogonal to normal
-		uTangents[i] -= normals[i] * uTangents[i].dot( normals[i] );
-		vTangents[i] -= normals[i] * vTangents[i].dot( normals[i] );
-
-		uTangents[i].normalize();
-		vTangents[i].normalize();
-
-		if( orthoTangents )
-		{
-			vTangents[i] -= uTangents[i] * vTangents[i].dot( uTangents[i] );
-			vTangents[i].normalize();
-		}
+	std::vector<V3f> uTangents( numUVs, V3f( 0 ) );
+	std::vector<V3f> vTangents( numUVs, V3f( 0 ) );
 
-		// Ensure we have set of basis vectors (n, uT, vT) with the correct handedness.
-		if( uTangents[i].cross( vTangents[i] ).dot( normals[i] ) < 0.0f )
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numReferencedUVs ),
+		[&]( const tbb::blocked_range<size_t> &range )
 		{
-			uTangents[i] *= -1.0f;
-		}
-	}
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				V3f uTangent( 0 );
+				V3f vTangent( 0 );
+				V3f normal( 0 );
+
+				for( int j = uvOffsets[i]; j < uvOffsets[i+1]; ++j )
+				{
+					const size_t faceIndex = uvFaceVertices[j] / 3;
+					assert( vertsPerFace[faceIndex] == 3 );
+
+					// indices into the facevarying data for this face
+					size_t fvi0 = faceIndex * 3;
+					size_t fvi1 = fvi0 + 1;
+					size_t fvi2 = fvi1 + 1;
+					assert( fvi2 < vertIds.size() );
+					assert( fvi2 < uvIndices.size() );
+
+					// positions for each vertex of this face
+					const V3f &p0 = points[vertIds[fvi0]];
+					const V3f &p1 = points[vertIds[fvi1]];
+					const V3f &p2 = points[vertIds[fvi2]];
+
+					// uv coordinates for each vertex of this face
+					const V2f &uv0 = uvs[uvIndices[fvi0]];
+					const V2f &uv1 = uvs[uvIndices[fvi1]];
+					const V2f &uv2 = uvs[uvIndices[fvi2]];
+
+					// compute tangents and normal for this face
+					const V3f e0 = p1 - p0;
+					const V3f e1 = p2 - p0;
+
+					const V2f e0uv = uv1 - uv0;
+					const V2f e1uv = uv2 - uv0;
+
+					// and accumulate them into the computation so far
+					uTangent += ( e0 * -e1uv.y + e1 * e0uv.y ).normalized();
+					vTangent += ( e0 * -e1uv.x + e1 * e0uv.x ).normalized();
+					normal += ( p2 - p1 ).cross( p0 - p1 ).normalized();
+				}
+
+				// normalize and orthogonalize everything
+				normal.normalize();
+
+				uTangent.normalize();
+				vTangent.normalize();
+
+				// Make uTangent/vTangent orthogonal to normal
+				uTangent -= normal * uTangent.dot( normal );
+				vTangent -= normal * vTangent.dot( normal );
+
+				uTangent.normalize();
+				vTangent.normalize();
+
+				if( orthoTangents )
+				{
+					vTangent -= uTangent * vTangent.dot( uTangent );
+					vTangent.normalize();
+				}
+
+				// Ensure we have set of basis vectors (n, uT, vT) with the correct handedness.
+				if( uTangent.cross( vTangent ).dot( normal ) < 0.0f )
+				{
+					uTangent *= -1.0f;
+				}
+
+				uTangents[i] = uTangent;
+				vTangents[i] = vTangent;
+			}
+		},
+		taskGroupContext
+	);
 
 	// convert the tangents back to facevarying data and add that to the mesh
 	V3fVectorDataPtr fvUD = new V3fVectorData();
@@ -173,11 +194,18 @@ std::pair<PrimitiveVariable, PrimitiveVariable> IECoreScene::MeshAlgo::calculate
 	fvU.resize( uvIndices.size() );
 	fvV.resize( uvIndices.size() );
 
-	for( unsigned i = 0; i < uvIndices.size(); i++ )
-	{
-		fvU[i] = uTangents[uvIndices[i]];
-		fvV[i] = vTangents[uvIndices[i]];
-	}
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, uvIndices.size() ),
+		[&]( const tbb::blocked_range<size_t> &range )
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				fvU[i] = uTangents[uvIndices[i]];
+				fvV[i] = vTangents[uvIndices[i]];
+			}
+		},
+		taskGroupContext
+	);
 
 	PrimitiveVariable tangentPrimVar( PrimitiveVariable::FaceVarying, fvUD );
 	PrimitiveVariable bitangentPrimVar( PrimitiveVariable::FaceVarying, fvVD );
@@ -0,0 +1,328 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "IECoreScene/MeshAlgo.h"
+
+#include "ExclusiveScan.h"
+#include "RemapData.h"
+
+#include "IECore/DespatchTypedData.h"
+#include "IECore/TriangleAlgo.h"
+
+#include "boost/format.hpp"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Imath;
+using namespace IECore;
+using namespace IECoreScene;
+
+//////////////////////////////////////////////////////////////////////////
+// Triangulate
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Fills `triangleOffsets` so that the triangles for face `f` are in the
+// range `[triangleOffsets[f], triangleOffsets[f+1])`.
+void computeTriangleOffsets( const std::vector<int> &verticesPerFace, std::vector<int> &triangleOffsets )
+{
+	Private::exclusiveScan(
+		verticesPerFace.size(),
+		[&]( size_t i ) { return std::max( verticesPerFace[i] - 2, 0 ); },
+		triangleOffsets
+	);
+}
+
+/// Throws if any of the faces are concave or non-planar.
+struct ValidateFaces
+{
+	typedef void ReturnType;
+
+	ValidateFaces( const MeshPrimitive *mesh, const std::vector<int> &faceOffsets, float tolerance )
+		:	m_mesh( mesh ), m_faceOffsets( faceOffsets ), m_tolerance( tolerance )
+	{
+	}
+
+	template<typename T>
+	ReturnType operator()( const T *p )
+	{
+		const std::vector<int> &verticesPerFace = m_mesh->verticesPerFace()->readable();
+
+		tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, verticesPerFace.size() ),
+			[&]( const tbb::blocked_range<size_t> &range )
+			{
+				for( size_t f = range.begin(); f != range.end(); ++f )
+				{
+					if( verticesPerFace[f] > 3 )
+					{
+						validateFace( p->readable(), m_faceOffsets[f], verticesPerFace[f] );
+					}
+				}
+			},
+			taskGroupContext
+		);
+	}
+
+	struct ErrorHandler
+	{
+		template<typename T, typename F>
+		void operator()( const T *data, const F &functor )
+		{
+			throw InvalidArgumentException( ( boost::format( "MeshAlgo::triangulate : Invalid data type \"%s\" for primitive variable \"P\"." ) % data->typeName() ).str() );
+		}
+	};
+
+	private :
+
+		template<typename Vec>
+		void validateFace( const std::vector<Vec> &pReadable, int faceVertexIdStart, int numFaceVerts ) const
+		{
+			const std::vector<int> &vertexIdsReadable = m_mesh->vertexIds()->readable();
+
+			const Vec &p0 = pReadable[ vertexIdsReadable[ faceVertexIdStart ] ];
+			const Vec firstTriangleNormal = triangleNormal( p0, pReadable[ vertexIdsReadable[ faceVertexIdStart + 1 ] ], pReadable[ vertexIdsReadable[ faceVertexIdStart + 2 ] ] );
+
+			/// Convexivity test - for each edge, all other vertices must be on the same "side" of it
+			for( int i = 0; i < numFaceVerts - 1; i++ )
+			{
+				const int edgeStart = vertexIdsReadable[ faceVertexIdStart + i ];
+				const int edgeEnd = vertexIdsReadable[ faceVertexIdStart + i + 1 ];
+
+				const Vec edge = pReadable[ edgeEnd ] - pReadable[ edgeStart ];
+				const float edgeLength = edge.length();
+
+				if( edgeLength > m_tolerance )
+				{
+					const Vec edgeDirection = edge / edgeLength;
+
+					/// Construct a plane whose normal is perpendicular to both the edge and the polygon's normal
+					const Vec planeNormal = edgeDirection.cross( firstTriangleNormal );
+					const float planeConstant = planeNormal.dot( pReadable[ edgeStart ] );
+
+					int sign = 0;
+					bool first = true;
+					for( int j = 0; j < numFaceVerts; j++ )
+					{
+						const int testVertex = vertexIdsReadable[ faceVertexIdStart + j ];
+
+						if( testVertex != edgeStart && testVertex != edgeEnd )
+						{
+							float signedDistance = planeNormal.dot( pReadable[ testVertex ] ) - planeConstant;
+
+							if( fabs( signedDistance ) > m_tolerance )
+							{
+								int thisSign = 1;
+								if( signedDistance < 0.0 )
+								{
+									thisSign = -1;
+								}
+								if( first )
+								{
+									sign = thisSign;
+									first = false;
+								}
+								else if( thisSign != sign )
+								{
+									assert( sign != 0 );
+									throw InvalidArgumentException( "MeshAlgo::triangulate : Cannot deal with concave polygons" );
+								}
+							}
+						}
+					}
+				}
+			}
+
+			/// Planarity test - each triangle of the fan must face the same way as the first
+			for( int i = 2; i < numFaceVerts - 1; i++ )
+			{
+				const Vec &p1 = pReadable[ vertexIdsReadable[ faceVertexIdStart + i ] ];
+				const Vec &p2 = pReadable[ vertexIdsReadable[ faceVertexIdStart + i + 1 ] ];
+				if( fabs( triangleNormal( p0, p1, p2 ).dot( firstTriangleNormal ) - 1.0 ) > m_tolerance )
+				{
+					throw InvalidArgumentException( "MeshAlgo::triangulate : Cannot deal with non-planar polygons" );
+				}
+			}
+		}
+
+		const MeshPrimitive *m_mesh;
+		const std::vector<int> &m_faceOffsets;
+		float m_tolerance;
+
+};
+
+} // namespace
+
+MeshPrimitivePtr IECoreScene::MeshAlgo::triangulate( const MeshPrimitive *mesh, bool throwExceptions, float tolerance )
+{
+	if( !mesh->arePrimitiveVariablesValid() )
+	{
+		throw InvalidArgumentException( "MeshAlgo::triangulate : Mesh has invalid primitive variables" );
+	}
+
+	MeshPrimitivePtr result = mesh->copy();
+	if( mesh->maxVerticesPerFace() == 3 )
+	{
+		// already triangulated
+		return result;
+	}
+
+	const std::vector<int> &verticesPerFace = mesh->verticesPerFace()->readable();
+	const std::vector<int> &vertexIds = mesh->vertexIds()->readable();
+	const size_t numFaces = verticesPerFace.size();
+
+	// Compute the offsets of the face-vertices and triangles for each face,
+	// so that each face can be triangulated independently.
+
+	std::vector<int> faceOffsets;
+	Private::exclusiveScan( numFaces, [&]( size_t i ) { return verticesPerFace[i]; }, faceOffsets );
+
+	std::vector<int> triangleOffsets;
+	computeTriangleOffsets( verticesPerFace, triangleOffsets );
+	const size_t numTriangles = triangleOffsets.back();
+
+	if( throwExceptions )
+	{
+		PrimitiveVariableMap::const_iterator pIt = mesh->variables.find( "P" );
+		if( pIt == mesh->variables.end() )
+		{
+			throw InvalidArgumentException( "MeshAlgo::triangulate : MeshPrimitive has no \"P\" primitive variable" );
+		}
+
+		ValidateFaces validateFaces( mesh, faceOffsets, tolerance );
+		despatchTypedData<ValidateFaces, TypeTraits::IsFloatVec3VectorTypedData, ValidateFaces::ErrorHandler>( pIt->second.data.get(), validateFaces );
+	}
+
+	// Triangulate each face with a simple fan. Alongside the new topology we
+	// record the original face-vertex for each triangle vertex and the original
+	// face for each triangle, so we can remap the primitive variables.
+
+	IntVectorDataPtr newVerticesPerFaceData = new IntVectorData;
+	newVerticesPerFaceData->writable().resize( numTriangles, 3 );
+	IntVectorDataPtr newVertexIdsData = new IntVectorData;
+	std::vector<int> &newVertexIds = newVertexIdsData->writable();
+	newVertexIds.resize( numTriangles * 3 );
+	std::vector<int> faceVaryingIndices( numTriangles * 3 );
+	std::vector<int> uniformIndices( numTriangles );
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numFaces ),
+		[&]( const tbb::blocked_range<size_t> &range )
+		{
+			for( size_t f = range.begin(); f != range.end(); ++f )
+			{
+				const int i0 = faceOffsets[f];
+				int t = triangleOffsets[f];
+				for( int i = 1; i < verticesPerFace[f] - 1; ++i, ++t )
+				{
+					faceVaryingIndices[t*3] = i0;
+					faceVaryingIndices[t*3+1] = i0 + i;
+					faceVaryingIndices[t*3+2] = i0 + i + 1;
+					newVertexIds[t*3] = vertexIds[i0];
+					newVertexIds[t*3+1] = vertexIds[i0 + i];
+					newVertexIds[t*3+2] = vertexIds[i0 + i + 1];
+					uniformIndices[t] = f;
+				}
+			}
+		},
+		taskGroupContext
+	);
+
+	result->setTopology( newVerticesPerFaceData, newVertexIdsData, mesh->interpolation() );
+
+	// Remap the FaceVarying and Uniform primitive variables. Indexed
+	// variables remain indexed, and only their indices are remapped.
+
+	Private::RemapData faceVaryingRemap( faceVaryingIndices );
+	Private::RemapData uniformRemap( uniformIndices );
+	for( PrimitiveVariableMap::iterator it = result->variables.begin(); it != result->variables.end(); ++it )
+	{
+		Private::RemapData *remap = nullptr;
+		if( it->second.interpolation == PrimitiveVariable::FaceVarying )
+		{
+			remap = &faceVaryingRemap;
+		}
+		else if( it->second.interpolation == PrimitiveVariable::Uniform )
+		{
+			remap = &uniformRemap;
+		}
+		else
+		{
+			continue;
+		}
+
+		Private::remapPrimitiveVariable( it->second, *remap );
+	}
+
+	assert( result->arePrimitiveVariablesValid() );
+
+	return result;
+}
+
+IntVectorDataPtr IECoreScene::MeshAlgo::triangulatedFaces( const MeshPrimitive *mesh )
+{
+	const std::vector<int> &verticesPerFace = mesh->verticesPerFace()->readable();
+
+	std::vector<int> triangleOffsets;
+	computeTriangleOffsets( verticesPerFace, triangleOffsets );
+
+	IntVectorDataPtr resultData = new IntVectorData;
+	std::vector<int> &result = resultData->writable();
+	result.resize( triangleOffsets.back() );
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, verticesPerFace.size() ),
+		[&]( const tbb::blocked_range<size_t> &range )
+		{
+			for( size_t f = range.begin(); f != range.end(); ++f )
+			{
+				std::fill( result.begin() + triangleOffsets[f], result.begin() + triangleOffsets[f+1], f );
+			}
+		},
+		taskGroupContext
+	);
+
+	return resultData;
+}
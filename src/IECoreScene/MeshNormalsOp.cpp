@@ -34,8 +34,9 @@
 
 #include "IECoreScene/MeshNormalsOp.h"
 
+#include "IECoreScene/MeshAlgo.h"
+
 #include "IECore/CompoundParameter.h"
-#include "IECore/DespatchTypedData.h"
 
 #include "boost/format.hpp"
 
@@ -64,6 +65,7 @@ MeshNormalsOp::MeshNormalsOp() : MeshPrimitiveOp( "Calculates vertex normals for
 	IntParameter::PresetsContainer interpolationPresets;
 	interpolationPresets.push_back( IntParameter::Preset( "Vertex", PrimitiveVariable::Vertex ) );
 	interpolationPresets.push_back( IntParameter::Preset( "Uniform", PrimitiveVariable::Uniform ) );
+	interpolationPresets.push_back( IntParameter::Preset( "FaceVarying", PrimitiveVariable::FaceVarying ) );
 	IntParameterPtr interpolationParameter;
 	interpolationParameter = new IntParameter(
 		"interpolation",
@@ -72,9 +74,21 @@ MeshNormalsOp::MeshNormalsOp() : MeshPrimitiveOp( "Calculates vertex normals for
 		interpolationPresets
 	);
 
+	IntParameter::PresetsContainer weightingPresets;
+	weightingPresets.push_back( IntParameter::Preset( "Equal", MeshAlgo::EqualWeighting ) );
+	weightingPresets.push_back( IntParameter::Preset( "Angle", MeshAlgo::AngleWeighting ) );
+	weightingPresets.push_back( IntParameter::Preset( "Area", MeshAlgo::AreaWeighting ) );
+	IntParameterPtr weightingParameter = new IntParameter(
+		"weighting",
+		"How the face normals are weighted when calculating Vertex normals.",
+		MeshAlgo::EqualWeighting,
+		weightingPresets
+	);
+
 	parameters()->addParameter( pPrimVarNameParameter );
 	parameters()->addParameter( nPrimVarNameParameter );
 	parameters()->addParameter( interpolationParameter );
+	parameters()->addParameter( weightingParameter );
 }
 
 MeshNormalsOp::~MeshNormalsOp()
@@ -111,97 +125,15 @@ const IntParameter * MeshNormalsOp::interpolationParameter() const
 	return parameters()->parameter<IntParameter>( "interpolation" );
 }
 
-struct MeshNormalsOp::CalculateNormals
+IntParameter * MeshNormalsOp::weightingParameter()
 {
-	typedef DataPtr ReturnType;
-
-	CalculateNormals( const IntVectorData *vertsPerFace, const IntVectorData *vertIds, PrimitiveVariable::Interpolation interpolation )
-		:	m_vertsPerFace( vertsPerFace ), m_vertIds( vertIds ), m_interpolation( interpolation )
-	{
-	}
-
-	template<typename T>
-	ReturnType operator()( T * data )
-	{
-		typedef typename T::ValueType VecContainer;
-		typedef typename VecContainer::value_type Vec;
-
-		const typename T::ValueType &points = data->readable();
-		const vector<int> &vertsPerFace = m_vertsPerFace->readable();
-		const vector<int> &vertIds = m_vertIds->readable();
-
-		typename T::Ptr normalsData = new T;
-		normalsData->setInterpretation( GeometricData::Normal );
-		VecContainer &normals = normalsData->writable();
-		if( m_interpolation == PrimitiveVariable::Uniform )
-		{
-			normals.reserve( vertsPerFace.size() );
-		}
-		else
-		{
-			normals.resize( points.size(), Vec( 0 ) );
-		}
-
-		// loop over the faces
-		const int *vertId = &(vertIds[0]);
-		for( vector<int>::const_iterator it = vertsPerFace.begin(); it!=vertsPerFace.end(); it++ )
-		{
-			// calculate the face normal. note that this method is very naive, and doesn't
-			// cope with colinear vertices or concave faces - we could use polygonNormal() from
-			// PolygonAlgo.h to deal with that, but currently we'd prefer to avoid the overhead.
-			const Vec &p0 = points[*vertId];
-			const Vec &p1 = points[*(vertId+1)];
-			const Vec &p2 = points[*(vertId+2)];
-
-			Vec normal = (p2-p1).cross(p0-p1);
-			normal.normalize();
-
-			if( m_interpolation == PrimitiveVariable::Uniform )
-			{
-				normals.push_back( normal );
-				vertId += *it;
-			}
-			else
-			{
-				// accumulate the face normal onto each of the vertices
-				// for this face.
-				for( int i=0; i<*it; ++i )
-				{
-					normals[*vertId] += normal;
-					++vertId;
-				}
-			}
-		}
-
-		// normalize each of the vertex normals
-		if( m_interpolation == PrimitiveVariable::Vertex )
-		{
-			for( typename VecContainer::iterator it=normals.begin(), eIt=normals.end(); it != eIt; ++it )
-			{
-				it->normalize();
-			}
-		}
-
-		return normalsData;
-	}
-
-	private :
-
-		ConstIntVectorDataPtr m_vertsPerFace;
-		ConstIntVectorDataPtr m_vertIds;
-		PrimitiveVariable::Interpolation m_interpolation;
-
-};
+	return parameters()->parameter<IntParameter>( "weighting" );
+}
 
-struct MeshNormalsOp::HandleErrors
+const IntParameter * MeshNormalsOp::weightingParameter() const
 {
-	template<typename T, typename F>
-	void operator()( const T *d, const F &f )
-	{
-		string e = boost::str( boost::format( "MeshNormalsOp : pPrimVarName parameter has unsupported data type \"%s\"." ) % d->typeName() );
-		throw InvalidArgumentException( e );
-	}
-};
+	return parameters()->parameter<IntParameter>( "weighting" );
+}
 
 void MeshNormalsOp::modifyTypedPrimitive( MeshPrimitive * mesh, const CompoundObject * operands )
 {
@@ -220,9 +152,18 @@ void MeshNormalsOp::modifyTypedPrimitive( MeshPrimitive * mesh, const CompoundOb
 	}
 
 	const PrimitiveVariable::Interpolation interpolation = static_cast<PrimitiveVariable::Interpolation>( operands->member<IntData>( "interpolation" )->readable() );
+	const MeshAlgo::NormalWeighting weighting = static_cast<MeshAlgo::NormalWeighting>( operands->member<IntData>( "weighting" )->readable() );
+
+	// Write into any existing normals, so that recalculating normals for
+	// a deforming mesh needn't reallocate them. They are only reused if
+	// the mesh holds the sole reference to them.
+	const std::string &nPrimVarName = nPrimVarNameParameter()->getTypedValue();
+	Data *destination = nullptr;
+	PrimitiveVariableMap::const_iterator nIt = mesh->variables.find( nPrimVarName );
+	if( nIt != mesh->variables.end() && nIt->second.interpolation == interpolation && !nIt->second.indices )
+	{
+		destination = nIt->second.data.get();
+	}
 
-	CalculateNormals f( mesh->verticesPerFace(), mesh->vertexIds(), interpolation );
-	DataPtr n = despatchTypedData<CalculateNormals, TypeTraits::IsVec3VectorTypedData, HandleErrors>( pvIt->second.data.get(), f );
-
-	mesh->variables[ nPrimVarNameParameter()->getTypedValue() ] = PrimitiveVariable( interpolation, n );
+	mesh->variables[nPrimVarName] = MeshAlgo::calculateNormals( mesh, interpolation, weighting, pPrimVarName, destination );
 }
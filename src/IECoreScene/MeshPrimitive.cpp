@@ -34,11 +34,13 @@
 
 #include "IECoreScene/MeshPrimitive.h"
 
+#include "IECoreScene/MeshTopology.h"
 #include "IECoreScene/PolygonIterator.h"
 #include "IECoreScene/Renderer.h"
 
 #include "IECore/Math.h"
 #include "IECore/MurmurHash.h"
+#include "IECore/ObjectPool.h"
 
 #include <algorithm>
 #include <numeric>
@@ -57,6 +59,21 @@ static IndexedIO::EntryID g_interpolationEntry("interpolation");
 const unsigned int MeshPrimitive::m_ioVersion = 0;
 IE_CORE_DEFINEOBJECTTYPEDESCRIPTION(MeshPrimitive);
 
+static void deduplicateTopology( Object *object, const ObjectPool::ChildFn &childFn )
+{
+	// The topology is already known to be valid, so we can
+	// avoid the checks made by setTopology().
+	MeshPrimitive *mesh = static_cast<MeshPrimitive *>( object );
+	mesh->setTopologyUnchecked(
+		boost::static_pointer_cast<IntVectorData>( childFn( mesh->verticesPerFace() ) ),
+		boost::static_pointer_cast<IntVectorData>( childFn( mesh->vertexIds() ) ),
+		mesh->variableSize( PrimitiveVariable::Vertex ),
+		mesh->interpolation()
+	);
+}
+
+static bool g_deduplicateRegistration = ObjectPool::registerDeduplicateFn( MeshPrimitiveTypeId, deduplicateTopology );
+
 MeshPrimitive::MeshPrimitive()
 	: m_verticesPerFace( new IntVectorData ), m_vertexIds( new IntVectorData ), m_numVertices( 0 ), m_interpolation( "linear" ), m_minVerticesPerFace(0), m_maxVerticesPerFace(0)
 {
@@ -195,6 +212,11 @@ PolygonIterator MeshPrimitive::faceEnd()
 	return PolygonIterator( m_verticesPerFace->readable().end(), m_vertexIds->readable().end(), m_vertexIds->readable().size() );
 }
 
+ConstMeshTopologyPtr MeshPrimitive::topology() const
+{
+	return MeshTopology::cachedTopology( this );
+}
+
 size_t MeshPrimitive::variableSize( PrimitiveVariable::Interpolation interpolation ) const
 {
 	switch(interpolation)
@@ -34,6 +34,8 @@
 
 #include "IECoreScene/MeshPrimitiveEvaluator.h"
 
+#include "TriangleBVH.h"
+
 #include "IECoreScene/PrimitiveVariable.h"
 
 #include "IECore/BoxOps.h"
@@ -49,6 +51,10 @@ IECORE_POP_DEFAULT_VISIBILITY
 #include "OpenEXR/ImathBoxAlgo.h"
 #include "OpenEXR/ImathLineAlgo.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task.h"
+
 #include <cassert>
 
 using namespace IECore;
@@ -217,7 +223,7 @@ const V3i &MeshPrimitiveEvaluator::Result::vertexIds() const
 	return m_vertexIds;
 }
 
-MeshPrimitiveEvaluator::MeshPrimitiveEvaluator( ConstMeshPrimitivePtr mesh ) : m_uvTree(nullptr), m_haveMassProperties( false ), m_haveSurfaceArea( false ), m_haveAverageNormals( false )
+MeshPrimitiveEvaluator::MeshPrimitiveEvaluator( ConstMeshPrimitivePtr mesh, Accelerator accelerator ) : m_tree(nullptr), m_bvh(nullptr), m_uvTree(nullptr), m_haveMassProperties( false ), m_haveSurfaceArea( false ), m_haveAverageNormals( false )
 {
 	if (! mesh )
 	{
@@ -300,7 +306,14 @@ MeshPrimitiveEvaluator::MeshPrimitiveEvaluator( ConstMeshPrimitivePtr mesh ) : m
 		}
 	}
 
-	m_tree = new TriangleBoundTree( m_triangles.begin(), m_triangles.end() );
+	if( accelerator == BVHAccelerator )
+	{
+		m_bvh = new Private::TriangleBVH( m_verts->readable(), *m_meshVertexIds, m_triangles );
+	}
+	else
+	{
+		m_tree = new TriangleBoundTree( m_triangles.begin(), m_triangles.end() );
+	}
 
 	if( m_uv.interpolation != PrimitiveVariable::Invalid )
 	{
@@ -322,11 +335,14 @@ PrimitiveEvaluatorPtr MeshPrimitiveEvaluator::create( ConstPrimitivePtr primitiv
 
 MeshPrimitiveEvaluator::~MeshPrimitiveEvaluator()
 {
-	assert( m_tree );
+	assert( m_tree || m_bvh );
 
 	delete m_tree;
 	m_tree = nullptr;
 
+	delete m_bvh;
+	m_bvh = nullptr;
+
 	delete m_uvTree;
 	m_uvTree = nullptr;
 }
@@ -496,158 +512,123 @@ void MeshPrimitiveEvaluator::calculateAverageNormals() const
 	}
 #endif
 
-	/// Build vertex connectivity. We want to be able to quickly find the list of triangles connected to each vertex.
-	typedef std::map< VertexIndex, std::set<TriangleIndex> > VertexConnectivity;
-	VertexConnectivity vertexConnectivity;
-
-	IntVectorData::ValueType::const_iterator it = m_meshVertexIds->begin();
-	int triangleIndex = 0;
-	while ( it != m_meshVertexIds->end() )
+	/// The shared topology gives us the triangles connected to each vertex and to each edge.
+	m_topology = m_mesh->topology();
+	const std::vector<int> &vertexOffsets = m_topology->vertexOffsets();
+	const std::vector<int> &vertexFaces = m_topology->vertexFaces();
+	const std::vector<int> &edgeOffsets = m_topology->edgeOffsets();
+	const std::vector<int> &edgeFaces = m_topology->edgeFaces();
+	const std::vector<V3f> &verts = m_verts->readable();
+	const std::vector<int> &vertexIds = *m_meshVertexIds;
+
+	/// Validate the edge connectivity before doing any further work.
+	const size_t numEdges = m_topology->numEdges();
+	for( size_t edgeIndex = 0; edgeIndex < numEdges; ++edgeIndex )
 	{
-		VertexIndex v0 = *it ++;
-		VertexIndex v1 = *it ++;
-		VertexIndex v2 = *it ++;
-
-		vertexConnectivity[ v0 ].insert( triangleIndex );
-		vertexConnectivity[ v1 ].insert( triangleIndex );
-		vertexConnectivity[ v2 ].insert( triangleIndex );
-
-		triangleIndex++;
+		const int numEdgeFaces = edgeOffsets[edgeIndex+1] - edgeOffsets[edgeIndex];
+		if( numEdgeFaces > 2 )
+		{
+			/// If there are more than 2 faces connected to any given edge then the mesh is non-manifold, which results in an exception.
+			throw Exception("Non-manifold mesh given to MeshPrimitiveImplicitSurfaceFunction");
+		}
+		else if( numEdgeFaces == 1 )
+		{
+			/// If there are less than 2 faces connected to any given edge then the mesh is not closed, which results in an exception.
+			throw Exception("Mesh given to MeshPrimitiveImplicitSurfaceFunction is not closed");
+		}
 	}
 
-	assert( triangleIndex == (int)(verticesPerFace->readable().size()) );
-
 	/// Calculate "Angle-weighted pseudo-normal" for each vertex. A description of this, and proof of its validity for use in signed distance functions
 	/// can be found here: www.ann.jussieu.fr/~frey/papiers/PsNormTVCG.pdf
 	m_vertexAngleWeightedNormals = new V3fVectorData( );
-	m_vertexAngleWeightedNormals->writable().reserve( m_verts->readable().size() );
+	std::vector<V3f> &vertexNormals = m_vertexAngleWeightedNormals->writable();
+	vertexNormals.resize( verts.size(), V3f( 0 ) );
 
-	int numVertices = m_verts->readable().size();
+	const int numVertices = std::min( verts.size(), m_topology->numVertices() );
 
-	for ( VertexIndex vertexIndex = 0; vertexIndex < numVertices; vertexIndex++)
-	{
-		Imath::V3f n( 0.0, 0.0, 0.0 );
-
-		const std::set<TriangleIndex> &connectedTriangles = vertexConnectivity[ vertexIndex ];
-
-		double angleTotal = 0.0;
-		for (std::set<TriangleIndex>::const_iterator faceIt = connectedTriangles.begin(); faceIt != connectedTriangles.end(); ++faceIt)
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<int>( 0, numVertices ),
+		[&]( const tbb::blocked_range<int> &range )
 		{
-
-			/// Find the vertices associated with this triangle
-			VertexIndex v0 = (*m_meshVertexIds)[ (*faceIt) * 3 + 0 ];
-			assert( vertexConnectivity[ v0 ].find( *faceIt ) != vertexConnectivity[ v0 ].end() );
-
-			VertexIndex v1 = (*m_meshVertexIds)[ (*faceIt) * 3 + 1 ];
-			assert( vertexConnectivity[ v1 ].find( *faceIt ) != vertexConnectivity[ v1 ].end() );
-
-			VertexIndex v2 = (*m_meshVertexIds)[ (*faceIt) * 3 + 2 ];
-			assert( vertexConnectivity[ v2 ].find( *faceIt ) != vertexConnectivity[ v2 ].end() );
-
-			/// Find the two edges that go from the current vertex (i) to the other	two triangle vertices
-			Imath::V3f e0, e1;
-			if ( v2 == vertexIndex )
-			{
-				e0 = (m_verts->readable()[ v1 ] - m_verts->readable()[ v2 ]).normalized();
-				e1 = (m_verts->readable()[ v0 ] - m_verts->readable()[ v2 ]).normalized();
-			}
-			else if ( v1 == vertexIndex )
-			{
-				e0 = (m_verts->readable()[ v2 ] - m_verts->readable()[ v1 ]).normalized();
-				e1 = (m_verts->readable()[ v0 ] - m_verts->readable()[ v1 ]).normalized();
-			}
-			else
+			for( VertexIndex vertexIndex = range.begin(); vertexIndex != range.end(); ++vertexIndex )
 			{
-				assert( v0 == vertexIndex );
+				Imath::V3f n( 0.0, 0.0, 0.0 );
 
-				e0 = (m_verts->readable()[ v1 ] - m_verts->readable()[ v0 ]).normalized();
-				e1 = (m_verts->readable()[ v2 ] - m_verts->readable()[ v0 ]).normalized();
-			}
-
-			double cosAngle = e0.dot( e1 );
-			double angle = acos( cosAngle );
-			assert( angle >= -Imath::limits<double>::epsilon() );
-			angleTotal += angle;
-
-			const Imath::V3f &p0 = m_verts->readable()[ v0 ];
-			const Imath::V3f &p1 = m_verts->readable()[ v1 ];
-			const Imath::V3f &p2 = m_verts->readable()[ v2 ];
-			n += triangleNormal( p0, p1, p2 ) * angle;
-		}
-
-		n.normalize();
-
-		assert(m_vertexAngleWeightedNormals);
-
-		m_vertexAngleWeightedNormals->writable().push_back( n );
-	}
-
-	assert( m_vertexAngleWeightedNormals->readable().size() == m_verts->readable().size()  );
-
-	/// Calculate edge connectivity. For any given pair of (connected) vertices we want to be able to find the faces connected to that edge.
-	typedef std::map<Edge, std::vector<int> > EdgeConnectivity;
+				for( int i = vertexOffsets[vertexIndex]; i < vertexOffsets[vertexIndex+1]; ++i )
+				{
+					/// The faces for each vertex are sorted, and a triangle which uses the
+					/// vertex more than once must only contribute once.
+					const TriangleIndex triangleIndex = vertexFaces[i];
+					if( i > vertexOffsets[vertexIndex] && vertexFaces[i-1] == triangleIndex )
+					{
+						continue;
+					}
 
-	EdgeConnectivity edgeConnectivity;
+					/// Find the vertices associated with this triangle
+					VertexIndex v0 = vertexIds[ triangleIndex * 3 + 0 ];
+					VertexIndex v1 = vertexIds[ triangleIndex * 3 + 1 ];
+					VertexIndex v2 = vertexIds[ triangleIndex * 3 + 2 ];
 
-	it = m_meshVertexIds->begin();
-	triangleIndex = 0;
-	while ( it != m_meshVertexIds->end() )
-	{
-		VertexIndex v0 = *it ++;
-		VertexIndex v1 = *it ++;
-		VertexIndex v2 = *it ++;
+					/// Find the two edges that go from the current vertex (i) to the other	two triangle vertices
+					Imath::V3f e0, e1;
+					if ( v2 == vertexIndex )
+					{
+						e0 = (verts[ v1 ] - verts[ v2 ]).normalized();
+						e1 = (verts[ v0 ] - verts[ v2 ]).normalized();
+					}
+					else if ( v1 == vertexIndex )
+					{
+						e0 = (verts[ v2 ] - verts[ v1 ]).normalized();
+						e1 = (verts[ v0 ] - verts[ v1 ]).normalized();
+					}
+					else
+					{
+						assert( v0 == vertexIndex );
 
-		edgeConnectivity[ Edge(v0, v1) ].push_back( triangleIndex );
-		edgeConnectivity[ Edge(v0, v2) ].push_back( triangleIndex );
-		edgeConnectivity[ Edge(v1, v2) ].push_back( triangleIndex );
+						e0 = (verts[ v1 ] - verts[ v0 ]).normalized();
+						e1 = (verts[ v2 ] - verts[ v0 ]).normalized();
+					}
 
-		/// Store the same edges going in the opposite direction, too. This doubles our (small) storage overhead but allows for faster lookups.
-		edgeConnectivity[ Edge(v1, v0) ].push_back( triangleIndex );
-		edgeConnectivity[ Edge(v2, v0) ].push_back( triangleIndex );
-		edgeConnectivity[ Edge(v2, v1) ].push_back( triangleIndex );
+					double cosAngle = e0.dot( e1 );
+					double angle = acos( cosAngle );
+					assert( angle >= -Imath::limits<double>::epsilon() );
 
-		triangleIndex ++;
-	}
+					n += triangleNormal( verts[ v0 ], verts[ v1 ], verts[ v2 ] ) * angle;
+				}
 
-	/// Calculate the average edge normals
-	for (EdgeConnectivity::const_iterator it = edgeConnectivity.begin(); it != edgeConnectivity.end(); ++it)
-	{
-		if (it->second.size() > 2)
-		{
-			/// If there are more than 2 faces connected to any given edge then the mesh is non-manifold, which results in an exception.
-			throw Exception("Non-manifold mesh given to MeshPrimitiveImplicitSurfaceFunction");
-		}
-		else if (it->second.size() == 1)
-		{
-			/// If there are less than 2 faces connected to any given edge then the mesh is not closed, which results in an exception.
-			throw Exception("Mesh given to MeshPrimitiveImplicitSurfaceFunction is not closed");
-		}
-		else
+				n.normalize();
+				vertexNormals[vertexIndex] = n;
+			}
+		},
+		taskGroupContext
+	);
+
+	/// Calculate the average edge normals, indexed in the same way as the edges of the topology.
+	m_edgeAverageNormals.resize( numEdges );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numEdges ),
+		[&]( const tbb::blocked_range<size_t> &range )
 		{
-			assert( it->second.size() == 2 );
-		}
-
-		TriangleIndex triangle0 = it->second[0];
-		TriangleIndex triangle1 = it->second[1];
-
-		VertexIndex v00 = (*m_meshVertexIds)[ triangle0 * 3 + 0 ];
-		VertexIndex v01 = (*m_meshVertexIds)[ triangle0 * 3 + 1 ];
-		VertexIndex v02 = (*m_meshVertexIds)[ triangle0 * 3 + 2 ];
-
-		VertexIndex v10 = (*m_meshVertexIds)[ triangle1 * 3 + 0 ];
-		VertexIndex v11 = (*m_meshVertexIds)[ triangle1 * 3 + 1 ];
-		VertexIndex v12 = (*m_meshVertexIds)[ triangle1 * 3 + 2 ];
+			for( size_t edgeIndex = range.begin(); edgeIndex != range.end(); ++edgeIndex )
+			{
+				assert( edgeOffsets[edgeIndex+1] - edgeOffsets[edgeIndex] == 2 );
+				const TriangleIndex triangle0 = edgeFaces[ edgeOffsets[edgeIndex] ];
+				const TriangleIndex triangle1 = edgeFaces[ edgeOffsets[edgeIndex] + 1 ];
 
-		const Imath::V3f &p00 = m_verts->readable()[ v00 ];
-		const Imath::V3f &p01 = m_verts->readable()[ v01 ];
-		const Imath::V3f &p02 = m_verts->readable()[ v02 ];
+				const Imath::V3f &p00 = verts[ vertexIds[ triangle0 * 3 + 0 ] ];
+				const Imath::V3f &p01 = verts[ vertexIds[ triangle0 * 3 + 1 ] ];
+				const Imath::V3f &p02 = verts[ vertexIds[ triangle0 * 3 + 2 ] ];
 
-		const Imath::V3f &p10 = m_verts->readable()[ v10 ];
-		const Imath::V3f &p11 = m_verts->readable()[ v11 ];
-		const Imath::V3f &p12 = m_verts->readable()[ v12 ];
+				const Imath::V3f &p10 = verts[ vertexIds[ triangle1 * 3 + 0 ] ];
+				const Imath::V3f &p11 = verts[ vertexIds[ triangle1 * 3 + 1 ] ];
+				const Imath::V3f &p12 = verts[ vertexIds[ triangle1 * 3 + 2 ] ];
 
-		m_edgeAverageNormals[ it->first ] = ( triangleNormal( p00, p01, p02 ) + triangleNormal( p10, p11, p12 ) ) / 2.0f;
-	}
+				m_edgeAverageNormals[edgeIndex] = ( triangleNormal( p00, p01, p02 ) + triangleNormal( p10, p11, p12 ) ) / 2.0f;
+			}
+		},
+		taskGroupContext
+	);
 
 	m_haveAverageNormals = true;
 }
@@ -687,27 +668,25 @@ bool MeshPrimitiveEvaluator::signedDistance( const Imath::V3f &p, float &distanc
 		{
 			// Closest feature is an edge, so we need to use the average normal of the adjoining triangles
 
-			const V3i &triangleVertexIds = r->vertexIds();
-			Edge edge;
-
+			/// Edge `k` of the triangle runs from vertex `k` to vertex `k + 1`.
+			int triangleEdge = 0;
 			if ( region == 1 )
 			{
-				edge = Edge( triangleVertexIds[1], triangleVertexIds[2] );
+				triangleEdge = 1;
 			}
 			else if ( region == 3 )
 			{
-				edge = Edge( triangleVertexIds[0], triangleVertexIds[2] );
+				triangleEdge = 2;
 			}
 			else
 			{
 				assert( region == 5 );
-				edge = Edge( triangleVertexIds[0], triangleVertexIds[1] );
 			}
 
-			EdgeAverageNormals::const_iterator it = m_edgeAverageNormals.find( edge );
-			assert (it != m_edgeAverageNormals.end() );
+			const int edgeIndex = m_topology->faceVertexEdges()[ r->triangleIndex() * 3 + triangleEdge ];
+			assert( edgeIndex < (int)m_edgeAverageNormals.size() );
 
-			const Imath::V3f &n = it->second;
+			const Imath::V3f &n = m_edgeAverageNormals[edgeIndex];
 			float planeConstant = n.dot( r->point() );
 			float sign = n.dot( p ) - planeConstant;
 			distance = (r->point() - p ).length() * (sign < Imath::limits<float>::epsilon() ? -1.0 : 1.0 );
@@ -772,12 +751,25 @@ bool MeshPrimitiveEvaluator::closestPoint( const V3f &p, PrimitiveEvaluator::Res
 		return false;
 	}
 
-	assert( m_tree );
-
 	Result *mr = static_cast<Result *>( result );
 
 	float maxDistSqrd = limits<float>::max();
 
+	if( m_bvh )
+	{
+		unsigned int triangleIndex;
+		V3f bary;
+		if( !m_bvh->closestPoint( p, maxDistSqrd, triangleIndex, bary ) )
+		{
+			return false;
+		}
+
+		barycentricPosition( triangleIndex, bary, mr );
+		return true;
+	}
+
+	assert( m_tree );
+
 	closestPointWalk( m_tree->rootIndex(), p, maxDistSqrd, mr );
 
 	return true;
@@ -808,8 +800,6 @@ bool MeshPrimitiveEvaluator::intersectionPoint( const Imath::V3f &origin, const
 		return false;
 	}
 
-	assert( m_tree );
-
 	Result *mr = static_cast<Result *>( result );
 
 	float maxDistSqrd = maxDistance * maxDistance;
@@ -818,6 +808,22 @@ bool MeshPrimitiveEvaluator::intersectionPoint( const Imath::V3f &origin, const
 	ray.pos = origin;
 	ray.dir = direction.normalized();
 
+	if( m_bvh )
+	{
+		unsigned int triangleIndex;
+		V3f bary, hitPoint;
+		if( !m_bvh->intersectionPoint( ray.pos, ray.dir, maxDistSqrd, triangleIndex, bary, hitPoint ) )
+		{
+			return false;
+		}
+
+		barycentricPosition( triangleIndex, bary, mr );
+		mr->m_p = hitPoint;
+		return true;
+	}
+
+	assert( m_tree );
+
 	bool hit = false;
 
 	intersectionPointWalk( m_tree->rootIndex(), ray, maxDistSqrd, mr, hit );
@@ -834,19 +840,89 @@ int MeshPrimitiveEvaluator::intersectionPoints( const Imath::V3f &origin, const
 		return 0;
 	}
 
-	assert( m_tree );
-
 	float maxDistSqrd = maxDistance * maxDistance;
 
 	Imath::Line3f ray;
 	ray.pos = origin;
 	ray.dir = direction.normalized();
 
+	if( m_bvh )
+	{
+		std::vector<Private::TriangleBVH::Hit> hits;
+		m_bvh->intersectionPoints( ray.pos, ray.dir, maxDistSqrd, hits );
+		results.reserve( hits.size() );
+		for( std::vector<Private::TriangleBVH::Hit>::const_iterator it = hits.begin(); it != hits.end(); ++it )
+		{
+			ResultPtr result = new Result();
+			barycentricPosition( it->triangleIndex, it->barycentric, result.get() );
+			result->m_p = it->point;
+			results.push_back( result );
+		}
+		return results.size();
+	}
+
+	assert( m_tree );
+
 	intersectionPointsWalk( m_tree->rootIndex(), ray, maxDistSqrd, results );
 
 	return results.size();
 }
 
+MeshPrimitiveEvaluator::Accelerator MeshPrimitiveEvaluator::accelerator() const
+{
+	return m_bvh ? BVHAccelerator : KDTreeAccelerator;
+}
+
+void MeshPrimitiveEvaluator::batchClosestPoint( const std::vector<Imath::V3f> &points, std::vector<PrimitiveEvaluator::ResultPtr> &results ) const
+{
+	results.clear();
+	results.resize( points.size() );
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, points.size() ),
+		[this, &points, &results]( const tbb::blocked_range<size_t> &range ) {
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				ResultPtr result = new Result();
+				if( closestPoint( points[i], result.get() ) )
+				{
+					results[i] = result;
+				}
+			}
+		},
+		taskGroupContext
+	);
+}
+
+void MeshPrimitiveEvaluator::batchIntersectionPoint( const std::vector<Imath::V3f> &origins, const std::vector<Imath::V3f> &directions,
+	std::vector<PrimitiveEvaluator::ResultPtr> &results, float maxDistance ) const
+{
+	if( origins.size() != directions.size() )
+	{
+		throw InvalidArgumentException( "Mismatched origins and directions given to MeshPrimitiveEvaluator::batchIntersectionPoint" );
+	}
+
+	results.clear();
+	results.resize( origins.size() );
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, origins.size() ),
+		[this, &origins, &directions, &results, maxDistance]( const tbb::blocked_range<size_t> &range ) {
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				ResultPtr result = new Result();
+				if( intersectionPoint( origins[i], directions[i], result.get(), maxDistance ) )
+				{
+					results[i] = result;
+				}
+			}
+		},
+		taskGroupContext
+	);
+}
+
 bool MeshPrimitiveEvaluator::barycentricPosition( unsigned int triangleIndex, const Imath::V3f &barycentricCoordinates, PrimitiveEvaluator::Result *result ) const
 {
 	if( triangleIndex >= m_triangles.size() )
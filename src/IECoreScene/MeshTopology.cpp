@@ -0,0 +1,374 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "IECoreScene/MeshTopology.h"
+
+#include "ExclusiveScan.h"
+
+#include "IECore/Exception.h"
+#include "IECore/LRUCache.h"
+#include "IECore/MurmurHash.h"
+#include "IECore/ObjectStatistics.h"
+#include "IECore/RadixSort.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/parallel_invoke.h"
+#include "tbb/task.h"
+
+#include <cstdint>
+
+using namespace std;
+using namespace Imath;
+using namespace IECore;
+using namespace IECoreScene;
+
+//////////////////////////////////////////////////////////////////////////
+// Internal utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Given the sorted indices of `keys`, fills `offsets` so that the
+// elements with key `k` are in the range `[offsets[k], offsets[k+1])`.
+void sortedOffsets( const std::vector<int> &keys, const std::vector<unsigned int> &sortedIndices, size_t numKeys, std::vector<int> &offsets, tbb::task_group_context &taskGroupContext )
+{
+	offsets.resize( numKeys + 1 );
+	const size_t size = sortedIndices.size();
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, size + 1 ),
+		[&]( const tbb::blocked_range<size_t> &range ) {
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				// Each position fills the offsets for all the keys
+				// between the previous key and its own.
+				const int previousKey = i > 0 ? keys[sortedIndices[i-1]] : -1;
+				const int key = i < size ? keys[sortedIndices[i]] : (int)numKeys;
+				for( int k = previousKey + 1; k <= key; ++k )
+				{
+					offsets[k] = i;
+				}
+			}
+		},
+		taskGroupContext
+	);
+}
+
+inline uint64_t edgeKey( int v0, int v1 )
+{
+	if( v1 < v0 )
+	{
+		std::swap( v0, v1 );
+	}
+	return ( (uint64_t)v0 << 32 ) | (uint64_t)v1;
+}
+
+template<typename T>
+size_t vectorMemoryUsage( const std::vector<T> &v )
+{
+	return v.capacity() * sizeof( T );
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// MeshTopology
+//////////////////////////////////////////////////////////////////////////
+
+MeshTopology::MeshTopology( const MeshPrimitive *mesh )
+	:	m_numVertices( mesh->variableSize( PrimitiveVariable::Vertex ) )
+{
+	const std::vector<int> &verticesPerFace = mesh->verticesPerFace()->readable();
+	const std::vector<int> &vertexIds = mesh->vertexIds()->readable();
+	const size_t numFaces = verticesPerFace.size();
+	const size_t numFaceVertices = vertexIds.size();
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+
+	// Faces
+
+	Private::exclusiveScan( numFaces, [&]( size_t i ) { return verticesPerFace[i]; }, m_faceOffsets );
+	if( (size_t)m_faceOffsets.back() != numFaceVertices )
+	{
+		throw Exception( "Bad topology - number of vertexIds not equal to sum of verticesPerFace" );
+	}
+
+	m_faceVertexFaces.resize( numFaceVertices );
+	std::vector<uint64_t> edgeKeys( numFaceVertices );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numFaces ),
+		[&]( const tbb::blocked_range<size_t> &range ) {
+			for( size_t f = range.begin(); f != range.end(); ++f )
+			{
+				const int begin = m_faceOffsets[f];
+				const int end = m_faceOffsets[f+1];
+				for( int i = begin; i < end; ++i )
+				{
+					m_faceVertexFaces[i] = f;
+					edgeKeys[i] = edgeKey( vertexIds[i], vertexIds[i + 1 < end ? i + 1 : begin] );
+				}
+			}
+		},
+		taskGroupContext
+	);
+
+	// Vertices and edges. Both are derived from a stable sort, so
+	// that the face-vertices for each vertex or edge are in ascending
+	// order.
+
+	std::vector<unsigned int> sortedVertices;
+	std::vector<unsigned int> sortedEdges;
+	tbb::parallel_invoke(
+		[&] {
+			RadixSort radixSort;
+			sortedVertices = radixSort( vertexIds );
+		},
+		[&] {
+			RadixSort radixSort;
+			sortedEdges = radixSort( edgeKeys );
+		},
+		taskGroupContext
+	);
+
+	if( numFaceVertices && ( vertexIds[sortedVertices.front()] < 0 || vertexIds[sortedVertices.back()] >= (int)m_numVertices ) )
+	{
+		throw Exception( "Bad topology - vertexId out of range" );
+	}
+
+	sortedOffsets( vertexIds, sortedVertices, m_numVertices, m_vertexOffsets, taskGroupContext );
+
+	m_vertexFaceVertices.resize( numFaceVertices );
+	m_vertexFaces.resize( numFaceVertices );
+	std::vector<int> edgeStarts( numFaceVertices );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numFaceVertices ),
+		[&]( const tbb::blocked_range<size_t> &range ) {
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				m_vertexFaceVertices[i] = sortedVertices[i];
+				m_vertexFaces[i] = m_faceVertexFaces[sortedVertices[i]];
+				edgeStarts[i] = i == 0 || edgeKeys[sortedEdges[i]] != edgeKeys[sortedEdges[i-1]];
+			}
+		},
+		taskGroupContext
+	);
+
+	std::vector<int> edgeIndices;
+	Private::exclusiveScan( numFaceVertices, [&]( size_t i ) { return edgeStarts[i]; }, edgeIndices );
+	const size_t numEdges = edgeIndices.back();
+
+	m_edges.resize( numEdges );
+	m_edgeOffsets.resize( numEdges + 1 );
+	m_edgeOffsets.back() = numFaceVertices;
+	m_edgeFaces.resize( numFaceVertices );
+	m_faceVertexEdges.resize( numFaceVertices );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numFaceVertices ),
+		[&]( const tbb::blocked_range<size_t> &range ) {
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				const int faceVertex = sortedEdges[i];
+				const int edge = edgeIndices[i] + edgeStarts[i] - 1;
+				m_faceVertexEdges[faceVertex] = edge;
+				m_edgeFaces[i] = m_faceVertexFaces[faceVertex];
+				if( edgeStarts[i] )
+				{
+					const uint64_t key = edgeKeys[faceVertex];
+					m_edges[edge] = V2i( key >> 32, key & 0xffffffff );
+					m_edgeOffsets[edge] = i;
+				}
+			}
+		},
+		taskGroupContext
+	);
+}
+
+MeshTopology::~MeshTopology()
+{
+}
+
+size_t MeshTopology::numFaces() const
+{
+	return m_faceOffsets.size() - 1;
+}
+
+size_t MeshTopology::numVertices() const
+{
+	return m_numVertices;
+}
+
+size_t MeshTopology::numFaceVertices() const
+{
+	return m_faceVertexFaces.size();
+}
+
+size_t MeshTopology::numEdges() const
+{
+	return m_edges.size();
+}
+
+const std::vector<int> &MeshTopology::faceOffsets() const
+{
+	return m_faceOffsets;
+}
+
+const std::vector<int> &MeshTopology::faceVertexFaces() const
+{
+	return m_faceVertexFaces;
+}
+
+const std::vector<int> &MeshTopology::vertexOffsets() const
+{
+	return m_vertexOffsets;
+}
+
+const std::vector<int> &MeshTopology::vertexFaceVertices() const
+{
+	return m_vertexFaceVertices;
+}
+
+const std::vector<int> &MeshTopology::vertexFaces() const
+{
+	return m_vertexFaces;
+}
+
+const std::vector<Imath::V2i> &MeshTopology::edges() const
+{
+	return m_edges;
+}
+
+const std::vector<int> &MeshTopology::faceVertexEdges() const
+{
+	return m_faceVertexEdges;
+}
+
+const std::vector<int> &MeshTopology::edgeOffsets() const
+{
+	return m_edgeOffsets;
+}
+
+const std::vector<int> &MeshTopology::edgeFaces() const
+{
+	return m_edgeFaces;
+}
+
+size_t MeshTopology::memoryUsage() const
+{
+	return
+		sizeof( *this ) +
+		vectorMemoryUsage( m_faceOffsets ) +
+		vectorMemoryUsage( m_faceVertexFaces ) +
+		vectorMemoryUsage( m_vertexOffsets ) +
+		vectorMemoryUsage( m_vertexFaceVertices ) +
+		vectorMemoryUsage( m_vertexFaces ) +
+		vectorMemoryUsage( m_edges ) +
+		vectorMemoryUsage( m_faceVertexEdges ) +
+		vectorMemoryUsage( m_edgeOffsets ) +
+		vectorMemoryUsage( m_edgeFaces )
+	;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Caching
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+struct CacheGetterKey
+{
+
+	CacheGetterKey( const MeshPrimitive *mesh )
+		:	mesh( mesh )
+	{
+		// The topology hash doesn't account for trailing vertices
+		// which aren't referenced by any face, but we do.
+		mesh->topologyHash( hash );
+		hash.append( (uint64_t)mesh->variableSize( PrimitiveVariable::Vertex ) );
+	}
+
+	operator const MurmurHash & () const
+	{
+		return hash;
+	}
+
+	const MeshPrimitive *mesh;
+	MurmurHash hash;
+
+};
+
+ConstMeshTopologyPtr cacheGetter( const CacheGetterKey &key, size_t &cost )
+{
+	ConstMeshTopologyPtr result = new MeshTopology( key.mesh );
+	cost = result->memoryUsage();
+	return result;
+}
+
+typedef LRUCache<MurmurHash, ConstMeshTopologyPtr, LRUCachePolicy::TaskParallel, CacheGetterKey> Cache;
+
+Cache &cache()
+{
+	// Deliberately leaked, so that it outlives any static
+	// meshes which might otherwise be destroyed after it.
+	static Cache *c = new Cache( cacheGetter, 500 * 1024 * 1024 );
+	return *c;
+}
+
+#ifdef IECORE_OBJECTSTATISTICS
+ObjectStatistics::Owner g_cacheOwner( "IECoreScene.MeshTopologyCache", [] { return cache().currentCost(); } );
+#endif
+
+} // namespace
+
+ConstMeshTopologyPtr MeshTopology::cachedTopology( const MeshPrimitive *mesh )
+{
+	return cache().get( CacheGetterKey( mesh ) );
+}
+
+void MeshTopology::setCacheMemoryLimit( size_t bytes )
+{
+	cache().setMaxCost( bytes );
+}
+
+size_t MeshTopology::getCacheMemoryLimit()
+{
+	return cache().getMaxCost();
+}
+
+size_t MeshTopology::cacheMemoryUsage()
+{
+	return cache().currentCost();
+}
@@ -0,0 +1,142 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "MortonOrder.h"
+
+#include "IECore/RadixSort.h"
+
+#include "OpenEXR/ImathBox.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/parallel_reduce.h"
+#include "tbb/task.h"
+
+#include <cstdint>
+
+using namespace Imath;
+using namespace IECore;
+
+namespace
+{
+
+// Number of bits used to quantise each axis, so that
+// a code fits in 64 bits.
+const int g_bitsPerAxis = 21;
+
+// Spreads the lowest 21 bits of `x` so that there are
+// two zero bits between each of them.
+uint64_t expandBits( uint64_t x )
+{
+	x &= 0x1fffff;
+	x = ( x | x << 32 ) & 0x1f00000000ffffull;
+	x = ( x | x << 16 ) & 0x1f0000ff0000ffull;
+	x = ( x | x << 8 ) & 0x100f00f00f00f00full;
+	x = ( x | x << 4 ) & 0x10c30c30c30c30c3ull;
+	x = ( x | x << 2 ) & 0x1249249249249249ull;
+	return x;
+}
+
+uint64_t quantise( float v, float min, float scale )
+{
+	const float q = ( v - min ) * scale;
+	// The negated comparison also catches NaNs.
+	if( !( q > 0.0f ) )
+	{
+		return 0;
+	}
+	const float maxValue = (float)( ( 1 << g_bitsPerAxis ) - 1 );
+	return q < maxValue ? (uint64_t)q : (uint64_t)maxValue;
+}
+
+} // namespace
+
+void IECoreScene::Private::mortonOrder( const std::vector<V3f> &positions, std::vector<int> &order )
+{
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+
+	const Box3f bound = tbb::parallel_reduce(
+		tbb::blocked_range<size_t>( 0, positions.size() ),
+		Box3f(),
+		[&]( const tbb::blocked_range<size_t> &range, Box3f b ) {
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				b.extendBy( positions[i] );
+			}
+			return b;
+		},
+		[]( Box3f a, const Box3f &b ) {
+			a.extendBy( b );
+			return a;
+		},
+		tbb::auto_partitioner(),
+		taskGroupContext
+	);
+
+	V3f scale( 0 );
+	if( !bound.isEmpty() )
+	{
+		const V3f size = bound.size();
+		for( int i = 0; i < 3; ++i )
+		{
+			if( size[i] > 0.0f )
+			{
+				scale[i] = (float)( ( 1 << g_bitsPerAxis ) - 1 ) / size[i];
+			}
+		}
+	}
+
+	std::vector<uint64_t> codes( positions.size() );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, positions.size() ),
+		[&]( const tbb::blocked_range<size_t> &range )
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				const V3f &p = positions[i];
+				codes[i] =
+					expandBits( quantise( p.x, bound.min.x, scale.x ) ) << 2 |
+					expandBits( quantise( p.y, bound.min.y, scale.y ) ) << 1 |
+					expandBits( quantise( p.z, bound.min.z, scale.z ) )
+				;
+			}
+		},
+		taskGroupContext
+	);
+
+	RadixSort sorter;
+	const std::vector<unsigned int> &sorted = sorter( codes );
+	order.assign( sorted.begin(), sorted.end() );
+}
@@ -42,6 +42,7 @@
 #include "IECore/ObjectParameter.h"
 #include "IECore/VectorTypedData.h"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace IECore;
@@ -134,16 +135,25 @@ static void densities( const vector<Vec3<T> > &points, int numNeighbours, T mult
 	vector<typename Tree::Neighbour> neighbours;
 
 	result.resize( points.size() );
-	for( unsigned int i=0; i<points.size(); i++ )
+
+	// The neighbours are found in parallel using the batched query,
+	// processing a limited number of points at a time to bound the
+	// memory needed to hold them.
+	const size_t batchSize = 65536;
+	for( size_t batchBegin = 0; batchBegin < points.size(); batchBegin += batchSize )
 	{
-		tree.nearestNNeighbours( points[i], numNeighbours, neighbours );
-		T r = ((*(neighbours.rbegin()->point)) - points[i]).length();
-		result[i] = multiplier / (r*r*r);
+		const size_t batchEnd = std::min( batchBegin + batchSize, points.size() );
+		const unsigned int numFound = tree.nearestNNeighbours( points.begin() + batchBegin, points.begin() + batchEnd, numNeighbours, neighbours );
+		for( size_t i=batchBegin; i<batchEnd; i++ )
+		{
+			const typename Tree::Neighbour &furthest = neighbours[( i - batchBegin + 1 ) * numFound - 1];
+			T r = ((*(furthest.point)) - points[i]).length();
+			result[i] = multiplier / (r*r*r);
+		}
 	}
 }
 
 /// \todo Support 2d point types?
-/// \todo Threading?
 ObjectPtr PointDensitiesOp::doOperation( const CompoundObject * operands )
 {
 	const int numNeighbours = m_numNeighboursParameter->getNumericValue();
@@ -41,6 +41,8 @@
 #include "IECore/ObjectParameter.h"
 #include "IECore/VectorTypedData.h"
 
+#include <algorithm>
+
 using namespace IECore;
 using namespace IECoreScene;
 using namespace Imath;
@@ -101,13 +103,13 @@ const IntParameter * PointNormalsOp::numNeighboursParameter() const
 	return m_numNeighboursParameter.get();
 }
 
-/// Calculates density at a point by finding the volume of a sphere holding numNeighbours. Doesn't bother
-/// with any constant factors for the density (PI, 4/3, numNeighbours) as these are factored out in the use below anyway.
+/// Calculates density at a point by finding the volume of a sphere holding numNeighbours, given the furthest
+/// of those neighbours. Doesn't bother with any constant factors for the density (PI, 4/3, numNeighbours) as
+/// these are factored out in the use below anyway.
 template<typename T>
-static inline typename T::Point::BaseType density( const T tree, const typename T::Point &p, int numNeighbours, vector<typename T::Neighbour> &neighbours )
+static inline typename T::BaseType density( const T &p, const T &furthestNeighbour )
 {
-	tree.nearestNNeighbours( p, numNeighbours, neighbours );
-	typename T::Point::BaseType r = ((*(neighbours.rbegin()->point)) - p).length();
+	typename T::BaseType r = (furthestNeighbour - p).length();
 	return 1.0/(r*r*r);
 }
 
@@ -123,14 +125,42 @@ static void normals( const vector<T> &points, int numNeighbours, vector<T> &resu
 
 	result.resize( points.size() );
 
-	for( unsigned int i=0; i<points.size(); i++ )
+	float o = Real( 0.1 ) ; // should we scale offset for gradient by the radius of the neighbours sphere?
+
+	// We need the density at each point and at three offset positions. These
+	// are found in parallel using the batched query, processing a limited number
+	// of points at a time to bound the memory needed to hold the neighbours.
+	const size_t batchSize = 16384;
+	vector<T> queries;
+	queries.reserve( std::min( batchSize, points.size() ) * 4 );
+	for( size_t batchBegin = 0; batchBegin < points.size(); batchBegin += batchSize )
 	{
-		Real d = density( tree, points[i], numNeighbours, neighbours );
-		float o = Real( 0.1 ) ; // should we scale offset for gradient by the radius of the neighbours sphere?
-		Real dx = d - density( tree, points[i] + T( o, 0, 0 ), numNeighbours, neighbours );
-		Real dy = d - density( tree, points[i] + T( 0, o, 0 ), numNeighbours, neighbours );
-		Real dz = d - density( tree, points[i] + T( 0, 0, o ), numNeighbours, neighbours );
-		result[i] = T( dx, dy, dz ).normalized();
+		const size_t batchEnd = std::min( batchBegin + batchSize, points.size() );
+
+		queries.clear();
+		for( size_t i=batchBegin; i<batchEnd; i++ )
+		{
+			queries.push_back( points[i] );
+			queries.push_back( points[i] + T( o, 0, 0 ) );
+			queries.push_back( points[i] + T( 0, o, 0 ) );
+			queries.push_back( points[i] + T( 0, 0, o ) );
+		}
+
+		const unsigned int numFound = tree.nearestNNeighbours( queries.begin(), queries.end(), numNeighbours, neighbours );
+
+		for( size_t i=batchBegin; i<batchEnd; i++ )
+		{
+			const size_t q = ( i - batchBegin ) * 4;
+			Real dq[4];
+			for( size_t j=0; j<4; j++ )
+			{
+				dq[j] = density( queries[q+j], *(neighbours[( q + j + 1 ) * numFound - 1].point) );
+			}
+			Real dx = dq[0] - dq[1];
+			Real dy = dq[0] - dq[2];
+			Real dz = dq[0] - dq[3];
+			result[i] = T( dx, dy, dz ).normalized();
+		}
 	}
 }
 
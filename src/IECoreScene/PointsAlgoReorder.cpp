@@ -0,0 +1,104 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "IECoreScene/PointsAlgo.h"
+
+#include "MortonOrder.h"
+#include "RemapData.h"
+
+#include "boost/format.hpp"
+
+using namespace Imath;
+using namespace IECore;
+using namespace IECoreScene;
+
+IntVectorDataPtr PointsAlgo::calculateLocalityOrder( const PointsPrimitive *points, const std::string &position )
+{
+	const V3fVectorData *pData = points->variableData<V3fVectorData>( position, PrimitiveVariable::Vertex );
+	if( !pData )
+	{
+		throw InvalidArgumentException( boost::str( boost::format( "PointsAlgo::calculateLocalityOrder : PointsPrimitive has no \"%s\" primitive variable." ) % position ) );
+	}
+
+	IntVectorDataPtr resultData = new IntVectorData;
+	Private::mortonOrder( pData->readable(), resultData->writable() );
+	return resultData;
+}
+
+PointsPrimitivePtr PointsAlgo::reorder( const PointsPrimitive *points, const IntVectorData *pointOrderData )
+{
+	if( !points->arePrimitiveVariablesValid() )
+	{
+		throw InvalidArgumentException( "PointsAlgo::reorder : PointsPrimitive has invalid primitive variables" );
+	}
+
+	const std::vector<int> &pointOrder = pointOrderData->readable();
+	const size_t numPoints = points->getNumPoints();
+	if( pointOrder.size() != numPoints )
+	{
+		throw InvalidArgumentException( boost::str( boost::format( "PointsAlgo::reorder : Wrong number of elements in pointOrder (%d but expected %d)" ) % pointOrder.size() % numPoints ) );
+	}
+
+	std::vector<bool> used( numPoints, false );
+	for( int i : pointOrder )
+	{
+		if( i < 0 || i >= (int)numPoints || used[i] )
+		{
+			throw InvalidArgumentException( "PointsAlgo::reorder : pointOrder is not a valid permutation" );
+		}
+		used[i] = true;
+	}
+
+	PointsPrimitivePtr result = new PointsPrimitive( numPoints );
+
+	Private::RemapData remap( pointOrder );
+	for( const auto &variable : points->variables )
+	{
+		PrimitiveVariable primitiveVariable = variable.second;
+		switch( primitiveVariable.interpolation )
+		{
+			case PrimitiveVariable::Vertex :
+			case PrimitiveVariable::Varying :
+			case PrimitiveVariable::FaceVarying :
+				Private::remapPrimitiveVariable( primitiveVariable, remap );
+				break;
+			default :
+				break;
+		}
+		result->variables[variable.first] = primitiveVariable;
+	}
+
+	return result;
+}
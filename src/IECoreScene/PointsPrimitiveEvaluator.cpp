@@ -39,6 +39,8 @@
 #include "IECore/Exception.h"
 #include "IECore/SimpleTypedData.h"
 
+#include "tbb/task_arena.h"
+
 using namespace std;
 using namespace Imath;
 using namespace IECore;
@@ -264,6 +266,16 @@ void PointsPrimitiveEvaluator::buildTree()
 		return;
 	}
 
-	m_tree.init( m_pVector->begin(), m_pVector->end() );
+	// Large trees are built in parallel. While waiting for those tasks
+	// this thread could otherwise pick up an unrelated one which calls
+	// buildTree() on this evaluator, and deadlock on the mutex we hold.
+	// Building inside our own arena ensures we only ever wait on tasks
+	// belonging to the build.
+	tbb::task_arena arena;
+	arena.execute(
+		[this] {
+			m_tree.init( m_pVector->begin(), m_pVector->end() );
+		}
+	);
 	m_haveTree = true;
 }
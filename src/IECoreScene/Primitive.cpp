@@ -36,6 +36,7 @@
 
 #include "IECore/DespatchTypedData.h"
 #include "IECore/MurmurHash.h"
+#include "IECore/ObjectPool.h"
 #include "IECore/TypeTraits.h"
 #include "IECore/VectorTypedData.h"
 
@@ -60,6 +61,24 @@ static IndexedIO::EntryID g_indicesEntry("indices");
 const unsigned int Primitive::m_ioVersion = 2;
 IE_CORE_DEFINEOBJECTTYPEDESCRIPTION( Primitive );
 
+static void deduplicatePrimitiveVariables( Object *object, const ObjectPool::ChildFn &childFn )
+{
+	PrimitiveVariableMap &variables = static_cast<Primitive *>( object )->variables;
+	for( PrimitiveVariableMap::iterator it = variables.begin(); it != variables.end(); ++it )
+	{
+		if( it->second.data )
+		{
+			it->second.data = boost::static_pointer_cast<Data>( childFn( it->second.data.get() ) );
+		}
+		if( it->second.indices )
+		{
+			it->second.indices = boost::static_pointer_cast<IntVectorData>( childFn( it->second.indices.get() ) );
+		}
+	}
+}
+
+static bool g_deduplicateRegistration = ObjectPool::registerDeduplicateFn( PrimitiveTypeId, deduplicatePrimitiveVariables );
+
 Primitive::Primitive()
 {
 }
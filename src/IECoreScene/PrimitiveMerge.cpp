@@ -0,0 +1,557 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "PrimitiveMerge.h"
+
+#include "ExclusiveScan.h"
+
+#include "IECore/DataAlgo.h"
+#include "IECore/DataCastOp.h"
+#include "IECore/DespatchTypedData.h"
+#include "IECore/TypeTraits.h"
+
+#include "OpenEXR/ImathColor.h"
+#include "OpenEXR/half.h"
+
+#include "boost/format.hpp"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task.h"
+
+#include <algorithm>
+#include <map>
+#include <type_traits>
+
+using namespace Imath;
+using namespace IECore;
+using namespace IECoreScene;
+
+namespace
+{
+
+// The value used to fill in for primitives which don't have
+// a particular variable. Imath types don't initialise
+// themselves, so we must be explicit.
+template<typename T>
+struct DefaultValue
+{
+	static T value()
+	{
+		return T();
+	}
+};
+
+template<typename T>
+struct DefaultValue<Vec2<T> >
+{
+	static Vec2<T> value()
+	{
+		return Vec2<T>( 0 );
+	}
+};
+
+template<typename T>
+struct DefaultValue<Vec3<T> >
+{
+	static Vec3<T> value()
+	{
+		return Vec3<T>( 0 );
+	}
+};
+
+template<typename T>
+struct DefaultValue<Color3<T> >
+{
+	static Color3<T> value()
+	{
+		return Color3<T>( 0 );
+	}
+};
+
+template<typename T>
+struct DefaultValue<Color4<T> >
+{
+	static Color4<T> value()
+	{
+		return Color4<T>( 0 );
+	}
+};
+
+template<>
+struct DefaultValue<half>
+{
+	static half value()
+	{
+		return half( 0.0f );
+	}
+};
+
+// Transforms values in place according to their geometric interpretation.
+// Only 3d vectors are affected.
+template<typename T>
+struct TransformValues
+{
+
+	TransformValues( const M44f &matrix, GeometricData::Interpretation interpretation )
+	{
+	}
+
+	template<typename Iterator>
+	void operator()( Iterator begin, Iterator end ) const
+	{
+	}
+
+};
+
+template<typename T>
+struct TransformValues<Vec3<T> >
+{
+
+	TransformValues( const M44f &matrix, GeometricData::Interpretation interpretation )
+		:	m_matrix( interpretation == GeometricData::Normal ? matrix.inverse().transposed() : matrix ), m_interpretation( interpretation )
+	{
+	}
+
+	template<typename Iterator>
+	void operator()( Iterator begin, Iterator end ) const
+	{
+		switch( m_interpretation )
+		{
+			case GeometricData::Point :
+				for( Iterator it = begin; it != end; ++it )
+				{
+					m_matrix.multVecMatrix( *it, *it );
+				}
+				break;
+			case GeometricData::Vector :
+			case GeometricData::Normal :
+				for( Iterator it = begin; it != end; ++it )
+				{
+					m_matrix.multDirMatrix( *it, *it );
+				}
+				break;
+			default :
+				break;
+		}
+	}
+
+	private :
+
+		const M44f m_matrix;
+		const GeometricData::Interpretation m_interpretation;
+
+};
+
+// Calls `f( i )` for each input primitive in parallel. Elements of
+// `std::vector<bool>` can't be written concurrently, so bool data
+// is merged serially.
+template<typename ValueType, typename F>
+void forEachPrimitive( size_t numPrimitives, const F &f )
+{
+	if( std::is_same<ValueType, bool>::value )
+	{
+		for( size_t i = 0; i < numPrimitives; ++i )
+		{
+			f( i );
+		}
+		return;
+	}
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numPrimitives ),
+		[&]( const tbb::blocked_range<size_t> &range )
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				f( i );
+			}
+		},
+		taskGroupContext
+	);
+}
+
+struct MergedVariable
+{
+	PrimitiveVariable::Interpolation interpolation;
+	IECore::TypeId typeId;
+	bool indexed;
+	// One per input primitive, with null data where the
+	// primitive doesn't have the variable.
+	std::vector<PrimitiveVariable> sources;
+	PrimitiveVariable result;
+};
+
+struct MergeVariable
+{
+	typedef DataPtr ReturnType;
+
+	MergeVariable( const MergedVariable &variable, const std::vector<int> &offsets, const std::vector<M44f> &transforms, IntVectorDataPtr &indices )
+		:	m_variable( variable ), m_offsets( offsets ), m_transforms( transforms ), m_indices( indices )
+	{
+	}
+
+	template<typename T>
+	ReturnType operator()( const T *firstData )
+	{
+		typedef typename T::ValueType::value_type ValueType;
+
+		const GeometricData::Interpretation interpretation = getGeometricInterpretation( firstData );
+		const std::vector<PrimitiveVariable> &sources = m_variable.sources;
+
+		typename T::Ptr result = new T;
+		typename T::ValueType &resultValues = result->writable();
+
+		if( !m_variable.indexed )
+		{
+			resultValues.resize( m_offsets.back() );
+			forEachPrimitive<ValueType>(
+				sources.size(),
+				[&]( size_t i )
+				{
+					const typename T::ValueType::iterator begin = resultValues.begin() + m_offsets[i];
+					const typename T::ValueType::iterator end = resultValues.begin() + m_offsets[i+1];
+					if( !sources[i].data )
+					{
+						std::fill( begin, end, DefaultValue<ValueType>::value() );
+						return;
+					}
+
+					const typename T::ValueType &values = static_cast<const T *>( sources[i].data.get() )->readable();
+					if( sources[i].indices )
+					{
+						typename T::ValueType::iterator it = begin;
+						for( int index : sources[i].indices->readable() )
+						{
+							*it++ = values[index];
+						}
+					}
+					else
+					{
+						std::copy( values.begin(), values.end(), begin );
+					}
+
+					if( !m_transforms.empty() )
+					{
+						TransformValues<ValueType>( m_transforms[i], interpretation )( begin, end );
+					}
+				}
+			);
+		}
+		else
+		{
+			// Each primitive contributes its data (or default values) to the
+			// merged data, and its indices offset to match.
+			std::vector<int> dataOffsets;
+			Private::exclusiveScan(
+				sources.size(),
+				[&]( size_t i ) -> int {
+					if( sources[i].data )
+					{
+						return static_cast<const T *>( sources[i].data.get() )->readable().size();
+					}
+					return m_offsets[i+1] - m_offsets[i];
+				},
+				dataOffsets
+			);
+
+			resultValues.resize( dataOffsets.back() );
+			m_indices = new IntVectorData;
+			std::vector<int> &indices = m_indices->writable();
+			indices.resize( m_offsets.back() );
+
+			forEachPrimitive<ValueType>(
+				sources.size(),
+				[&]( size_t i )
+				{
+					const std::vector<int>::iterator indicesBegin = indices.begin() + m_offsets[i];
+					const std::vector<int>::iterator indicesEnd = indices.begin() + m_offsets[i+1];
+					const int dataOffset = dataOffsets[i];
+					const typename T::ValueType::iterator begin = resultValues.begin() + dataOffset;
+					if( !sources[i].data )
+					{
+						std::fill( begin, resultValues.begin() + dataOffsets[i+1], DefaultValue<ValueType>::value() );
+					}
+					else
+					{
+						const typename T::ValueType &values = static_cast<const T *>( sources[i].data.get() )->readable();
+						std::copy( values.begin(), values.end(), begin );
+						if( !m_transforms.empty() )
+						{
+							TransformValues<ValueType>( m_transforms[i], interpretation )( begin, begin + values.size() );
+						}
+					}
+
+					if( sources[i].indices )
+					{
+						const std::vector<int> &sourceIndices = sources[i].indices->readable();
+						std::transform(
+							sourceIndices.begin(), sourceIndices.end(), indicesBegin,
+							[dataOffset]( int index ) { return index + dataOffset; }
+						);
+					}
+					else
+					{
+						int index = dataOffset;
+						for( std::vector<int>::iterator it = indicesBegin; it != indicesEnd; ++it )
+						{
+							*it = index++;
+						}
+					}
+				}
+			);
+		}
+
+		setGeometricInterpretation( result.get(), interpretation );
+		return result;
+	}
+
+	struct ErrorHandler
+	{
+		template<typename T, typename F>
+		void operator()( const T *data, const F &functor )
+		{
+			throw InvalidArgumentException( ( boost::format( "Primitive variable has unsupported type \"%s\"" ) % data->typeName() ).str() );
+		}
+	};
+
+	private :
+
+		const MergedVariable &m_variable;
+		const std::vector<int> &m_offsets;
+		const std::vector<M44f> &m_transforms;
+		IntVectorDataPtr &m_indices;
+
+};
+
+// Returns true if `primitiveVariable` has data, and unless it is
+// Constant, that the data is a vector of the right size for `primitive`.
+bool isMergeable( const PrimitiveVariable &primitiveVariable, const Primitive *primitive )
+{
+	if( !primitiveVariable.data )
+	{
+		return false;
+	}
+	else if( primitiveVariable.interpolation == PrimitiveVariable::Constant )
+	{
+		return true;
+	}
+	else if( !despatchTraitsTest<TypeTraits::IsVectorTypedData>( primitiveVariable.data.get() ) )
+	{
+		return false;
+	}
+
+	size_t size;
+	if( primitiveVariable.indices )
+	{
+		size = primitiveVariable.indices->readable().size();
+	}
+	else
+	{
+		size = despatchTypedData<TypedDataSize, TypeTraits::IsVectorTypedData, DespatchTypedDataIgnoreError>( primitiveVariable.data.get() );
+	}
+
+	return size == primitive->variableSize( primitiveVariable.interpolation );
+}
+
+DataPtr castData( const Data *data, IECore::TypeId typeId, const std::string &name )
+{
+	DataCastOpPtr castOp = new DataCastOp();
+	castOp->objectParameter()->setValue( const_cast<Data *>( data ) );
+	castOp->targetTypeParameter()->setNumericValue( typeId );
+
+	try
+	{
+		return runTimeCast<Data>( castOp->operate() );
+	}
+	catch( const IECore::Exception &e )
+	{
+		throw InvalidArgumentException( boost::str( boost::format( "Unable to cast primitive variable \"%s\" (%s)" ) % name % e.what() ) );
+	}
+}
+
+} // namespace
+
+void IECoreScene::Private::mergePrimitiveVariables( const std::vector<const Primitive *> &primitives, const std::vector<M44f> &transforms, Primitive *result, MergeMode mode )
+{
+	if( !transforms.empty() && transforms.size() != primitives.size() )
+	{
+		throw InvalidArgumentException( "Number of transforms does not match number of primitives" );
+	}
+
+	// Decide what each variable will look like, and gather the
+	// sources for it.
+
+	typedef std::map<std::string, MergedVariable> MergedVariables;
+	MergedVariables mergedVariables;
+
+	const bool strict = mode == StrictMerge;
+	for( size_t i = 0; i < primitives.size(); ++i )
+	{
+		for( const auto &variable : primitives[i]->variables )
+		{
+			const std::string &name = variable.first;
+			const PrimitiveVariable &primitiveVariable = variable.second;
+
+			if( !isMergeable( primitiveVariable, primitives[i] ) )
+			{
+				if( strict )
+				{
+					throw InvalidArgumentException( boost::str( boost::format( "Primitive variable \"%s\" is invalid" ) % name ) );
+				}
+				continue;
+			}
+
+			MergedVariables::iterator mIt = mergedVariables.find( name );
+			if( mIt == mergedVariables.end() )
+			{
+				// The first primitive to have the variable decides its
+				// interpolation, type and indexing.
+				MergedVariable &m = mergedVariables[name];
+				m.interpolation = primitiveVariable.interpolation;
+				m.typeId = primitiveVariable.data->typeId();
+				m.indexed = static_cast<bool>( primitiveVariable.indices );
+				if( m.interpolation == PrimitiveVariable::Constant )
+				{
+					m.result = primitiveVariable;
+				}
+				else
+				{
+					m.sources.resize( primitives.size() );
+					m.sources[i] = primitiveVariable;
+				}
+				continue;
+			}
+
+			MergedVariable &m = mIt->second;
+			if( m.interpolation != primitiveVariable.interpolation )
+			{
+				if( strict )
+				{
+					throw InvalidArgumentException( boost::str( boost::format( "Mismatching interpolation for primitive variable \"%s\"" ) % name ) );
+				}
+				continue;
+			}
+			else if( m.interpolation == PrimitiveVariable::Constant )
+			{
+				continue;
+			}
+
+			m.sources[i] = primitiveVariable;
+			if( primitiveVariable.data->typeId() != m.typeId )
+			{
+				try
+				{
+					m.sources[i].data = castData( primitiveVariable.data.get(), m.typeId, name );
+				}
+				catch( const IECore::Exception & )
+				{
+					if( strict )
+					{
+						throw;
+					}
+					m.sources[i] = PrimitiveVariable();
+				}
+			}
+		}
+	}
+
+	// Compute the offset of each primitive in the merged
+	// variables, and discard any variables which won't fit.
+
+	std::vector<int> offsets[PrimitiveVariable::FaceVarying + 1];
+	std::vector<MergedVariable *> toMerge;
+	for( auto &variable : mergedVariables )
+	{
+		if( variable.second.interpolation == PrimitiveVariable::Constant )
+		{
+			continue;
+		}
+
+		std::vector<int> &interpolationOffsets = offsets[variable.second.interpolation];
+		if( interpolationOffsets.empty() )
+		{
+			const PrimitiveVariable::Interpolation interpolation = variable.second.interpolation;
+			Private::exclusiveScan(
+				primitives.size(),
+				[&]( size_t i ) -> int { return primitives[i]->variableSize( interpolation ); },
+				interpolationOffsets
+			);
+		}
+
+		if( (size_t)interpolationOffsets.back() == result->variableSize( variable.second.interpolation ) )
+		{
+			toMerge.push_back( &variable.second );
+		}
+	}
+
+	// Merge the variables in parallel.
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, toMerge.size() ),
+		[&]( const tbb::blocked_range<size_t> &range )
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				MergedVariable &variable = *toMerge[i];
+				const PrimitiveVariable *first = nullptr;
+				for( const auto &source : variable.sources )
+				{
+					if( source.data )
+					{
+						first = &source;
+						break;
+					}
+				}
+
+				IntVectorDataPtr indices;
+				MergeVariable merge( variable, offsets[variable.interpolation], transforms, indices );
+				DataPtr data = despatchTypedData<MergeVariable, TypeTraits::IsVectorTypedData, MergeVariable::ErrorHandler>( const_cast<Data *>( first->data.get() ), merge );
+				variable.result = PrimitiveVariable( variable.interpolation, data, indices );
+			}
+		},
+		taskGroupContext
+	);
+
+	for( auto &variable : mergedVariables )
+	{
+		if( variable.second.result.data )
+		{
+			result->variables[variable.first] = variable.second.result;
+		}
+	}
+}
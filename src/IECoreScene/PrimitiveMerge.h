@@ -0,0 +1,88 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef IECORESCENE_PRIMITIVEMERGE_H
+#define IECORESCENE_PRIMITIVEMERGE_H
+
+#include "IECoreScene/Primitive.h"
+
+#include "OpenEXR/ImathMatrix.h"
+
+#include <vector>
+
+namespace IECoreScene
+{
+
+namespace Private
+{
+
+/// Determines how `mergePrimitiveVariables()` treats variables which
+/// can't be merged.
+enum MergeMode
+{
+	/// Mismatched interpolations, types which can't be cast and
+	/// invalid variables throw.
+	StrictMerge,
+	/// Mismatched interpolations, types which can't be cast and
+	/// invalid variables are treated as if the primitive didn't
+	/// have the variable at all, and are filled with default values.
+	LenientMerge
+};
+
+/// Merges the primitive variables of `primitives` into `result`, which must
+/// already have been given the merged topology. This is the shared back end
+/// for `MeshAlgo::merge()`, `CurvesAlgo::merge()` and `PointsAlgo::mergePoints()`.
+///
+/// - The first primitive to have a variable decides its interpolation and
+///   type, and whether or not the result is indexed.
+/// - Constant primitive variables are taken from the first primitive which
+///   has them.
+/// - Other primitive variables with a different type on later primitives
+///   are cast to match.
+/// - Conflicts which can't be resolved are dealt with according to `mode`.
+/// - Primitives missing a variable contribute default values.
+/// - If `transforms` is non-empty, it must contain a matrix per primitive,
+///   which is applied to 3d vector data according to its geometric
+///   interpretation.
+///
+/// Variables whose merged size wouldn't match `result` (for instance Uniform
+/// variables on points) are omitted. The variables are copied in parallel.
+void mergePrimitiveVariables( const std::vector<const Primitive *> &primitives, const std::vector<Imath::M44f> &transforms, Primitive *result, MergeMode mode );
+
+} // namespace Private
+
+} // namespace IECoreScene
+
+#endif // IECORESCENE_PRIMITIVEMERGE_H
@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef IECORESCENE_REMAPDATA_H
+#define IECORESCENE_REMAPDATA_H
+
+#include "IECoreScene/PrimitiveVariable.h"
+
+#include "IECore/DataAlgo.h"
+#include "IECore/DespatchTypedData.h"
+#include "IECore/TypeTraits.h"
+#include "IECore/VectorTypedData.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task.h"
+
+#include <vector>
+
+namespace IECoreScene
+{
+
+namespace Private
+{
+
+/// Returns new data containing `data[indices[i]]` for each of the indices.
+/// The remapping is performed in parallel.
+struct RemapData
+{
+	typedef IECore::DataPtr ReturnType;
+
+	RemapData( const std::vector<int> &indices )
+		:	m_indices( indices )
+	{
+	}
+
+	template<typename T>
+	ReturnType operator()( const T *data )
+	{
+		typename T::Ptr result = new T;
+		result->writable().resize( m_indices.size() );
+		remap( data->readable(), result->writable() );
+		IECore::setGeometricInterpretation( result.get(), IECore::getGeometricInterpretation( data ) );
+		return result;
+	}
+
+	private :
+
+		template<typename V>
+		void remap( const std::vector<V> &src, std::vector<V> &dst ) const
+		{
+			tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+			tbb::parallel_for(
+				tbb::blocked_range<size_t>( 0, m_indices.size() ),
+				[&]( const tbb::blocked_range<size_t> &range )
+				{
+					for( size_t i = range.begin(); i != range.end(); ++i )
+					{
+						dst[i] = src[m_indices[i]];
+					}
+				},
+				taskGroupContext
+			);
+		}
+
+		// Elements of `std::vector<bool>` can't be written concurrently.
+		void remap( const std::vector<bool> &src, std::vector<bool> &dst ) const
+		{
+			for( size_t i = 0; i < m_indices.size(); ++i )
+			{
+				dst[i] = src[m_indices[i]];
+			}
+		}
+
+		const std::vector<int> &m_indices;
+
+};
+
+/// Remaps `primitiveVariable` in place using `remap`. Indexed primitive
+/// variables remain indexed, and only their indices are remapped.
+inline void remapPrimitiveVariable( PrimitiveVariable &primitiveVariable, RemapData &remap )
+{
+	if( primitiveVariable.indices )
+	{
+		primitiveVariable.indices = boost::static_pointer_cast<IECore::IntVectorData>( remap( primitiveVariable.indices.get() ) );
+	}
+	else
+	{
+		primitiveVariable.data = IECore::despatchTypedData<RemapData, IECore::TypeTraits::IsVectorTypedData>( primitiveVariable.data.get(), remap );
+	}
+}
+
+} // namespace Private
+
+} // namespace IECoreScene
+
+#endif // IECORESCENE_REMAPDATA_H
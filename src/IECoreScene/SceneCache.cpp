@@ -35,26 +35,44 @@
 #include "IECoreScene/SceneCache.h"
 
 
+#include "HierarchyAlgo.h"
 #include "TagSetAlgo.h"
 
 #include "IECoreScene/Primitive.h"
 #include "IECoreScene/SharedSceneInterfaces.h"
 #include "IECoreScene/VisibleRenderable.h"
 
-#include "IECore/ComputationCache.h"
 #include "IECore/FileIndexedIO.h"
 #include "IECore/HeaderGenerator.h"
+#include "IECore/Interpolator.h"
+#include "IECore/LRUCache.h"
 #include "IECore/MessageHandler.h"
 #include "IECore/ObjectInterpolator.h"
+#include "IECore/ObjectPool.h"
+#include "IECore/ObjectStatistics.h"
 #include "IECore/SimpleTypedData.h"
+#include "IECore/Timer.h"
 #include "IECore/TransformationMatrixData.h"
 #include "IECore/PathMatcherData.h"
 
 #include "OpenEXR/ImathBoxAlgo.h"
 
+#include "boost/bind.hpp"
+#include "boost/noncopyable.hpp"
 #include "boost/tuple/tuple.hpp"
 
+#include "tbb/atomic.h"
+#include "tbb/blocked_range.h"
 #include "tbb/concurrent_hash_map.h"
+#include "tbb/concurrent_queue.h"
+#include "tbb/mutex.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task_group.h"
+#include "tbb/tbb_thread.h"
+
+#include <deque>
+#include <exception>
+#include <memory>
 
 using namespace IECore;
 using namespace IECoreScene;
@@ -94,6 +112,14 @@ const SceneInterface::Name &SceneCache::animatedObjectPrimVarsAttribute = Intern
 
 typedef std::vector<double> SampleTimes;
 
+// Settings for the caches of newly opened files, indexed by SceneCache::CacheType
+// and guarded by g_defaultCacheMutex. Every file has its own caches, which aren't
+// accounted for by the ObjectPool memory limit, so the default memory limits are
+// kept small to bound the memory used when many files are open.
+static tbb::mutex g_defaultCacheMutex;
+static size_t g_defaultCacheMemoryLimits[] = { 1024 * 1024, 2 * 1024 * 1024, 16 * 1024 * 1024 };
+static bool g_defaultCacheBufferDeduplication[] = { false, false, false };
+
 class SceneCache::Implementation : public RefCounted
 {
 	public :
@@ -102,6 +128,11 @@ class SceneCache::Implementation : public RefCounted
 		{
 		}
 
+		tbb::mutex *writerIOMutex() const
+		{
+			return m_writerIOMutex;
+		}
+
 		std::string fileName() const
 		{
 			if ( m_indexedIO->typeId() == FileIndexedIOTypeId )
@@ -285,7 +316,7 @@ class SceneCache::Implementation : public RefCounted
 
 	protected :
 
-		Implementation( IndexedIOPtr io ) : m_indexedIO(io)
+		Implementation( IndexedIOPtr io ) : m_indexedIO(io), m_writerIOMutex(nullptr)
 		{
 		}
 
@@ -310,6 +341,10 @@ class SceneCache::Implementation : public RefCounted
 		}
 
 		IndexedIOPtr m_indexedIO;
+		/// The mutex serialising access to the IndexedIO of a scene being written. It
+		/// is null for readers and flushed writers, so that WriterImplementation::IOLock
+		/// doesn't need to cast to find it.
+		tbb::mutex *m_writerIOMutex;
 };
 
 /// Reader implementation for SceneCache
@@ -420,6 +455,14 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 			return x;
 		}
 
+		// Returns the indices of the first and last samples used when reading at any time in the given range.
+		static inline void sampleRange( const SampleTimes &sampleTimes, double startTime, double endTime, size_t &firstIndex, size_t &lastIndex )
+		{
+			size_t unused;
+			sampleInterval( sampleTimes, startTime, firstIndex, unused );
+			sampleInterval( sampleTimes, std::max( startTime, endTime ), unused, lastIndex );
+		}
+
 		double boundSampleInterval( double time, size_t &floorIndex, size_t &ceilIndex ) const
 		{
 			const SampleTimes &sampleTimes = boundSampleTimes();
@@ -584,9 +627,33 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 			return m_sharedData->readObjectAtSample( this, sampleIndex );
 		}
 
+		// The writer saves any object sample identical to a previous one as a reference to the
+		// first copy. Returns true and the path to that copy if the given entry is a reference.
+		static bool objectSampleReference( const IndexedIO *objectIO, const IndexedIO::EntryID &entry, IndexedIO::EntryIDList &path )
+		{
+			const IndexedIO::Entry e = objectIO->entry( entry );
+			if ( e.entryType() != IndexedIO::File )
+			{
+				return false;
+			}
+			path.resize( e.arrayLength() );
+			InternedString *p = &(path[0]);
+			objectIO->read( entry, p, e.arrayLength() );
+			return true;
+		}
+
 		static PrimitiveVariableMap readObjectPrimitiveVariablesAtSample( const IndexedIOPtr &io, const std::vector<InternedString> &primVarNames, size_t sample )
 		{
-			return Primitive::loadPrimitiveVariables( io->subdirectory( objectEntry ).get(), sampleEntry(sample), primVarNames );
+			ConstIndexedIOPtr objectIO = io->subdirectory( objectEntry );
+			IndexedIO::EntryID entry = sampleEntry(sample);
+			IndexedIO::EntryIDList path;
+			if ( objectSampleReference( objectIO.get(), entry, path ) )
+			{
+				entry = path.back();
+				path.pop_back();
+				objectIO = objectIO->directory( path );
+			}
+			return Primitive::loadPrimitiveVariables( objectIO.get(), entry, primVarNames );
 		}
 
 		PrimitiveVariableMap readObjectPrimitiveVariables( const std::vector<InternedString> &primVarNames, double time ) const
@@ -603,9 +670,8 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 				return readObjectPrimitiveVariablesAtSample(m_indexedIO, primVarNames, sample2);
 			}
 
-			IndexedIOPtr objectIO = m_indexedIO->subdirectory( objectEntry );
-			PrimitiveVariableMap map1 = Primitive::loadPrimitiveVariables( objectIO.get(), sampleEntry(sample1), primVarNames );
-			PrimitiveVariableMap map2 = Primitive::loadPrimitiveVariables( objectIO.get(), sampleEntry(sample2), primVarNames );
+			PrimitiveVariableMap map1 = readObjectPrimitiveVariablesAtSample( m_indexedIO, primVarNames, sample1 );
+			PrimitiveVariableMap map2 = readObjectPrimitiveVariablesAtSample( m_indexedIO, primVarNames, sample2 );
 
 			for ( PrimitiveVariableMap::iterator it1 = map1.begin(); it1 != map1.end(); it1++ )
 			{
@@ -619,6 +685,152 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 			return map1;
 		}
 
+		Imath::Box3d readBound( double time ) const
+		{
+			size_t sample1, sample2;
+			double x = boundSampleInterval( time, sample1, sample2 );
+			if ( x == 0 )
+			{
+				return readBoundAtSample( sample1 );
+			}
+			if ( x == 1 )
+			{
+				return readBoundAtSample( sample2 );
+			}
+			Imath::Box3d result;
+			LinearInterpolator<Imath::Box3d>()( readBoundAtSample( sample1 ), readBoundAtSample( sample2 ), x, result );
+			return result;
+		}
+
+		Imath::M44d readTransformAsMatrix( double time ) const
+		{
+			if ( !m_indexedIO->hasEntry( transformEntry ) )
+			{
+				return Imath::M44d();
+			}
+
+			size_t sample1, sample2;
+			double x = transformSampleInterval( time, sample1, sample2 );
+			if ( x == 0 )
+			{
+				return readTransformAsMatrixAtSample( sample1 );
+			}
+			if ( x == 1 )
+			{
+				return readTransformAsMatrixAtSample( sample2 );
+			}
+
+			ConstDataPtr transform1 = readTransformAtSample( sample1 );
+			ConstDataPtr transform2 = readTransformAtSample( sample2 );
+			ConstDataPtr transform = runTimeCast< const Data >( linearObjectInterpolation( transform1.get(), transform2.get(), x ) );
+			if ( !transform )
+			{
+				// failed to interpolate, use the closest one
+				transform = ( x >= 0.5 ? transform2 : transform1 );
+			}
+			return dataToMatrix( transform.get() );
+		}
+
+		/// Returns the type of the object stored at this location, or InvalidTypeId if there's none.
+		/// The type is taken from the tag saved by the writer, to avoid loading the object.
+		IECore::TypeId objectType( double time ) const
+		{
+			if ( !hasObject() )
+			{
+				return InvalidTypeId;
+			}
+
+			ConstIndexedIOPtr tagsIO = m_indexedIO->subdirectory( localTagsEntry, IndexedIO::NullIfMissing );
+			if ( tagsIO )
+			{
+				static const std::string prefix( "ObjectType:" );
+				NameList tags;
+				tagsIO->entryIds( tags );
+				for ( NameList::const_iterator it = tags.begin(); it != tags.end(); ++it )
+				{
+					if ( it->string().compare( 0, prefix.size(), prefix ) == 0 )
+					{
+						return RunTimeTyped::typeIdFromTypeName( it->c_str() + prefix.size() );
+					}
+				}
+			}
+
+			size_t sample1, sample2;
+			objectSampleInterval( time, sample1, sample2 );
+			return readObjectAtSample( sample1 )->typeId();
+		}
+
+		/// Used by SceneCache::readHierarchy() to traverse the ReaderImplementations directly,
+		/// skipping the SceneCache instances and the virtual calls.
+		struct HierarchyAccessor
+		{
+			typedef ConstReaderImplementationPtr LocationPtr;
+
+			static void childNames( const LocationPtr &location, SceneCache::NameList &childNames )
+			{
+				location->childNames( childNames );
+			}
+
+			static LocationPtr child( const LocationPtr &location, const SceneCache::Name &name )
+			{
+				return location->child( name, SceneInterface::ThrowIfMissing );
+			}
+
+			static Imath::M44d transform( const LocationPtr &location, double time )
+			{
+				return location->readTransformAsMatrix( time );
+			}
+
+			static Imath::Box3d bound( const LocationPtr &location, double time )
+			{
+				return location->readBound( time );
+			}
+
+			static IECore::TypeId objectType( const LocationPtr &location, double time )
+			{
+				return location->objectType( time );
+			}
+		};
+
+		/// Loads into the shared caches all the samples needed to read this location
+		/// at any time in the range [startTime, endTime].
+		void prefetch( int what, double startTime, double endTime ) const
+		{
+			size_t firstIndex, lastIndex;
+
+			if( ( what & SceneCache::PrefetchTransforms ) && m_indexedIO->hasEntry( transformEntry ) )
+			{
+				sampleRange( transformSampleTimes(), startTime, endTime, firstIndex, lastIndex );
+				for( size_t i = firstIndex; i <= lastIndex; ++i )
+				{
+					readTransformAtSample( i );
+				}
+			}
+
+			if( what & SceneCache::PrefetchAttributes )
+			{
+				NameList attrs;
+				attributeNames( attrs );
+				for( NameList::const_iterator it = attrs.begin(); it != attrs.end(); ++it )
+				{
+					sampleRange( attributeSampleTimes( *it ), startTime, endTime, firstIndex, lastIndex );
+					for( size_t i = firstIndex; i <= lastIndex; ++i )
+					{
+						readAttributeAtSample( *it, i );
+					}
+				}
+			}
+
+			if( ( what & SceneCache::PrefetchObjects ) && hasObject() )
+			{
+				sampleRange( objectSampleTimes(), startTime, endTime, firstIndex, lastIndex );
+				for( size_t i = firstIndex; i <= lastIndex; ++i )
+				{
+					readObjectAtSample( i );
+				}
+			}
+		}
+
 		ReaderImplementationPtr child( const Name &name, MissingBehaviour missingBehaviour )
 		{
 			IndexedIOPtr children = m_indexedIO->subdirectory( childrenEntry, (IndexedIO::MissingBehaviour)missingBehaviour );
@@ -757,6 +969,31 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 			}
 		}
 
+		SceneCache::CacheStatistics cacheStatistics( SceneCache::CacheType type ) const
+		{
+			return m_sharedData->cache( type )->statistics();
+		}
+
+		void setCacheMemoryLimit( SceneCache::CacheType type, size_t bytes )
+		{
+			m_sharedData->cache( type )->setMaxMemoryUsage( bytes );
+		}
+
+		size_t getCacheMemoryLimit( SceneCache::CacheType type ) const
+		{
+			return m_sharedData->cache( type )->getMaxMemoryUsage();
+		}
+
+		void setCacheBufferDeduplication( SceneCache::CacheType type, bool enabled )
+		{
+			m_sharedData->cache( type )->setBufferDeduplication( enabled );
+		}
+
+		bool getCacheBufferDeduplication( SceneCache::CacheType type ) const
+		{
+			return m_sharedData->cache( type )->getBufferDeduplication();
+		}
+
 		static ReaderImplementation *reader( Implementation *impl, bool throwException = true )
 		{
 			ReaderImplementation *reader = dynamic_cast< ReaderImplementation* >( impl );
@@ -850,14 +1087,183 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 
 		// \todo Consider using concurrent_vector for constant access time.
 		typedef tbb::concurrent_hash_map< uint64_t, SampleTimes > SampleTimesMap;
+		typedef tbb::concurrent_hash_map< MurmurHash, MurmurHash > ObjectHashMap;
 		typedef std::map< IndexedIO::EntryID, const SampleTimes* > AttributeSamplesMap;
 		typedef tbb::spin_rw_mutex AttributeMapMutex;
 
 		typedef std::pair< const ReaderImplementation *, size_t > SimpleCacheKey;
 		typedef tuple< const ReaderImplementation *, const SceneCache::Name &, size_t > AttributeCacheKey;
 
-		typedef IECore::ComputationCache< SimpleCacheKey > SimpleCache;
-		typedef IECore::ComputationCache< AttributeCacheKey > AttributeCache;
+		/// The interface of the data caches used to report their usage and change their limits.
+		class DataCacheBase : public RefCounted
+		{
+			public :
+
+				IE_CORE_DECLAREMEMBERPTR( DataCacheBase )
+
+				virtual SceneCache::CacheStatistics statistics() const = 0;
+				virtual void setMaxMemoryUsage( size_t maxMemory ) = 0;
+				virtual size_t getMaxMemoryUsage() const = 0;
+				virtual void setBufferDeduplication( bool enabled ) = 0;
+				virtual bool getBufferDeduplication() const = 0;
+
+		};
+
+		/// LRUCache for the data loaded from the file, limited by the memory used by the loaded
+		/// objects. The loaded objects are also stored in the default ObjectPool, so that identical
+		/// objects are shared with the other files and clients.
+		template< typename T >
+		class DataCache : public DataCacheBase
+		{
+			public :
+
+				typedef ObjectPtr (*LoadFn)( const T & );
+				typedef MurmurHash (*HashFn)( const T & );
+
+				IE_CORE_DECLAREMEMBERPTR( DataCache )
+
+				DataCache( LoadFn loadFn, HashFn hashFn, size_t maxMemory, bool bufferDeduplication )
+					:	m_loadFn( loadFn ), m_hashFn( hashFn ),
+						m_cache( boost::bind( &DataCache::getter, this, ::_1, ::_2 ), boost::bind( &DataCache::removed, this, ::_1, ::_2 ), maxMemory )
+				{
+					m_bufferDeduplication = bufferDeduplication;
+					m_requests = 0;
+					m_misses = 0;
+					m_evictions = 0;
+					m_loadTime = 0;
+				}
+
+				/// Returns the cached object, loading it from the file if necessary. When
+				/// loadIfMissing is false, returns null for objects not in the cache instead.
+				/// Such probes aren't counted in the statistics, so that a read which probes
+				/// several entries is only counted once. Callers which don't go on to load
+				/// the object must count the read themselves with countRequest().
+				ConstObjectPtr get( const T &args, bool loadIfMissing = true )
+				{
+					const Key key( args, m_hashFn( args ), loadIfMissing );
+					if ( loadIfMissing )
+					{
+						++m_requests;
+					}
+					else if ( !m_cache.cached( key.hash ) )
+					{
+						return nullptr;
+					}
+					return m_cache.get( key );
+				}
+
+				/// Counts a request which was satisfied without loading the object via get().
+				void countRequest( bool hit )
+				{
+					++m_requests;
+					if ( !hit )
+					{
+						++m_misses;
+					}
+				}
+
+				/// Registers an object computed by the caller.
+				void set( const T &args, const Object *obj )
+				{
+					ConstObjectPtr stored = ObjectPool::defaultObjectPool()->store( obj, storeMode() );
+					m_cache.set( m_hashFn( args ), stored, stored->memoryUsage() );
+				}
+
+				SceneCache::CacheStatistics statistics() const override
+				{
+					SceneCache::CacheStatistics result;
+					result.misses = m_misses;
+					result.hits = m_requests - result.misses;
+					result.evictions = m_evictions;
+					result.memoryUsage = m_cache.currentCost();
+					result.loadTime = (double)m_loadTime * 1e-9;
+					return result;
+				}
+
+				void setMaxMemoryUsage( size_t maxMemory ) override
+				{
+					m_cache.setMaxCost( maxMemory );
+				}
+
+				size_t getMaxMemoryUsage() const override
+				{
+					return m_cache.getMaxCost();
+				}
+
+				void setBufferDeduplication( bool enabled ) override
+				{
+					m_bufferDeduplication = enabled;
+				}
+
+				bool getBufferDeduplication() const override
+				{
+					return m_bufferDeduplication;
+				}
+
+			private :
+
+				// Key passed to the getter, so the hash is only computed once per request.
+				struct Key
+				{
+					Key( const T &args, const MurmurHash &hash, bool counted ) : args( args ), hash( hash ), counted( counted )
+					{
+					}
+
+					operator const MurmurHash &() const
+					{
+						return hash;
+					}
+
+					const T &args;
+					MurmurHash hash;
+					// False for probes, which may still load the object if it is
+					// evicted after being found in the cache.
+					bool counted;
+				};
+
+				// Traversals of the whole file, for instance to compute bounds or
+				// checksums, would otherwise evict the data used interactively.
+				typedef LRUCache< MurmurHash, ConstObjectPtr, LRUCachePolicy::ScanResistant, Key > Cache;
+
+				ConstObjectPtr getter( const Key &key, size_t &cost )
+				{
+					if ( key.counted )
+					{
+						++m_misses;
+					}
+					Timer timer( true, Timer::WallClock );
+					ObjectPtr loaded = m_loadFn( key.args );
+					ConstObjectPtr result = ObjectPool::defaultObjectPool()->store( loaded.get(), storeMode() );
+					m_loadTime += (uint64_t)( timer.stop() * 1e9 );
+					cost = result->memoryUsage();
+					return result;
+				}
+
+				void removed( const MurmurHash &, const ConstObjectPtr & )
+				{
+					++m_evictions;
+				}
+
+				ObjectPool::StoreMode storeMode() const
+				{
+					return m_bufferDeduplication ? ObjectPool::StoreDeduplicated : ObjectPool::StoreReference;
+				}
+
+				LoadFn m_loadFn;
+				HashFn m_hashFn;
+				Cache m_cache;
+
+				tbb::atomic<size_t> m_requests;
+				tbb::atomic<size_t> m_misses;
+				tbb::atomic<size_t> m_evictions;
+				// in nanoseconds
+				tbb::atomic<uint64_t> m_loadTime;
+				tbb::atomic<bool> m_bufferDeduplication;
+
+		};
+
+		typedef DataCache< SimpleCacheKey > SimpleCache;
+		typedef DataCache< AttributeCacheKey > AttributeDataCache;
 
 		/// Hold pointers to values allocated/deallocated by the root scene object (the last one to die)
 		class SharedData : public RefCounted
@@ -865,10 +1271,25 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 			public :
 
 				SharedData() :
-					objectCache( new SimpleCache( doReadObjectAtSample, simpleHash,  10000 )  ),
-					attributeCache( new AttributeCache( doReadAttributeAtSample, attributeHash, 1000) ),
-					transformCache( new SimpleCache(  doReadTransformAtSample, simpleHash, 1000) )
+					objectCache( new SimpleCache( doReadObjectAtSample, objectHash, SceneCache::getDefaultCacheMemoryLimit( SceneCache::ObjectCache ), SceneCache::getDefaultCacheBufferDeduplication( SceneCache::ObjectCache ) ) ),
+					attributeCache( new AttributeDataCache( doReadAttributeAtSample, attributeHash, SceneCache::getDefaultCacheMemoryLimit( SceneCache::AttributeCache ), SceneCache::getDefaultCacheBufferDeduplication( SceneCache::AttributeCache ) ) ),
+					transformCache( new SimpleCache( doReadTransformAtSample, simpleHash, SceneCache::getDefaultCacheMemoryLimit( SceneCache::TransformCache ), SceneCache::getDefaultCacheBufferDeduplication( SceneCache::TransformCache ) ) )
+				{
+				}
+
+				DataCacheBase *cache( SceneCache::CacheType type )
 				{
+					switch( type )
+					{
+						case SceneCache::TransformCache :
+							return transformCache.get();
+						case SceneCache::AttributeCache :
+							return attributeCache.get();
+						case SceneCache::ObjectCache :
+							return objectCache.get();
+						default :
+							throw Exception( "Invalid cache type!" );
+					}
 				}
 
 				/// utility function used by the ReaderImplementation to use the LRUCache for transform reading
@@ -889,11 +1310,15 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 						/// Could not create the object from another time sample... so we load the entire object
 						SimpleCacheKey defaultKey( reader, defaultSample );
 
-						ConstObjectPtr obj = objectCache->get( currentKey, SimpleCache::NullIfMissing );
-						if ( !obj )
+						ConstObjectPtr obj = objectCache->get( currentKey, false );
+						if ( obj )
+						{
+							objectCache->countRequest( /* hit = */ true );
+						}
+						else
 						{
 							/// ok, try to build the object from another frame...
-							ConstObjectPtr defaultObj = objectCache->get( defaultKey, SimpleCache::NullIfMissing );
+							ConstObjectPtr defaultObj = objectCache->get( defaultKey, false );
 							if ( defaultObj )
 							{
 								IECore::ConstInternedStringVectorDataPtr varNames = runTimeCast<const InternedStringVectorData>( reader->readAttributeAtSample(animatedObjectPrimVarsAttribute, 0) );
@@ -904,7 +1329,8 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 									{
 										// we managed to load the object from a different time sample from the cache, just have to load the changing prim vars...
 										mergeMaps( prim->variables, readObjectPrimitiveVariablesAtSample( reader->m_indexedIO, varNames->readable(), sample ) );
-										objectCache->set( currentKey, prim.get(), ObjectPool::StoreReference );
+										objectCache->set( currentKey, prim.get() );
+										objectCache->countRequest( /* hit = */ false );
 										return prim;
 									}
 								}
@@ -913,7 +1339,7 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 							obj = objectCache->get( currentKey );
 						}
 						/// register the object as the default, so next frames could reuse them
-						objectCache->set( defaultKey, obj.get(), ObjectPool::StoreReference );
+						objectCache->set( defaultKey, obj.get() );
 						return obj;
 					}
 					/// The object has animated topology... so we load the entire object
@@ -929,10 +1355,18 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 
 				// \todo Consider adding "ReaderImplementation *rootScene" to optimize the scene() calls.
 				SampleTimesMap sampleTimesMap;
+				/// maps the hash of a location and sample to the hash used by the object cache.
+				ObjectHashMap objectHashes;
 				SimpleCache::Ptr objectCache;
-				AttributeCache::Ptr attributeCache;
+				AttributeDataCache::Ptr attributeCache;
 				SimpleCache::Ptr transformCache;
 
+#ifdef IECORE_OBJECTSTATISTICS
+				ObjectStatistics::Owner objectCacheOwner{ "SceneCache.ObjectCache", [this] { return objectCache->statistics().memoryUsage; } };
+				ObjectStatistics::Owner attributeCacheOwner{ "SceneCache.AttributeCache", [this] { return attributeCache->statistics().memoryUsage; } };
+				ObjectStatistics::Owner transformCacheOwner{ "SceneCache.TransformCache", [this] { return transformCache->statistics().memoryUsage; } };
+#endif
+
 			private :
 
 			// utility function that copies all the values from the rhs dictionary to the lhs.
@@ -1044,7 +1478,7 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 			return &(it->second);
 		}
 
-		void sceneHash( MurmurHash &h ) const
+		void fileHash( MurmurHash &h ) const
 		{
 			if( FileIndexedIO *fileIndexedIO = runTimeCast<FileIndexedIO>( m_indexedIO.get() ) )
 			{
@@ -1060,6 +1494,11 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 				/// when writing it, and just load them here.
 				h.append( (uint64_t)m_sharedData );
 			}
+		}
+
+		void sceneHash( MurmurHash &h ) const
+		{
+			fileHash( h );
 
 			const ReaderImplementation *currScene = this;
 			while( currScene->m_parent )
@@ -1080,6 +1519,40 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 			return h;
 		}
 
+		// Object samples are identified by their location in the file, so that samples
+		// saved as references share the cache entry of the sample they refer to. Resolving
+		// the references is too expensive to do on every lookup, so it is only done the
+		// first time a sample is requested, and the result is kept in m_sharedData.
+		static MurmurHash objectHash( const SimpleCacheKey &key )
+		{
+			const ReaderImplementation *reader = key.first;
+			const MurmurHash locationHash = simpleHash( key );
+			{
+				ObjectHashMap::const_accessor it;
+				if ( reader->m_sharedData->objectHashes.find( it, locationHash ) )
+				{
+					return it->second;
+				}
+			}
+
+			const IndexedIO::EntryID entry = sampleEntry( key.second );
+
+			IndexedIO::EntryIDList path;
+			ConstIndexedIOPtr objectIO = reader->m_indexedIO->subdirectory( objectEntry, IndexedIO::NullIfMissing );
+			if ( !objectIO || !objectIO->hasEntry( entry ) || !objectSampleReference( objectIO.get(), entry, path ) )
+			{
+				reader->m_indexedIO->path( path );
+				path.push_back( objectEntry );
+				path.push_back( entry );
+			}
+
+			MurmurHash h;
+			reader->fileHash( h );
+			h.append( &(path[0]), path.size() );
+			reader->m_sharedData->objectHashes.insert( ObjectHashMap::value_type( locationHash, h ) );
+			return h;
+		}
+
 		// static function used by the cache mechanism to actually load the object data from file.
 		static ObjectPtr doReadTransformAtSample( const SimpleCacheKey &key )
 		{
@@ -1145,59 +1618,398 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 
 SceneCache::ReaderImplementation::Defaults SceneCache::ReaderImplementation::g_defaults;
 
-/// Writer implementation for SceneCache
-/// Each location keeps refcount pointers to their child locations, so they can always return the same (unfinished child) and when the root is destroyed, it
-/// can trigger the recursive computation of bounding boxes and the global storage of all sampleTime vectors used in the file.
-class SceneCache::WriterImplementation : public SceneCache::Implementation
+//////////////////////////////////////////////////////////////////////////
+// Prefetch
+//////////////////////////////////////////////////////////////////////////
+
+class SceneCache::Prefetch::Implementation : public RefCounted
 {
+
 	public :
 
-		IE_CORE_DECLAREPTR( WriterImplementation )
+		Implementation( const PathMatcher &paths, double startTime, double endTime, int what )
+			:	m_paths( paths ), m_startTime( startTime ), m_endTime( endTime ), m_what( what )
+		{
+			m_pendingTasks = 0;
+			m_cancelled = false;
+		}
 
-		WriterImplementation( IndexedIOPtr io, Implementation *parent = nullptr) : SceneCache::Implementation( io ), m_parent(static_cast< WriterImplementation* >( parent ))
+		void start( ReaderImplementationPtr location )
 		{
-			if ( m_parent )
-			{
-				// use same map from the root
-				m_sampleTimesMap = m_parent->m_sampleTimesMap;
-			}
-			else
-			{
-				// only the root instance allocate the map.
-				m_sampleTimesMap = new SampleTimesMap;
-			}
+			spawn( location, SceneInterface::Path() );
 		}
 
-		~WriterImplementation() override
+		void wait()
 		{
-			// the root location destruction triggers the flush on the file.
-			if ( !m_parent )
+			waitForTasks();
+			tbb::mutex::scoped_lock lock( m_exceptionMutex );
+			if( m_exception )
 			{
-				try
-				{
-					flush();
-				}
-				catch ( Exception &e )
-				{
-					msg( Msg::Error, "SceneCache::~SceneCache", ( boost::format( "Corrupted file resulted from exception while flushing data: %s." ) % e.what() ).str() );
-				}
-				catch (...)
-				{
-					msg( Msg::Error, "SceneCache::~SceneCache", "Corrupted file resulted from unknown exception while flushing data." );
-				}
+				std::rethrow_exception( m_exception );
 			}
 		}
 
-		const SceneCache::Name &name() const
+		void cancel()
 		{
-			if ( m_parent )
-			{
-				return m_indexedIO->currentEntryId();
-			}
-			return SceneInterface::rootName;
+			m_cancelled = true;
+			waitForTasks();
 		}
 
-		void path( SceneCache::Path &p ) const
+		bool done() const
+		{
+			return m_pendingTasks == 0;
+		}
+
+	private :
+
+		// Decrements the pending task count however a task exits.
+		struct PendingTask : boost::noncopyable
+		{
+			PendingTask( tbb::atomic<size_t> &pendingTasks ) : m_pendingTasks( pendingTasks ) {}
+			~PendingTask() { --m_pendingTasks; }
+			tbb::atomic<size_t> &m_pendingTasks;
+		};
+
+		void waitForTasks()
+		{
+			tbb::mutex::scoped_lock lock( m_waitMutex );
+			m_tasks.wait();
+		}
+
+		void spawn( ReaderImplementationPtr location, const SceneInterface::Path &path )
+		{
+			++m_pendingTasks;
+			try
+			{
+				m_tasks.run(
+					[this, location, path] {
+						PendingTask pendingTask( m_pendingTasks );
+						try
+						{
+							visit( location.get(), path );
+						}
+						catch( ... )
+						{
+							// Failing to traverse the hierarchy is an error in the
+							// file itself, so we keep it for wait() to report.
+							tbb::mutex::scoped_lock lock( m_exceptionMutex );
+							if( !m_exception )
+							{
+								m_exception = std::current_exception();
+							}
+						}
+					}
+				);
+			}
+			catch( ... )
+			{
+				--m_pendingTasks;
+				throw;
+			}
+		}
+
+		void visit( const ReaderImplementation *location, const SceneInterface::Path &path )
+		{
+			if( m_cancelled )
+			{
+				return;
+			}
+
+			const unsigned match = m_paths.match( path );
+
+			if( match & PathMatcher::ExactMatch )
+			{
+				try
+				{
+					location->prefetch( m_what, m_startTime, m_endTime );
+				}
+				catch( ... )
+				{
+					// The same error will be raised when the data is read
+					// by the client, which is better placed to report it.
+				}
+			}
+
+			if( !( match & PathMatcher::DescendantMatch ) )
+			{
+				return;
+			}
+
+			NameList childNames;
+			location->childNames( childNames );
+
+			SceneInterface::Path childPath = path;
+			childPath.push_back( SceneInterface::Name() );
+			for( NameList::const_iterator it = childNames.begin(); it != childNames.end() && !m_cancelled; ++it )
+			{
+				childPath.back() = *it;
+				if( m_paths.match( childPath ) == PathMatcher::NoMatch )
+				{
+					continue;
+				}
+				spawn( location->child( *it, SceneInterface::ThrowIfMissing ), childPath );
+			}
+		}
+
+		const PathMatcher m_paths;
+		const double m_startTime;
+		const double m_endTime;
+		const int m_what;
+
+		tbb::task_group m_tasks;
+		tbb::mutex m_waitMutex;
+		tbb::atomic<size_t> m_pendingTasks;
+		tbb::atomic<bool> m_cancelled;
+		tbb::mutex m_exceptionMutex;
+		std::exception_ptr m_exception;
+
+};
+
+SceneCache::Prefetch::Prefetch( ImplementationPtr implementation )
+	:	m_implementation( implementation )
+{
+}
+
+SceneCache::Prefetch::~Prefetch()
+{
+	try
+	{
+		m_implementation->cancel();
+	}
+	catch( ... )
+	{
+		// We mustn't throw from a destructor, and the client
+		// is no longer interested in the results anyway.
+	}
+}
+
+void SceneCache::Prefetch::wait()
+{
+	m_implementation->wait();
+}
+
+void SceneCache::Prefetch::cancel()
+{
+	m_implementation->cancel();
+}
+
+bool SceneCache::Prefetch::done() const
+{
+	return m_implementation->done();
+}
+
+namespace
+{
+
+/// Saves the object samples of a scene being written, replacing any sample identical to
+/// one saved before with a reference to the first copy. The references are written in
+/// the same form used by Object::SaveContext, so Object::load() resolves them for free.
+class UniqueSampleWriter : private boost::noncopyable
+{
+	public :
+
+		void save( const Object *object, IndexedIOPtr io, const IndexedIO::EntryID &name )
+		{
+			const MurmurHash hash = object->hash();
+			SavedSamples::const_iterator it = m_savedSamples.find( hash );
+			if ( it != m_savedSamples.end() )
+			{
+				io->write( name, &(it->second[0]), it->second.size() );
+				return;
+			}
+
+			object->save( io, name );
+
+			IndexedIO::EntryIDList &path = m_savedSamples[hash];
+			io->path( path );
+			path.push_back( name );
+		}
+
+	private :
+
+		typedef std::map< MurmurHash, IndexedIO::EntryIDList > SavedSamples;
+		SavedSamples m_savedSamples;
+
+};
+
+/// Queues the samples written by a pipelined WriterImplementation. A single appender thread saves
+/// them to the file in the order they were written, while the caller carries on producing the next
+/// samples. The per-sample analysis required by the flush runs in parallel on the task scheduler.
+class WriterPipeline : private boost::noncopyable
+{
+	public :
+
+		WriterPipeline( tbb::mutex &ioMutex, UniqueSampleWriter &uniqueSampleWriter )
+			:	m_ioMutex( ioMutex ), m_uniqueSampleWriter( uniqueSampleWriter )
+		{
+			// bounds the memory held by samples waiting to be saved
+			m_queue.set_capacity( 128 );
+			tbb::tbb_thread appender( boost::bind( &WriterPipeline::append, this ) );
+			m_thread.swap( appender );
+		}
+
+		~WriterPipeline()
+		{
+			if ( m_thread.joinable() )
+			{
+				try
+				{
+					finish();
+				}
+				catch ( std::exception &e )
+				{
+					msg( Msg::Error, "SceneCache::~SceneCache", e.what() );
+				}
+			}
+		}
+
+		// Queues the object to be saved by the appender thread as the given entry of io.
+		// Unique samples are saved through the UniqueSampleWriter.
+		void save( IndexedIOPtr io, const IndexedIO::EntryID &name, ConstObjectPtr object, bool unique = false )
+		{
+			m_queue.push( Sample( io, name, object, unique ) );
+		}
+
+		// Runs f in parallel with the caller. Exceptions are rethrown by finish().
+		template<typename F>
+		void run( const F &f )
+		{
+			m_tasks.run( f );
+		}
+
+		// Waits for all the queued samples to be saved and all the tasks to be completed.
+		void finish()
+		{
+			m_queue.push( Sample() );
+			m_thread.join();
+			m_tasks.wait();
+			if ( m_error.size() )
+			{
+				throw IOException( m_error );
+			}
+		}
+
+	private :
+
+		struct Sample
+		{
+			Sample() : unique( false )
+			{
+			}
+
+			Sample( IndexedIOPtr io, const IndexedIO::EntryID &name, ConstObjectPtr object, bool unique )
+				:	io( io ), name( name ), object( object ), unique( unique )
+			{
+			}
+
+			IndexedIOPtr io;
+			IndexedIO::EntryID name;
+			ConstObjectPtr object;
+			bool unique;
+		};
+
+		void append()
+		{
+			Sample sample;
+			while( true )
+			{
+				m_queue.pop( sample );
+				if ( !sample.object )
+				{
+					// end of the queue signalled by finish().
+					break;
+				}
+				// after the first error we keep draining the queue so the caller never blocks.
+				if ( m_error.empty() )
+				{
+					try
+					{
+						tbb::mutex::scoped_lock lock( m_ioMutex );
+						if ( sample.unique )
+						{
+							m_uniqueSampleWriter.save( sample.object.get(), sample.io, sample.name );
+						}
+						else
+						{
+							sample.object->save( sample.io, sample.name );
+						}
+					}
+					catch ( std::exception &e )
+					{
+						m_error = e.what();
+					}
+				}
+				sample = Sample();
+			}
+		}
+
+		tbb::mutex &m_ioMutex;
+		// only accessed by the appender thread until it is joined.
+		UniqueSampleWriter &m_uniqueSampleWriter;
+		tbb::concurrent_bounded_queue<Sample> m_queue;
+		tbb::task_group m_tasks;
+		// only accessed by the appender thread until it is joined.
+		std::string m_error;
+		tbb::tbb_thread m_thread;
+
+};
+
+} // namespace
+
+/// Writer implementation for SceneCache
+/// Each location keeps refcount pointers to their child locations, so they can always return the same (unfinished child) and when the root is destroyed, it
+/// can trigger the recursive computation of bounding boxes and the global storage of all sampleTime vectors used in the file.
+class SceneCache::WriterImplementation : public SceneCache::Implementation
+{
+	public :
+
+		IE_CORE_DECLAREPTR( WriterImplementation )
+
+		WriterImplementation( IndexedIOPtr io, Implementation *parent = nullptr) : SceneCache::Implementation( io ), m_parent(static_cast< WriterImplementation* >( parent ))
+		{
+			if ( m_parent )
+			{
+				// use same map from the root
+				m_sampleTimesMap = m_parent->m_sampleTimesMap;
+			}
+			else
+			{
+				// only the root instance allocate the map.
+				m_sampleTimesMap = new SampleTimesMap;
+			}
+			m_writerIOMutex = &root()->m_ioMutex;
+		}
+
+		~WriterImplementation() override
+		{
+			// the root location destruction triggers the flush on the file.
+			if ( !m_parent )
+			{
+				try
+				{
+					flush();
+				}
+				catch ( Exception &e )
+				{
+					msg( Msg::Error, "SceneCache::~SceneCache", ( boost::format( "Corrupted file resulted from exception while flushing data: %s." ) % e.what() ).str() );
+				}
+				catch (...)
+				{
+					msg( Msg::Error, "SceneCache::~SceneCache", "Corrupted file resulted from unknown exception while flushing data." );
+				}
+			}
+		}
+
+		const SceneCache::Name &name() const
+		{
+			if ( m_parent )
+			{
+				return m_indexedIO->currentEntryId();
+			}
+			return SceneInterface::rootName;
+		}
+
+		void path( SceneCache::Path &p ) const
 		{
 			IndexedIO::EntryIDList ioPath;
 			m_indexedIO->path( ioPath );
@@ -1256,9 +2068,19 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			}
 			size_t sampleIndex = m_transformSampleTimes.size();
 			m_transformSampleTimes.push_back( time );
-			IndexedIOPtr io = m_indexedIO->subdirectory( transformEntry, IndexedIO::CreateIfMissing );
-			((const Object *)transform)->save( io, sampleEntry(sampleIndex) );
-			m_transformSamples.push_back( transform );
+			ConstDataPtr sample = transform;
+			if ( getPipelined() )
+			{
+				// the sample is saved later on, so we protect it from further changes by the caller.
+				sample = transform->copy();
+			}
+			IndexedIOPtr io;
+			{
+				IOLock lock( this );
+				io = m_indexedIO->subdirectory( transformEntry, IndexedIO::CreateIfMissing );
+			}
+			saveSample( sample.get(), io, sampleEntry(sampleIndex) );
+			m_transformSamples.push_back( sample );
 		}
 
 		void writeAttribute( const SceneCache::Name &name, const Object *attribute, double time )
@@ -1287,14 +2109,24 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			}
 			size_t sampleIndex = sampleTimes.size();
 			sampleTimes.push_back( time );
-			IndexedIOPtr io = m_indexedIO->subdirectory( attributesEntry, IndexedIO::CreateIfMissing );
-			io = io->subdirectory( name, IndexedIO::CreateIfMissing );
-			attribute->save( io, sampleEntry(sampleIndex) );
+			ConstObjectPtr sample = attribute;
+			if ( getPipelined() )
+			{
+				sample = attribute->copy();
+			}
+			IndexedIOPtr io;
+			{
+				IOLock lock( this );
+				io = m_indexedIO->subdirectory( attributesEntry, IndexedIO::CreateIfMissing );
+				io = io->subdirectory( name, IndexedIO::CreateIfMissing );
+			}
+			saveSample( sample.get(), io, sampleEntry(sampleIndex) );
 		}
 
 		void writeLocalTag( const char *tag )
 		{
 			writable();
+			IOLock lock( this );
 			IndexedIOPtr io = m_indexedIO->subdirectory( localTagsEntry, IndexedIO::CreateIfMissing );
 			// we just create a IndexedIO::Directory
 			io->subdirectory( tag, IndexedIO::CreateIfMissing );
@@ -1307,6 +2139,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 				return;
 			}
 			writable();
+			IOLock lock( this );
 			IndexedIOPtr io(nullptr);
 			if ( tagLocation == SceneInterface::LocalTag )
 			{
@@ -1351,67 +2184,43 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 					throw Exception( "Times must be incremental amongst calls to writeObject!" );
 				}
 			}
+
+			const bool renderable = runTimeCast< const VisibleRenderable >( object );
+			if ( m_objectSampleInfo.size() && m_objectSampleInfo.front().renderable != renderable )
+			{
+				throw Exception( "Either all object samples must have bounds (VisibleRenderable) or none of them!" );
+			}
+
 			size_t sampleIndex = m_objectSampleTimes.size();
 			m_objectSampleTimes.push_back( time );
-			IndexedIOPtr io = m_indexedIO->subdirectory( objectEntry, IndexedIO::CreateIfMissing );
-			object->save( io, sampleEntry(sampleIndex) );
+			// deque elements are never moved, so the pipeline tasks can fill them in while more samples are added.
+			m_objectSampleInfo.push_back( ObjectSampleInfo() );
+			ObjectSampleInfo *info = &m_objectSampleInfo.back();
+			info->renderable = renderable;
 
-			const VisibleRenderable *renderable = runTimeCast< const VisibleRenderable >( object );
-			if ( renderable )
+			IndexedIOPtr io;
 			{
-				if ( !m_objectSamples.size() && m_objectSampleTimes.size() > 1 )
-				{
-					throw Exception( "Either all object samples must have bounds (VisibleRenderable) or none of them!" );
-				}
+				IOLock lock( this );
+				io = m_indexedIO->subdirectory( objectEntry, IndexedIO::CreateIfMissing );
+			}
 
-				const Primitive *primitive = runTimeCast< const Primitive >( renderable );
-				if ( primitive )
+			if ( WriterPipeline *pipeline = root()->m_pipeline.get() )
+			{
+				ConstObjectPtr sample = object->copy();
+				pipeline->save( io, sampleEntry(sampleIndex), sample, true );
+				if ( renderable )
 				{
-					MurmurHash topologyHash;
-					primitive->topologyHash( topologyHash );
-					topologyHash.append( primitive->typeId() );
-					if ( m_objectSamples.empty() )
-					{
-						m_animatedObjectTopology = AnimatedHashTest( topologyHash, false );
-					}
-
-					if ( topologyHash != m_animatedObjectTopology.first )
-					{
-						m_animatedObjectTopology.second = true;
-					}
-
-					for ( PrimitiveVariableMap::const_iterator it = primitive->variables.begin(); it != primitive->variables.end(); ++it )
-					{
-						Name primVarName = Name( it->first );
-
-						MurmurHash hash;
-						it->second.data->hash( hash );
-						hash.append( it->second.interpolation );
-
-						AnimatedPrimVarMap::iterator pIt = m_animatedObjectPrimVars.find( primVarName );
-						if ( pIt == m_animatedObjectPrimVars.end() )
-						{
-							m_animatedObjectPrimVars.insert( AnimatedPrimVarMap::value_type( primVarName, AnimatedHashTest( hash, false ) ) );
-						}
-						else if ( hash != pIt->second.first )
-						{
-							pIt->second.second = true;
-						}
-					}
+					pipeline->run( [sample, info] { analyseObjectSample( sample.get(), *info ); } );
 				}
-
-				Box3f bf = renderable->bound();
-				Box3d bd(
-					V3d( bf.min.x, bf.min.y, bf.min.z ),
-					V3f( bf.max.x, bf.max.y, bf.max.z )
-				);
-				m_objectSamples.push_back( bd );
 			}
 			else
 			{
-				if ( m_objectSamples.size() )
+				// static objects are usually written at every frame, and instanced ones at many
+				// locations, so each distinct object is only saved once in the file.
+				root()->m_uniqueSampleWriter.save( object, io, sampleEntry(sampleIndex) );
+				if ( renderable )
 				{
-					throw Exception( "Either all object samples must have bounds (VisibleRenderable) or none of them!" );
+					analyseObjectSample( object, *info );
 				}
 			}
 
@@ -1430,6 +2239,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			IECore::PathMatcherDataPtr setData = new IECore::PathMatcherData();
 			setData->writable() = set;
 
+			IOLock lock( this );
 			IndexedIOPtr setsIO = m_indexedIO->subdirectory( setsEntry, IndexedIO::CreateIfMissing );
 			setData->Object::save( setsIO, name );
 		}
@@ -1447,6 +2257,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 				return it->second;
 			}
 
+			IOLock lock( this );
 			IndexedIOPtr children = m_indexedIO->subdirectory( childrenEntry, (IndexedIO::MissingBehaviour)missingBehaviour );
 			if ( !children )
 			{
@@ -1465,6 +2276,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 		SceneCache::ImplementationPtr createChild( const SceneCache::Name &name )
 		{
 			writable();
+			IOLock lock( this );
 			IndexedIOPtr children = m_indexedIO->subdirectory( childrenEntry, IndexedIO::CreateIfMissing );
 			if ( children->hasEntry( name ) )
 			{
@@ -1493,21 +2305,178 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			return location;
 		}
 
-		static WriterImplementation *writer( Implementation *impl, bool throwException = true )
+		static WriterImplementation *writer( Implementation *impl, bool throwException = true )
+		{
+			WriterImplementation *writer = dynamic_cast< WriterImplementation* >( impl );
+			if ( throwException && !writer )
+			{
+				throw Exception( "Function not supported when loading a scene file." );
+			}
+			return writer;
+		}
+
+		void setPipelined( bool pipelined )
+		{
+			writable();
+			WriterImplementation *r = root();
+			if ( pipelined && !r->m_pipeline )
+			{
+				r->m_pipeline.reset( new WriterPipeline( r->m_ioMutex, r->m_uniqueSampleWriter ) );
+			}
+			else if ( !pipelined && r->m_pipeline )
+			{
+				std::unique_ptr<WriterPipeline> pipeline( std::move( r->m_pipeline ) );
+				pipeline->finish();
+			}
+		}
+
+		bool getPipelined() const
+		{
+			return m_sampleTimesMap && root()->m_pipeline;
+		}
+
+		/// Serialises the access to the IndexedIO of a scene being written with the appender
+		/// thread of the pipelined mode. Does nothing for readers and for flushed writers.
+		class IOLock : public tbb::mutex::scoped_lock
+		{
+			public :
+
+				IOLock( const Implementation *impl )
+				{
+					if ( tbb::mutex *mutex = impl->writerIOMutex() )
+					{
+						acquire( *mutex );
+					}
+				}
+
+		};
+
+	private :
+
+		typedef std::vector< Imath::Box3d > BoxSamples;
+		typedef ConstDataPtr TransformSample;
+		typedef std::vector< TransformSample > TransformSamples;
+
+		// What we need to know about each object sample to compute the bounds and
+		// to detect the animated topology and primitive variables during the flush.
+		struct ObjectSampleInfo
+		{
+			ObjectSampleInfo() : renderable( false ), primitive( false )
+			{
+			}
+
+			bool renderable;
+			Imath::Box3d bound;
+			bool primitive;
+			MurmurHash topologyHash;
+			std::vector< std::pair< SceneCache::Name, MurmurHash > > primVarHashes;
+		};
+
+		typedef std::deque< ObjectSampleInfo > ObjectSampleInfos;
+
+		const WriterImplementation *root() const
+		{
+			const WriterImplementation *result = this;
+			while( result->m_parent )
+			{
+				result = result->m_parent;
+			}
+			return result;
+		}
+
+		WriterImplementation *root()
+		{
+			WriterImplementation *result = this;
+			while( result->m_parent )
+			{
+				result = result->m_parent;
+			}
+			return result;
+		}
+
+		// Saves the sample right away, or queues it for the appender thread in the pipelined mode.
+		void saveSample( const Object *sample, IndexedIOPtr io, const IndexedIO::EntryID &name )
+		{
+			if ( WriterPipeline *pipeline = root()->m_pipeline.get() )
+			{
+				pipeline->save( io, name, sample );
+			}
+			else
+			{
+				sample->save( io, name );
+			}
+		}
+
+		// Computes the bound and hashes of a VisibleRenderable object sample. Runs in parallel with the
+		// caller in the pipelined mode, so it must not touch anything but the given info.
+		static void analyseObjectSample( const Object *object, ObjectSampleInfo &info )
+		{
+			const VisibleRenderable *renderable = static_cast< const VisibleRenderable * >( object );
+
+			const Primitive *primitive = runTimeCast< const Primitive >( renderable );
+			if ( primitive )
+			{
+				info.primitive = true;
+				primitive->topologyHash( info.topologyHash );
+				info.topologyHash.append( primitive->typeId() );
+
+				info.primVarHashes.reserve( primitive->variables.size() );
+				for ( PrimitiveVariableMap::const_iterator it = primitive->variables.begin(); it != primitive->variables.end(); ++it )
+				{
+					MurmurHash hash;
+					it->second.data->hash( hash );
+					hash.append( it->second.interpolation );
+					info.primVarHashes.push_back( std::make_pair( Name( it->first ), hash ) );
+				}
+			}
+
+			Box3f bf = renderable->bound();
+			info.bound = Box3d(
+				V3d( bf.min.x, bf.min.y, bf.min.z ),
+				V3f( bf.max.x, bf.max.y, bf.max.z )
+			);
+		}
+
+		// Combines the infos of all the object samples, in the order they were written.
+		void reduceObjectSamples()
 		{
-			WriterImplementation *writer = dynamic_cast< WriterImplementation* >( impl );
-			if ( throwException && !writer )
+			for ( ObjectSampleInfos::const_iterator sit = m_objectSampleInfo.begin(); sit != m_objectSampleInfo.end(); ++sit )
 			{
-				throw Exception( "Function not supported when loading a scene file." );
-			}
-			return writer;
-		}
+				if ( !sit->renderable )
+				{
+					continue;
+				}
 
-	private :
+				if ( sit->primitive )
+				{
+					if ( m_objectSamples.empty() )
+					{
+						m_animatedObjectTopology = AnimatedHashTest( sit->topologyHash, false );
+					}
 
-		typedef std::vector< Imath::Box3d > BoxSamples;
-		typedef ConstDataPtr TransformSample;
-		typedef std::vector< TransformSample > TransformSamples;
+					if ( sit->topologyHash != m_animatedObjectTopology.first )
+					{
+						m_animatedObjectTopology.second = true;
+					}
+
+					for ( std::vector< std::pair< SceneCache::Name, MurmurHash > >::const_iterator it = sit->primVarHashes.begin(); it != sit->primVarHashes.end(); ++it )
+					{
+						AnimatedPrimVarMap::iterator pIt = m_animatedObjectPrimVars.find( it->first );
+						if ( pIt == m_animatedObjectPrimVars.end() )
+						{
+							m_animatedObjectPrimVars.insert( AnimatedPrimVarMap::value_type( it->first, AnimatedHashTest( it->second, false ) ) );
+						}
+						else if ( it->second != pIt->second.first )
+						{
+							pIt->second.second = true;
+						}
+					}
+				}
+
+				m_objectSamples.push_back( sit->bound );
+			}
+			m_objectSampleInfo.clear();
+		}
 
 		IndexedIOPtr globalSampleTimes()
 		{
@@ -1669,6 +2638,200 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 
 		}
 
+		// Computes the bounding boxes over time for this location and all of its descendants. The children
+		// are independent from each other, so their subtrees are computed in parallel and then accumulated
+		// in a fixed order, which keeps the results identical to a serial computation.
+		void computeBounds()
+		{
+			std::vector< WriterImplementation * > children;
+			children.reserve( m_children.size() );
+			for ( std::map< SceneCache::Name, WriterImplementationPtr >::const_iterator cit = m_children.begin(); cit != m_children.end(); cit++ )
+			{
+				children.push_back( cit->second.get() );
+			}
+
+			std::vector< SampleTimes > childSampleTimes( children.size() );
+			std::vector< BoxSamples > childBoxSamples( children.size() );
+			tbb::parallel_for(
+				tbb::blocked_range<size_t>( 0, children.size() ),
+				[&children, &childSampleTimes, &childBoxSamples]( const tbb::blocked_range<size_t> &range )
+				{
+					for ( size_t i = range.begin(); i != range.end(); ++i )
+					{
+						children[i]->computeBounds();
+						children[i]->parentSpaceBounds( childSampleTimes[i], childBoxSamples[i] );
+					}
+				}
+			);
+
+			// We have to compute the bounding box over time for the object and each child.
+			for ( size_t i = 0; i < children.size(); ++i )
+			{
+				accumulateBoxSamples( childSampleTimes[i], childBoxSamples[i] );
+			}
+
+			reduceObjectSamples();
+
+			if ( m_objectSampleTimes.size() && m_objectSamples.size() )
+			{
+				// union all the bounding box samples from the child and also from the optional object stored in this location
+				accumulateBoxSamples( m_objectSampleTimes, m_objectSamples );
+			}
+		}
+
+		// Returns the bounding boxes over time of this location in the space of its parent.
+		void parentSpaceBounds( SampleTimes &sampleTimes, BoxSamples &boxSamples ) const
+		{
+			const SampleTimes &childBoundTimes = m_boundSampleTimes;
+			const BoxSamples &childBoxSamples = m_boundSamples;
+			const SampleTimes &childTransformTimes = m_transformSampleTimes;
+			const TransformSamples &childTransformSamples = m_transformSamples;
+
+			if ( childBoundTimes.size() == 0 )
+			{
+				return;
+			}
+
+			if ( childTransformTimes.size() == 0 )
+			{
+				// no transform or animation applied to this child... we just return its bounds.
+				sampleTimes = childBoundTimes;
+				boxSamples = childBoxSamples;
+			}
+			else if ( childTransformTimes.size() == 1 )
+			{
+				M44d m = dataToMatrix( childTransformSamples[0].get() );
+				// there's just one constant transform applied to the children, very simple case
+				// (we can ignore it's time and just use the child box one)
+				BoxSamples transformedChildBoxes;
+				transformedChildBoxes.reserve( childBoundTimes.size() );
+				for ( BoxSamples::const_iterator cbit = childBoxSamples.begin(); cbit != childBoxSamples.end(); cbit++ )
+				{
+					transformedChildBoxes.push_back( transform( *cbit, m ) );
+				}
+				// return the resulting transformed bounding boxes
+				sampleTimes = childBoundTimes;
+				boxSamples.swap( transformedChildBoxes );
+			}
+			else // childTransformTimes.size() > 1
+			{
+				BoxSamples transformedChildBoxes;
+
+				if ( childBoundTimes.size() > 1 )
+				{
+					// complex case: animated transforms.
+
+					// Step 1: Apply bbox interpolation for each transform sample that doesn't have a corresponding bbox sample.
+					SampleTimes transformedChildSampleTimes;
+
+					transformedChildSampleTimes.reserve( childBoundTimes.size() + childTransformTimes.size() );
+					transformedChildBoxes.reserve( childBoundTimes.size() + childTransformTimes.size() );
+
+					SampleTimes::const_iterator transformTimeIt, childTimeIt;
+					BoxSamples::const_iterator childBoxIt;
+					transformTimeIt = childTransformTimes.begin();
+					childTimeIt = childBoundTimes.begin();
+					TransformSamples::const_iterator transformIt = childTransformSamples.begin();
+					childBoxIt = childBoxSamples.begin();
+					Imath::Box3d tmpBox;
+					LinearInterpolator<Box3d> boxInterpolator;
+
+					while( childTimeIt != childBoundTimes.end() && transformTimeIt != childTransformTimes.end() )
+					{
+						if ( *childTimeIt < *transformTimeIt )
+						{
+							// Situation: child sample comes before the transform sample: interpolate transform.
+							transformedChildSampleTimes.push_back( *childTimeIt );
+							transformedChildBoxes.push_back( *childBoxIt );
+							childTimeIt++;
+							childBoxIt++;
+						}
+						else if ( *transformTimeIt < *childTimeIt )
+						{
+							// Situation: transform sample comes before the child sample: interpolate child bbox.
+							if ( childBoxIt == childBoxSamples.begin() )
+							{
+								// this is the first known sample so nothing to interpolate...
+								tmpBox = *childBoxIt;
+							}
+							else
+							{
+								// interpolate known samples.
+								double prevChildTime = *(childTimeIt-1);
+								double x = (*transformTimeIt -prevChildTime) /((*childTimeIt)-prevChildTime);
+								boxInterpolator( *(childBoxIt-1), *childBoxIt, x, tmpBox );
+							}
+							transformedChildSampleTimes.push_back( *transformTimeIt );
+							transformedChildBoxes.push_back( tmpBox );
+							transformTimeIt++;
+							transformIt++;
+						}
+						else
+						{
+							// Situation: child sample matches the time of the transform sample: transform child bbox.
+							transformedChildSampleTimes.push_back( *childTimeIt );
+							transformedChildBoxes.push_back( *childBoxIt );
+							childTimeIt++;
+							childBoxIt++;
+							transformTimeIt++;
+							transformIt++;
+						}
+					}
+
+					while( childTimeIt != childBoundTimes.end() )
+					{
+						// Situation: child samples exist after all the transform samples.
+						transformedChildSampleTimes.push_back( *childTimeIt );
+						transformedChildBoxes.push_back( *childBoxIt );
+						childTimeIt++;
+						childBoxIt++;
+					}
+
+					tmpBox = *(childBoxSamples.rbegin());
+					while( transformTimeIt != childTransformTimes.end() )
+					{
+						// Situation: transform samples exist after all the child samples
+						transformedChildSampleTimes.push_back( *transformTimeIt );
+						transformedChildBoxes.push_back( tmpBox );
+						transformTimeIt++;
+						transformIt++;
+					}
+
+					// We also want to add some border in the sampled bounding boxes to
+					// guarantee that the interpolated rotations that trace curves in space
+					// would still be included in the linear interpolated bounding boxes.
+					// then we transform the child bboxes...
+					transformAndExpandBounds( childTransformTimes, childTransformSamples, transformedChildSampleTimes, transformedChildBoxes );
+
+					// return the resulting transformed bounding boxes
+					sampleTimes.swap( transformedChildSampleTimes );
+					boxSamples.swap( transformedChildBoxes );
+				}
+				else
+				{
+					// the child object does not vary in time, so we just have to transform at each transform
+					// sample (and we can ignore the sample time for the box - if existent)
+
+					Imath::Box3d tmpBox;
+					if ( childBoxSamples.size() )
+					{
+						tmpBox = childBoxSamples[0];
+					}
+
+					transformedChildBoxes.resize( childTransformTimes.size(), tmpBox );
+
+					// We also want to add some border in the sampled bounding boxes to
+					// guarantee that the interpolated rotations that trace curves in space
+					// would still be included in the linear interpolated bounding boxes.
+					// then we transform the child bboxes...
+					transformAndExpandBounds( childTransformTimes, childTransformSamples, childTransformTimes, transformedChildBoxes );
+					// return the resulting transformed bounding boxes
+					sampleTimes = childTransformTimes;
+					boxSamples.swap( transformedChildBoxes );
+				}
+			}
+		}
+
 		// Called from the destructor of the root location.
 		// It triggers flush recursivelly on all the child locations.
 		// It also sets m_sampleTimesMap to NULL which prevents further modification on this and all child scene interface objects through their call to writable().
@@ -1678,6 +2841,18 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 		//
 		void flush()
 		{
+			if ( !m_parent )
+			{
+				if ( m_pipeline )
+				{
+					// all the queued samples must be in the file before we finish it.
+					std::unique_ptr<WriterPipeline> pipeline( std::move( m_pipeline ) );
+					pipeline->finish();
+				}
+				// compute the bounds of the whole hierarchy up front, so the locations can be visited in parallel.
+				computeBounds();
+			}
+
 			if ( m_parent )
 			{
 				NameList tags;
@@ -1739,162 +2914,6 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 				storeSampleTimes( m_objectSampleTimes, io );
 			}
 
-			// We have to compute the bounding box over time for the object and each child.
-			for ( std::map< SceneCache::Name, WriterImplementationPtr >::const_iterator cit = m_children.begin(); cit != m_children.end(); cit++ )
-			{
-				const SampleTimes &childBoundTimes = cit->second->m_boundSampleTimes;
-				const BoxSamples &childBoxSamples = cit->second->m_boundSamples;
-				const SampleTimes &childTransformTimes = cit->second->m_transformSampleTimes;
-				const TransformSamples &childTransformSamples = cit->second->m_transformSamples;
-
-				if ( childBoundTimes.size() == 0 )
-				{
-					continue;
-				}
-
-				if ( childTransformTimes.size() == 0 )
-				{
-					// no transform or animation applied to this child... we just accumulate it.
-					accumulateBoxSamples( childBoundTimes, childBoxSamples );
-				}
-				else if ( childTransformTimes.size() == 1 )
-				{
-					M44d m = dataToMatrix( childTransformSamples[0].get() );
-					// there's just one constant transform applied to the children, very simple case
-					// (we can ignore it's time and just use the child box one)
-					BoxSamples transformedChildBoxes;
-					transformedChildBoxes.reserve( childBoundTimes.size() );
-					for ( BoxSamples::const_iterator cbit = childBoxSamples.begin(); cbit != childBoxSamples.end(); cbit++ )
-					{
-						transformedChildBoxes.push_back( transform( *cbit, m ) );
-					}
-					// accumulate the resulting transformed bounding boxes
-					accumulateBoxSamples( childBoundTimes, transformedChildBoxes );
-				}
-				else // childTransformTimes.size() > 1
-				{
-					BoxSamples transformedChildBoxes;
-
-					if ( childBoundTimes.size() > 1 )
-					{
-						// complex case: animated transforms.
-
-						// Step 1: Apply bbox interpolation for each transform sample that doesn't have a corresponding bbox sample.
-						SampleTimes transformedChildSampleTimes;
-
-						transformedChildSampleTimes.reserve( childBoundTimes.size() + childTransformTimes.size() );
-						transformedChildBoxes.reserve( childBoundTimes.size() + childTransformTimes.size() );
-
-						SampleTimes::const_iterator transformTimeIt, childTimeIt;
-						BoxSamples::const_iterator childBoxIt;
-						transformTimeIt = childTransformTimes.begin();
-						childTimeIt = childBoundTimes.begin();
-						TransformSamples::const_iterator transformIt = childTransformSamples.begin();
-						childBoxIt = childBoxSamples.begin();
-						Imath::Box3d tmpBox;
-						LinearInterpolator<Box3d> boxInterpolator;
-
-						while( childTimeIt != childBoundTimes.end() && transformTimeIt != childTransformTimes.end() )
-						{
-							if ( *childTimeIt < *transformTimeIt )
-							{
-								// Situation: child sample comes before the transform sample: interpolate transform.
-								transformedChildSampleTimes.push_back( *childTimeIt );
-								transformedChildBoxes.push_back( *childBoxIt );
-								childTimeIt++;
-								childBoxIt++;
-							}
-							else if ( *transformTimeIt < *childTimeIt )
-							{
-								// Situation: transform sample comes before the child sample: interpolate child bbox.
-								if ( childBoxIt == childBoxSamples.begin() )
-								{
-									// this is the first known sample so nothing to interpolate...
-									tmpBox = *childBoxIt;
-								}
-								else
-								{
-									// interpolate known samples.
-									double prevChildTime = *(childTimeIt-1);
-									double x = (*transformTimeIt -prevChildTime) /((*childTimeIt)-prevChildTime);
-									boxInterpolator( *(childBoxIt-1), *childBoxIt, x, tmpBox );
-								}
-								transformedChildSampleTimes.push_back( *transformTimeIt );
-								transformedChildBoxes.push_back( tmpBox );
-								transformTimeIt++;
-								transformIt++;
-							}
-							else
-							{
-								// Situation: child sample matches the time of the transform sample: transform child bbox.
-								transformedChildSampleTimes.push_back( *childTimeIt );
-								transformedChildBoxes.push_back( *childBoxIt );
-								childTimeIt++;
-								childBoxIt++;
-								transformTimeIt++;
-								transformIt++;
-							}
-						}
-
-						while( childTimeIt != childBoundTimes.end() )
-						{
-							// Situation: child samples exist after all the transform samples.
-							transformedChildSampleTimes.push_back( *childTimeIt );
-							transformedChildBoxes.push_back( *childBoxIt );
-							childTimeIt++;
-							childBoxIt++;
-						}
-
-						tmpBox = *(childBoxSamples.rbegin());
-						while( transformTimeIt != childTransformTimes.end() )
-						{
-							// Situation: transform samples exist after all the child samples
-							transformedChildSampleTimes.push_back( *transformTimeIt );
-							transformedChildBoxes.push_back( tmpBox );
-							transformTimeIt++;
-							transformIt++;
-						}
-
-						// We also want to add some border in the sampled bounding boxes to
-						// guarantee that the interpolated rotations that trace curves in space
-						// would still be included in the linear interpolated bounding boxes.
-						// then we transform the child bboxes...
-						transformAndExpandBounds( childTransformTimes, childTransformSamples, transformedChildSampleTimes, transformedChildBoxes );
-
-						// accumulate the resulting transformed bounding boxes
-						accumulateBoxSamples( transformedChildSampleTimes, transformedChildBoxes );
-					}
-					else
-					{
-						// the child object does not vary in time, so we just have to transform at each transform
-						// sample (and we can ignore the sample time for the box - if existent)
-
-						Imath::Box3d tmpBox;
-						if ( childBoxSamples.size() )
-						{
-							tmpBox = childBoxSamples[0];
-						}
-
-						transformedChildBoxes.resize( childTransformTimes.size(), tmpBox );
-
-						// We also want to add some border in the sampled bounding boxes to
-						// guarantee that the interpolated rotations that trace curves in space
-						// would still be included in the linear interpolated bounding boxes.
-						// then we transform the child bboxes...
-						transformAndExpandBounds( childTransformTimes, childTransformSamples, childTransformTimes, transformedChildBoxes );
-						// accumulate the resulting transformed bounding boxes
-						accumulateBoxSamples( childTransformTimes, transformedChildBoxes );
-					}
-				}
-			}
-
-			if ( m_objectSampleTimes.size() && m_objectSamples.size() )
-			{
-				// union all the bounding box samples from the child and also from the optional object stored in this location
-				accumulateBoxSamples( m_objectSampleTimes, m_objectSamples );
-			}
-
-
 			if ( m_boundSampleTimes.size() )
 			{
 				// save the bound sample times
@@ -1942,6 +2961,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 				}
 			}
 			m_sampleTimesMap = nullptr;
+			m_writerIOMutex = nullptr;
 		}
 
 
@@ -2095,12 +3115,18 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 		typedef std::map< SceneCache::Name, SampleTimes > AttributeSamplesMap;
 
 		SampleTimesMap *m_sampleTimesMap;
+		// only used by the root location
+		mutable tbb::mutex m_ioMutex;
+		UniqueSampleWriter m_uniqueSampleWriter;
+		std::unique_ptr<WriterPipeline> m_pipeline;
 		SampleTimes m_boundSampleTimes;		// implicit or explicit bound sample times
 		SampleTimes m_transformSampleTimes;
 		AttributeSamplesMap m_attributeSampleTimes;
 		SampleTimes m_objectSampleTimes;
 		// store the transform objects (we want to interpolate the transforms later)
 		TransformSamples m_transformSamples;
+		// analysis of the object samples, reduced to m_objectSamples and the animated hash tests by computeBounds()
+		ObjectSampleInfos m_objectSampleInfo;
 		// store the object's bounding box (we want to transform them later)
 		BoxSamples m_objectSamples;
 		// overwriting bounding boxes (or used during flush to compute the final bounding boxes).
@@ -2281,11 +3307,13 @@ void SceneCache::writeTransform( const Data *transform, double time )
 
 bool SceneCache::hasAttribute( const Name &name ) const
 {
+	WriterImplementation::IOLock lock( m_implementation.get() );
 	return m_implementation->hasAttribute(name);
 }
 
 void SceneCache::attributeNames( NameList &attrs ) const
 {
+	WriterImplementation::IOLock lock( m_implementation.get() );
 	m_implementation->attributeNames(attrs);
 }
 
@@ -2338,6 +3366,7 @@ void SceneCache::readTags( NameList &tags, int filter ) const
 		/// non Local tags is only supported in read mode.
 		ReaderImplementation::reader( m_implementation.get() );
 	}
+	WriterImplementation::IOLock lock( m_implementation.get() );
 	return m_implementation->readTags(tags, filter);
 }
 
@@ -2414,6 +3443,7 @@ void SceneCache::hashSet( const Name &name, IECore::MurmurHash &h ) const
 
 bool SceneCache::hasObject() const
 {
+	WriterImplementation::IOLock lock( m_implementation.get() );
 	return m_implementation->hasObject();
 }
 
@@ -2455,6 +3485,7 @@ void SceneCache::writeObject( const Object *object, double time )
 
 void SceneCache::childNames( NameList &childNames ) const
 {
+	WriterImplementation::IOLock lock( m_implementation.get() );
 	return m_implementation->childNames(childNames);
 }
 
@@ -2494,6 +3525,7 @@ ConstSceneInterfacePtr SceneCache::child( const Name &name, SceneCache::MissingB
 
 bool SceneCache::hasChild( const Name &name ) const
 {
+	WriterImplementation::IOLock lock( m_implementation.get() );
 	return m_implementation->hasChild(name);
 }
 
@@ -2555,6 +3587,107 @@ SceneCachePtr SceneCache::duplicate( ImplementationPtr& impl ) const
 	return new SceneCache( impl );
 }
 
+void SceneCache::setPipelinedWriting( bool pipelined )
+{
+	WriterImplementation *writer = WriterImplementation::writer( m_implementation.get() );
+	writer->setPipelined( pipelined );
+}
+
+bool SceneCache::getPipelinedWriting() const
+{
+	WriterImplementation *writer = WriterImplementation::writer( m_implementation.get(), false );
+	return writer && writer->getPipelined();
+}
+
+SceneCache::PrefetchPtr SceneCache::prefetch( const IECore::PathMatcher &paths, double startTime, double endTime, int what ) const
+{
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	Prefetch::ImplementationPtr implementation = new Prefetch::Implementation( paths, startTime, endTime, what );
+	implementation->start( reader );
+	return new Prefetch( implementation );
+}
+
+void SceneCache::readHierarchy( const IECore::PathMatcher &filter, double time, Hierarchy &hierarchy, int what ) const
+{
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	Private::readHierarchy<ReaderImplementation::HierarchyAccessor>( reader, filter, time, what, /* parallel = */ true, hierarchy );
+}
+
+SceneCache::CacheStatistics::CacheStatistics()
+	:	hits( 0 ), misses( 0 ), evictions( 0 ), memoryUsage( 0 ), loadTime( 0 )
+{
+}
+
+SceneCache::CacheStatistics SceneCache::cacheStatistics( CacheType cache ) const
+{
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	return reader->cacheStatistics( cache );
+}
+
+void SceneCache::setCacheMemoryLimit( CacheType cache, size_t bytes )
+{
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	reader->setCacheMemoryLimit( cache, bytes );
+}
+
+size_t SceneCache::getCacheMemoryLimit( CacheType cache ) const
+{
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	return reader->getCacheMemoryLimit( cache );
+}
+
+void SceneCache::setDefaultCacheMemoryLimit( CacheType cache, size_t bytes )
+{
+	if ( cache < TransformCache || cache > ObjectCache )
+	{
+		throw Exception( "Invalid cache type!" );
+	}
+	tbb::mutex::scoped_lock lock( g_defaultCacheMutex );
+	g_defaultCacheMemoryLimits[cache] = bytes;
+}
+
+size_t SceneCache::getDefaultCacheMemoryLimit( CacheType cache )
+{
+	if ( cache < TransformCache || cache > ObjectCache )
+	{
+		throw Exception( "Invalid cache type!" );
+	}
+	tbb::mutex::scoped_lock lock( g_defaultCacheMutex );
+	return g_defaultCacheMemoryLimits[cache];
+}
+
+void SceneCache::setCacheBufferDeduplication( CacheType cache, bool enabled )
+{
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	reader->setCacheBufferDeduplication( cache, enabled );
+}
+
+bool SceneCache::getCacheBufferDeduplication( CacheType cache ) const
+{
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	return reader->getCacheBufferDeduplication( cache );
+}
+
+void SceneCache::setDefaultCacheBufferDeduplication( CacheType cache, bool enabled )
+{
+	if ( cache < TransformCache || cache > ObjectCache )
+	{
+		throw Exception( "Invalid cache type!" );
+	}
+	tbb::mutex::scoped_lock lock( g_defaultCacheMutex );
+	g_defaultCacheBufferDeduplication[cache] = enabled;
+}
+
+bool SceneCache::getDefaultCacheBufferDeduplication( CacheType cache )
+{
+	if ( cache < TransformCache || cache > ObjectCache )
+	{
+		throw Exception( "Invalid cache type!" );
+	}
+	tbb::mutex::scoped_lock lock( g_defaultCacheMutex );
+	return g_defaultCacheBufferDeduplication[cache];
+}
+
 bool SceneCache::readOnly() const
 {
 	return dynamic_cast< const ReaderImplementation* >( m_implementation.get() ) != nullptr;
@@ -34,6 +34,8 @@
 
 #include "IECoreScene/SceneInterface.h"
 
+#include "HierarchyAlgo.h"
+
 #include "boost/filesystem/convenience.hpp"
 #include "boost/tokenizer.hpp"
 
@@ -136,6 +138,48 @@ void SceneInterface::hash( HashType hashType, double time, MurmurHash &h ) const
 	h.append( typeId() );
 }
 
+namespace
+{
+
+struct SceneInterfaceAccessor
+{
+	typedef ConstSceneInterfacePtr LocationPtr;
+
+	static void childNames( const LocationPtr &location, SceneInterface::NameList &childNames )
+	{
+		location->childNames( childNames );
+	}
+
+	static LocationPtr child( const LocationPtr &location, const SceneInterface::Name &name )
+	{
+		return location->child( name );
+	}
+
+	static Imath::M44d transform( const LocationPtr &location, double time )
+	{
+		return location->readTransformAsMatrix( time );
+	}
+
+	static Imath::Box3d bound( const LocationPtr &location, double time )
+	{
+		return location->hasBound() ? location->readBound( time ) : Imath::Box3d();
+	}
+
+	static TypeId objectType( const LocationPtr &location, double time )
+	{
+		return location->hasObject() ? location->readObject( time )->typeId() : InvalidTypeId;
+	}
+};
+
+} // namespace
+
+void SceneInterface::readHierarchy( const IECore::PathMatcher &filter, double time, Hierarchy &hierarchy, int what ) const
+{
+	// Derived classes aren't required to be safe to query concurrently,
+	// so we can only traverse serially.
+	Private::readHierarchy<SceneInterfaceAccessor>( this, filter, time, what, /* parallel = */ false, hierarchy );
+}
+
 void SceneInterface::pathToString( const SceneInterface::Path &p, std::string &path )
 {
 	if ( !p.size() )
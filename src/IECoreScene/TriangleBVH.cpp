@@ -0,0 +1,736 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "TriangleBVH.h"
+
+#include "IECore/TriangleAlgo.h"
+#include "IECore/VectorOps.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/concurrent_vector.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+using namespace Imath;
+using namespace IECore;
+using namespace IECoreScene::Private;
+
+//////////////////////////////////////////////////////////////////////////
+// SIMD utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// We use the generic vector extensions provided by GCC and Clang rather
+// than platform specific intrinsics, and leave it to the compiler to emit
+// SSE or NEON instructions as appropriate.
+typedef float Float4 __attribute__( ( vector_size( 16 ) ) );
+typedef int Int4 __attribute__( ( vector_size( 16 ) ) );
+
+inline Float4 splat( float f )
+{
+	return Float4{ f, f, f, f };
+}
+
+inline Float4 select( Int4 mask, Float4 a, Float4 b )
+{
+	return (Float4)( ( mask & (Int4)a ) | ( ~mask & (Int4)b ) );
+}
+
+inline Float4 vmin( Float4 a, Float4 b )
+{
+	return select( a < b, a, b );
+}
+
+inline Float4 vmax( Float4 a, Float4 b )
+{
+	return select( a > b, a, b );
+}
+
+inline Float4 vabs( Float4 a )
+{
+	return (Float4)( (Int4)a & Int4{ 0x7fffffff, 0x7fffffff, 0x7fffffff, 0x7fffffff } );
+}
+
+inline int moveMask( Int4 mask )
+{
+	return ( mask[0] & 1 ) | ( mask[1] & 2 ) | ( mask[2] & 4 ) | ( mask[3] & 8 );
+}
+
+// Relative padding applied to box tests, so that rounding error can
+// never cause us to cull a box containing a valid result.
+const float g_boxTolerance = 1e-5f;
+// Relative padding applied to the SIMD triangle test, which only
+// selects candidates for the exact scalar test.
+const float g_triangleTolerance = 1e-4f;
+// Beyond this depth we switch from SAH splits to median splits, which at
+// least halve the number of triangles per level. This bounds the depth of
+// the tree, and therefore the size of the traversal stack.
+const int g_maxSAHDepth = 32;
+const int g_maxStackSize = 256;
+const int g_numBins = 16;
+const size_t g_parallelThreshold = 8192;
+
+struct Ray4
+{
+
+	Ray4( const V3f &o, const V3f &d )
+	{
+		for( int i = 0; i < 3; ++i )
+		{
+			origin[i] = splat( o[i] );
+			direction[i] = splat( d[i] );
+			// Avoid infinities, which would give NaNs for rays starting exactly
+			// on a slab boundary.
+			const float safeD = std::fabs( d[i] ) > 1e-30f ? d[i] : std::copysign( 1e-30f, d[i] );
+			inverseDirection[i] = splat( 1.0f / safeD );
+		}
+	}
+
+	Float4 origin[3];
+	Float4 direction[3];
+	Float4 inverseDirection[3];
+
+};
+
+// Returns a mask of the boxes hit by the ray closer than maxDistance, and
+// the distance along the ray to each box.
+inline int intersectBoxes( const Ray4 &ray, const Float4 bounds[6], float maxDistance, Float4 &distance )
+{
+	Float4 tNear = splat( 0.0f );
+	Float4 tFar = splat( maxDistance );
+	for( int i = 0; i < 3; ++i )
+	{
+		const Float4 t0 = ( bounds[i] - ray.origin[i] ) * ray.inverseDirection[i];
+		const Float4 t1 = ( bounds[i+3] - ray.origin[i] ) * ray.inverseDirection[i];
+		tNear = vmax( tNear, vmin( t0, t1 ) );
+		tFar = vmin( tFar, vmax( t0, t1 ) );
+	}
+
+	distance = tNear * splat( 1.0f - g_boxTolerance );
+	return moveMask( distance <= tFar * splat( 1.0f + g_boxTolerance ) );
+}
+
+// Returns the squared distance from p to each box.
+inline Float4 boxDistanceSquared( const Float4 p[3], const Float4 bounds[6] )
+{
+	Float4 result = splat( 0.0f );
+	for( int i = 0; i < 3; ++i )
+	{
+		const Float4 d = vmax( vmax( bounds[i] - p[i], p[i] - bounds[i+3] ), splat( 0.0f ) );
+		result += d * d;
+	}
+	return result * splat( 1.0f - g_boxTolerance );
+}
+
+// A Moller-Trumbore test of the ray against four triangles, returning a mask
+// of the ones which might be hit. To avoid dividing, the barycentric
+// coordinates are compared against the determinant rather than normalised,
+// and all comparisons are padded in proportion to their rounding error. The
+// test is therefore conservative, and candidates must be confirmed using an
+// exact test.
+inline int intersectTriangles( const Ray4 &ray, const Float4 v0[3], const Float4 e1[3], const Float4 e2[3], const Float4 &edgeScale )
+{
+	const Float4 px = ray.direction[1] * e2[2] - ray.direction[2] * e2[1];
+	const Float4 py = ray.direction[2] * e2[0] - ray.direction[0] * e2[2];
+	const Float4 pz = ray.direction[0] * e2[1] - ray.direction[1] * e2[0];
+	const Float4 det = e1[0] * px + e1[1] * py + e1[2] * pz;
+
+	const Float4 tx = ray.origin[0] - v0[0];
+	const Float4 ty = ray.origin[1] - v0[1];
+	const Float4 tz = ray.origin[2] - v0[2];
+	const Float4 u = tx * px + ty * py + tz * pz;
+
+	const Float4 qx = ty * e1[2] - tz * e1[1];
+	const Float4 qy = tz * e1[0] - tx * e1[2];
+	const Float4 qz = tx * e1[1] - ty * e1[0];
+	const Float4 v = ray.direction[0] * qx + ray.direction[1] * qy + ray.direction[2] * qz;
+
+	const Float4 tScale = vmax( vmax( vabs( tx ), vabs( ty ) ), vabs( tz ) );
+	const Float4 tolerance = splat( g_triangleTolerance ) * edgeScale * ( tScale + edgeScale );
+
+	// Flip signs so that we can treat all determinants as positive.
+	const Int4 negative = det < splat( 0.0f );
+	const Float4 absDet = select( negative, -det, det );
+	const Float4 uu = select( negative, -u, u );
+	const Float4 vv = select( negative, -v, v );
+
+	const Int4 inside = ( uu >= -tolerance ) & ( vv >= -tolerance ) & ( uu + vv <= absDet + tolerance );
+	// Nearly parallel rays are left entirely to the exact test.
+	return moveMask( inside | ( absDet <= tolerance ) );
+}
+
+struct StackEntry
+{
+	int code;
+	float distance;
+};
+
+// Pushes the children selected by mask in order of decreasing distance,
+// so that the closest is popped first.
+inline void pushChildren( const int children[4], int mask, const Float4 &distance, StackEntry *stack, int &stackSize )
+{
+	StackEntry *first = stack + stackSize;
+	for( int i = 0; i < 4; ++i )
+	{
+		if( !( mask & ( 1 << i ) ) )
+		{
+			continue;
+		}
+
+		const StackEntry entry = { children[i], distance[i] };
+		StackEntry *it = stack + stackSize++;
+		assert( stackSize <= g_maxStackSize );
+		while( it != first && ( it - 1 )->distance < entry.distance )
+		{
+			*it = *( it - 1 );
+			--it;
+		}
+		*it = entry;
+	}
+}
+
+inline float halfArea( const Box3f &b )
+{
+	const V3f s = b.size();
+	return s.x * s.y + s.y * s.z + s.z * s.x;
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// Node and Leaf
+//////////////////////////////////////////////////////////////////////////
+
+struct TriangleBVH::Node
+{
+	// Child bounds, in the order minX, minY, minZ, maxX, maxY, maxZ.
+	Float4 bounds[6];
+	int children[4];
+	int numChildren;
+};
+
+struct TriangleBVH::Leaf
+{
+	Float4 v0[3];
+	Float4 e1[3];
+	Float4 e2[3];
+	// The length of the longest edge, used to
+	// compute tolerances in intersectTriangles().
+	Float4 edgeScale;
+	int triangles[4];
+	int numTriangles;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Builder
+//////////////////////////////////////////////////////////////////////////
+
+class TriangleBVH::Builder
+{
+
+	public :
+
+		Builder( const TriangleBVH &bvh, const std::vector<Box3f> &triangleBounds )
+			:	m_bvh( bvh ), m_triangleBounds( triangleBounds ), m_centroids( triangleBounds.size() ), m_indices( triangleBounds.size() )
+		{
+			for( size_t i = 0, e = triangleBounds.size(); i < e; ++i )
+			{
+				m_centroids[i] = triangleBounds[i].center();
+				m_indices[i] = i;
+			}
+		}
+
+		int build()
+		{
+			tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+			return buildNode( makeRange( m_indices.data(), m_indices.data() + m_indices.size() ), 0, taskGroupContext );
+		}
+
+		tbb::concurrent_vector<Node> nodes;
+		tbb::concurrent_vector<Leaf> leaves;
+
+	private :
+
+		struct Range
+		{
+			int *begin;
+			int *end;
+			Box3f bound;
+			Box3f centroidBound;
+
+			size_t size() const
+			{
+				return end - begin;
+			}
+		};
+
+		Range makeRange( int *begin, int *end ) const
+		{
+			Range result;
+			result.begin = begin;
+			result.end = end;
+			for( int *it = begin; it != end; ++it )
+			{
+				result.bound.extendBy( m_triangleBounds[*it] );
+				result.centroidBound.extendBy( m_centroids[*it] );
+			}
+			return result;
+		}
+
+		int binIndex( int triangleIndex, int axis, float binMin, float binScale ) const
+		{
+			return std::min( (int)( ( m_centroids[triangleIndex][axis] - binMin ) * binScale ), g_numBins - 1 );
+		}
+
+		// Partitions the range using the binned surface area heuristic,
+		// returning the partition point, or nullptr if no useful split was
+		// found.
+		int *sahPartition( const Range &range ) const
+		{
+			const V3f extent = range.centroidBound.size();
+
+			float bestCost = std::numeric_limits<float>::max();
+			int bestAxis = -1;
+			int bestBin = 0;
+			for( int axis = 0; axis < 3; ++axis )
+			{
+				if( extent[axis] <= 0.0f )
+				{
+					continue;
+				}
+
+				const float binMin = range.centroidBound.min[axis];
+				const float binScale = g_numBins / extent[axis];
+
+				Box3f binBounds[g_numBins];
+				size_t binCounts[g_numBins] = { 0 };
+				for( int *it = range.begin; it != range.end; ++it )
+				{
+					const int bin = binIndex( *it, axis, binMin, binScale );
+					binBounds[bin].extendBy( m_triangleBounds[*it] );
+					binCounts[bin]++;
+				}
+
+				float highAreas[g_numBins];
+				size_t highCounts[g_numBins];
+				Box3f bound;
+				size_t count = 0;
+				for( int i = g_numBins - 1; i > 0; --i )
+				{
+					bound.extendBy( binBounds[i] );
+					count += binCounts[i];
+					highAreas[i] = halfArea( bound );
+					highCounts[i] = count;
+				}
+
+				bound.makeEmpty();
+				count = 0;
+				for( int i = 0; i < g_numBins - 1; ++i )
+				{
+					bound.extendBy( binBounds[i] );
+					count += binCounts[i];
+					if( !count || !highCounts[i+1] )
+					{
+						continue;
+					}
+
+					const float cost = count * halfArea( bound ) + highCounts[i+1] * highAreas[i+1];
+					if( cost < bestCost )
+					{
+						bestCost = cost;
+						bestAxis = axis;
+						bestBin = i;
+					}
+				}
+			}
+
+			if( bestAxis < 0 )
+			{
+				return nullptr;
+			}
+
+			const float binMin = range.centroidBound.min[bestAxis];
+			const float binScale = g_numBins / extent[bestAxis];
+			return std::partition(
+				range.begin, range.end,
+				[this, bestAxis, binMin, binScale, bestBin]( int i ) {
+					return binIndex( i, bestAxis, binMin, binScale ) <= bestBin;
+				}
+			);
+		}
+
+		void split( const Range &range, int depth, Range &low, Range &high ) const
+		{
+			int *mid = depth <= g_maxSAHDepth ? sahPartition( range ) : nullptr;
+			if( !mid )
+			{
+				const int axis = range.centroidBound.majorAxis();
+				mid = range.begin + range.size() / 2;
+				std::nth_element(
+					range.begin, mid, range.end,
+					[this, axis]( int a, int b ) {
+						return m_centroids[a][axis] < m_centroids[b][axis];
+					}
+				);
+			}
+
+			low = makeRange( range.begin, mid );
+			high = makeRange( mid, range.end );
+		}
+
+		int buildNode( const Range &range, int depth, tbb::task_group_context &taskGroupContext )
+		{
+			if( range.size() <= 4 )
+			{
+				return buildLeaf( range );
+			}
+
+			// Split until we have enough children to fill the node, always
+			// splitting the child with the largest surface area.
+			Range children[4];
+			children[0] = range;
+			int numChildren = 1;
+			while( numChildren < 4 )
+			{
+				int toSplit = -1;
+				float largestArea = -1.0f;
+				for( int i = 0; i < numChildren; ++i )
+				{
+					const float area = halfArea( children[i].bound );
+					if( children[i].size() > 4 && area > largestArea )
+					{
+						toSplit = i;
+						largestArea = area;
+					}
+				}
+
+				if( toSplit < 0 )
+				{
+					break;
+				}
+
+				const Range toSplitRange = children[toSplit];
+				split( toSplitRange, depth, children[toSplit], children[numChildren++] );
+			}
+
+			tbb::concurrent_vector<Node>::iterator nodeIt = nodes.grow_by( 1 );
+			const int nodeIndex = nodeIt - nodes.begin();
+			Node &node = *nodeIt;
+			node.numChildren = numChildren;
+			for( int i = 0; i < 4; ++i )
+			{
+				const Box3f bound = i < numChildren ? children[i].bound : Box3f( V3f( 0 ) );
+				for( int j = 0; j < 3; ++j )
+				{
+					node.bounds[j][i] = bound.min[j];
+					node.bounds[j+3][i] = bound.max[j];
+				}
+				node.children[i] = 0;
+			}
+
+			if( range.size() > g_parallelThreshold )
+			{
+				tbb::parallel_for(
+					tbb::blocked_range<int>( 0, numChildren, 1 ),
+					[&]( const tbb::blocked_range<int> &r ) {
+						for( int i = r.begin(); i != r.end(); ++i )
+						{
+							node.children[i] = buildNode( children[i], depth + 1, taskGroupContext );
+						}
+					},
+					taskGroupContext
+				);
+			}
+			else
+			{
+				for( int i = 0; i < numChildren; ++i )
+				{
+					node.children[i] = buildNode( children[i], depth + 1, taskGroupContext );
+				}
+			}
+
+			return nodeIndex;
+		}
+
+		int buildLeaf( const Range &range )
+		{
+			Leaf leaf;
+			leaf.numTriangles = range.size();
+			for( int i = 0; i < 4; ++i )
+			{
+				V3f p0( 0 ), p1( 0 ), p2( 0 );
+				leaf.triangles[i] = -1;
+				if( i < leaf.numTriangles )
+				{
+					leaf.triangles[i] = range.begin[i];
+					m_bvh.triangle( leaf.triangles[i], p0, p1, p2 );
+				}
+
+				const V3f e1 = p1 - p0;
+				const V3f e2 = p2 - p0;
+				for( int j = 0; j < 3; ++j )
+				{
+					leaf.v0[j][i] = p0[j];
+					leaf.e1[j][i] = e1[j];
+					leaf.e2[j][i] = e2[j];
+				}
+				leaf.edgeScale[i] = std::max( e1.length(), e2.length() );
+			}
+
+			tbb::concurrent_vector<Leaf>::iterator leafIt = leaves.push_back( leaf );
+			return ~(int)( leafIt - leaves.begin() );
+		}
+
+		const TriangleBVH &m_bvh;
+		const std::vector<Box3f> &m_triangleBounds;
+		std::vector<V3f> m_centroids;
+		std::vector<int> m_indices;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+// TriangleBVH
+//////////////////////////////////////////////////////////////////////////
+
+TriangleBVH::TriangleBVH( const std::vector<Imath::V3f> &points, const std::vector<int> &vertexIds, const std::vector<Imath::Box3f> &triangleBounds )
+	:	m_points( points ), m_vertexIds( vertexIds ), m_root( 0 ), m_nodes( nullptr ), m_leaves( nullptr )
+{
+	assert( vertexIds.size() == triangleBounds.size() * 3 );
+	if( triangleBounds.empty() )
+	{
+		return;
+	}
+
+	Builder builder( *this, triangleBounds );
+	m_root = builder.build();
+
+	m_nodes = new Node[builder.nodes.size()];
+	std::copy( builder.nodes.begin(), builder.nodes.end(), m_nodes );
+	m_leaves = new Leaf[builder.leaves.size()];
+	std::copy( builder.leaves.begin(), builder.leaves.end(), m_leaves );
+}
+
+TriangleBVH::~TriangleBVH()
+{
+	delete [] m_nodes;
+	delete [] m_leaves;
+}
+
+bool TriangleBVH::closestPoint( const Imath::V3f &p, float &closestDistanceSqrd, unsigned int &triangleIndex, Imath::V3f &barycentric ) const
+{
+	if( !m_leaves )
+	{
+		return false;
+	}
+
+	const Float4 p4[3] = { splat( p.x ), splat( p.y ), splat( p.z ) };
+
+	StackEntry stack[g_maxStackSize];
+	int stackSize = 0;
+	stack[stackSize++] = { m_root, 0.0f };
+
+	bool found = false;
+	while( stackSize )
+	{
+		const StackEntry entry = stack[--stackSize];
+		if( entry.distance >= closestDistanceSqrd )
+		{
+			continue;
+		}
+
+		if( entry.code < 0 )
+		{
+			const Leaf &leaf = m_leaves[~entry.code];
+			for( int i = 0; i < leaf.numTriangles; ++i )
+			{
+				V3f p0, p1, p2;
+				triangle( leaf.triangles[i], p0, p1, p2 );
+
+				V3f bary;
+				const float dSqrd = triangleClosestBarycentric( p0, p1, p2, p, bary );
+				if( dSqrd < closestDistanceSqrd )
+				{
+					closestDistanceSqrd = dSqrd;
+					triangleIndex = leaf.triangles[i];
+					barycentric = bary;
+					found = true;
+				}
+			}
+		}
+		else
+		{
+			const Node &node = m_nodes[entry.code];
+			const Float4 distance = boxDistanceSquared( p4, node.bounds );
+			const int mask = moveMask( distance < splat( closestDistanceSqrd ) ) & ( ( 1 << node.numChildren ) - 1 );
+			pushChildren( node.children, mask, distance, stack, stackSize );
+		}
+	}
+
+	return found;
+}
+
+bool TriangleBVH::intersectionPoint( const Imath::V3f &origin, const Imath::V3f &direction, float &maxDistSqrd, unsigned int &triangleIndex, Imath::V3f &barycentric, Imath::V3f &hitPoint ) const
+{
+	if( !m_leaves )
+	{
+		return false;
+	}
+
+	const Ray4 ray( origin, direction );
+	float maxDistance = std::sqrt( maxDistSqrd );
+
+	StackEntry stack[g_maxStackSize];
+	int stackSize = 0;
+	stack[stackSize++] = { m_root, 0.0f };
+
+	bool hit = false;
+	while( stackSize )
+	{
+		const StackEntry entry = stack[--stackSize];
+		if( entry.distance > maxDistance * ( 1.0f + g_boxTolerance ) )
+		{
+			continue;
+		}
+
+		if( entry.code < 0 )
+		{
+			const Leaf &leaf = m_leaves[~entry.code];
+			const int candidates = intersectTriangles( ray, leaf.v0, leaf.e1, leaf.e2, leaf.edgeScale ) & ( ( 1 << leaf.numTriangles ) - 1 );
+			for( int i = 0; i < leaf.numTriangles; ++i )
+			{
+				if( !( candidates & ( 1 << i ) ) )
+				{
+					continue;
+				}
+
+				V3f p0, p1, p2;
+				triangle( leaf.triangles[i], p0, p1, p2 );
+
+				V3f point, bary;
+				bool front;
+				if( triangleRayIntersection( p0, p1, p2, origin, direction, point, bary, front ) )
+				{
+					const float dSqrd = vecDistance2( point, origin );
+					if( dSqrd < maxDistSqrd )
+					{
+						maxDistSqrd = dSqrd;
+						maxDistance = std::sqrt( dSqrd );
+						triangleIndex = leaf.triangles[i];
+						barycentric = bary;
+						hitPoint = point;
+						hit = true;
+					}
+				}
+			}
+		}
+		else
+		{
+			const Node &node = m_nodes[entry.code];
+			Float4 distance;
+			const int mask = intersectBoxes( ray, node.bounds, maxDistance, distance ) & ( ( 1 << node.numChildren ) - 1 );
+			pushChildren( node.children, mask, distance, stack, stackSize );
+		}
+	}
+
+	return hit;
+}
+
+void TriangleBVH::intersectionPoints( const Imath::V3f &origin, const Imath::V3f &direction, float maxDistSqrd, std::vector<Hit> &hits ) const
+{
+	if( !m_leaves )
+	{
+		return;
+	}
+
+	const Ray4 ray( origin, direction );
+	const float maxDistance = std::sqrt( maxDistSqrd );
+
+	StackEntry stack[g_maxStackSize];
+	int stackSize = 0;
+	stack[stackSize++] = { m_root, 0.0f };
+
+	while( stackSize )
+	{
+		const StackEntry entry = stack[--stackSize];
+		if( entry.code < 0 )
+		{
+			const Leaf &leaf = m_leaves[~entry.code];
+			const int candidates = intersectTriangles( ray, leaf.v0, leaf.e1, leaf.e2, leaf.edgeScale ) & ( ( 1 << leaf.numTriangles ) - 1 );
+			for( int i = 0; i < leaf.numTriangles; ++i )
+			{
+				if( !( candidates & ( 1 << i ) ) )
+				{
+					continue;
+				}
+
+				V3f p0, p1, p2;
+				triangle( leaf.triangles[i], p0, p1, p2 );
+
+				Hit h;
+				bool front;
+				if( triangleRayIntersection( p0, p1, p2, origin, direction, h.point, h.barycentric, front ) )
+				{
+					if( vecDistance2( h.point, origin ) < maxDistSqrd )
+					{
+						h.triangleIndex = leaf.triangles[i];
+						hits.push_back( h );
+					}
+				}
+			}
+		}
+		else
+		{
+			const Node &node = m_nodes[entry.code];
+			Float4 distance;
+			const int mask = intersectBoxes( ray, node.bounds, maxDistance, distance ) & ( ( 1 << node.numChildren ) - 1 );
+			pushChildren( node.children, mask, distance, stack, stackSize );
+		}
+	}
+}
+
+void TriangleBVH::triangle( int triangleIndex, Imath::V3f &p0, Imath::V3f &p1, Imath::V3f &p2 ) const
+{
+	const int *ids = m_vertexIds.data() + triangleIndex * 3;
+	p0 = m_points[ids[0]];
+	p1 = m_points[ids[1]];
+	p2 = m_points[ids[2]];
+}
@@ -0,0 +1,116 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef IECORESCENE_TRIANGLEBVH_H
+#define IECORESCENE_TRIANGLEBVH_H
+
+#include "OpenEXR/ImathBox.h"
+#include "OpenEXR/ImathVec.h"
+
+#include "boost/noncopyable.hpp"
+
+#include <vector>
+
+namespace IECoreScene
+{
+
+namespace Private
+{
+
+/// A 4-wide bounding volume hierarchy over the triangles of a mesh, built
+/// using a binned surface area heuristic. Each node stores the bounds of its
+/// four children in SIMD-friendly "structure of arrays" form, so that a query
+/// tests all four boxes at once, and each leaf stores up to four triangles
+/// in the same form so that rays may be tested against them together. Used
+/// by the MeshPrimitiveEvaluator as an alternative to its BoundedKDTree.
+class TriangleBVH : boost::noncopyable
+{
+
+	public :
+
+		/// The points and vertexIds are referenced rather than copied, and must
+		/// remain valid for the lifetime of the TriangleBVH. The vertexIds must
+		/// describe triangles, and triangleBounds must contain the bound of
+		/// each of them.
+		TriangleBVH( const std::vector<Imath::V3f> &points, const std::vector<int> &vertexIds, const std::vector<Imath::Box3f> &triangleBounds );
+		~TriangleBVH();
+
+		/// Finds the closest triangle to p which is closer than
+		/// closestDistanceSqrd, updating closestDistanceSqrd and returning true
+		/// if one is found.
+		bool closestPoint( const Imath::V3f &p, float &closestDistanceSqrd, unsigned int &triangleIndex, Imath::V3f &barycentric ) const;
+
+		/// Finds the closest intersection of the ray with a triangle, closer
+		/// than maxDistSqrd to the origin. The direction must be normalised.
+		/// Intersections are computed using IECore::triangleRayIntersection(),
+		/// so results match those of an exhaustive search.
+		bool intersectionPoint( const Imath::V3f &origin, const Imath::V3f &direction, float &maxDistSqrd, unsigned int &triangleIndex, Imath::V3f &barycentric, Imath::V3f &hitPoint ) const;
+
+		struct Hit
+		{
+			unsigned int triangleIndex;
+			Imath::V3f barycentric;
+			Imath::V3f point;
+		};
+
+		/// Appends all intersections closer than maxDistSqrd to hits, in no
+		/// particular order.
+		void intersectionPoints( const Imath::V3f &origin, const Imath::V3f &direction, float maxDistSqrd, std::vector<Hit> &hits ) const;
+
+	private :
+
+		struct Node;
+		struct Leaf;
+		class Builder;
+
+		void triangle( int triangleIndex, Imath::V3f &p0, Imath::V3f &p1, Imath::V3f &p2 ) const;
+
+		const std::vector<Imath::V3f> &m_points;
+		const std::vector<int> &m_vertexIds;
+
+		/// Children and roots are encoded as indices into m_nodes when
+		/// non-negative, and as the complement of an index into m_leaves
+		/// otherwise.
+		int m_root;
+		Node *m_nodes;
+		Leaf *m_leaves;
+
+};
+
+} // namespace Private
+
+} // namespace IECoreScene
+
+#endif // IECORESCENE_TRIANGLEBVH_H
@@ -60,6 +60,27 @@ boost::python::list segment(const CurvesPrimitive *curves, const PrimitiveVariab
 	return returnList;
 }
 
+CurvesPrimitivePtr merge( boost::python::list &curvesPrimitivesList, boost::python::list &transformList )
+{
+	const size_t numCurvesPrimitives = boost::python::len( curvesPrimitivesList );
+	std::vector<const CurvesPrimitive *> curvesPrimitives( numCurvesPrimitives );
+	std::vector<CurvesPrimitivePtr> curvesPrimitivesPtrs( numCurvesPrimitives );
+	for( size_t i = 0; i < numCurvesPrimitives; ++i )
+	{
+		curvesPrimitivesPtrs[i] = boost::python::extract<CurvesPrimitivePtr>( curvesPrimitivesList[i] );
+		curvesPrimitives[i] = curvesPrimitivesPtrs[i].get();
+	}
+
+	const size_t numTransforms = boost::python::len( transformList );
+	std::vector<Imath::M44f> transforms( numTransforms );
+	for( size_t i = 0; i < numTransforms; ++i )
+	{
+		transforms[i] = boost::python::extract<Imath::M44f>( transformList[i] );
+	}
+
+	return CurvesAlgo::merge( curvesPrimitives, transforms );
+}
+
 BOOST_PYTHON_FUNCTION_OVERLOADS(segmentOverLoads, segment, 2, 3);
 
 } // namepsace
@@ -76,6 +97,7 @@ void bindCurvesAlgo()
 
 	def( "resamplePrimitiveVariable", &CurvesAlgo::resamplePrimitiveVariable );
 	def( "deleteCurves", &CurvesAlgo::deleteCurves, arg_( "invert" ) = false );
+	def( "merge", &::merge, ( arg_( "curvesPrimitives" ), arg_( "transforms" ) = boost::python::list() ) );
 	def( "segment", ::segment, segmentOverLoads());
 }
 
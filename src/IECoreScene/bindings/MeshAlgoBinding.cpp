@@ -90,6 +90,27 @@ boost::python::list segment(const MeshPrimitive *mesh, const PrimitiveVariable &
 	return returnList;
 }
 
+MeshPrimitivePtr merge( boost::python::list &meshesList, boost::python::list &transformList )
+{
+	const size_t numMeshes = boost::python::len( meshesList );
+	std::vector<const MeshPrimitive *> meshes( numMeshes );
+	std::vector<MeshPrimitivePtr> meshesPtrs( numMeshes );
+	for( size_t i = 0; i < numMeshes; ++i )
+	{
+		meshesPtrs[i] = boost::python::extract<MeshPrimitivePtr>( meshesList[i] );
+		meshes[i] = meshesPtrs[i].get();
+	}
+
+	const size_t numTransforms = boost::python::len( transformList );
+	std::vector<Imath::M44f> transforms( numTransforms );
+	for( size_t i = 0; i < numTransforms; ++i )
+	{
+		transforms[i] = boost::python::extract<Imath::M44f>( transformList[i] );
+	}
+
+	return MeshAlgo::merge( meshes, transforms );
+}
+
 BOOST_PYTHON_FUNCTION_OVERLOADS(segmentOverLoads, segment, 2, 3);
 
 } // namespace anonymous
@@ -105,7 +126,15 @@ void bindMeshAlgo()
 	scope meshAlgoScope( meshAlgoModule );
 
 	StdPairToTupleConverter<PrimitiveVariable, PrimitiveVariable>();
+	StdPairToTupleConverter<IECore::IntVectorDataPtr, IECore::IntVectorDataPtr>();
+
+	enum_<MeshAlgo::NormalWeighting>( "NormalWeighting" )
+		.value( "Equal", MeshAlgo::EqualWeighting )
+		.value( "Angle", MeshAlgo::AngleWeighting )
+		.value( "Area", MeshAlgo::AreaWeighting )
+	;
 
+	def( "calculateNormals", &MeshAlgo::calculateNormals, ( arg_( "mesh" ), arg_( "interpolation" ) = PrimitiveVariable::Vertex, arg_( "weighting" ) = MeshAlgo::EqualWeighting, arg_( "position" ) = "P", arg_( "destination" ) = object() ) );
 	def( "calculateTangents", &MeshAlgo::calculateTangents, ( arg_( "mesh" ), arg_( "uvSet" ) = "uv", arg_( "orthoTangents" ) = true, arg_( "position" ) = "P" ) );
 	def( "calculateFaceArea", &MeshAlgo::calculateFaceArea, ( arg_( "mesh" ), arg_( "position" ) = "P" ) );
 	def( "calculateFaceTextureArea", &MeshAlgo::calculateFaceTextureArea, ( arg_( "mesh" ), arg_( "uvSet" ) = "uv", arg_( "position" ) = "P" ) );
@@ -115,6 +144,11 @@ void bindMeshAlgo()
 	def( "reverseWinding", &MeshAlgo::reverseWinding );
 	def( "distributePoints", &MeshAlgo::distributePoints, ( arg_( "mesh" ), arg_( "density" ) = 100.0, arg_( "offset" ) = Imath::V2f( 0 ), arg_( "densityMask" ) = "density", arg_( "uvSet" ) = "uv", arg_( "position" ) = "P" ) );
 	def( "segment", &::segment, segmentOverLoads() );
+	def( "triangulate", &MeshAlgo::triangulate, ( arg_( "mesh" ), arg_( "throwExceptions" ) = false, arg_( "tolerance" ) = 1e-6f ) );
+	def( "triangulatedFaces", &MeshAlgo::triangulatedFaces );
+	def( "merge", &::merge, ( arg_( "meshes" ), arg_( "transforms" ) = boost::python::list() ) );
+	def( "calculateLocalityOrder", &MeshAlgo::calculateLocalityOrder, ( arg_( "mesh" ), arg_( "position" ) = "P" ) );
+	def( "reorder", &MeshAlgo::reorder, ( arg_( "mesh" ), arg_( "faceOrder" ), arg_( "vertexOrder" ) ) );
 }
 
 } // namespace IECoreSceneModule
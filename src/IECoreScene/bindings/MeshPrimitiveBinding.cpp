@@ -37,7 +37,9 @@
 #include "MeshPrimitiveBinding.h"
 
 #include "IECoreScene/MeshPrimitive.h"
+#include "IECoreScene/MeshTopology.h"
 
+#include "IECorePython/RefCountedBinding.h"
 #include "IECorePython/RunTimeTypedBinding.h"
 
 using namespace boost::python;
@@ -58,6 +60,22 @@ namespace IECoreSceneModule
 		return p.vertexIds()->copy();
 	}
 
+	static MeshTopologyPtr topology( const MeshPrimitive &p )
+	{
+		return boost::const_pointer_cast<MeshTopology>( p.topology() );
+	}
+
+	template<const std::vector<int> &(MeshTopology::*Accessor)() const>
+	static IntVectorDataPtr topologyArray( const MeshTopology &t )
+	{
+		return new IntVectorData( (t.*Accessor)() );
+	}
+
+	static V2iVectorDataPtr topologyEdges( const MeshTopology &t )
+	{
+		return new V2iVectorData( t.edges() );
+	}
+
 	void bindMeshPrimitive()
 	{
 		RunTimeTypedClass<MeshPrimitive>()
@@ -73,10 +91,32 @@ namespace IECoreSceneModule
 			.add_property( "vertexIds", &vertexIds, "A copy of the mesh's list of vertex ids." )
 			.add_property( "interpolation", make_function( &MeshPrimitive::interpolation, return_value_policy<copy_const_reference>() ), &MeshPrimitive::setInterpolation )
 			.def( "setTopology", &MeshPrimitive::setTopology )
+			.def( "topology", &topology )
 			.def( "createBox", &MeshPrimitive::createBox, ( arg_( "bounds" ) ) ).staticmethod( "createBox" )
 			.def( "createPlane", &MeshPrimitive::createPlane, ( arg_( "bounds" ), arg_( "divisions" ) = Imath::V2i( 1 ) ) ).staticmethod( "createPlane" )
 			.def( "createSphere", &MeshPrimitive::createSphere, ( arg_( "radius" ), arg_( "zMin" ) = -1.0f, arg_( "zMax" ) = 1.0f, arg_( "thetaMax" ) = 360.0f, arg_( "divisions" ) = Imath::V2i( 20, 40 ) ) ).staticmethod( "createSphere" )
 		;
+
+		RefCountedClass<MeshTopology, RefCounted>( "MeshTopology" )
+			.def( init<const MeshPrimitive *>() )
+			.def( "numFaces", &MeshTopology::numFaces )
+			.def( "numVertices", &MeshTopology::numVertices )
+			.def( "numFaceVertices", &MeshTopology::numFaceVertices )
+			.def( "numEdges", &MeshTopology::numEdges )
+			.def( "faceOffsets", &topologyArray<&MeshTopology::faceOffsets>, "A copy of the face offsets." )
+			.def( "faceVertexFaces", &topologyArray<&MeshTopology::faceVertexFaces>, "A copy of the face for each face-vertex." )
+			.def( "vertexOffsets", &topologyArray<&MeshTopology::vertexOffsets>, "A copy of the vertex offsets." )
+			.def( "vertexFaceVertices", &topologyArray<&MeshTopology::vertexFaceVertices>, "A copy of the face-vertices for each vertex." )
+			.def( "vertexFaces", &topologyArray<&MeshTopology::vertexFaces>, "A copy of the faces for each vertex." )
+			.def( "edges", &topologyEdges, "A copy of the edges." )
+			.def( "faceVertexEdges", &topologyArray<&MeshTopology::faceVertexEdges>, "A copy of the edge for each face-vertex." )
+			.def( "edgeOffsets", &topologyArray<&MeshTopology::edgeOffsets>, "A copy of the edge offsets." )
+			.def( "edgeFaces", &topologyArray<&MeshTopology::edgeFaces>, "A copy of the faces for each edge." )
+			.def( "memoryUsage", &MeshTopology::memoryUsage )
+			.def( "setCacheMemoryLimit", &MeshTopology::setCacheMemoryLimit ).staticmethod( "setCacheMemoryLimit" )
+			.def( "getCacheMemoryLimit", &MeshTopology::getCacheMemoryLimit ).staticmethod( "getCacheMemoryLimit" )
+			.def( "cacheMemoryUsage", &MeshTopology::cacheMemoryUsage ).staticmethod( "cacheMemoryUsage" )
+		;
 	}
 
 }
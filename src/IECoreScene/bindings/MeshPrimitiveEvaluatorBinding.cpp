@@ -40,6 +40,9 @@
 
 #include "IECorePython/RefCountedBinding.h"
 #include "IECorePython/RunTimeTypedBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
+
+#include "IECore/VectorTypedData.h"
 
 using namespace IECore;
 using namespace IECoreScene;
@@ -56,17 +59,62 @@ static bool barycentricPosition( const MeshPrimitiveEvaluator &e, unsigned int t
 	return e.barycentricPosition( t, b, r );
 }
 
+static list resultList( const std::vector<PrimitiveEvaluator::ResultPtr> &results )
+{
+	list result;
+	for( std::vector<PrimitiveEvaluator::ResultPtr>::const_iterator it = results.begin(); it != results.end(); ++it )
+	{
+		if( *it )
+		{
+			result.append( *it );
+		}
+		else
+		{
+			result.append( object() );
+		}
+	}
+	return result;
+}
+
+static list batchClosestPoint( const MeshPrimitiveEvaluator &e, const V3fVectorData *points )
+{
+	std::vector<PrimitiveEvaluator::ResultPtr> results;
+	{
+		IECorePython::ScopedGILRelease gilRelease;
+		e.batchClosestPoint( points->readable(), results );
+	}
+	return resultList( results );
+}
+
+static list batchIntersectionPoint( const MeshPrimitiveEvaluator &e, const V3fVectorData *origins, const V3fVectorData *directions, float maxDistance )
+{
+	std::vector<PrimitiveEvaluator::ResultPtr> results;
+	{
+		IECorePython::ScopedGILRelease gilRelease;
+		e.batchIntersectionPoint( origins->readable(), directions->readable(), results, maxDistance );
+	}
+	return resultList( results );
+}
+
 void bindMeshPrimitiveEvaluator()
 {
 	object m = RunTimeTypedClass<MeshPrimitiveEvaluator>()
-		.def( init< MeshPrimitivePtr > () )
+		.def( init< MeshPrimitivePtr, optional<MeshPrimitiveEvaluator::Accelerator> > () )
 		.def( "barycentricPosition", &barycentricPosition )
 		.def( "uvBound", &MeshPrimitiveEvaluator::uvBound )
+		.def( "accelerator", &MeshPrimitiveEvaluator::accelerator )
+		.def( "batchClosestPoint", &batchClosestPoint )
+		.def( "batchIntersectionPoint", &batchIntersectionPoint, ( arg( "origins" ), arg( "directions" ), arg( "maxDistance" ) = Imath::limits<float>::max() ) )
 	;
 
 	{
 		scope ms( m );
 
+		enum_<MeshPrimitiveEvaluator::Accelerator>( "Accelerator" )
+			.value( "KDTree", MeshPrimitiveEvaluator::KDTreeAccelerator )
+			.value( "BVH", MeshPrimitiveEvaluator::BVHAccelerator )
+		;
+
 		RefCountedClass<MeshPrimitiveEvaluator::Result, PrimitiveEvaluator::Result>( "Result" )
 			.def( "triangleIndex", &MeshPrimitiveEvaluator::Result::triangleIndex )
 			.def( "barycentricCoordinates", &MeshPrimitiveEvaluator::Result::barycentricCoordinates, return_value_policy<copy_const_reference>() )
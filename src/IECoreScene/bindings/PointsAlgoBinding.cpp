@@ -49,7 +49,7 @@ using namespace IECoreScene;
 namespace
 {
 
-PointsPrimitivePtr mergePointsList( boost::python::list &pointsPrimitiveList )
+PointsPrimitivePtr mergePointsList( boost::python::list &pointsPrimitiveList, boost::python::list &transformList )
 {
 	int numPointsPrimitives = boost::python::len( pointsPrimitiveList );
 	std::vector<const PointsPrimitive *> pointsPrimitiveVec( numPointsPrimitives );
@@ -60,7 +60,15 @@ PointsPrimitivePtr mergePointsList( boost::python::list &pointsPrimitiveList )
 		pointsPrimitiveVec[i] = ptr.get();
 	}
 
-	return PointsAlgo::mergePoints( pointsPrimitiveVec );
+	int numTransforms = boost::python::len( transformList );
+	std::vector<Imath::M44f> transforms( numTransforms );
+
+	for( int i = 0; i < numTransforms; ++i )
+	{
+		transforms[i] = boost::python::extract<Imath::M44f>( transformList[i] );
+	}
+
+	return PointsAlgo::mergePoints( pointsPrimitiveVec, transforms );
 }
 
 boost::python::list segment(const PointsPrimitive *points, const PrimitiveVariable &primitiveVariable, const IECore::Data *segmentValues = nullptr)
@@ -91,8 +99,10 @@ void bindPointsAlgo()
 
 	def( "resamplePrimitiveVariable", &PointsAlgo::resamplePrimitiveVariable );
 	def( "deletePoints", &PointsAlgo::deletePoints, arg_( "invert" ) = false);
-	def( "mergePoints", &::mergePointsList );
+	def( "mergePoints", &::mergePointsList, ( arg_( "pointsPrimitives" ), arg_( "transforms" ) = boost::python::list() ) );
 	def( "segment", &::segment, segmentOverLoads());
+	def( "calculateLocalityOrder", &PointsAlgo::calculateLocalityOrder, ( arg_( "points" ), arg_( "position" ) = "P" ) );
+	def( "reorder", &PointsAlgo::reorder, ( arg_( "points" ), arg_( "pointOrder" ) ) );
 }
 
 } // namespace IECoreSceneModule
@@ -41,7 +41,9 @@
 #include "IECoreScene/SceneCache.h"
 #include "IECoreScene/SharedSceneInterfaces.h"
 
+#include "IECorePython/RefCountedBinding.h"
 #include "IECorePython/RunTimeTypedBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 #include "tbb/tbb.h"
 
@@ -68,6 +70,18 @@ SceneCachePtr constructor2( IECore::IndexedIOPtr indexedIO )
 	return new SceneCache( indexedIO );
 }
 
+void prefetchWait( SceneCache::Prefetch &prefetch )
+{
+	IECorePython::ScopedGILRelease gilRelease;
+	prefetch.wait();
+}
+
+void prefetchCancel( SceneCache::Prefetch &prefetch )
+{
+	IECorePython::ScopedGILRelease gilRelease;
+	prefetch.cancel();
+}
+
 } // namespace
 
 //////////////////////////////////////////////////////////////////////////
@@ -166,10 +180,51 @@ namespace IECoreSceneModule
 
 void bindSceneCache()
 {
-	RunTimeTypedClass<SceneCache>()
-		.def( "__init__", make_constructor( &constructor ), "Opens a scene file for read or write." )
-		.def( "__init__", make_constructor( &constructor2 ), "Opens a scene from a previously opened file handle." )
-	;
+	{
+		scope sceneCacheScope = RunTimeTypedClass<SceneCache>()
+			.def( "__init__", make_constructor( &constructor ), "Opens a scene file for read or write." )
+			.def( "__init__", make_constructor( &constructor2 ), "Opens a scene from a previously opened file handle." )
+			.def( "setPipelinedWriting", &SceneCache::setPipelinedWriting )
+			.def( "getPipelinedWriting", &SceneCache::getPipelinedWriting )
+			.def( "prefetch", &SceneCache::prefetch, ( arg( "paths" ), arg( "startTime" ), arg( "endTime" ), arg( "what" ) = (int)SceneCache::PrefetchAll ) )
+			.def( "cacheStatistics", &SceneCache::cacheStatistics )
+			.def( "setCacheMemoryLimit", &SceneCache::setCacheMemoryLimit )
+			.def( "getCacheMemoryLimit", &SceneCache::getCacheMemoryLimit )
+			.def( "setDefaultCacheMemoryLimit", &SceneCache::setDefaultCacheMemoryLimit ).staticmethod( "setDefaultCacheMemoryLimit" )
+			.def( "getDefaultCacheMemoryLimit", &SceneCache::getDefaultCacheMemoryLimit ).staticmethod( "getDefaultCacheMemoryLimit" )
+			.def( "setCacheBufferDeduplication", &SceneCache::setCacheBufferDeduplication )
+			.def( "getCacheBufferDeduplication", &SceneCache::getCacheBufferDeduplication )
+			.def( "setDefaultCacheBufferDeduplication", &SceneCache::setDefaultCacheBufferDeduplication ).staticmethod( "setDefaultCacheBufferDeduplication" )
+			.def( "getDefaultCacheBufferDeduplication", &SceneCache::getDefaultCacheBufferDeduplication ).staticmethod( "getDefaultCacheBufferDeduplication" )
+		;
+
+		enum_<SceneCache::PrefetchData>( "PrefetchData" )
+			.value( "Transforms", SceneCache::PrefetchTransforms )
+			.value( "Attributes", SceneCache::PrefetchAttributes )
+			.value( "Objects", SceneCache::PrefetchObjects )
+			.value( "All", SceneCache::PrefetchAll )
+		;
+
+		enum_<SceneCache::CacheType>( "CacheType" )
+			.value( "TransformCache", SceneCache::TransformCache )
+			.value( "AttributeCache", SceneCache::AttributeCache )
+			.value( "ObjectCache", SceneCache::ObjectCache )
+		;
+
+		class_<SceneCache::CacheStatistics>( "CacheStatistics" )
+			.def_readonly( "hits", &SceneCache::CacheStatistics::hits )
+			.def_readonly( "misses", &SceneCache::CacheStatistics::misses )
+			.def_readonly( "evictions", &SceneCache::CacheStatistics::evictions )
+			.def_readonly( "memoryUsage", &SceneCache::CacheStatistics::memoryUsage )
+			.def_readonly( "loadTime", &SceneCache::CacheStatistics::loadTime )
+		;
+
+		RefCountedClass<SceneCache::Prefetch, RefCounted>( "Prefetch" )
+			.def( "wait", &prefetchWait )
+			.def( "cancel", &prefetchCancel )
+			.def( "done", &SceneCache::Prefetch::done )
+		;
+	}
 
 	def( "testSceneCacheParallelAttributeRead", &testSceneCacheParallelAttributeRead );
 	def( "testSceneCacheParallelFakeAttributeRead", &testSceneCacheParallelFakeAttributeRead );
@@ -41,6 +41,10 @@
 
 #include "IECorePython/IECoreBinding.h"
 #include "IECorePython/RunTimeTypedBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
+
+#include "IECore/CompoundData.h"
+#include "IECore/VectorTypedData.h"
 
 #include "boost/python/suite/indexing/container_utils.hpp"
 
@@ -210,6 +214,47 @@ static MurmurHash hashSet( SceneInterface &m, const SceneInterface::Name &name)
 	return h;
 }
 
+static CompoundDataPtr readHierarchy( const SceneInterface &m, const PathMatcher &filter, double time, int what )
+{
+	SceneInterface::Hierarchy hierarchy;
+	{
+		IECorePython::ScopedGILRelease gilRelease;
+		m.readHierarchy( filter, time, hierarchy, what );
+	}
+
+	CompoundDataPtr result = new CompoundData();
+	CompoundDataMap &members = result->writable();
+
+	StringVectorDataPtr paths = new StringVectorData();
+	paths->writable().reserve( hierarchy.paths.size() );
+	for( std::vector<SceneInterface::Path>::const_iterator it = hierarchy.paths.begin(); it != hierarchy.paths.end(); ++it )
+	{
+		std::string p;
+		SceneInterface::pathToString( *it, p );
+		paths->writable().push_back( p );
+	}
+	members["paths"] = paths;
+	members["parentIndices"] = new IntVectorData( hierarchy.parentIndices );
+
+	if( what & SceneInterface::HierarchyTransforms )
+	{
+		members["localTransforms"] = new M44dVectorData( hierarchy.localTransforms );
+		members["worldTransforms"] = new M44dVectorData( hierarchy.worldTransforms );
+	}
+	if( what & SceneInterface::HierarchyBounds )
+	{
+		members["bounds"] = new Box3dVectorData( hierarchy.bounds );
+	}
+	if( what & SceneInterface::HierarchyObjectTypes )
+	{
+		IntVectorDataPtr objectTypes = new IntVectorData();
+		objectTypes->writable().assign( hierarchy.objectTypes.begin(), hierarchy.objectTypes.end() );
+		members["objectTypes"] = objectTypes;
+	}
+
+	return result;
+}
+
 void bindSceneInterface()
 {
 	SceneInterfacePtr (SceneInterface::*nonConstChild)(const SceneInterface::Name &, SceneInterface::MissingBehaviour) = &SceneInterface::child;
@@ -246,6 +291,14 @@ void bindSceneInterface()
 			.export_values()
 		;
 
+		enum_< SceneInterface::HierarchyData > ("HierarchyData")
+			.value("HierarchyTransforms", SceneInterface::HierarchyTransforms)
+			.value("HierarchyBounds", SceneInterface::HierarchyBounds)
+			.value("HierarchyObjectTypes", SceneInterface::HierarchyObjectTypes)
+			.value("HierarchyAll", SceneInterface::HierarchyAll)
+			.export_values()
+		;
+
 	}
 
 	// now we've defined the nested types, we're able to define the methods for
@@ -283,6 +336,7 @@ void bindSceneInterface()
 		.def( "createChild", &SceneInterface::createChild )
 		.def( "scene", &nonConstScene, ( arg( "path" ), arg( "missingBehaviour" ) = SceneInterface::ThrowIfMissing ) )
 		.def( "hash", &sceneHash )
+		.def( "readHierarchy", &readHierarchy, ( arg( "filter" ), arg( "time" ), arg( "what" ) = (int)SceneInterface::HierarchyAll ) )
 
 		.def( "pathToString", pathToString ).staticmethod("pathToString")
 		.def( "stringToPath", stringToPath ).staticmethod("stringToPath")
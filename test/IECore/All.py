@@ -143,6 +143,7 @@ from TimeCodeDataTest import TimeCodeDataTest
 from NullObjectTest import NullObjectTest
 from StandardRadialLensModelTest import StandardRadialLensModelTest
 from ObjectPoolTest import ObjectPoolTest
+from ObjectStatisticsTest import ObjectStatisticsTest
 from RefCountedTest import RefCountedTest
 from DataAlgoTest import DataAlgoTest
 from PolygonAlgoTest import PolygonAlgoTest
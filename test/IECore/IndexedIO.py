@@ -38,6 +38,8 @@ import os
 import unittest
 import math
 import random
+import struct
+import threading
 
 import IECore
 
@@ -575,6 +577,148 @@ class TestFileIndexedIO(unittest.TestCase):
 		self.failIf(fv is gv)
 		self.assertEqual(fv, gv)
 
+	def testCompression( self ) :
+
+		f = IECore.FileIndexedIO( "./test/FileIndexedIO.fio", [], IECore.IndexedIO.OpenMode.Write )
+		self.assertEqual( f.getCompressionThreshold(), 0 )
+		f.write( "uncompressed", IECore.FloatVectorData( [ 1 ] * 100000 ) )
+		del f
+		uncompressedSize = os.path.getsize( "./test/FileIndexedIO.fio" )
+
+		f = IECore.FileIndexedIO( "./test/FileIndexedIO.fio", [], IECore.IndexedIO.OpenMode.Write )
+		f.setCompressionThreshold( 1024 )
+		g = f.subdirectory( "sub", IECore.IndexedIO.MissingBehaviour.CreateIfMissing )
+		self.assertEqual( g.getCompressionThreshold(), 1024 )
+
+		floats = IECore.FloatVectorData( [ 1 ] * 100000 )
+		ints = IECore.IntVectorData( range( 0, 3000000 ) )
+		strings = IECore.StringVectorData( [ "a", "bb", "ccc" ] * 1000 )
+		internedStrings = IECore.InternedStringVectorData( [ "a", "bb", "ccc" ] * 1000 )
+		small = IECore.FloatVectorData( [ 1, 2, 3 ] )
+
+		f.write( "compressed", floats )
+		g.write( "ints", ints )
+		g.write( "strings", strings )
+		g.write( "internedStrings", internedStrings )
+		g.write( "small", small )
+		g.commit()
+		del f, g
+
+		self.assertLess( os.path.getsize( "./test/FileIndexedIO.fio" ), uncompressedSize )
+
+		f = IECore.FileIndexedIO( "./test/FileIndexedIO.fio", [], IECore.IndexedIO.OpenMode.Read )
+		self.assertEqual( f.read( "compressed" ), floats )
+		self.assertEqual( f.entry( "compressed" ).arrayLength(), len( floats ) )
+
+		g = f.subdirectory( "sub" )
+		self.assertEqual( g.read( "ints" ), ints )
+		self.assertEqual( g.read( "strings" ), strings )
+		self.assertEqual( g.read( "internedStrings" ), internedStrings )
+		self.assertEqual( g.read( "small" ), small )
+
+	def testConcurrentReads( self ) :
+
+		f = IECore.FileIndexedIO( "./test/FileIndexedIO.fio", [], IECore.IndexedIO.OpenMode.Write )
+		for i in range( 0, 20 ) :
+			g = f.subdirectory( str( i ), IECore.IndexedIO.MissingBehaviour.CreateIfMissing )
+			g.write( "floats", IECore.FloatVectorData( [ float( i ) ] * ( 1000 + i ) ) )
+			g.write( "string", "string%d" % i )
+			g.commit()
+		del f, g
+
+		f = IECore.FileIndexedIO( "./test/FileIndexedIO.fio", [], IECore.IndexedIO.OpenMode.Read )
+
+		errors = []
+		def read( order ) :
+			try :
+				for i in order :
+					g = f.subdirectory( str( i ) )
+					self.assertEqual( g.read( "floats" ), IECore.FloatVectorData( [ float( i ) ] * ( 1000 + i ) ) )
+					self.assertEqual( g.read( "string" ).value, "string%d" % i )
+			except Exception as e :
+				errors.append( e )
+
+		threads = []
+		for t in range( 0, 8 ) :
+			order = list( range( 0, 20 ) )
+			random.shuffle( order )
+			threads.append( threading.Thread( target = read, args = ( order, ) ) )
+			threads[-1].start()
+
+		for t in threads :
+			t.join()
+
+		self.assertEqual( errors, [] )
+
+	def testConcurrentNestedReads( self ) :
+
+		f = IECore.FileIndexedIO( "./test/FileIndexedIO.fio", [], IECore.IndexedIO.OpenMode.Write )
+		f.setCompressionThreshold( 1 )
+		for i in range( 0, 4 ) :
+			g = f.subdirectory( str( i ), IECore.IndexedIO.MissingBehaviour.CreateIfMissing )
+			# large enough to be compressed in several chunks, which are
+			# decompressed in parallel
+			g.write( "strings", IECore.StringVectorData( [ "%d.%d" % ( i, j ) for j in range( 0, 100000 * ( i + 1 ) ) ] ) )
+			g.commit()
+		del f, g
+
+		f = IECore.FileIndexedIO( "./test/FileIndexedIO.fio", [], IECore.IndexedIO.OpenMode.Read )
+		IECore.testStreamIndexedIOConcurrentNestedReads( f, 200 )
+
+	def testLargeIndex( self ) :
+
+		# enough strings and nodes to need several string chunks and subindexes
+		f = IECore.FileIndexedIO( "./test/FileIndexedIO.fio", [], IECore.IndexedIO.OpenMode.Write )
+		self.assertEqual( f.getOnDemandIndex(), False )
+		f.setOnDemandIndex( True )
+		for i in range( 0, 100 ) :
+			g = f.subdirectory( "dir%d" % i, IECore.IndexedIO.MissingBehaviour.CreateIfMissing )
+			for j in range( 0, 100 ) :
+				g.subdirectory( "sub%d" % j, IECore.IndexedIO.MissingBehaviour.CreateIfMissing ).write( "value%d" % ( i * 100 + j ), i * 100 + j )
+		del f, g
+
+		def check( f, numDirs ) :
+
+			self.assertEqual( len( f.entryIds() ), numDirs )
+			for i in reversed( range( 0, numDirs ) ) :
+				g = f.subdirectory( "dir%d" % i )
+				self.assertEqual( len( g.entryIds() ), 100 )
+				for j in range( 0, 100, 7 ) :
+					self.assertEqual( g.subdirectory( "sub%d" % j ).read( "value%d" % ( i * 100 + j ) ).value, i * 100 + j )
+
+		check( IECore.FileIndexedIO( "./test/FileIndexedIO.fio", [], IECore.IndexedIO.OpenMode.Read ), 100 )
+		self.assertEqual( self.__fileVersion( "./test/FileIndexedIO.fio" ), 7 )
+
+		f = IECore.FileIndexedIO( "./test/FileIndexedIO.fio", [], IECore.IndexedIO.OpenMode.Append )
+		self.assertEqual( f.getOnDemandIndex(), True )
+		g = f.subdirectory( "dir100", IECore.IndexedIO.MissingBehaviour.CreateIfMissing )
+		for j in range( 0, 100 ) :
+			g.subdirectory( "sub%d" % j, IECore.IndexedIO.MissingBehaviour.CreateIfMissing ).write( "value%d" % ( 10000 + j ), 10000 + j )
+		del f, g
+
+		check( IECore.FileIndexedIO( "./test/FileIndexedIO.fio", [], IECore.IndexedIO.OpenMode.Read ), 101 )
+		self.assertEqual( self.__fileVersion( "./test/FileIndexedIO.fio" ), 7 )
+
+	def testDefaultVersion( self ) :
+
+		# Files must remain readable by older releases unless
+		# the on demand index is explicitly enabled.
+		f = IECore.FileIndexedIO( "./test/FileIndexedIO.fio", [], IECore.IndexedIO.OpenMode.Write )
+		f.subdirectory( "dir", IECore.IndexedIO.MissingBehaviour.CreateIfMissing ).write( "value", 1 )
+		del f
+
+		self.assertEqual( self.__fileVersion( "./test/FileIndexedIO.fio" ), 6 )
+
+		f = IECore.FileIndexedIO( "./test/FileIndexedIO.fio", [], IECore.IndexedIO.OpenMode.Read )
+		self.assertEqual( f.subdirectory( "dir" ).read( "value" ).value, 1 )
+
+	def __fileVersion( self, path ) :
+
+		# The version precedes the magic number at the end of the file.
+		with open( path, "rb" ) as f :
+			f.seek( -16, os.SEEK_END )
+			return struct.unpack( "<q", f.read( 8 ) )[0]
+
 	def setUp( self ):
 
 		if os.path.isfile("./test/FileIndexedIO.fio") :
@@ -43,6 +43,7 @@
 #include "tbb/tbb.h"
 
 #include <iostream>
+#include <vector>
 
 using namespace boost;
 using namespace boost::unit_test;
@@ -95,6 +96,52 @@ struct InternedStringTest
 
 	};
 
+	void testInternStrings()
+	{
+		std::vector<std::string> strings;
+		for( size_t i = 0; i < 10000; ++i )
+		{
+			strings.push_back( "internStrings" + lexical_cast<std::string>( i % 5000 ) );
+		}
+		strings.push_back( "" );
+
+		std::vector<InternedString> internedStrings( strings.size() );
+		InternedString::internStrings( strings.data(), strings.size(), internedStrings.data() );
+
+		for( size_t i = 0; i < strings.size(); ++i )
+		{
+			BOOST_CHECK_EQUAL( internedStrings[i].string(), strings[i] );
+			BOOST_CHECK( internedStrings[i] == InternedString( strings[i] ) );
+		}
+		BOOST_CHECK( internedStrings[0] == internedStrings[5000] );
+	}
+
+	void testConcurrentInternStrings()
+	{
+		std::vector<std::string> strings;
+		for( size_t i = 0; i < 1000; ++i )
+		{
+			strings.push_back( "concurrentInternStrings" + lexical_cast<std::string>( i ) );
+		}
+
+		const size_t numIterations = 1000;
+		std::vector<InternedString> internedStrings( strings.size() * numIterations );
+		parallel_for(
+			blocked_range<size_t>( 0, numIterations ),
+			[&strings, &internedStrings]( const blocked_range<size_t> &r ) {
+				for( size_t i = r.begin(); i != r.end(); ++i )
+				{
+					InternedString::internStrings( strings.data(), strings.size(), &internedStrings[i * strings.size()] );
+				}
+			}
+		);
+
+		for( size_t i = 0; i < internedStrings.size(); ++i )
+		{
+			BOOST_CHECK( internedStrings[i] == InternedString( strings[i % strings.size()] ) );
+		}
+	}
+
 };
 
 
@@ -107,6 +154,8 @@ struct InternedStringTestSuite : public boost::unit_test::test_suite
 
 		add( BOOST_CLASS_TEST_CASE( &InternedStringTest::testConcurrentConstruction, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &InternedStringTest::testRangeConstruction, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &InternedStringTest::testInternStrings, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &InternedStringTest::testConcurrentInternStrings, instance ) );
 
 	}
 };
@@ -66,6 +66,8 @@ class KDTreeTest
 		void testNearestNeighour();
 		void testNearestNeighours();
 		void testNearestNNeighours();
+		void testBatchedQueries();
+		void testParallelBuild();
 
 	private:
 
@@ -105,6 +107,8 @@ struct KDTreeTestSuite : public boost::unit_test::test_suite
 		add( BOOST_CLASS_TEST_CASE( &KDTreeTest<T>::testNearestNeighour, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &KDTreeTest<T>::testNearestNeighours, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &KDTreeTest<T>::testNearestNNeighours, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &KDTreeTest<T>::testBatchedQueries, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &KDTreeTest<T>::testParallelBuild, instance ) );
 	}
 };
 
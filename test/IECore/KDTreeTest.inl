@@ -192,4 +192,98 @@ void KDTreeTest<T>::testNearestNNeighours()
 
 }
 
+template<typename T>
+void KDTreeTest<T>::testBatchedQueries()
+{
+	// Query with points which aren't in the tree, as well
+	// as points which are.
+	PointVector queries( m_points );
+	for( unsigned int i=0; i<m_numPoints; i++ )
+	{
+		T p;
+		for ( unsigned int j = 0; j < VectorTraits< T >::dimensions(); j++)
+			p[j] = m_randGen.nextf();
+		queries.push_back( p );
+	}
+
+	// The batched queries must give exactly the same results
+	// as the single point queries.
+
+	IteratorVector nearest;
+	m_tree->nearestNeighbour( queries.begin(), queries.end(), nearest );
+	BOOST_CHECK_EQUAL( nearest.size(), queries.size() );
+	for( size_t i=0; i<queries.size(); i++ )
+	{
+		BOOST_CHECK( nearest[i] == m_tree->nearestNeighbour( queries[i] ) );
+	}
+
+	NeighbourVector batchNeighbours, neighbours;
+	for( unsigned int numRequested = 1; numRequested < 8; numRequested += 3 )
+	{
+		unsigned int numFound = m_tree->nearestNNeighbours( queries.begin(), queries.end(), numRequested, batchNeighbours );
+		BOOST_CHECK_EQUAL( numFound, std::min( numRequested, m_numPoints ) );
+		BOOST_CHECK_EQUAL( batchNeighbours.size(), queries.size() * numFound );
+		for( size_t i=0; i<queries.size(); i++ )
+		{
+			BOOST_CHECK_EQUAL( m_tree->nearestNNeighbours( queries[i], numRequested, neighbours ), numFound );
+			for( unsigned int j=0; j<numFound; j++ )
+			{
+				BOOST_CHECK( batchNeighbours[i*numFound+j].point == neighbours[j].point );
+				BOOST_CHECK_EQUAL( batchNeighbours[i*numFound+j].distSquared, neighbours[j].distSquared );
+			}
+		}
+	}
+
+	// Empty batches should be fine too.
+	m_tree->nearestNeighbour( queries.end(), queries.end(), nearest );
+	BOOST_CHECK( nearest.empty() );
+	BOOST_CHECK_EQUAL( m_tree->nearestNNeighbours( queries.end(), queries.end(), 4, batchNeighbours ), std::min( 4u, m_numPoints ) );
+	BOOST_CHECK( batchNeighbours.empty() );
+}
+
+template<typename T>
+void KDTreeTest<T>::testParallelBuild()
+{
+	// Enough points for the tree to be built in parallel.
+	PointVector points( 200000 );
+	for( size_t i=0; i<points.size(); i++ )
+	{
+		for ( unsigned int j = 0; j < VectorTraits< T >::dimensions(); j++)
+			points[i][j] = m_randGen.nextf();
+	}
+
+	Tree tree( points.begin(), points.end() );
+
+	// Every point must be in exactly one leaf.
+	std::vector<int> leafCounts( points.size(), 0 );
+	for( typename Tree::NodeIndex i=tree.rootIndex(); i<tree.numNodes(); i++ )
+	{
+		const typename Tree::Node &node = tree.node( i );
+		if( node.isLeaf() && node.permFirst() )
+		{
+			for( PointIterator *it = node.permFirst(); it!=node.permLast(); it++ )
+			{
+				leafCounts[*it - points.begin()]++;
+			}
+		}
+	}
+	BOOST_CHECK( std::count( leafCounts.begin(), leafCounts.end(), 1 ) == (int)points.size() );
+
+	// Compare against a brute force search.
+	for( unsigned int i=0; i<100; i++ )
+	{
+		T p;
+		for ( unsigned int j = 0; j < VectorTraits< T >::dimensions(); j++)
+			p[j] = m_randGen.nextf();
+
+		typename T::BaseType closestDistSquared = Imath::limits<typename T::BaseType>::max();
+		for( typename PointVector::const_iterator it=points.begin(); it!=points.end(); it++ )
+		{
+			closestDistSquared = std::min( closestDistSquared, vecDistance2( p, *it ) );
+		}
+
+		BOOST_CHECK_EQUAL( vecDistance2( p, *tree.nearestNeighbour( p ) ), closestDistSquared );
+	}
+}
+
 }
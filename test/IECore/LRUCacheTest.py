@@ -312,6 +312,65 @@ class LRUCacheTest( unittest.TestCase ) :
 		# Cache small enough that evictions are necessary
 		IECore.testParallelLRUCacheRecursion( 100000, 1000, 100 )
 
+	def testTaskParallelRecursion( self ) :
+
+		# Cache big enough that nothing will be evicted
+		IECore.testTaskParallelLRUCacheRecursion( 100000, 10000, 10000 )
+		# Cache small enough that evictions are necessary
+		IECore.testTaskParallelLRUCacheRecursion( 100000, 1000, 100 )
+
+	def testTaskParallelCollaboration( self ) :
+
+		# arguments are :
+		# iterations, number of unique values, maximum cost
+
+		# many threads waiting on each value, with getters using TBB themselves
+		IECore.testTaskParallelLRUCacheCollaboration( 10000, 10, 100 )
+		# values being evicted and computed again while threads wait for them
+		IECore.testTaskParallelLRUCacheCollaboration( 10000, 100, 10 )
+
+	def testTaskParallelRecursionDetection( self ) :
+
+		IECore.testTaskParallelLRUCacheRecursionDetection()
+
+	def testScanResistantThreading( self ) :
+
+		IECore.testScanResistantLRUCacheThreading( 100000, 100, 100 )
+		IECore.testScanResistantLRUCacheThreading( 100000, 100, 90 )
+		IECore.testScanResistantLRUCacheThreading( 100000, 1000, 2 )
+		IECore.testScanResistantLRUCacheThreading( 100000, 1000, 90, 20 )
+
+	def testScanResistantRecursion( self ) :
+
+		IECore.testScanResistantLRUCacheRecursion( 100000, 10000, 10000 )
+		IECore.testScanResistantLRUCacheRecursion( 100000, 1000, 100 )
+
+	def testScanResistantScan( self ) :
+
+		IECore.testScanResistantLRUCacheScan()
+
+	def testStatistics( self ) :
+
+		def getter( key ) :
+			return ( key, 1 )
+
+		c = IECore.LRUCache( getter, 2 )
+		self.assertEqual( c.statistics(), { "hits" : 0, "misses" : 0, "evictions" : 0 } )
+
+		c.get( 1 )
+		c.get( 1 )
+		c.get( 2 )
+		self.assertEqual( c.statistics(), { "hits" : 1, "misses" : 2, "evictions" : 0 } )
+
+		# erasing and clearing are not evictions
+		c.erase( 1 )
+		c.get( 3 )
+		c.get( 4 )
+		self.assertEqual( c.statistics(), { "hits" : 1, "misses" : 4, "evictions" : 1 } )
+
+		c.resetStatistics()
+		self.assertEqual( c.statistics(), { "hits" : 0, "misses" : 0, "evictions" : 0 } )
+
 	def testExceptions( self ) :
 
 		calls = []
@@ -112,5 +112,27 @@ class ObjectPoolTest( unittest.TestCase ) :
 			p.contains( b.hash() )
 		)
 
+	def testStoreDeduplicated( self ) :
+
+		p = IECore.ObjectPool( 1024 * 1024 )
+
+		shared = IECore.IntVectorData( range( 0, 10000 ) )
+		a = IECore.CompoundObject( { "shared" : shared, "name" : IECore.StringData( "a" ) } )
+		b = IECore.CompoundObject( { "shared" : shared.copy(), "name" : IECore.StringData( "b" ) } )
+
+		aStored = p.store( a, IECore.ObjectPool.StoreDeduplicated )
+		bStored = p.store( b, IECore.ObjectPool.StoreDeduplicated )
+		self.assertEqual( aStored, a )
+		self.assertEqual( bStored, b )
+		self.assertTrue( aStored.isSame( p.retrieve( a.hash(), _copy=False ) ) )
+
+		# the large buffer is shared between the stored objects, and only accounted for once
+		self.assertLess( IECore.CompoundObject( { "a" : aStored, "b" : bStored } ).memoryUsage(), a.memoryUsage() + b.memoryUsage() )
+		self.assertLess( p.memoryUsage(), a.memoryUsage() + b.memoryUsage() )
+		self.assertTrue( p.contains( shared.hash() ) )
+
+		# storing a pooled buffer directly returns the pooled instance
+		self.assertTrue( p.retrieve( shared.hash(), _copy=False ).isSame( p.store( shared, IECore.ObjectPool.StoreDeduplicated ) ) )
+
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,112 @@
+##########################################################################
+#
+#  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+import unittest
+
+import IECore
+
+class ObjectStatisticsTest( unittest.TestCase ) :
+
+	def testDisabled( self ) :
+
+		if IECore.ObjectStatistics.enabled() :
+			return
+
+		s = IECore.ObjectStatistics.snapshot()
+		self.assertEqual( s["types"], {} )
+		self.assertEqual( s["owners"], {} )
+
+	@unittest.skipIf( not IECore.ObjectStatistics.enabled(), "ObjectStatistics not enabled" )
+	def testInstances( self ) :
+
+		def instances() :
+			s = IECore.ObjectStatistics.snapshot()["types"]
+			return s["CompoundObject"].instances if "CompoundObject" in s else 0
+
+		before = instances()
+		o = [ IECore.CompoundObject() for i in range( 0, 10 ) ]
+		self.assertEqual( instances(), before + 10 )
+		del o
+		self.assertEqual( instances(), before )
+
+	@unittest.skipIf( not IECore.ObjectStatistics.enabled(), "ObjectStatistics not enabled" )
+	def testSharedBuffersCountedOnce( self ) :
+
+		def stats() :
+			return IECore.ObjectStatistics.snapshot()["types"].get( "IntVectorData" )
+
+		before = stats()
+		beforeBuffers = before.buffers if before else 0
+		beforeMemory = before.bufferMemory if before else 0
+
+		d = IECore.IntVectorData( range( 0, 100000 ) )
+		copies = [ d.copy() for i in range( 0, 10 ) ]
+
+		after = stats()
+		self.assertEqual( after.buffers, beforeBuffers + 1 )
+		self.assertGreaterEqual( after.bufferMemory - beforeMemory, 100000 * 4 )
+		self.assertLess( after.bufferMemory - beforeMemory, 2 * 100000 * 4 )
+
+		# Modifying a copy gives it a buffer of its own.
+		copies[0].append( 1 )
+		self.assertEqual( stats().buffers, beforeBuffers + 2 )
+
+	@unittest.skipIf( not IECore.ObjectStatistics.enabled(), "ObjectStatistics not enabled" )
+	def testModificationsRecordedOnNextAccess( self ) :
+
+		def memory() :
+			s = IECore.ObjectStatistics.snapshot()["types"].get( "FloatVectorData" )
+			return s.bufferMemory if s else 0
+
+		d = IECore.FloatVectorData()
+		before = memory()
+
+		d.extend( [ 1.0 ] * 100000 )
+		d.hash()
+		self.assertGreaterEqual( memory() - before, 100000 * 4 )
+
+		del d
+		self.assertLess( memory(), before + 100000 * 4 )
+
+	@unittest.skipIf( not IECore.ObjectStatistics.enabled(), "ObjectStatistics not enabled" )
+	def testOwners( self ) :
+
+		p = IECore.ObjectPool( 1024 * 1024 )
+		p.store( IECore.IntVectorData( range( 0, 1000 ) ), IECore.ObjectPool.StoreReference )
+
+		owners = IECore.ObjectStatistics.snapshot()["owners"]
+		self.assertGreaterEqual( owners["ObjectPool"], p.memoryUsage() )
+
+if __name__ == "__main__":
+	unittest.main()
@@ -95,6 +95,41 @@ struct RadixSortTest
 			}
 		}
 	}
+
+	template<typename T>
+	void testStable()
+	{
+		boost::mt19937 generator( 42 );
+		boost::uniform_int<> uni_dist( -100, 100 );
+		boost::variate_generator<boost::mt19937&, boost::uniform_int<> > uni( generator, uni_dist );
+
+		// large enough to be sorted in parallel, with many equal values
+		std::vector<T> input;
+		for ( unsigned n = 0; n < 200000; n++ )
+		{
+			input.push_back( static_cast<T>( uni() ) );
+		}
+
+		RadixSort sorter;
+		const std::vector<unsigned int> &indices = sorter( input );
+		BOOST_CHECK_EQUAL( indices.size(), input.size() );
+
+		for ( unsigned n = 1; n < input.size(); n++ )
+		{
+			BOOST_CHECK( input[ indices[n] ] >= input[ indices[n - 1] ] );
+			if( input[ indices[n] ] == input[ indices[n - 1] ] )
+			{
+				BOOST_CHECK( indices[n] > indices[n - 1] );
+			}
+		}
+
+		std::vector<T> sorted = input;
+		RadixSort::permute( indices, sorted );
+		for ( unsigned n = 0; n < input.size(); n++ )
+		{
+			BOOST_CHECK_EQUAL( sorted[n], input[ indices[n] ] );
+		}
+	}
 };
 
 struct RadixSortTestSuite : public boost::unit_test::test_suite
@@ -107,6 +142,13 @@ struct RadixSortTestSuite : public boost::unit_test::test_suite
 		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::test<float>, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::test<unsigned int>, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::test<int>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::test<double>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::test<uint64_t>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::test<int64_t>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::testStable<float>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::testStable<int>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::testStable<double>, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &RadixSortTest::testStable<int64_t>, instance ) );
 	}
 
 };
@@ -95,6 +95,70 @@ class RadixSortTest( unittest.TestCase ) :
 
 			self.assert_( d[ idx[ i ] ] >= d[ idx[ i - 1 ] ] )
 
+	def testDouble( self ) :
+
+		random.seed( 15 )
+
+		s = IECore.RadixSort()
+
+		d = IECore.DoubleVectorData( [ random.uniform( -1e300, 1e300 ) for i in range( 0, 10000 ) ] )
+
+		idx = s.sort( d )
+
+		self.assertEqual( len(idx), 10000 )
+
+		for i in range( 1, 10000 ):
+
+			self.assertGreaterEqual( d[ idx[ i ] ], d[ idx[ i - 1 ] ] )
+
+	def testInt64( self ) :
+
+		random.seed( 16 )
+
+		s = IECore.RadixSort()
+
+		d = IECore.Int64VectorData( [ random.randint( -2**63, 2**63 - 1 ) for i in range( 0, 10000 ) ] )
+
+		idx = s.sort( d )
+
+		self.assertEqual( len(idx), 10000 )
+
+		for i in range( 1, 10000 ):
+
+			self.assertGreaterEqual( d[ idx[ i ] ], d[ idx[ i - 1 ] ] )
+
+	def testUInt64( self ) :
+
+		random.seed( 17 )
+
+		s = IECore.RadixSort()
+
+		d = IECore.UInt64VectorData( [ random.randint( 0, 2**64 - 1 ) for i in range( 0, 10000 ) ] )
+
+		idx = s.sort( d )
+
+		self.assertEqual( len(idx), 10000 )
+
+		for i in range( 1, 10000 ):
+
+			self.assertGreaterEqual( d[ idx[ i ] ], d[ idx[ i - 1 ] ] )
+
+	def testStable( self ) :
+
+		random.seed( 18 )
+
+		s = IECore.RadixSort()
+
+		# large enough to be sorted in parallel
+		d = IECore.FloatVectorData( [ random.randint( 0, 10 ) for i in range( 0, 100000 ) ] )
+
+		idx = s.sort( d )
+
+		for i in range( 1, len( d ) ):
+
+			self.assertGreaterEqual( d[ idx[ i ] ], d[ idx[ i - 1 ] ] )
+			if d[ idx[ i ] ] == d[ idx[ i - 1 ] ] :
+				self.assertGreater( idx[ i ], idx[ i - 1 ] )
 
 if __name__ == "__main__":
 	unittest.main()
@@ -0,0 +1,223 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "SmallObjectAllocatorTest.h"
+
+#include "IECore/SimpleTypedData.h"
+#include "IECore/SmallObjectAllocator.h"
+
+#include "tbb/tbb.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+using namespace boost;
+using namespace boost::unit_test;
+using namespace tbb;
+
+namespace IECore
+{
+
+struct SmallObjectAllocatorTest
+{
+
+	void testSizes()
+	{
+		std::vector<std::pair<void *, size_t> > blocks;
+		for( size_t size = 0; size <= SmallObjectAllocator::maxBlockSize + 16; ++size )
+		{
+			for( size_t i = 0; i < 100; ++i )
+			{
+				void *block = SmallObjectAllocator::allocate( size );
+				BOOST_CHECK( ( reinterpret_cast<size_t>( block ) & 15 ) == 0 );
+				memset( block, size % 256, size );
+				blocks.push_back( std::make_pair( block, size ) );
+			}
+		}
+
+		for( std::vector<std::pair<void *, size_t> >::const_iterator it = blocks.begin(); it != blocks.end(); ++it )
+		{
+			const unsigned char *c = static_cast<const unsigned char *>( it->first );
+			for( size_t i = 0; i < it->second; ++i )
+			{
+				BOOST_CHECK_EQUAL( c[i], it->second % 256 );
+			}
+			SmallObjectAllocator::deallocate( it->first, it->second );
+		}
+	}
+
+	void testThreading()
+	{
+		// allocate on some threads and free on others.
+		const size_t numObjects = 1000000;
+		std::vector<IntDataPtr> objects( numObjects );
+
+		parallel_for(
+			blocked_range<size_t>( 0, numObjects ),
+			[&objects]( const blocked_range<size_t> &r ) {
+				for( size_t i = r.begin(); i != r.end(); ++i )
+				{
+					objects[i] = new IntData( i );
+				}
+			}
+		);
+
+		tbb::atomic<size_t> errors;
+		errors = 0;
+		parallel_for(
+			blocked_range<size_t>( 0, numObjects ),
+			[&objects, &errors]( const blocked_range<size_t> &r ) {
+				for( size_t i = r.begin(); i != r.end(); ++i )
+				{
+					if( objects[i]->readable() != (int)i )
+					{
+						errors++;
+					}
+					if( i % 2 )
+					{
+						objects[i] = nullptr;
+					}
+				}
+			},
+			simple_partitioner()
+		);
+		BOOST_CHECK_EQUAL( (size_t)errors, 0u );
+
+		parallel_for(
+			blocked_range<size_t>( 0, numObjects ),
+			[&objects]( const blocked_range<size_t> &r ) {
+				for( size_t i = r.begin(); i != r.end(); ++i )
+				{
+					if( i % 2 )
+					{
+						objects[i] = new IntData( -(int)i );
+					}
+				}
+			}
+		);
+
+		for( size_t i = 0; i < numObjects; ++i )
+		{
+			BOOST_CHECK_EQUAL( objects[i]->readable(), i % 2 ? -(int)i : (int)i );
+		}
+	}
+
+	void testTrim()
+	{
+		// Enough blocks of an unusual size to fill several slabs,
+		// all of which will be free after we deallocate them.
+		const size_t size = SmallObjectAllocator::maxBlockSize - 8;
+		std::vector<void *> blocks;
+		for( size_t i = 0; i < 10000; ++i )
+		{
+			blocks.push_back( SmallObjectAllocator::allocate( size ) );
+		}
+
+		for( std::vector<void *>::const_iterator it = blocks.begin(); it != blocks.end(); ++it )
+		{
+			SmallObjectAllocator::deallocate( *it, size );
+		}
+
+		const SmallObjectAllocator::Statistics before = SmallObjectAllocator::statistics();
+		const size_t released = SmallObjectAllocator::trim();
+		const SmallObjectAllocator::Statistics after = SmallObjectAllocator::statistics();
+
+		// There are no slabs to release if pooling has been disabled
+		// with IECORE_SMALLOBJECTALLOCATOR=0.
+		if( before.slabs )
+		{
+			BOOST_CHECK( released >= 10000 * size );
+		}
+		BOOST_CHECK_EQUAL( before.slabMemory - after.slabMemory, released );
+
+		// The pools must still work after trimming.
+		void *block = SmallObjectAllocator::allocate( size );
+		memset( block, 1, size );
+		SmallObjectAllocator::deallocate( block, size );
+	}
+
+	struct Thrower
+	{
+		IECORE_SMALLOBJECTALLOCATOR_OPERATORS
+
+		Thrower()
+		{
+			throw std::runtime_error( "Thrower" );
+		}
+
+		char data[40];
+	};
+
+	void testOperators()
+	{
+		IntData *d = new( std::nothrow ) IntData( 10 );
+		BOOST_CHECK( d );
+		BOOST_CHECK_EQUAL( d->readable(), 10 );
+		delete d;
+
+		typename std::aligned_storage<sizeof( IntData ), alignof( IntData )>::type storage;
+		d = new( &storage ) IntData( 20 );
+		BOOST_CHECK_EQUAL( d->readable(), 20 );
+		d->~IntData();
+
+		// The blocks must be returned to the pools when
+		// the constructor throws.
+		BOOST_CHECK_THROW( new Thrower, std::runtime_error );
+		BOOST_CHECK_THROW( new( std::nothrow ) Thrower, std::runtime_error );
+	}
+
+};
+
+struct SmallObjectAllocatorTestSuite : public boost::unit_test::test_suite
+{
+
+	SmallObjectAllocatorTestSuite() : boost::unit_test::test_suite( "SmallObjectAllocatorTestSuite" )
+	{
+		boost::shared_ptr<SmallObjectAllocatorTest> instance( new SmallObjectAllocatorTest() );
+
+		add( BOOST_CLASS_TEST_CASE( &SmallObjectAllocatorTest::testSizes, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &SmallObjectAllocatorTest::testThreading, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &SmallObjectAllocatorTest::testTrim, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &SmallObjectAllocatorTest::testOperators, instance ) );
+	}
+};
+
+void addSmallObjectAllocatorTest( boost::unit_test::test_suite *test )
+{
+	test->add( new SmallObjectAllocatorTestSuite() );
+}
+
+} // namespace IECore
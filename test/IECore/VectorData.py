@@ -1260,6 +1260,26 @@ class TestVectorDataHashOptimisation( unittest.TestCase ) :
 		# should be slow this time, as the hash is being recomputed
 		self.assertGreaterEqual( secondTime, 0.8 * firstTime )
 
+class TestVectorDataChunkedHash( unittest.TestCase ) :
+
+	def test( self ) :
+
+		# large enough to be hashed as many chunks
+		d = IECore.V3fVectorData( [ imath.V3f( i ) for i in range( 0, 1000000 ) ] )
+		h = d.hash()
+
+		self.assertEqual( d.copy().hash(), h )
+		self.assertEqual( IECore.V3fVectorData( [ imath.V3f( i ) for i in range( 0, 1000000 ) ] ).hash(), h )
+
+		for i in ( 0, len( d ) // 2, len( d ) - 1 ) :
+			d2 = d.copy()
+			d2[i] = imath.V3f( -1 )
+			self.assertNotEqual( d2.hash(), h )
+
+		d2 = d.copy()
+		d2.append( imath.V3f( 0 ) )
+		self.assertNotEqual( d2.hash(), h )
+
 class TestInternedStringVectorData( unittest.TestCase ) :
 
 	def test( self ) :
@@ -1279,5 +1279,37 @@ class CurvesAlgoDeleteCurvesTest ( unittest.TestCase ):
 		self.assertEqual( actualCurves["e"].data, IECore.FloatVectorData([0, 1])  )
 		self.assertEqual( actualCurves["e"].interpolation, IECoreScene.PrimitiveVariable.Interpolation.FaceVarying)
 
+class CurvesAlgoMergeTest( unittest.TestCase ) :
+
+	def testMerge( self ) :
+
+		c1 = IECoreScene.CurvesPrimitive( IECore.IntVectorData( [ 4 ] ), IECore.CubicBasisf.catmullRom(), False, IECore.V3fVectorData( [ imath.V3f( x ) for x in range( 0, 4 ) ] ) )
+		c1["a"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.IntVectorData( [ 1 ] ) )
+		c2 = IECoreScene.CurvesPrimitive( IECore.IntVectorData( [ 4, 5 ] ), IECore.CubicBasisf.catmullRom(), False, IECore.V3fVectorData( [ imath.V3f( x ) for x in range( 4, 13 ) ] ) )
+		c2["b"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Varying, IECore.FloatVectorData( [ 2 ] * 5 ) )
+
+		merged = IECoreScene.CurvesAlgo.merge( [ c1, c2 ] )
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+
+		self.assertEqual( merged.verticesPerCurve(), IECore.IntVectorData( [ 4, 4, 5 ] ) )
+		self.assertEqual( merged.basis(), IECore.CubicBasisf.catmullRom() )
+		self.assertEqual( list( merged["P"].data ), [ imath.V3f( x ) for x in range( 0, 13 ) ] )
+		self.assertEqual( merged["a"].data, IECore.IntVectorData( [ 1, 0, 0 ] ) )
+		self.assertEqual( merged["b"].data, IECore.FloatVectorData( [ 0 ] * 2 + [ 2 ] * 5 ) )
+
+	def testTransforms( self ) :
+
+		c = IECoreScene.CurvesPrimitive( IECore.IntVectorData( [ 2 ] ), IECore.CubicBasisf.linear(), False, IECore.V3fVectorData( [ imath.V3f( 0 ), imath.V3f( 1 ) ] ) )
+		merged = IECoreScene.CurvesAlgo.merge( [ c, c ], [ imath.M44f(), imath.M44f().translate( imath.V3f( 10 ) ) ] )
+
+		self.assertEqual( list( merged["P"].data ), [ imath.V3f( 0 ), imath.V3f( 1 ), imath.V3f( 10 ), imath.V3f( 11 ) ] )
+
+	def testMismatchedBasis( self ) :
+
+		c1 = IECoreScene.CurvesPrimitive( IECore.IntVectorData( [ 4 ] ), IECore.CubicBasisf.catmullRom() )
+		c2 = IECoreScene.CurvesPrimitive( IECore.IntVectorData( [ 4 ] ), IECore.CubicBasisf.linear() )
+
+		self.assertRaises( RuntimeError, IECoreScene.CurvesAlgo.merge, [ c1, c2 ] )
+
 if __name__ == "__main__":
 	unittest.main()
@@ -0,0 +1,300 @@
+##########################################################################
+#
+#  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+
+import unittest
+import imath
+
+import IECore
+import IECoreScene
+
+class MeshAlgoMergeTest( unittest.TestCase ) :
+
+	def testTopology( self ) :
+
+		m1 = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 0 ) ) )
+		m2 = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( 0 ), imath.V2f( 1 ) ), imath.V2i( 2 ) )
+
+		merged = IECoreScene.MeshAlgo.merge( [ m1, m2 ] )
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+
+		self.assertEqual( merged.numFaces(), m1.numFaces() + m2.numFaces() )
+		self.assertEqual( merged.verticesPerFace, IECore.IntVectorData( list( m1.verticesPerFace ) + list( m2.verticesPerFace ) ) )
+		self.assertEqual(
+			merged.vertexIds,
+			IECore.IntVectorData( list( m1.vertexIds ) + [ i + len( m1["P"].data ) for i in m2.vertexIds ] )
+		)
+		self.assertEqual( merged.interpolation, m1.interpolation )
+
+		self.assertEqual( list( merged["P"].data ), list( m1["P"].data ) + list( m2["P"].data ) )
+		self.assertEqual( merged["P"].data.getInterpretation(), IECore.GeometricData.Interpretation.Point )
+
+	def __triangleAndQuad( self ) :
+
+		triangle = IECoreScene.MeshPrimitive( IECore.IntVectorData( [ 3 ] ), IECore.IntVectorData( [ 0, 1, 2 ] ) )
+		triangle["P"] = IECoreScene.PrimitiveVariable(
+			IECoreScene.PrimitiveVariable.Interpolation.Vertex,
+			IECore.V3fVectorData( [ imath.V3f( 0, 0, 0 ), imath.V3f( 1, 0, 0 ), imath.V3f( 0, 1, 0 ) ] )
+		)
+
+		quad = IECoreScene.MeshPrimitive( IECore.IntVectorData( [ 4 ] ), IECore.IntVectorData( [ 0, 1, 3, 2 ] ) )
+		quad["P"] = IECoreScene.PrimitiveVariable(
+			IECoreScene.PrimitiveVariable.Interpolation.Vertex,
+			IECore.V3fVectorData( [ imath.V3f( 2, 0, 0 ), imath.V3f( 3, 0, 0 ), imath.V3f( 2, 1, 0 ), imath.V3f( 3, 1, 0 ) ] )
+		)
+
+		return triangle, quad
+
+	def testExplicitTopology( self ) :
+
+		triangle, quad = self.__triangleAndQuad()
+
+		merged = IECoreScene.MeshAlgo.merge( [ triangle, quad ] )
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+
+		self.assertEqual( merged.verticesPerFace, IECore.IntVectorData( [ 3, 4 ] ) )
+		self.assertEqual( merged.vertexIds, IECore.IntVectorData( [ 0, 1, 2, 3, 4, 6, 5 ] ) )
+		self.assertEqual(
+			merged["P"].data,
+			IECore.V3fVectorData(
+				[
+					imath.V3f( 0, 0, 0 ), imath.V3f( 1, 0, 0 ), imath.V3f( 0, 1, 0 ),
+					imath.V3f( 2, 0, 0 ), imath.V3f( 3, 0, 0 ), imath.V3f( 2, 1, 0 ), imath.V3f( 3, 1, 0 )
+				],
+				IECore.GeometricData.Interpretation.Point
+			)
+		)
+
+		merged = IECoreScene.MeshAlgo.merge( [ quad, triangle ] )
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+
+		self.assertEqual( merged.verticesPerFace, IECore.IntVectorData( [ 4, 3 ] ) )
+		self.assertEqual( merged.vertexIds, IECore.IntVectorData( [ 0, 1, 3, 2, 4, 5, 6 ] ) )
+
+	def testInterpolations( self ) :
+
+		triangle, quad = self.__triangleAndQuad()
+
+		triangle["v"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.FloatVectorData( [ 1, 2, 3 ] ) )
+		quad["v"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.FloatVectorData( [ 4, 5, 6, 7 ] ) )
+
+		triangle["u"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.FloatVectorData( [ 1 ] ) )
+		quad["u"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.FloatVectorData( [ 2 ] ) )
+
+		triangle["fv"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.FaceVarying, IECore.FloatVectorData( [ 1, 2, 3 ] ) )
+		quad["fv"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.FaceVarying, IECore.FloatVectorData( [ 4, 5, 6, 7 ] ) )
+
+		triangle["c"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Constant, IECore.FloatData( 1 ) )
+		quad["c"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Constant, IECore.FloatData( 2 ) )
+
+		# Each mesh has "x" with a different interpolation. The
+		# first mesh decides the interpolation, and the values from
+		# the other are treated as missing rather than resampled.
+		triangle["x"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.FloatVectorData( [ 1 ] ) )
+		quad["x"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.FloatVectorData( [ 4, 5, 6, 7 ] ) )
+
+		merged = IECoreScene.MeshAlgo.merge( [ triangle, quad ] )
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+
+		self.assertEqual( merged["v"], IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.FloatVectorData( [ 1, 2, 3, 4, 5, 6, 7 ] ) ) )
+		self.assertEqual( merged["u"], IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.FloatVectorData( [ 1, 2 ] ) ) )
+		self.assertEqual( merged["fv"], IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.FaceVarying, IECore.FloatVectorData( [ 1, 2, 3, 4, 5, 6, 7 ] ) ) )
+		self.assertEqual( merged["c"], IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Constant, IECore.FloatData( 1 ) ) )
+		self.assertEqual( merged["x"], IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.FloatVectorData( [ 1, 0 ] ) ) )
+
+		merged = IECoreScene.MeshAlgo.merge( [ quad, triangle ] )
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+
+		self.assertEqual( merged["c"], IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Constant, IECore.FloatData( 2 ) ) )
+		self.assertEqual( merged["x"], IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.FloatVectorData( [ 4, 5, 6, 7, 0, 0, 0 ] ) ) )
+
+	def testDefaultsForMissingPrimitiveVariables( self ) :
+
+		triangle, quad = self.__triangleAndQuad()
+
+		triangle["s"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.StringVectorData( [ "a" ] ) )
+		triangle["i"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.FaceVarying, IECore.IntVectorData( [ 1, 2, 3 ] ) )
+		triangle["c"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Constant, IECore.StringData( "c" ) )
+
+		quad["N"] = IECoreScene.PrimitiveVariable(
+			IECoreScene.PrimitiveVariable.Interpolation.Vertex,
+			IECore.V3fVectorData( [ imath.V3f( 0, 0, 1 ) ] * 4, IECore.GeometricData.Interpretation.Normal )
+		)
+
+		for meshes in ( [ triangle, quad ], [ quad, triangle ] ) :
+
+			merged = IECoreScene.MeshAlgo.merge( meshes )
+			self.assertTrue( merged.arePrimitiveVariablesValid() )
+
+			triangleFirst = meshes[0] is triangle
+
+			self.assertEqual( merged["s"].interpolation, IECoreScene.PrimitiveVariable.Interpolation.Uniform )
+			self.assertEqual( merged["s"].data, IECore.StringVectorData( [ "a", "" ] if triangleFirst else [ "", "a" ] ) )
+
+			self.assertEqual( merged["i"].interpolation, IECoreScene.PrimitiveVariable.Interpolation.FaceVarying )
+			self.assertEqual( merged["i"].data, IECore.IntVectorData( [ 1, 2, 3 ] + [ 0 ] * 4 if triangleFirst else [ 0 ] * 4 + [ 1, 2, 3 ] ) )
+
+			self.assertEqual( merged["c"], triangle["c"] )
+
+			self.assertEqual( merged["N"].interpolation, IECoreScene.PrimitiveVariable.Interpolation.Vertex )
+			self.assertEqual(
+				merged["N"].data,
+				IECore.V3fVectorData(
+					[ imath.V3f( 0 ) ] * 3 + [ imath.V3f( 0, 0, 1 ) ] * 4 if triangleFirst else [ imath.V3f( 0, 0, 1 ) ] * 4 + [ imath.V3f( 0 ) ] * 3,
+					IECore.GeometricData.Interpretation.Normal
+				)
+			)
+
+	def testManyMeshes( self ) :
+
+		plane = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 1 ) ) )
+		plane["N"] = IECoreScene.MeshAlgo.calculateNormals( plane )
+
+		meshes = [ plane ] * 1000
+		transforms = [ imath.M44f().rotate( imath.V3f( 0, i * 0.001, 0 ) ).translate( imath.V3f( i, 0, 0 ) ) for i in range( 0, 1000 ) ]
+
+		merged = IECoreScene.MeshAlgo.merge( meshes, transforms )
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+		self.assertEqual( merged.numFaces(), 1000 )
+		self.assertEqual( len( merged["uv"].data ), 4000 )
+
+		for i in range( 0, 1000, 97 ) :
+			for j in range( 0, 4 ) :
+				self.assertTrue( merged["P"].data[i*4+j].equalWithAbsError( plane["P"].data[j] * transforms[i], 1e-5 ) )
+				self.assertTrue( merged["N"].data[i*4+j].equalWithAbsError( transforms[i].multDirMatrix( plane["N"].data[j] ), 1e-5 ) )
+				self.assertEqual( merged["uv"].data[i*4+j], plane["uv"].data[j] )
+
+	def testMissingPrimitiveVariables( self ) :
+
+		m1 = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 0 ) ) )
+		m1["a"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.FloatVectorData( [ 1 ] ) )
+		m2 = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( 0 ), imath.V2f( 1 ) ) )
+		m2["b"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.Color3fVectorData( [ imath.Color3f( 1 ) ] * 4 ) )
+
+		merged = IECoreScene.MeshAlgo.merge( [ m1, m2 ] )
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+
+		self.assertEqual( merged["a"].interpolation, IECoreScene.PrimitiveVariable.Interpolation.Uniform )
+		self.assertEqual( merged["a"].data, IECore.FloatVectorData( [ 1, 0 ] ) )
+
+		self.assertEqual( merged["b"].interpolation, IECoreScene.PrimitiveVariable.Interpolation.Vertex )
+		self.assertEqual( merged["b"].data, IECore.Color3fVectorData( [ imath.Color3f( 0 ) ] * 4 + [ imath.Color3f( 1 ) ] * 4 ) )
+
+	def testIndexedPrimitiveVariables( self ) :
+
+		m1 = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 0 ) ) )
+		m1["s"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.FaceVarying, IECore.StringVectorData( [ "a", "b" ] ), IECore.IntVectorData( [ 0, 1, 1, 0 ] ) )
+		m2 = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( 0 ), imath.V2f( 1 ) ) )
+		m3 = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( 1 ), imath.V2f( 2 ) ) )
+		m3["s"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.FaceVarying, IECore.StringVectorData( [ "c", "d", "e", "f" ] ) )
+
+		merged = IECoreScene.MeshAlgo.merge( [ m1, m2, m3 ] )
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+
+		self.assertTrue( merged["s"].indices is not None )
+		self.assertEqual(
+			list( merged["s"].expandedData() ),
+			[ "a", "b", "b", "a" ] + [ "" ] * 4 + [ "c", "d", "e", "f" ]
+		)
+
+	def testTypeConversion( self ) :
+
+		m1 = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 0 ) ) )
+		m1["a"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.FloatVectorData( [ 1.5 ] ) )
+		m2 = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( 0 ), imath.V2f( 1 ) ) )
+		m2["a"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.IntVectorData( [ 2 ] ) )
+
+		merged = IECoreScene.MeshAlgo.merge( [ m1, m2 ] )
+		self.assertEqual( merged["a"].data, IECore.FloatVectorData( [ 1.5, 2 ] ) )
+
+		# Types which can't be cast are treated as missing.
+		m2["a"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.StringVectorData( [ "two" ] ) )
+		merged = IECoreScene.MeshAlgo.merge( [ m1, m2 ] )
+		self.assertEqual( merged["a"].data, IECore.FloatVectorData( [ 1.5, 0 ] ) )
+
+	def testMismatchedInterpolation( self ) :
+
+		m1 = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 0 ) ) )
+		m1["a"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.FloatVectorData( [ 1 ] ) )
+		m1["b"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Constant, IECore.FloatData( 1 ) )
+		m2 = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( 0 ), imath.V2f( 1 ) ) )
+		m2["a"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Constant, IECore.FloatData( 2 ) )
+		m2["b"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.FloatVectorData( [ 2 ] ) )
+
+		merged = IECoreScene.MeshAlgo.merge( [ m1, m2 ] )
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+		self.assertEqual( merged["a"], IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.FloatVectorData( [ 1, 0 ] ) ) )
+		self.assertEqual( merged["b"], m1["b"] )
+
+	def testUnusedVertices( self ) :
+
+		m1 = IECoreScene.MeshPrimitive( IECore.IntVectorData( [ 3 ] ), IECore.IntVectorData( [ 0, 1, 2 ] ) )
+		m1["P"] = IECoreScene.PrimitiveVariable(
+			IECoreScene.PrimitiveVariable.Interpolation.Vertex,
+			IECore.V3fVectorData( [ imath.V3f( i ) for i in range( 0, 3 ) ] )
+		)
+
+		# Vertex 2 is not referenced by any face. Reordering moves
+		# it to the end, where the vertex ids can't account for it.
+		m2 = IECoreScene.MeshPrimitive( IECore.IntVectorData( [ 3 ] ), IECore.IntVectorData( [ 0, 1, 3 ] ) )
+		m2["P"] = IECoreScene.PrimitiveVariable(
+			IECoreScene.PrimitiveVariable.Interpolation.Vertex,
+			IECore.V3fVectorData( [ imath.V3f( i ) for i in range( 3, 7 ) ] )
+		)
+		m2 = IECoreScene.MeshAlgo.reorder( m2, *IECoreScene.MeshAlgo.calculateLocalityOrder( m2 ) )
+		self.assertEqual( max( m2.vertexIds ), 2 )
+		self.assertTrue( m2.arePrimitiveVariablesValid() )
+
+		for meshes in ( [ m1, m2 ], [ m2, m1 ] ) :
+			merged = IECoreScene.MeshAlgo.merge( meshes )
+			self.assertEqual( merged.variableSize( IECoreScene.PrimitiveVariable.Interpolation.Vertex ), 7 )
+			self.assertTrue( merged.arePrimitiveVariablesValid() )
+			self.assertEqual( list( merged["P"].data ), list( meshes[0]["P"].data ) + list( meshes[1]["P"].data ) )
+
+		merged = IECoreScene.MeshMergeOp()( input = m1, mesh = m2 )
+		self.assertEqual( merged.variableSize( IECoreScene.PrimitiveVariable.Interpolation.Vertex ), 7 )
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+
+	def testMismatchedTransforms( self ) :
+
+		m = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 1 ) ) )
+		self.assertRaises( RuntimeError, IECoreScene.MeshAlgo.merge, [ m, m ], [ imath.M44f() ] )
+
+	def testEmpty( self ) :
+
+		merged = IECoreScene.MeshAlgo.merge( [] )
+		self.assertEqual( merged.numFaces(), 0 )
+
+if __name__ == "__main__":
+	unittest.main()
@@ -0,0 +1,146 @@
+##########################################################################
+#
+#  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+import math
+import unittest
+import imath
+
+import IECore
+import IECoreScene
+
+class MeshAlgoNormalsTest( unittest.TestCase ) :
+
+	def testPlane( self ) :
+
+		m = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 1 ) ), imath.V2i( 4 ) )
+
+		for interpolation in (
+			IECoreScene.PrimitiveVariable.Interpolation.Vertex,
+			IECoreScene.PrimitiveVariable.Interpolation.Varying,
+			IECoreScene.PrimitiveVariable.Interpolation.Uniform,
+			IECoreScene.PrimitiveVariable.Interpolation.FaceVarying,
+		) :
+
+			n = IECoreScene.MeshAlgo.calculateNormals( m, interpolation )
+			self.assertEqual( n.interpolation, interpolation )
+			self.assertEqual( len( n.data ), m.variableSize( interpolation ) )
+			self.assertEqual( n.data.getInterpretation(), IECore.GeometricData.Interpretation.Normal )
+			self.assertTrue( m.isPrimitiveVariableValid( n ) )
+			for v in n.data :
+				self.assertEqual( v, imath.V3f( 0, 0, 1 ) )
+
+	def testSphere( self ) :
+
+		m = IECore.Reader.create( "test/IECore/data/cobFiles/pSphereShape1.cob" ).read()
+		del m["N"]
+
+		for weighting in IECoreScene.MeshAlgo.NormalWeighting.values.values() :
+
+			n = IECoreScene.MeshAlgo.calculateNormals( m, weighting = weighting )
+			for i, v in enumerate( n.data ) :
+				self.assertAlmostEqual( v.length(), 1, 5 )
+				self.assertGreater( v.dot( m["P"].data[i].normalized() ), 0.99 )
+
+	def testWeighting( self ) :
+
+		# Two triangles meeting at vertex 0. The first is large, faces +Z and
+		# has a right angle at vertex 0. The second is small, faces +X and has
+		# a narrow angle at vertex 0.
+		m = IECoreScene.MeshPrimitive(
+			IECore.IntVectorData( [ 3, 3 ] ),
+			IECore.IntVectorData( [ 0, 1, 2, 0, 3, 4 ] ),
+			"linear",
+			IECore.V3fVectorData( [
+				imath.V3f( 0 ), imath.V3f( 10, 0, 0 ), imath.V3f( 0, 10, 0 ),
+				imath.V3f( 0, 1, 0 ), imath.V3f( 0, 1, 0.1 )
+			] )
+		)
+
+		n = IECoreScene.MeshAlgo.calculateNormals( m, weighting = IECoreScene.MeshAlgo.NormalWeighting.Equal )
+		self.assertTrue( n.data[0].equalWithAbsError( imath.V3f( 1, 0, 1 ).normalized(), 0.00001 ) )
+
+		n = IECoreScene.MeshAlgo.calculateNormals( m, weighting = IECoreScene.MeshAlgo.NormalWeighting.Angle )
+		self.assertTrue( n.data[0].equalWithAbsError( imath.V3f( math.atan2( 0.1, 1 ), 0, math.pi / 2 ).normalized(), 0.00001 ) )
+
+		n = IECoreScene.MeshAlgo.calculateNormals( m, weighting = IECoreScene.MeshAlgo.NormalWeighting.Area )
+		self.assertTrue( n.data[0].equalWithAbsError( imath.V3f( 0.1, 0, 100 ).normalized(), 0.00001 ) )
+
+	def testDoublePrecision( self ) :
+
+		m = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 1 ) ) )
+		m["Pd"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.V3dVectorData( [ imath.V3d( p.x, p.y, p.z ) for p in m["P"].data ] ) )
+
+		n = IECoreScene.MeshAlgo.calculateNormals( m, position = "Pd" )
+		self.assertTrue( isinstance( n.data, IECore.V3dVectorData ) )
+		for v in n.data :
+			self.assertEqual( v, imath.V3d( 0, 0, 1 ) )
+
+	def testDestination( self ) :
+
+		m = IECoreScene.MeshPrimitive.createSphere( 1 )
+		n = IECoreScene.MeshAlgo.calculateNormals( m )
+
+		m["P"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.V3fVectorData( [ p * imath.V3f( 1, 2, 1 ) for p in m["P"].data ] ) )
+		# Data referenced elsewhere must not be modified in place.
+		nCopy = n.data.copy()
+		n2 = IECoreScene.MeshAlgo.calculateNormals( m, destination = n.data )
+		self.assertFalse( n2.data.isSame( n.data ) )
+		self.assertEqual( n.data, nCopy )
+		self.assertEqual( n2.data, IECoreScene.MeshAlgo.calculateNormals( m ).data )
+
+		# Data of the wrong type is ignored.
+		n3 = IECoreScene.MeshAlgo.calculateNormals( m, destination = IECore.IntVectorData() )
+		self.assertEqual( n3.data, n2.data )
+
+	def testDeterminism( self ) :
+
+		m = IECoreScene.MeshPrimitive.createSphere( 1, divisions = imath.V2i( 300, 400 ) )
+		m["P"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.V3fVectorData( [ p * ( 1 + 0.1 * math.sin( p.x * 10 ) ) for p in m["P"].data ] ) )
+
+		for weighting in IECoreScene.MeshAlgo.NormalWeighting.values.values() :
+			h = IECoreScene.MeshAlgo.calculateNormals( m, weighting = weighting ).data.hash()
+			for i in range( 0, 5 ) :
+				self.assertEqual( IECoreScene.MeshAlgo.calculateNormals( m, weighting = weighting ).data.hash(), h )
+
+	def testErrors( self ) :
+
+		m = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 1 ) ) )
+		self.assertRaises( RuntimeError, IECoreScene.MeshAlgo.calculateNormals, m, IECoreScene.PrimitiveVariable.Interpolation.Constant )
+		self.assertRaises( RuntimeError, IECoreScene.MeshAlgo.calculateNormals, m, position = "notThere" )
+
+		m["Pi"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.IntVectorData( [ 1, 2, 3, 4 ] ) )
+		self.assertRaises( RuntimeError, IECoreScene.MeshAlgo.calculateNormals, m, position = "Pi" )
+
+if __name__ == "__main__":
+	unittest.main()
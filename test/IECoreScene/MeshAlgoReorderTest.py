@@ -0,0 +1,157 @@
+##########################################################################
+#
+#  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+
+import random
+import unittest
+import imath
+
+import IECore
+import IECoreScene
+
+class MeshAlgoReorderTest( unittest.TestCase ) :
+
+	def __faceVertexIds( self, mesh, face ) :
+
+		offset = sum( mesh.verticesPerFace[:face] )
+		return list( mesh.vertexIds[offset:offset+mesh.verticesPerFace[face]] )
+
+	def __spread( self, mesh ) :
+
+		result = 0
+		offset = 0
+		for n in mesh.verticesPerFace :
+			ids = mesh.vertexIds[offset:offset+n]
+			result += max( ids ) - min( ids )
+			offset += n
+
+		return result
+
+	def __shuffled( self, mesh ) :
+
+		random.seed( 0 )
+		faceOrder = list( range( 0, mesh.numFaces() ) )
+		vertexOrder = list( range( 0, mesh.variableSize( IECoreScene.PrimitiveVariable.Interpolation.Vertex ) ) )
+		random.shuffle( faceOrder )
+		random.shuffle( vertexOrder )
+
+		return IECoreScene.MeshAlgo.reorder( mesh, IECore.IntVectorData( faceOrder ), IECore.IntVectorData( vertexOrder ) )
+
+	def testOrders( self ) :
+
+		mesh = IECore.Reader.create( "test/IECore/data/cobFiles/polySphereQuads.cob" ).read()
+		faceOrder, vertexOrder = IECoreScene.MeshAlgo.calculateLocalityOrder( mesh )
+
+		self.assertEqual( sorted( faceOrder ), list( range( 0, mesh.numFaces() ) ) )
+		self.assertEqual( sorted( vertexOrder ), list( range( 0, mesh.variableSize( IECoreScene.PrimitiveVariable.Interpolation.Vertex ) ) ) )
+
+	def testReorder( self ) :
+
+		mesh = IECore.Reader.create( "test/IECore/data/cobFiles/polySphereQuads.cob" ).read()
+		mesh["s"] = IECoreScene.PrimitiveVariable(
+			IECoreScene.PrimitiveVariable.Interpolation.Uniform,
+			IECore.StringVectorData( [ "a", "b" ] ),
+			IECore.IntVectorData( [ i % 2 for i in range( 0, mesh.numFaces() ) ] )
+		)
+		mesh["fv"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.FaceVarying, IECore.IntVectorData( range( 0, len( mesh.vertexIds ) ) ) )
+		mesh["c"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Constant, IECore.FloatData( 1 ) )
+
+		faceOrder, vertexOrder = IECoreScene.MeshAlgo.calculateLocalityOrder( mesh )
+		reordered = IECoreScene.MeshAlgo.reorder( mesh, faceOrder, vertexOrder )
+
+		self.assertTrue( reordered.arePrimitiveVariablesValid() )
+		self.assertEqual( reordered.numFaces(), mesh.numFaces() )
+		self.assertEqual( reordered.keys(), mesh.keys() )
+		self.assertEqual( reordered["c"], mesh["c"] )
+		self.assertTrue( reordered["s"].indices is not None )
+		self.assertEqual( reordered["s"].data, mesh["s"].data )
+
+		for v in range( 0, len( vertexOrder ) ) :
+			self.assertEqual( reordered["P"].data[v], mesh["P"].data[vertexOrder[v]] )
+
+		for f in range( 0, reordered.numFaces(), 7 ) :
+			oldFace = faceOrder[f]
+			self.assertEqual( reordered["s"].indices[f], mesh["s"].indices[oldFace] )
+			self.assertEqual(
+				[ reordered["P"].data[i] for i in self.__faceVertexIds( reordered, f ) ],
+				[ mesh["P"].data[i] for i in self.__faceVertexIds( mesh, oldFace ) ]
+			)
+			oldOffset = sum( mesh.verticesPerFace[:oldFace] )
+			newOffset = sum( reordered.verticesPerFace[:f] )
+			for i in range( 0, mesh.verticesPerFace[oldFace] ) :
+				self.assertEqual( reordered["fv"].data[newOffset+i], oldOffset + i )
+
+	def testImprovesLocality( self ) :
+
+		mesh = self.__shuffled( IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 1 ) ), imath.V2i( 50 ) ) )
+		faceOrder, vertexOrder = IECoreScene.MeshAlgo.calculateLocalityOrder( mesh )
+		reordered = IECoreScene.MeshAlgo.reorder( mesh, faceOrder, vertexOrder )
+
+		self.assertLess( self.__spread( reordered ), self.__spread( mesh ) / 10 )
+
+		# The vertices should be numbered in the order they are first used.
+		self.assertEqual( sorted( self.__faceVertexIds( reordered, 0 ) ), [ 0, 1, 2, 3 ] )
+
+	def testUnusedVertices( self ) :
+
+		mesh = IECoreScene.MeshPrimitive( IECore.IntVectorData( [ 3 ] ), IECore.IntVectorData( [ 0, 2, 4 ] ) )
+		mesh["P"] = IECoreScene.PrimitiveVariable(
+			IECoreScene.PrimitiveVariable.Interpolation.Vertex,
+			IECore.V3fVectorData( [ imath.V3f( i, 0, 0 ) for i in range( 0, 5 ) ], IECore.GeometricData.Interpretation.Point )
+		)
+		self.assertTrue( mesh.arePrimitiveVariablesValid() )
+
+		faceOrder, vertexOrder = IECoreScene.MeshAlgo.calculateLocalityOrder( mesh )
+		self.assertEqual( sorted( vertexOrder ), [ 0, 1, 2, 3, 4 ] )
+		# Unused vertices are placed last.
+		self.assertEqual( sorted( vertexOrder[3:] ), [ 1, 3 ] )
+
+		reordered = IECoreScene.MeshAlgo.reorder( mesh, faceOrder, vertexOrder )
+		self.assertEqual( reordered.variableSize( IECoreScene.PrimitiveVariable.Interpolation.Vertex ), 5 )
+		self.assertTrue( reordered.arePrimitiveVariablesValid() )
+		self.assertEqual( sorted( reordered.vertexIds ), [ 0, 1, 2 ] )
+		for v in range( 0, 5 ) :
+			self.assertEqual( reordered["P"].data[v], mesh["P"].data[vertexOrder[v]] )
+
+	def testInvalidOrders( self ) :
+
+		mesh = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 1 ) ), imath.V2i( 2 ) )
+		vertexOrder = IECore.IntVectorData( range( 0, 9 ) )
+
+		self.assertRaises( RuntimeError, IECoreScene.MeshAlgo.reorder, mesh, IECore.IntVectorData( [ 0, 1, 2 ] ), vertexOrder )
+		self.assertRaises( RuntimeError, IECoreScene.MeshAlgo.reorder, mesh, IECore.IntVectorData( [ 0, 1, 2, 2 ] ), vertexOrder )
+		self.assertRaises( RuntimeError, IECoreScene.MeshAlgo.reorder, mesh, IECore.IntVectorData( [ 0, 1, 2, 4 ] ), vertexOrder )
+
+if __name__ == "__main__":
+	unittest.main()
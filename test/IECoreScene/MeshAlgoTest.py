@@ -38,8 +38,12 @@ from MeshAlgoDeleteFacesTest import MeshAlgoDeleteFacesTest
 from MeshAlgoDistortionsTest import MeshAlgoDistortionsTest
 from MeshAlgoDistributePointsTest import MeshAlgoDistributePointsTest
 from MeshAlgoFaceAreaTest import MeshAlgoFaceAreaTest
+from MeshAlgoMergeTest import MeshAlgoMergeTest
+from MeshAlgoNormalsTest import MeshAlgoNormalsTest
+from MeshAlgoReorderTest import MeshAlgoReorderTest
 from MeshAlgoResampleTest import MeshAlgoResampleTest
 from MeshAlgoTangentsTest import MeshAlgoTangentsTest
+from MeshAlgoTriangulateTest import MeshAlgoTriangulateTest
 from MeshAlgoWindingTest import MeshAlgoWindingTest
 from MeshAlgoSegmentTest import MeshAlgoSegmentTest
 
@@ -0,0 +1,212 @@
+##########################################################################
+#
+#  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+import unittest
+import math
+import imath
+
+import IECore
+import IECoreScene
+
+class MeshAlgoTriangulateTest( unittest.TestCase ) :
+
+	def testQuads( self ) :
+
+		# 3---4---5
+		# |   |   |
+		# 0---1---2
+		m = IECoreScene.MeshPrimitive(
+			IECore.IntVectorData( [ 4, 4 ] ),
+			IECore.IntVectorData( [ 0, 1, 4, 3, 1, 2, 5, 4 ] ),
+			"linear",
+			IECore.V3fVectorData( [ imath.V3f( x, y, 0 ) for y in range( 0, 2 ) for x in range( 0, 3 ) ] )
+		)
+		m["c"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Constant, IECore.FloatData( 1 ) )
+		m["v"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.FloatVectorData( [ 0, 1, 2, 3, 4, 5 ] ) )
+		m["u"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.IntVectorData( [ 10, 20 ] ) )
+		m["uv"] = IECoreScene.PrimitiveVariable(
+			IECoreScene.PrimitiveVariable.Interpolation.FaceVarying,
+			IECore.V2fVectorData( [ imath.V2f( 0, 0 ), imath.V2f( 0.5, 0 ), imath.V2f( 0.5, 1 ), imath.V2f( 0, 1 ), imath.V2f( 0.5, 0 ), imath.V2f( 1, 0 ), imath.V2f( 1, 1 ), imath.V2f( 0.5, 1 ) ] )
+		)
+
+		t = IECoreScene.MeshAlgo.triangulate( m, throwExceptions = True )
+		self.assertTrue( t.arePrimitiveVariablesValid() )
+
+		self.assertEqual( t.verticesPerFace, IECore.IntVectorData( [ 3, 3, 3, 3 ] ) )
+		self.assertEqual( t.vertexIds, IECore.IntVectorData( [ 0, 1, 4, 0, 4, 3, 1, 2, 5, 1, 5, 4 ] ) )
+
+		self.assertEqual( t["P"], m["P"] )
+		self.assertEqual( t["c"], m["c"] )
+		self.assertEqual( t["v"], m["v"] )
+		self.assertEqual( t["u"].data, IECore.IntVectorData( [ 10, 10, 20, 20 ] ) )
+		self.assertEqual(
+			t["uv"].data,
+			IECore.V2fVectorData( [
+				imath.V2f( 0, 0 ), imath.V2f( 0.5, 0 ), imath.V2f( 0.5, 1 ),
+				imath.V2f( 0, 0 ), imath.V2f( 0.5, 1 ), imath.V2f( 0, 1 ),
+				imath.V2f( 0.5, 0 ), imath.V2f( 1, 0 ), imath.V2f( 1, 1 ),
+				imath.V2f( 0.5, 0 ), imath.V2f( 1, 1 ), imath.V2f( 0.5, 1 ),
+			] )
+		)
+
+		self.assertEqual( IECoreScene.MeshAlgo.triangulatedFaces( m ), IECore.IntVectorData( [ 0, 0, 1, 1 ] ) )
+
+	def testNGons( self ) :
+
+		# A regular pentagon and hexagon, which are convex and planar.
+		p = [ imath.V3f( math.cos( 2 * math.pi * i / 5 ), math.sin( 2 * math.pi * i / 5 ), 0 ) for i in range( 0, 5 ) ]
+		p += [ imath.V3f( 3 + math.cos( 2 * math.pi * i / 6 ), math.sin( 2 * math.pi * i / 6 ), 0 ) for i in range( 0, 6 ) ]
+
+		m = IECoreScene.MeshPrimitive(
+			IECore.IntVectorData( [ 5, 6 ] ),
+			IECore.IntVectorData( range( 0, 11 ) ),
+			"linear",
+			IECore.V3fVectorData( p )
+		)
+		m["u"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.StringVectorData( [ "pentagon", "hexagon" ] ) )
+		m["fv"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.FaceVarying, IECore.FloatVectorData( [ i * 0.5 for i in range( 0, 11 ) ] ) )
+
+		t = IECoreScene.MeshAlgo.triangulate( m, throwExceptions = True )
+		self.assertTrue( t.arePrimitiveVariablesValid() )
+
+		self.assertEqual( t.verticesPerFace, IECore.IntVectorData( [ 3 ] * 7 ) )
+		self.assertEqual(
+			t.vertexIds,
+			IECore.IntVectorData( [
+				0, 1, 2, 0, 2, 3, 0, 3, 4,
+				5, 6, 7, 5, 7, 8, 5, 8, 9, 5, 9, 10,
+			] )
+		)
+		self.assertEqual( t["u"].data, IECore.StringVectorData( [ "pentagon" ] * 3 + [ "hexagon" ] * 4 ) )
+		self.assertEqual(
+			t["fv"].data,
+			IECore.FloatVectorData( [
+				0, 0.5, 1, 0, 1, 1.5, 0, 1.5, 2,
+				2.5, 3, 3.5, 2.5, 3.5, 4, 2.5, 4, 4.5, 2.5, 4.5, 5,
+			] )
+		)
+
+		self.assertEqual( IECoreScene.MeshAlgo.triangulatedFaces( m ), IECore.IntVectorData( [ 0, 0, 0, 1, 1, 1, 1 ] ) )
+
+	def testNonPlanarFace( self ) :
+
+		m = IECoreScene.MeshPrimitive(
+			IECore.IntVectorData( [ 4 ] ),
+			IECore.IntVectorData( [ 0, 1, 2, 3 ] ),
+			"linear",
+			IECore.V3fVectorData( [ imath.V3f( 0, 0, 0 ), imath.V3f( 1, 0, 0 ), imath.V3f( 1, 1, 1 ), imath.V3f( 0, 1, 0 ) ] )
+		)
+		m["u"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.FloatVectorData( [ 2 ] ) )
+		m["fv"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.FaceVarying, IECore.IntVectorData( [ 10, 11, 12, 13 ] ) )
+
+		with self.assertRaisesRegexp( RuntimeError, "non-planar" ) :
+			IECoreScene.MeshAlgo.triangulate( m, throwExceptions = True )
+
+		# Without validation, the face is split along the
+		# diagonal from the first vertex, like any other.
+		t = IECoreScene.MeshAlgo.triangulate( m )
+		self.assertTrue( t.arePrimitiveVariablesValid() )
+		self.assertEqual( t.verticesPerFace, IECore.IntVectorData( [ 3, 3 ] ) )
+		self.assertEqual( t.vertexIds, IECore.IntVectorData( [ 0, 1, 2, 0, 2, 3 ] ) )
+		self.assertEqual( t["P"], m["P"] )
+		self.assertEqual( t["u"].data, IECore.FloatVectorData( [ 2, 2 ] ) )
+		self.assertEqual( t["fv"].data, IECore.IntVectorData( [ 10, 11, 12, 10, 12, 13 ] ) )
+
+	def testInvertedWinding( self ) :
+
+		# A quad wound clockwise when viewed from +Z.
+		m = IECoreScene.MeshPrimitive(
+			IECore.IntVectorData( [ 4 ] ),
+			IECore.IntVectorData( [ 0, 3, 2, 1 ] ),
+			"linear",
+			IECore.V3fVectorData( [ imath.V3f( 0, 0, 0 ), imath.V3f( 1, 0, 0 ), imath.V3f( 1, 1, 0 ), imath.V3f( 0, 1, 0 ) ] )
+		)
+		m["fv"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.FaceVarying, IECore.IntVectorData( [ 0, 1, 2, 3 ] ) )
+
+		t = IECoreScene.MeshAlgo.triangulate( m, throwExceptions = True )
+		self.assertTrue( t.arePrimitiveVariablesValid() )
+		self.assertEqual( t.verticesPerFace, IECore.IntVectorData( [ 3, 3 ] ) )
+		self.assertEqual( t.vertexIds, IECore.IntVectorData( [ 0, 3, 2, 0, 2, 1 ] ) )
+		self.assertEqual( t["fv"].data, IECore.IntVectorData( [ 0, 1, 2, 0, 2, 3 ] ) )
+
+		# The triangles keep the winding of the original face.
+		p = t["P"].data
+		ids = t.vertexIds
+		for i in range( 0, len( ids ), 3 ) :
+			n = ( p[ids[i+1]] - p[ids[i]] ).cross( p[ids[i+2]] - p[ids[i]] )
+			self.assertLess( n.z, 0 )
+
+	def testMixedFaceSizes( self ) :
+
+		m = IECoreScene.MeshPrimitive(
+			IECore.IntVectorData( [ 3, 5, 4 ] ),
+			IECore.IntVectorData( [ 0, 1, 2, 0, 2, 3, 4, 5, 5, 4, 6, 7 ] ),
+			"linear",
+			IECore.V3fVectorData( [ imath.V3f( i ) for i in range( 0, 8 ) ] )
+		)
+		m["fv"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.FaceVarying, IECore.IntVectorData( range( 0, 12 ) ) )
+		m["u"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.StringVectorData( [ "a", "b" ] ), IECore.IntVectorData( [ 1, 0, 1 ] ) )
+
+		t = IECoreScene.MeshAlgo.triangulate( m )
+		self.assertTrue( t.arePrimitiveVariablesValid() )
+		self.assertEqual( t.verticesPerFace, IECore.IntVectorData( [ 3 ] * 6 ) )
+		self.assertEqual( t.vertexIds, IECore.IntVectorData( [ 0, 1, 2, 0, 2, 3, 0, 3, 4, 0, 4, 5, 5, 4, 6, 5, 6, 7 ] ) )
+		self.assertEqual( t["fv"].data, IECore.IntVectorData( [ 0, 1, 2, 3, 4, 5, 3, 5, 6, 3, 6, 7, 8, 9, 10, 8, 10, 11 ] ) )
+
+		self.assertTrue( t["u"].data.isSame( m["u"].data ) )
+		self.assertEqual( t["u"].indices, IECore.IntVectorData( [ 1, 0, 0, 0, 1, 1 ] ) )
+
+		self.assertEqual( IECoreScene.MeshAlgo.triangulatedFaces( m ), IECore.IntVectorData( [ 0, 1, 1, 1, 2, 2 ] ) )
+
+	def testAlreadyTriangulated( self ) :
+
+		m = IECoreScene.MeshPrimitive.createSphere( 1 )
+		t = IECoreScene.MeshAlgo.triangulate( m )
+		self.assertEqual( t, m )
+		self.assertEqual( IECoreScene.MeshAlgo.triangulatedFaces( m ), IECore.IntVectorData( range( 0, m.numFaces() ) ) )
+
+	def testExceptions( self ) :
+
+		m = IECoreScene.MeshPrimitive(
+			IECore.IntVectorData( [ 4 ] ),
+			IECore.IntVectorData( [ 0, 1, 2, 3 ] ),
+			"linear",
+			IECore.V3fVectorData( [ imath.V3f( 0, 0, 0 ), imath.V3f( 1, 0, 0 ), imath.V3f( 1, 1, 1 ), imath.V3f( 0, 1, 0 ) ] )
+		)
+
+		self.assertRaises( RuntimeError, IECoreScene.MeshAlgo.triangulate, m, throwExceptions = True )
+		self.assertEqual( IECoreScene.MeshAlgo.triangulate( m ).numFaces(), 2 )
+
+if __name__ == "__main__":
+	unittest.main()
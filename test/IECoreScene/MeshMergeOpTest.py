@@ -241,5 +241,58 @@ class MeshMergeOpTest( unittest.TestCase ) :
 		merged = IECoreScene.MeshMergeOp()( input=p1, mesh=p2 )
 		self.verifyMerge( p1, p2, merged )
 
+	def testFirstMeshDecidesIndexing( self ) :
+
+		p1 = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 0 ) ) )
+		p2 = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( 0 ), imath.V2f( 1 ) ) )
+		p2["uv"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.FaceVarying, p2["uv"].data, IECore.IntVectorData( [ 2, 1, 0, 3 ] ) )
+
+		merged = IECoreScene.MeshMergeOp()( input=p1, mesh=p2 )
+		self.assertEqual( merged["uv"].indices, None )
+		self.assertEqual( list( merged["uv"].data ), list( p1["uv"].data ) + list( p2["uv"].expandedData() ) )
+
+		merged = IECoreScene.MeshMergeOp()( input=p2, mesh=p1 )
+		self.assertNotEqual( merged["uv"].indices, None )
+		self.assertEqual( list( merged["uv"].expandedData() ), list( p2["uv"].expandedData() ) + list( p1["uv"].data ) )
+
+	def testConstantAndVertexPrimVarsWithSameName( self ) :
+
+		p1 = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 0 ) ) )
+		p1["a"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.FloatVectorData( [ 1, 2, 3, 4 ] ) )
+		p2 = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( 0 ), imath.V2f( 1 ) ) )
+		p2["a"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Constant, IECore.FloatData( 10 ) )
+
+		# The first mesh takes priority, and the conflicting
+		# variable on the second mesh is treated as missing.
+		merged = IECoreScene.MeshMergeOp()( input=p1, mesh=p2 )
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+		self.assertEqual( merged["a"].interpolation, IECoreScene.PrimitiveVariable.Interpolation.Vertex )
+		self.assertEqual( merged["a"].data, IECore.FloatVectorData( [ 1, 2, 3, 4, 0, 0, 0, 0 ] ) )
+
+		merged = IECoreScene.MeshMergeOp()( input=p2, mesh=p1 )
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+		self.assertEqual( merged["a"], p2["a"] )
+
+	def testIncompatibleTypes( self ) :
+
+		p1 = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 0 ) ) )
+		p1["a"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.FloatVectorData( [ 1 ] ) )
+		p2 = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( 0 ), imath.V2f( 1 ) ) )
+		p2["a"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.StringVectorData( [ "a" ] ) )
+
+		merged = IECoreScene.MeshMergeOp()( input=p1, mesh=p2 )
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+		self.assertEqual( merged["a"].data, IECore.FloatVectorData( [ 1, 0 ] ) )
+
+	def testUnsupportedTypes( self ) :
+
+		p1 = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 0 ) ) )
+		p1["a"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.CompoundData() )
+		p2 = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( 0 ), imath.V2f( 1 ) ) )
+
+		merged = IECoreScene.MeshMergeOp()( input=p1, mesh=p2 )
+		self.assertTrue( "a" not in merged )
+		self.assertTrue( merged.arePrimitiveVariablesValid() )
+
 if __name__ == "__main__":
     unittest.main()
@@ -106,5 +106,39 @@ class MeshNormalsOpTest( unittest.TestCase ) :
 		for n in m2["N"].data :
 			self.assertEqual( n, imath.V3f( 0, 0, 1 ) )
 
+	def testFaceVaryingInterpolation( self ) :
+
+		m = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 1 ) ), imath.V2i( 10 ) )
+
+		m2 = IECoreScene.MeshNormalsOp()( input = m, interpolation = IECoreScene.PrimitiveVariable.Interpolation.FaceVarying )
+		self.assertEqual( m2["N"].interpolation, IECoreScene.PrimitiveVariable.Interpolation.FaceVarying )
+		self.assertEqual( len( m2["N"].data ), m2.variableSize( IECoreScene.PrimitiveVariable.Interpolation.FaceVarying ) )
+
+		for n in m2["N"].data :
+			self.assertEqual( n, imath.V3f( 0, 0, 1 ) )
+
+	def testWeighting( self ) :
+
+		s = IECore.Reader.create( "test/IECore/data/cobFiles/pSphereShape1.cob" ).read()
+
+		for weighting in IECoreScene.MeshAlgo.NormalWeighting.values.values() :
+			ss = IECoreScene.MeshNormalsOp()( input = s, weighting = int( weighting ) )
+			self.assertEqual( ss["N"].data, IECoreScene.MeshAlgo.calculateNormals( s, weighting = weighting ).data )
+
+	def testSharedNormalsNotModified( self ) :
+
+		m = IECoreScene.MeshPrimitive.createSphere( 1 )
+		m = IECoreScene.MeshNormalsOp()( input = m )
+		n = m["N"].data.copy()
+
+		# Share the same normals Data between both meshes.
+		m2 = m.copy()
+		m2["N"] = m["N"]
+		m2["P"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.V3fVectorData( [ p * imath.V3f( 1, 2, 1 ) for p in m2["P"].data ] ) )
+		IECoreScene.MeshNormalsOp()( input = m2, copyInput = False )
+
+		self.assertEqual( m["N"].data, n )
+		self.assertNotEqual( m2["N"].data, n )
+
 if __name__ == "__main__":
     unittest.main()
@@ -374,6 +374,66 @@ class TestMeshPrimitive( unittest.TestCase ) :
 		self.assertEqual( m["myString"].data, IECore.StringVectorData( [ "indexed", "my", "string" ] ) )
 		self.assertEqual( m["myString"].indices, IECore.IntVectorData( [ 1, 0, 2, 1, 0, 2, 1, 0 ] ) )
 
+	def testTopology( self ) :
+
+		m = IECoreScene.MeshPrimitive( IECore.IntVectorData( [ 3, 3 ] ), IECore.IntVectorData( [ 0, 1, 2, 2, 1, 3 ] ) )
+		t = m.topology()
+
+		self.assertEqual( t.numFaces(), 2 )
+		self.assertEqual( t.numVertices(), 4 )
+		self.assertEqual( t.numFaceVertices(), 6 )
+		self.assertEqual( t.numEdges(), 5 )
+
+		self.assertEqual( t.faceOffsets(), IECore.IntVectorData( [ 0, 3, 6 ] ) )
+		self.assertEqual( t.faceVertexFaces(), IECore.IntVectorData( [ 0, 0, 0, 1, 1, 1 ] ) )
+
+		self.assertEqual( t.vertexOffsets(), IECore.IntVectorData( [ 0, 1, 3, 5, 6 ] ) )
+		self.assertEqual( t.vertexFaceVertices(), IECore.IntVectorData( [ 0, 1, 4, 2, 3, 5 ] ) )
+		self.assertEqual( t.vertexFaces(), IECore.IntVectorData( [ 0, 0, 1, 0, 1, 1 ] ) )
+
+		self.assertEqual(
+			t.edges(),
+			IECore.V2iVectorData( [ imath.V2i( 0, 1 ), imath.V2i( 0, 2 ), imath.V2i( 1, 2 ), imath.V2i( 1, 3 ), imath.V2i( 2, 3 ) ] )
+		)
+		self.assertEqual( t.faceVertexEdges(), IECore.IntVectorData( [ 0, 2, 1, 2, 3, 4 ] ) )
+		self.assertEqual( t.edgeOffsets(), IECore.IntVectorData( [ 0, 1, 2, 4, 5, 6 ] ) )
+		self.assertEqual( t.edgeFaces(), IECore.IntVectorData( [ 0, 0, 0, 1, 1, 1 ] ) )
+
+		self.assertRaises( RuntimeError, IECoreScene.MeshTopology, IECoreScene.MeshPrimitive( IECore.IntVectorData( [ 3 ] ), IECore.IntVectorData( [ 0, 1 ] ) ) )
+
+	def testTopologyIsShared( self ) :
+
+		m = IECoreScene.MeshPrimitive.createSphere( 1, divisions = imath.V2i( 31, 67 ) )
+		t = m.topology()
+		self.assertTrue( m.topology().isSame( t ) )
+
+		# Deforming the mesh doesn't affect the topology.
+		m2 = m.copy()
+		m2["P"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.V3fVectorData( [ p * 2 for p in m["P"].data ] ) )
+		self.assertTrue( m2.topology().isSame( t ) )
+
+		# But changing the topology does.
+		m2.setTopology( IECore.IntVectorData( [ 3 ] ), IECore.IntVectorData( [ 0, 1, 2 ] ), "linear" )
+		self.assertFalse( m2.topology().isSame( t ) )
+		self.assertEqual( m2.topology().numFaces(), 1 )
+
+		self.assertGreaterEqual( IECoreScene.MeshTopology.cacheMemoryUsage(), t.memoryUsage() )
+
+	def testTopologyCachePerformance( self ) :
+
+		m = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( 0 ), imath.V2f( 1 ) ), imath.V2i( 1000, 999 ) )
+
+		timer = IECore.Timer()
+		m.topology()
+		uncached = timer.stop()
+
+		timer = IECore.Timer()
+		for i in range( 0, 10 ) :
+			m.topology()
+		cached = timer.stop() / 10
+
+		self.assertLess( cached, uncached )
+
 	def tearDown( self ) :
 
 		for f in (
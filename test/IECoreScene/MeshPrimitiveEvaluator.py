@@ -370,6 +370,80 @@ class TestMeshPrimitiveEvaluator( unittest.TestCase ) :
 					hits = mpe.intersectionPoints( origin, direction )
 					self.failIf( hits )
 
+	def testBVHAccelerator( self ) :
+		""" Testing that the BVH accelerator gives the same results as the KDTree"""
+
+		m = IECore.Reader.create( "test/IECore/data/cobFiles/pSphereShape1.cob" ).read()
+
+		kd = IECoreScene.MeshPrimitiveEvaluator( m )
+		bvh = IECoreScene.MeshPrimitiveEvaluator( m, IECoreScene.MeshPrimitiveEvaluator.Accelerator.BVH )
+
+		self.assertEqual( kd.accelerator(), IECoreScene.MeshPrimitiveEvaluator.Accelerator.KDTree )
+		self.assertEqual( bvh.accelerator(), IECoreScene.MeshPrimitiveEvaluator.Accelerator.BVH )
+
+		kdResult = kd.createResult()
+		bvhResult = bvh.createResult()
+
+		random.seed( 2 )
+
+		for i in range( 0, 500 ) :
+
+			p = 3 * imath.V3f( random.uniform( -1, 1 ), random.uniform( -1, 1 ), random.uniform( -1, 1 ) )
+
+			self.assertTrue( kd.closestPoint( p, kdResult ) )
+			self.assertTrue( bvh.closestPoint( p, bvhResult ) )
+			self.assertAlmostEqual( ( kdResult.point() - p ).length(), ( bvhResult.point() - p ).length(), places = 5 )
+
+			origin = 2 * imath.V3f( random.uniform( -1, 1 ), random.uniform( -1, 1 ), random.uniform( -1, 1 ) )
+			direction = imath.V3f( random.uniform( -1, 1 ), random.uniform( -1, 1 ), random.uniform( -1, 1 ) )
+
+			kdHit = kd.intersectionPoint( origin, direction, kdResult )
+			bvhHit = bvh.intersectionPoint( origin, direction, bvhResult )
+			self.assertEqual( kdHit, bvhHit )
+			if kdHit :
+				self.assertTrue( kdResult.point().equalWithAbsError( bvhResult.point(), 1e-5 ) )
+				self.assertEqual( kdResult.triangleIndex(), bvhResult.triangleIndex() )
+
+			kdHits = sorted( h.triangleIndex() for h in kd.intersectionPoints( origin, direction ) )
+			bvhHits = sorted( h.triangleIndex() for h in bvh.intersectionPoints( origin, direction ) )
+			self.assertEqual( kdHits, bvhHits )
+
+	def testBatchedQueries( self ) :
+
+		m = IECore.Reader.create( "test/IECore/data/cobFiles/pSphereShape1.cob" ).read()
+
+		random.seed( 3 )
+
+		points = IECore.V3fVectorData()
+		directions = IECore.V3fVectorData()
+		for i in range( 0, 200 ) :
+			points.append( 2 * imath.V3f( random.uniform( -1, 1 ), random.uniform( -1, 1 ), random.uniform( -1, 1 ) ) )
+			directions.append( imath.V3f( random.uniform( -1, 1 ), random.uniform( -1, 1 ), random.uniform( -1, 1 ) ) )
+
+		for accelerator in IECoreScene.MeshPrimitiveEvaluator.Accelerator.values.values() :
+
+			e = IECoreScene.MeshPrimitiveEvaluator( m, accelerator )
+			r = e.createResult()
+
+			closest = e.batchClosestPoint( points )
+			self.assertEqual( len( closest ), len( points ) )
+			for p, c in zip( points, closest ) :
+				self.assertTrue( e.closestPoint( p, r ) )
+				self.assertEqual( r.point(), c.point() )
+				self.assertEqual( r.triangleIndex(), c.triangleIndex() )
+
+			for maxDistance in ( 0.5, 10 ) :
+				hits = e.batchIntersectionPoint( points, directions, maxDistance )
+				self.assertEqual( len( hits ), len( points ) )
+				for p, d, h in zip( points, directions, hits ) :
+					if e.intersectionPoint( p, d, r, maxDistance ) :
+						self.assertEqual( r.point(), h.point() )
+						self.assertEqual( r.triangleIndex(), h.triangleIndex() )
+					else :
+						self.assertEqual( h, None )
+
+			self.assertRaises( Exception, e.batchIntersectionPoint, points, IECore.V3fVectorData() )
+
 if __name__ == "__main__":
 	unittest.main()
 
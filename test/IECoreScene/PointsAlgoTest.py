@@ -529,6 +529,31 @@ class MergePointsTest( unittest.TestCase ) :
 
 		self.assertRaises( RuntimeError, lambda : IECoreScene.PointsAlgo.mergePoints( [pointsA, pointsB] ) )
 
+	def testIndexedPrimvarsRemainIndexed( self ) :
+		pointsA = IECoreScene.PointsPrimitive( IECore.V3fVectorData( [imath.V3f( x ) for x in range( 0, 3 )] ) )
+		pointsB = IECoreScene.PointsPrimitive( IECore.V3fVectorData( [imath.V3f( x ) for x in range( 0, 2 )] ) )
+
+		pointsA["foo"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.StringVectorData( ["a", "b"] ), IECore.IntVectorData( [1, 0, 1] ) )
+		pointsB["foo"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.StringVectorData( ["c"] ), IECore.IntVectorData( [0, 0] ) )
+
+		mergedPoints = IECoreScene.PointsAlgo.mergePoints( [pointsA, pointsB] )
+
+		self.assertEqual( mergedPoints["foo"].data, IECore.StringVectorData( ["a", "b", "c"] ) )
+		self.assertEqual( mergedPoints["foo"].indices, IECore.IntVectorData( [1, 0, 1, 2, 2] ) )
+
+	def testTransforms( self ) :
+		pointsA = IECoreScene.PointsPrimitive( IECore.V3fVectorData( [imath.V3f( x ) for x in range( 0, 2 )], IECore.GeometricData.Interpretation.Point ) )
+		pointsA["N"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.V3fVectorData( [imath.V3f( 0, 1, 0 )] * 2, IECore.GeometricData.Interpretation.Normal ) )
+		pointsA["Cs"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.V3fVectorData( [imath.V3f( 1 )] * 2 ) )
+
+		transform = imath.M44f().translate( imath.V3f( 1, 2, 3 ) ).scale( imath.V3f( 1, 2, 1 ) )
+		mergedPoints = IECoreScene.PointsAlgo.mergePoints( [pointsA, pointsA], [imath.M44f(), transform] )
+
+		self.assertEqual( mergedPoints["P"].data[0], imath.V3f( 0 ) )
+		self.assertTrue( mergedPoints["P"].data[3].equalWithAbsError( imath.V3f( 1 ) * transform, 1e-6 ) )
+		self.assertTrue( mergedPoints["N"].data[3].equalWithAbsError( imath.V3f( 0, 0.5, 0 ), 1e-6 ) )
+		self.assertEqual( mergedPoints["Cs"].data[3], imath.V3f( 1 ) )
+
 
 class SegmentPointsTest( unittest.TestCase ) :
 
@@ -630,5 +655,34 @@ class SegmentPointsTest( unittest.TestCase ) :
 		self.assertEqual( len(segments[1]["P"].data), 25 )
 
 
+class ReorderPointsTest( unittest.TestCase ) :
+
+	def testLocalityOrder( self ) :
+		points = IECoreScene.PointsPrimitive( IECore.V3fVectorData( [imath.V3f( x, 0, 0 ) for x in [3, 0, 2, 1]] ) )
+
+		order = IECoreScene.PointsAlgo.calculateLocalityOrder( points )
+		self.assertEqual( order, IECore.IntVectorData( [1, 3, 2, 0] ) )
+
+	def testReorder( self ) :
+		points = IECoreScene.PointsPrimitive( IECore.V3fVectorData( [imath.V3f( x ) for x in range( 0, 4 )] ) )
+		points["foo"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.StringVectorData( ["a", "b"] ), IECore.IntVectorData( [0, 1, 1, 0] ) )
+		points["bar"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Constant, IECore.IntData( 1 ) )
+
+		reordered = IECoreScene.PointsAlgo.reorder( points, IECore.IntVectorData( [2, 0, 3, 1] ) )
+
+		self.assertTrue( reordered.arePrimitiveVariablesValid() )
+		self.assertEqual( reordered.numPoints, 4 )
+		self.assertEqual( reordered["P"].data, IECore.V3fVectorData( [imath.V3f( x ) for x in [2, 0, 3, 1]] ) )
+		self.assertEqual( reordered["foo"].data, points["foo"].data )
+		self.assertEqual( reordered["foo"].indices, IECore.IntVectorData( [1, 0, 0, 1] ) )
+		self.assertEqual( reordered["bar"], points["bar"] )
+
+	def testRaisesExceptionIfOrderIsInvalid( self ) :
+		points = IECoreScene.PointsPrimitive( IECore.V3fVectorData( [imath.V3f( x ) for x in range( 0, 3 )] ) )
+
+		self.assertRaises( RuntimeError, lambda : IECoreScene.PointsAlgo.reorder( points, IECore.IntVectorData( [0, 1] ) ) )
+		self.assertRaises( RuntimeError, lambda : IECoreScene.PointsAlgo.reorder( points, IECore.IntVectorData( [0, 1, 1] ) ) )
+		self.assertRaises( RuntimeError, lambda : IECoreScene.PointsAlgo.reorder( points, IECore.IntVectorData( [0, 1, 3] ) ) )
+
 if __name__ == "__main__":
 	unittest.main()
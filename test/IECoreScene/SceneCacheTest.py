@@ -1117,6 +1117,294 @@ class SceneCacheTest( unittest.TestCase ) :
 
 			self.assertEqual( h1, h2 )
 
+	def testPipelinedWriting( self ) :
+
+		def write( fileName, pipelined ) :
+
+			m = IECoreScene.SceneCache( fileName, IECore.IndexedIO.OpenMode.Write )
+			m.setPipelinedWriting( pipelined )
+			self.assertEqual( m.getPipelinedWriting(), pipelined )
+
+			mesh = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 1 ) ), imath.V2i( 4 ) )
+			for i in range( 0, 20 ) :
+				c = m.createChild( str( i ) )
+				c.writeAttribute( "index", IECore.IntData( i ), 0.0 )
+				for t in range( 0, 4 ) :
+					c.writeTransform( IECore.M44dData( imath.M44d().translate( imath.V3d( i, t, 0 ) ) ), t )
+					# the samples are copied when queued, so changing them afterwards must not affect the file
+					mesh["P"].data[0] = imath.V3f( -1 - t, -1, 0 )
+					c.writeObject( mesh, t )
+					mesh["P"].data[0] = imath.V3f( 100 )
+
+		def collect( scene, result ) :
+
+			key = str( scene.path() )
+			result[key] = {
+				"bound" : [ scene.readBoundAtSample( i ) for i in range( 0, scene.numBoundSamples() ) ],
+				"attributes" : { n : [ scene.readAttributeAtSample( n, i ) for i in range( 0, scene.numAttributeSamples( n ) ) ] for n in scene.attributeNames() },
+				"tags" : sorted( scene.readTags() ),
+			}
+			if scene.hasObject() :
+				result[key]["object"] = [ scene.readObjectAtSample( i ) for i in range( 0, scene.numObjectSamples() ) ]
+			if scene.path() :
+				result[key]["transform"] = [ scene.readTransformAtSample( i ) for i in range( 0, scene.numTransformSamples() ) ]
+			for n in scene.childNames() :
+				collect( scene.child( n ), result )
+			return result
+
+		write( "/tmp/test.scc", False )
+		write( "/tmp/testPipelined.scc", True )
+
+		m1 = IECoreScene.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+		m2 = IECoreScene.SceneCache( "/tmp/testPipelined.scc", IECore.IndexedIO.OpenMode.Read )
+		self.assertEqual( collect( m2, {} ), collect( m1, {} ) )
+		self.assertEqual( m2.child( "3" ).readObjectAtSample( 2 )["P"].data[0], imath.V3f( -3, -1, 0 ) )
+
+		self.assertRaises( RuntimeError, m1.setPipelinedWriting, True )
+		self.assertFalse( m1.getPipelinedWriting() )
+
+	def testRepeatedObjectSamples( self ) :
+
+		mesh = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 1 ) ) )
+		movedMesh = mesh.copy()
+		movedMesh["P"].data[0] = imath.V3f( -2, -1, 0 )
+
+		for pipelined in ( False, True ) :
+
+			m = IECoreScene.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
+			m.setPipelinedWriting( pipelined )
+			a = m.createChild( "a" )
+			b = m.createChild( "b" )
+			for t, o in enumerate( [ mesh, mesh, movedMesh, mesh ] ) :
+				a.writeObject( o, t )
+			b.writeObject( mesh, 0 )
+			del m, a, b
+
+			# only the first copy of the mesh is saved, the other samples refer to it.
+			f = IECore.FileIndexedIO( "/tmp/test.scc", [], IECore.IndexedIO.OpenMode.Read )
+			aObject = f.directory( [ "root", "children", "a", "object" ] )
+			self.assertEqual( aObject.entry( "0" ).entryType(), IECore.IndexedIO.EntryType.Directory )
+			self.assertEqual( aObject.entry( "1" ).entryType(), IECore.IndexedIO.EntryType.File )
+			self.assertEqual( aObject.entry( "2" ).entryType(), IECore.IndexedIO.EntryType.Directory )
+			self.assertEqual( aObject.entry( "3" ).entryType(), IECore.IndexedIO.EntryType.File )
+			self.assertEqual( f.directory( [ "root", "children", "b", "object" ] ).entry( "0" ).entryType(), IECore.IndexedIO.EntryType.File )
+			del f, aObject
+
+			m = IECoreScene.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+			a = m.child( "a" )
+			for t, o in enumerate( [ mesh, mesh, movedMesh, mesh ] ) :
+				self.assertEqual( a.readObjectAtSample( t ), o )
+				self.assertEqual( a.readObjectPrimitiveVariables( [ "P" ], t )["P"], o["P"] )
+			self.assertEqual( a.readObject( 2.5 )["P"].data[0], imath.V3f( -1.5, -1, 0 ) )
+			self.assertEqual( m.child( "b" ).readObjectAtSample( 0 ), mesh )
+
+	def testPrefetch( self ) :
+
+		m = IECoreScene.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
+		mesh = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 1 ) ) )
+		for i in range( 0, 10 ) :
+			a = m.createChild( "a%d" % i )
+			b = a.createChild( "b" )
+			for t in range( 0, 5 ) :
+				a.writeTransform( IECore.M44dData( imath.M44d().translate( imath.V3d( i, t, 0 ) ) ), t )
+				b.writeAttribute( "w", IECore.IntData( t ), t )
+				b.writeObject( mesh, t )
+
+		self.assertRaises( RuntimeError, m.prefetch, IECore.PathMatcher( [ "/..." ] ), 0, 1 )
+		del m, a, b
+
+		m = IECoreScene.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+
+		p = m.prefetch( IECore.PathMatcher( [ "/a1/...", "/a3/b" ] ), 1.5, 3 )
+		p.wait()
+		self.assertTrue( p.done() )
+
+		for t in ( 1.5, 2, 3 ) :
+			self.assertEqual( m.child( "a1" ).readTransformAsMatrix( t ), imath.M44d().translate( imath.V3d( 1, t, 0 ) ) )
+			self.assertEqual( m.scene( [ "a3", "b" ] ).readAttribute( "w", t ), IECore.IntData( int( t ) ) )
+			self.assertEqual( m.scene( [ "a1", "b" ] ).readObject( t ), mesh )
+
+		p = m.child( "a2" ).prefetch( IECore.PathMatcher( [ "/b" ] ), 0, 4, IECoreScene.SceneCache.PrefetchData.Objects )
+		p.wait()
+		self.assertTrue( p.done() )
+		self.assertEqual( m.scene( [ "a2", "b" ] ).readObject( 4 ), mesh )
+
+		p = m.prefetch( IECore.PathMatcher( [ "/..." ] ), 0, 4 )
+		p.cancel()
+		self.assertTrue( p.done() )
+		p.wait()
+		del p
+
+	def testCacheStatistics( self ) :
+
+		m = IECoreScene.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
+		self.assertRaises( RuntimeError, m.cacheStatistics, IECoreScene.SceneCache.CacheType.ObjectCache )
+		a = m.createChild( "a" )
+		a.writeTransform( IECore.M44dData( imath.M44d().translate( imath.V3d( 1, 0, 0 ) ) ), 0 )
+		a.writeAttribute( "w", IECore.IntData( 1 ), 0 )
+		a.writeObject( IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 1 ) ) ), 0 )
+		del m, a
+
+		m = IECoreScene.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+		a = m.child( "a" )
+
+		s = m.cacheStatistics( IECoreScene.SceneCache.CacheType.TransformCache )
+		self.assertEqual( ( s.hits, s.misses, s.evictions, s.memoryUsage ), ( 0, 0, 0, 0 ) )
+
+		a.readTransformAtSample( 0 )
+		a.readTransformAtSample( 0 )
+		s = m.cacheStatistics( IECoreScene.SceneCache.CacheType.TransformCache )
+		self.assertEqual( ( s.hits, s.misses ), ( 1, 1 ) )
+		self.assertGreater( s.memoryUsage, 0 )
+		self.assertGreaterEqual( s.loadTime, 0 )
+
+		a.readAttributeAtSample( "w", 0 )
+		s = m.cacheStatistics( IECoreScene.SceneCache.CacheType.AttributeCache )
+		self.assertEqual( ( s.hits, s.misses ), ( 0, 1 ) )
+
+		mesh = a.readObjectAtSample( 0 )
+		s = m.cacheStatistics( IECoreScene.SceneCache.CacheType.ObjectCache )
+		self.assertEqual( ( s.hits, s.misses ), ( 0, 1 ) )
+		self.assertGreaterEqual( s.memoryUsage, mesh.memoryUsage() )
+		a.readObjectAtSample( 0 )
+		s = m.cacheStatistics( IECoreScene.SceneCache.CacheType.ObjectCache )
+		self.assertEqual( ( s.hits, s.misses ), ( 1, 1 ) )
+
+		# the caches are limited by the memory used by the objects they hold
+		m.setCacheMemoryLimit( IECoreScene.SceneCache.CacheType.ObjectCache, mesh.memoryUsage() - 1 )
+		self.assertEqual( m.getCacheMemoryLimit( IECoreScene.SceneCache.CacheType.ObjectCache ), mesh.memoryUsage() - 1 )
+		s = m.cacheStatistics( IECoreScene.SceneCache.CacheType.ObjectCache )
+		self.assertGreater( s.evictions, 0 )
+		self.assertEqual( s.memoryUsage, 0 )
+		self.assertEqual( a.readObjectAtSample( 0 ), mesh )
+		self.assertEqual( m.cacheStatistics( IECoreScene.SceneCache.CacheType.ObjectCache ).memoryUsage, 0 )
+
+		defaultLimit = IECoreScene.SceneCache.getDefaultCacheMemoryLimit( IECoreScene.SceneCache.CacheType.AttributeCache )
+		try :
+			IECoreScene.SceneCache.setDefaultCacheMemoryLimit( IECoreScene.SceneCache.CacheType.AttributeCache, 1024 )
+			m = IECoreScene.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+			self.assertEqual( m.getCacheMemoryLimit( IECoreScene.SceneCache.CacheType.AttributeCache ), 1024 )
+		finally :
+			IECoreScene.SceneCache.setDefaultCacheMemoryLimit( IECoreScene.SceneCache.CacheType.AttributeCache, defaultLimit )
+
+	def testCacheStatisticsWithAnimatedPrimVars( self ) :
+
+		mesh = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 1 ) ) )
+		m = IECoreScene.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
+		a = m.createChild( "a" )
+		for i in range( 0, 2 ) :
+			deformed = mesh.copy()
+			deformed["P"] = IECoreScene.PrimitiveVariable( deformed["P"].interpolation, IECore.V3fVectorData( [ p + imath.V3f( 0, 0, i ) for p in mesh["P"].data ], IECore.GeometricData.Interpretation.Point ) )
+			a.writeObject( deformed, i )
+		del m, a
+
+		m = IECoreScene.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+		a = m.child( "a" )
+		self.assertTrue( a.hasAttribute( "sceneInterface:animatedObjectPrimVars" ) )
+
+		def statistics() :
+			s = m.cacheStatistics( IECoreScene.SceneCache.CacheType.ObjectCache )
+			return ( s.hits, s.misses )
+
+		# Each read is counted once, regardless of how many cache
+		# entries are probed to satisfy it.
+		a.readObjectAtSample( 0 )
+		self.assertEqual( statistics(), ( 0, 1 ) )
+		# Built from the first sample, but the primitive variables
+		# still have to be loaded.
+		a.readObjectAtSample( 1 )
+		self.assertEqual( statistics(), ( 0, 2 ) )
+		a.readObjectAtSample( 1 )
+		self.assertEqual( statistics(), ( 1, 2 ) )
+		a.readObjectAtSample( 0 )
+		self.assertEqual( statistics(), ( 2, 2 ) )
+
+	def testCacheBufferDeduplication( self ) :
+
+		mesh = IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 1 ) ), imath.V2i( 32 ) )
+		m = IECoreScene.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
+		a = m.createChild( "a" )
+		for i in range( 0, 2 ) :
+			deformed = mesh.copy()
+			deformed["P"] = IECoreScene.PrimitiveVariable( deformed["P"].interpolation, IECore.V3fVectorData( [ p + imath.V3f( 0, 0, i ) for p in mesh["P"].data ], IECore.GeometricData.Interpretation.Point ) )
+			a.writeObject( deformed, i )
+		del m, a
+
+		m = IECoreScene.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+		self.assertFalse( m.getCacheBufferDeduplication( IECoreScene.SceneCache.CacheType.ObjectCache ) )
+		m.setCacheBufferDeduplication( IECoreScene.SceneCache.CacheType.ObjectCache, True )
+		self.assertTrue( m.getCacheBufferDeduplication( IECoreScene.SceneCache.CacheType.ObjectCache ) )
+
+		a = m.child( "a" )
+		o0 = a.readObjectAtSample( 0 )
+		o1 = a.readObjectAtSample( 1 )
+		self.assertEqual( o0.vertexIds, mesh.vertexIds )
+		self.assertEqual( o1.verticesPerFace, mesh.verticesPerFace )
+		self.assertNotEqual( o0, o1 )
+
+		# the topology is shared by both samples
+		self.assertLess( IECore.CompoundObject( { "0" : o0, "1" : o1 } ).memoryUsage(), o0.memoryUsage() + o1.memoryUsage() )
+
+		default = IECoreScene.SceneCache.getDefaultCacheBufferDeduplication( IECoreScene.SceneCache.CacheType.ObjectCache )
+		try :
+			IECoreScene.SceneCache.setDefaultCacheBufferDeduplication( IECoreScene.SceneCache.CacheType.ObjectCache, True )
+			m = IECoreScene.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+			self.assertTrue( m.getCacheBufferDeduplication( IECoreScene.SceneCache.CacheType.ObjectCache ) )
+		finally :
+			IECoreScene.SceneCache.setDefaultCacheBufferDeduplication( IECoreScene.SceneCache.CacheType.ObjectCache, default )
+
+	def testReadHierarchy( self ) :
+
+		m = IECoreScene.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Write )
+		a = m.createChild( "a" )
+		a.writeTransform( IECore.M44dData( imath.M44d().translate( imath.V3d( 1, 0, 0 ) ) ), 0 )
+		a.writeTransform( IECore.M44dData( imath.M44d().translate( imath.V3d( 2, 0, 0 ) ) ), 1 )
+		b = a.createChild( "b" )
+		b.writeTransform( IECore.M44dData( imath.M44d().translate( imath.V3d( 0, 1, 0 ) ) ), 0 )
+		b.writeObject( IECoreScene.SpherePrimitive( 1 ), 0 )
+		c = a.createChild( "c" )
+		c.writeObject( IECoreScene.MeshPrimitive.createPlane( imath.Box2f( imath.V2f( -1 ), imath.V2f( 1 ) ) ), 0 )
+		d = m.createChild( "d" )
+		d.writeObject( IECoreScene.PointsPrimitive( 3 ), 0 )
+		del m, a, b, c, d
+
+		m = IECoreScene.SceneCache( "/tmp/test.scc", IECore.IndexedIO.OpenMode.Read )
+
+		def walk( scene, parentTransform, filter, path, result ) :
+
+			transform = scene.readTransformAsMatrix( 0.5 )
+			worldTransform = transform * parentTransform
+			if filter.match( path ) & IECore.PathMatcher.Result.ExactMatch :
+				result.append( ( IECoreScene.SceneInterface.pathToString( path ), transform, worldTransform, scene.readBound( 0.5 ), scene.readObject( 0.5 ).typeId() if scene.hasObject() else IECore.TypeId.Invalid ) )
+			for name in scene.childNames() :
+				walk( scene.child( name ), worldTransform, filter, path + [ name ], result )
+
+		for paths in ( [ "/..." ], [ "/a/b", "/d" ], [ "/a", "/a/c" ], [] ) :
+
+			filter = IECore.PathMatcher( paths )
+			hierarchy = m.readHierarchy( filter, 0.5 )
+
+			expected = []
+			walk( m, imath.M44d(), filter, [], expected )
+			self.assertEqual( list( hierarchy["paths"] ), [ e[0] for e in expected ] )
+			self.assertEqual( list( hierarchy["localTransforms"] ), [ e[1] for e in expected ] )
+			self.assertEqual( list( hierarchy["worldTransforms"] ), [ e[2] for e in expected ] )
+			self.assertEqual( list( hierarchy["bounds"] ), [ e[3] for e in expected ] )
+			self.assertEqual( list( hierarchy["objectTypes"] ), [ int( e[4] ) for e in expected ] )
+
+			for i, parentIndex in enumerate( hierarchy["parentIndices"] ) :
+				if parentIndex == -1 :
+					continue
+				self.assertLess( parentIndex, i )
+				self.assertTrue( hierarchy["paths"][i].startswith( hierarchy["paths"][parentIndex].rstrip( "/" ) + "/" ) )
+
+		hierarchy = m.readHierarchy( IECore.PathMatcher( [ "/a/b" ] ), 0.5, IECoreScene.SceneInterface.HierarchyData.HierarchyTransforms )
+		self.assertEqual( list( hierarchy["paths"] ), [ "/a/b" ] )
+		self.assertEqual( list( hierarchy["parentIndices"] ), [ -1 ] )
+		self.assertEqual( hierarchy["worldTransforms"][0], imath.M44d().translate( imath.V3d( 1.5, 1, 0 ) ) )
+		self.assertFalse( "bounds" in hierarchy )
+		self.assertFalse( "objectTypes" in hierarchy )
+
 	def testParallelAttributeRead( self ) :
 
 		IECoreScene.testSceneCacheParallelAttributeRead()
@@ -0,0 +1,333 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "Benchmark.h"
+
+#include "IECore/Timer.h"
+
+#include "boost/filesystem/operations.hpp"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <ctime>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <random>
+#include <thread>
+
+#include <stdlib.h>
+
+using namespace IECore;
+using namespace IECoreBenchmark;
+
+//////////////////////////////////////////////////////////////////////////
+// Allocation counting
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+std::atomic<size_t> g_allocationCount( 0 );
+
+} // namespace
+
+void *operator new( size_t size )
+{
+	g_allocationCount.fetch_add( 1, std::memory_order_relaxed );
+	if( void *result = malloc( size ? size : 1 ) )
+	{
+		return result;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete( void *p ) noexcept
+{
+	free( p );
+}
+
+void operator delete( void *p, size_t ) noexcept
+{
+	free( p );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Options
+//////////////////////////////////////////////////////////////////////////
+
+Options::Options()
+	:	directory( "/tmp" ), maxThreads( std::max( 1u, std::thread::hardware_concurrency() ) ), scale( 1.0 ), repeats( 3 )
+{
+}
+
+std::string Options::fileName( const std::string &fileName ) const
+{
+	return ( boost::filesystem::path( directory ) / fileName ).string();
+}
+
+size_t Options::scaled( size_t n ) const
+{
+	return std::max( (size_t)1, (size_t)( n * scale ) );
+}
+
+bool Options::enabled( const std::string &benchmark ) const
+{
+	return filter.empty() || benchmark.find( filter ) != std::string::npos;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Results
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+std::string jsonString( const std::string &s )
+{
+	std::string result = "\"";
+	for( std::string::const_iterator it = s.begin(); it != s.end(); ++it )
+	{
+		switch( *it )
+		{
+			case '"' :
+				result += "\\\"";
+				break;
+			case '\\' :
+				result += "\\\\";
+				break;
+			case '\n' :
+				result += "\\n";
+				break;
+			default :
+				result += *it;
+		}
+	}
+	result += "\"";
+	return result;
+}
+
+} // namespace
+
+Results::Results( const Options &options )
+	:	m_options( options )
+{
+}
+
+void Results::add( const std::string &benchmark, const std::string &dataset, const std::string &metric, double value, const std::string &unit, size_t threads )
+{
+	Result r = { benchmark, dataset, metric, value, unit, threads };
+	m_results.push_back( r );
+}
+
+void Results::writeJSON( std::ostream &stream ) const
+{
+	char timestamp[64];
+	time_t now = ::time( nullptr );
+	strftime( timestamp, sizeof( timestamp ), "%Y-%m-%dT%H:%M:%SZ", gmtime( &now ) );
+
+	stream.precision( std::numeric_limits<double>::digits10 );
+
+	stream << "{\n";
+	stream << "\t\"version\" : 1,\n";
+	stream << "\t\"timestamp\" : " << jsonString( timestamp ) << ",\n";
+	stream << "\t\"hardwareConcurrency\" : " << std::thread::hardware_concurrency() << ",\n";
+	stream << "\t\"peakResidentSetSize\" : " << peakResidentSetSize() << ",\n";
+	stream << "\t\"options\" : {\n";
+	stream << "\t\t\"directory\" : " << jsonString( m_options.directory ) << ",\n";
+	stream << "\t\t\"maxThreads\" : " << m_options.maxThreads << ",\n";
+	stream << "\t\t\"scale\" : " << m_options.scale << ",\n";
+	stream << "\t\t\"repeats\" : " << m_options.repeats << ",\n";
+	stream << "\t\t\"filter\" : " << jsonString( m_options.filter ) << "\n";
+	stream << "\t},\n";
+	stream << "\t\"results\" : [\n";
+	for( std::vector<Result>::const_iterator it = m_results.begin(); it != m_results.end(); ++it )
+	{
+		stream << "\t\t{ ";
+		stream << "\"benchmark\" : " << jsonString( it->benchmark ) << ", ";
+		stream << "\"dataset\" : " << jsonString( it->dataset ) << ", ";
+		stream << "\"metric\" : " << jsonString( it->metric ) << ", ";
+		stream << "\"threads\" : " << it->threads << ", ";
+		stream << "\"value\" : " << it->value << ", ";
+		stream << "\"unit\" : " << jsonString( it->unit );
+		stream << " }" << ( it + 1 != m_results.end() ? "," : "" ) << "\n";
+	}
+	stream << "\t]\n";
+	stream << "}\n";
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Utilities
+//////////////////////////////////////////////////////////////////////////
+
+double IECoreBenchmark::time( const Options &options, const std::function<void ()> &f )
+{
+	return time( options, [] {}, f );
+}
+
+double IECoreBenchmark::time( const Options &options, const std::function<void ()> &setup, const std::function<void ()> &f )
+{
+	double result = std::numeric_limits<double>::max();
+	for( size_t i = 0; i < std::max( (size_t)1, options.repeats ); ++i )
+	{
+		setup();
+		Timer timer( true, Timer::WallClock );
+		f();
+		result = std::min( result, timer.stop() );
+	}
+	return result;
+}
+
+double IECoreBenchmark::timeThreads( size_t numThreads, const std::function<void ( size_t )> &f )
+{
+	std::atomic<size_t> ready( 0 );
+	std::atomic<bool> go( false );
+	std::exception_ptr exception;
+	std::mutex exceptionMutex;
+
+	std::vector<std::thread> threads;
+	for( size_t i = 0; i < numThreads; ++i )
+	{
+		threads.emplace_back(
+			[&, i] {
+				++ready;
+				while( !go )
+				{
+					std::this_thread::yield();
+				}
+				try
+				{
+					f( i );
+				}
+				catch( ... )
+				{
+					std::lock_guard<std::mutex> lock( exceptionMutex );
+					exception = std::current_exception();
+				}
+			}
+		);
+	}
+
+	while( ready != numThreads )
+	{
+		std::this_thread::yield();
+	}
+
+	Timer timer( true, Timer::WallClock );
+	go = true;
+	for( std::vector<std::thread>::iterator it = threads.begin(); it != threads.end(); ++it )
+	{
+		it->join();
+	}
+	const double result = timer.stop();
+
+	if( exception )
+	{
+		std::rethrow_exception( exception );
+	}
+	return result;
+}
+
+double IECoreBenchmark::timeThreads( const Options &options, size_t numThreads, const std::function<void ()> &setup, const std::function<void ( size_t )> &f )
+{
+	double result = std::numeric_limits<double>::max();
+	for( size_t i = 0; i < std::max( (size_t)1, options.repeats ); ++i )
+	{
+		setup();
+		result = std::min( result, timeThreads( numThreads, f ) );
+	}
+	return result;
+}
+
+std::vector<size_t> IECoreBenchmark::threadCounts( const Options &options )
+{
+	std::vector<size_t> result;
+	for( size_t n = 1; n < options.maxThreads; n *= 2 )
+	{
+		result.push_back( n );
+	}
+	result.push_back( std::max( (size_t)1, options.maxThreads ) );
+	return result;
+}
+
+size_t IECoreBenchmark::peakResidentSetSize()
+{
+	struct rusage usage;
+	if( getrusage( RUSAGE_SELF, &usage ) != 0 )
+	{
+		return 0;
+	}
+#ifdef __APPLE__
+	// bytes on OSX
+	return usage.ru_maxrss;
+#else
+	// kilobytes on Linux
+	return usage.ru_maxrss * 1024;
+#endif
+}
+
+size_t IECoreBenchmark::minorPageFaults()
+{
+	struct rusage usage;
+	if( getrusage( RUSAGE_SELF, &usage ) != 0 )
+	{
+		return 0;
+	}
+	return usage.ru_minflt;
+}
+
+size_t IECoreBenchmark::allocationCount()
+{
+	return g_allocationCount.load( std::memory_order_relaxed );
+}
+
+size_t IECoreBenchmark::fileSize( const std::string &fileName )
+{
+	return boost::filesystem::file_size( fileName );
+}
+
+std::vector<size_t> IECoreBenchmark::shuffledIndices( size_t n )
+{
+	std::vector<size_t> result( n );
+	for( size_t i = 0; i < n; ++i )
+	{
+		result[i] = i;
+	}
+	std::mt19937 generator( 42 );
+	std::shuffle( result.begin(), result.end(), generator );
+	return result;
+}
@@ -0,0 +1,138 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECOREBENCHMARK_BENCHMARK_H
+#define IECOREBENCHMARK_BENCHMARK_H
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace IECoreBenchmark
+{
+
+/// Settings shared by all the benchmarks, as specified on the command line.
+struct Options
+{
+	Options();
+
+	/// Directory where the synthetic files are written.
+	std::string directory;
+	/// The multithreaded benchmarks are run with 1, 2, 4 ... threads up to this number.
+	size_t maxThreads;
+	/// Multiplier applied to the size of the synthetic data.
+	double scale;
+	/// Number of times each measurement is repeated, keeping the fastest.
+	size_t repeats;
+	/// Only the benchmarks whose name contains this string are run.
+	std::string filter;
+
+	/// Returns the path to a file named fileName in the benchmark directory.
+	std::string fileName( const std::string &fileName ) const;
+	/// Returns n multiplied by scale, and never less than 1.
+	size_t scaled( size_t n ) const;
+	/// Returns true if the named benchmark passes the filter.
+	bool enabled( const std::string &benchmark ) const;
+
+};
+
+/// Collects the measurements made by the benchmarks and writes them as JSON.
+class Results
+{
+
+	public :
+
+		Results( const Options &options );
+
+		/// Records a measurement. The benchmark identifies what is being measured
+		/// (FileIndexedIO, SceneCache...), the dataset the synthetic data used, and
+		/// the metric the quantity measured, in the given unit.
+		void add( const std::string &benchmark, const std::string &dataset, const std::string &metric, double value, const std::string &unit, size_t threads = 1 );
+
+		void writeJSON( std::ostream &stream ) const;
+
+	private :
+
+		struct Result
+		{
+			std::string benchmark;
+			std::string dataset;
+			std::string metric;
+			double value;
+			std::string unit;
+			size_t threads;
+		};
+
+		const Options &m_options;
+		std::vector<Result> m_results;
+
+};
+
+/// Runs f repeatedly, returning the fastest wall clock time in seconds.
+double time( const Options &options, const std::function<void ()> &f );
+/// As above, but calling setup before each run of f, without timing it.
+double time( const Options &options, const std::function<void ()> &setup, const std::function<void ()> &f );
+
+/// Calls f( threadIndex ) from numThreads concurrent threads, returning the wall clock
+/// time in seconds taken for all of them to finish. The threads are started before
+/// the timing begins, so that only the work itself is measured.
+double timeThreads( size_t numThreads, const std::function<void ( size_t )> &f );
+/// As above, but repeating the measurement and returning the fastest time. The
+/// setup function is called before each run, without timing it.
+double timeThreads( const Options &options, size_t numThreads, const std::function<void ()> &setup, const std::function<void ( size_t )> &f );
+
+/// Returns the list of thread counts to use for the scaling benchmarks.
+std::vector<size_t> threadCounts( const Options &options );
+
+/// Returns the peak resident set size of the process, in bytes.
+size_t peakResidentSetSize();
+
+/// Returns the number of minor page faults incurred by the process so far.
+size_t minorPageFaults();
+
+/// Returns the number of calls made to the global operator new so far.
+/// The benchmark program replaces operator new to count them.
+size_t allocationCount();
+
+/// Returns the size of a file, in bytes.
+size_t fileSize( const std::string &fileName );
+
+/// Returns a pseudo random permutation of the numbers [0, n), which is the same
+/// for every run.
+std::vector<size_t> shuffledIndices( size_t n );
+
+} // namespace IECoreBenchmark
+
+#endif // IECOREBENCHMARK_BENCHMARK_H
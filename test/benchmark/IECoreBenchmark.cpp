@@ -0,0 +1,156 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "Benchmark.h"
+#include "IndexedIOBenchmark.h"
+#include "LRUCacheBenchmark.h"
+#include "MeshAlgoBenchmark.h"
+#include "ObjectIOBenchmark.h"
+#include "RadixSortBenchmark.h"
+#include "SceneCacheBenchmark.h"
+
+#include "boost/lexical_cast.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using namespace IECoreBenchmark;
+
+namespace
+{
+
+void usage( const char *program )
+{
+	std::cerr << "Usage : " << program << " [options]\n\n";
+	std::cerr << "Runs the IndexedIO, SceneCache, LRUCache, RadixSort, ObjectIO and MeshAlgo benchmarks, writing the results as JSON.\n\n";
+	std::cerr << "\t-o file       File to write the results to. Defaults to the standard output.\n";
+	std::cerr << "\t-d directory  Directory where the synthetic files are written. Defaults to /tmp.\n";
+	std::cerr << "\t-t threads    Maximum number of threads. Defaults to the number of cores.\n";
+	std::cerr << "\t-s scale      Multiplier for the size of the synthetic data. Defaults to 1.\n";
+	std::cerr << "\t-r repeats    Number of times each measurement is repeated. Defaults to 3.\n";
+	std::cerr << "\t-f filter     Only runs the benchmarks whose name contains filter.\n";
+	std::cerr << "\t-h            Prints this message.\n";
+}
+
+} // namespace
+
+int main( int argc, char *argv[] )
+{
+	Options options;
+	std::string outputFileName;
+
+	try
+	{
+		for( int i = 1; i < argc; ++i )
+		{
+			if( !strcmp( argv[i], "-h" ) )
+			{
+				usage( argv[0] );
+				return 0;
+			}
+
+			if( i + 1 >= argc || argv[i][0] != '-' || strlen( argv[i] ) != 2 )
+			{
+				usage( argv[0] );
+				return 1;
+			}
+
+			const char *value = argv[++i];
+			switch( argv[i-1][1] )
+			{
+				case 'o' :
+					outputFileName = value;
+					break;
+				case 'd' :
+					options.directory = value;
+					break;
+				case 't' :
+					options.maxThreads = boost::lexical_cast<size_t>( value );
+					break;
+				case 's' :
+					options.scale = boost::lexical_cast<double>( value );
+					break;
+				case 'r' :
+					options.repeats = boost::lexical_cast<size_t>( value );
+					break;
+				case 'f' :
+					options.filter = value;
+					break;
+				default :
+					usage( argv[0] );
+					return 1;
+			}
+		}
+	}
+	catch( const boost::bad_lexical_cast &e )
+	{
+		std::cerr << "Invalid argument : " << e.what() << std::endl;
+		return 1;
+	}
+
+	Results results( options );
+
+	try
+	{
+		runIndexedIOBenchmarks( options, results );
+		runSceneCacheBenchmarks( options, results );
+		runLRUCacheBenchmarks( options, results );
+		runRadixSortBenchmarks( options, results );
+		runObjectIOBenchmarks( options, results );
+		runMeshAlgoBenchmarks( options, results );
+	}
+	catch( const std::exception &e )
+	{
+		std::cerr << "Benchmark failed : " << e.what() << std::endl;
+		return 1;
+	}
+
+	if( outputFileName.empty() )
+	{
+		results.writeJSON( std::cout );
+	}
+	else
+	{
+		std::ofstream file( outputFileName.c_str() );
+		results.writeJSON( file );
+		if( !file )
+		{
+			std::cerr << "Unable to write \"" << outputFileName << "\"" << std::endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
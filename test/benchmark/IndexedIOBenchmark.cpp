@@ -0,0 +1,355 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "IndexedIOBenchmark.h"
+
+#include "IECore/FileIndexedIO.h"
+#include "IECore/MemoryIndexedIO.h"
+
+#include "boost/lexical_cast.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace IECore;
+using namespace IECoreBenchmark;
+
+namespace
+{
+
+//////////////////////////////////////////////////////////////////////////
+// Synthetic data
+//////////////////////////////////////////////////////////////////////////
+
+struct Entry
+{
+	IndexedIO::EntryIDList directory;
+	IndexedIO::EntryID name;
+	size_t length;
+};
+
+struct Dataset
+{
+	Dataset( const std::string &name ) : name( name ), maxLength( 0 ), bytes( 0 )
+	{
+	}
+
+	void addEntry( const IndexedIO::EntryIDList &directory, const IndexedIO::EntryID &entry, size_t length )
+	{
+		Entry e = { directory, entry, length };
+		entries.push_back( e );
+		maxLength = std::max( maxLength, length );
+		bytes += length * sizeof( float );
+	}
+
+	std::string name;
+	std::vector<Entry> entries;
+	size_t maxLength;
+	size_t bytes;
+};
+
+IndexedIO::EntryID entryName( const char *prefix, size_t i )
+{
+	return prefix + boost::lexical_cast<std::string>( i );
+}
+
+// A single chain of nested directories, with a few small arrays at each level.
+Dataset deepDataset( const Options &options )
+{
+	Dataset result( "deep" );
+	IndexedIO::EntryIDList directory;
+	for( size_t i = 0, depth = options.scaled( 256 ); i < depth; ++i )
+	{
+		directory.push_back( entryName( "d", i ) );
+		for( size_t j = 0; j < 4; ++j )
+		{
+			result.addEntry( directory, entryName( "e", j ), 16 );
+		}
+	}
+	return result;
+}
+
+// Many sibling directories, each holding a single small array.
+Dataset wideDataset( const Options &options )
+{
+	Dataset result( "wide" );
+	for( size_t i = 0, width = options.scaled( 20000 ); i < width; ++i )
+	{
+		IndexedIO::EntryIDList directory( 1, entryName( "c", i ) );
+		result.addEntry( directory, "e", 16 );
+	}
+	return result;
+}
+
+// A few arrays of several megabytes each.
+Dataset largeDataset( const Options &options )
+{
+	Dataset result( "largeArrays" );
+	IndexedIO::EntryIDList directory( 1, "arrays" );
+	for( size_t i = 0; i < 16; ++i )
+	{
+		result.addEntry( directory, entryName( "a", i ), options.scaled( 1 << 20 ) );
+	}
+	return result;
+}
+
+// Directories each holding many single value entries.
+Dataset smallDataset( const Options &options )
+{
+	Dataset result( "smallEntries" );
+	for( size_t i = 0, numDirectories = options.scaled( 100 ); i < numDirectories; ++i )
+	{
+		IndexedIO::EntryIDList directory( 1, entryName( "s", i ) );
+		for( size_t j = 0; j < 100; ++j )
+		{
+			result.addEntry( directory, entryName( "v", j ), 1 );
+		}
+	}
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Backends
+//////////////////////////////////////////////////////////////////////////
+
+class Backend
+{
+
+	public :
+
+		virtual ~Backend()
+		{
+		}
+
+		virtual std::string name() const = 0;
+		/// Returns a new empty file opened for writing.
+		virtual IndexedIOPtr create( const Dataset &dataset ) = 0;
+		/// Completes the writing of the file returned by create().
+		virtual void close( IndexedIOPtr &io ) = 0;
+		/// Opens the file written last for reading.
+		virtual ConstIndexedIOPtr open() const = 0;
+		virtual size_t size() const = 0;
+
+};
+
+class FileBackend : public Backend
+{
+
+	public :
+
+		FileBackend( const Options &options ) : m_options( options )
+		{
+		}
+
+		std::string name() const override
+		{
+			return "FileIndexedIO";
+		}
+
+		IndexedIOPtr create( const Dataset &dataset ) override
+		{
+			m_fileName = m_options.fileName( "IECoreBenchmark_" + dataset.name + ".fio" );
+			return new FileIndexedIO( m_fileName, IndexedIO::rootPath, IndexedIO::Write );
+		}
+
+		void close( IndexedIOPtr &io ) override
+		{
+			io = nullptr;
+		}
+
+		ConstIndexedIOPtr open() const override
+		{
+			return new FileIndexedIO( m_fileName, IndexedIO::rootPath, IndexedIO::Read );
+		}
+
+		size_t size() const override
+		{
+			return fileSize( m_fileName );
+		}
+
+	private :
+
+		const Options &m_options;
+		std::string m_fileName;
+
+};
+
+class MemoryBackend : public Backend
+{
+
+	public :
+
+		std::string name() const override
+		{
+			return "MemoryIndexedIO";
+		}
+
+		IndexedIOPtr create( const Dataset & ) override
+		{
+			m_buffer = nullptr;
+			return new MemoryIndexedIO( nullptr, IndexedIO::rootPath, IndexedIO::Write );
+		}
+
+		void close( IndexedIOPtr &io ) override
+		{
+			m_buffer = static_cast<MemoryIndexedIO *>( io.get() )->buffer();
+			io = nullptr;
+		}
+
+		ConstIndexedIOPtr open() const override
+		{
+			return new MemoryIndexedIO( m_buffer, IndexedIO::rootPath, IndexedIO::Read );
+		}
+
+		size_t size() const override
+		{
+			return m_buffer ? m_buffer->readable().size() : 0;
+		}
+
+	private :
+
+		ConstCharVectorDataPtr m_buffer;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Measurements
+//////////////////////////////////////////////////////////////////////////
+
+void write( IndexedIO *root, const Dataset &dataset )
+{
+	std::vector<float> data( dataset.maxLength, 1.0f );
+	for( std::vector<Entry>::const_iterator it = dataset.entries.begin(); it != dataset.entries.end(); ++it )
+	{
+		IndexedIOPtr directory = root->directory( it->directory, IndexedIO::CreateIfMissing );
+		directory->write( it->name, &data[0], it->length );
+	}
+}
+
+// Reads the entries of the dataset with the given indices, starting at first and
+// taking every stride-th one.
+void read( const IndexedIO *root, const Dataset &dataset, const std::vector<size_t> &indices, size_t first, size_t stride )
+{
+	std::vector<float> data( dataset.maxLength );
+	float *dataPtr = &data[0];
+	for( size_t i = first; i < indices.size(); i += stride )
+	{
+		const Entry &entry = dataset.entries[indices[i]];
+		ConstIndexedIOPtr directory = root->directory( entry.directory );
+		directory->read( entry.name, dataPtr, entry.length );
+	}
+}
+
+void runBenchmark( const Options &options, Backend &backend, const Dataset &dataset, Results &results )
+{
+	std::cerr << "Running " << backend.name() << " " << dataset.name << std::endl;
+
+	const double numEntries = dataset.entries.size();
+	const double megabytes = dataset.bytes / ( 1024.0 * 1024.0 );
+
+	IndexedIOPtr writeRoot;
+	double t = time(
+		options,
+		[&] { writeRoot = backend.create( dataset ); },
+		[&] { write( writeRoot.get(), dataset ); backend.close( writeRoot ); }
+	);
+	results.add( backend.name(), dataset.name, "writeTime", t, "s" );
+	results.add( backend.name(), dataset.name, "writeThroughput", megabytes / t, "MB/s" );
+	results.add( backend.name(), dataset.name, "fileSize", backend.size(), "bytes" );
+
+	t = time( options, [&] { backend.open(); } );
+	results.add( backend.name(), dataset.name, "openTime", t, "s" );
+
+	std::vector<size_t> sequentialIndices( dataset.entries.size() );
+	for( size_t i = 0; i < sequentialIndices.size(); ++i )
+	{
+		sequentialIndices[i] = i;
+	}
+	const std::vector<size_t> randomIndices = shuffledIndices( dataset.entries.size() );
+
+	ConstIndexedIOPtr readRoot;
+	t = time(
+		options,
+		[&] { readRoot = backend.open(); },
+		[&] { read( readRoot.get(), dataset, sequentialIndices, 0, 1 ); }
+	);
+	results.add( backend.name(), dataset.name, "sequentialReadLatency", t / numEntries, "s" );
+
+	t = time(
+		options,
+		[&] { readRoot = backend.open(); },
+		[&] { read( readRoot.get(), dataset, randomIndices, 0, 1 ); }
+	);
+	results.add( backend.name(), dataset.name, "randomReadLatency", t / numEntries, "s" );
+
+	// all the threads share the same file, each reading a different part of it.
+	const std::vector<size_t> threads = threadCounts( options );
+	for( std::vector<size_t>::const_iterator it = threads.begin(); it != threads.end(); ++it )
+	{
+		const size_t numThreads = *it;
+		t = timeThreads(
+			options, numThreads,
+			[&] { readRoot = backend.open(); },
+			[&]( size_t threadIndex ) { read( readRoot.get(), dataset, randomIndices, threadIndex, numThreads ); }
+		);
+		results.add( backend.name(), dataset.name, "readThroughput", numEntries / t, "entries/s", numThreads );
+	}
+
+	readRoot = nullptr;
+	results.add( backend.name(), dataset.name, "peakResidentSetSize", peakResidentSetSize(), "bytes" );
+}
+
+} // namespace
+
+void IECoreBenchmark::runIndexedIOBenchmarks( const Options &options, Results &results )
+{
+	FileBackend fileBackend( options );
+	MemoryBackend memoryBackend;
+	Backend *backends[] = { &fileBackend, &memoryBackend };
+
+	typedef Dataset (*DatasetGenerator)( const Options & );
+	DatasetGenerator generators[] = { deepDataset, wideDataset, largeDataset, smallDataset };
+
+	for( Backend *backend : backends )
+	{
+		if( !options.enabled( backend->name() ) )
+		{
+			continue;
+		}
+		for( DatasetGenerator generator : generators )
+		{
+			runBenchmark( options, *backend, generator( options ), results );
+		}
+	}
+}
@@ -0,0 +1,282 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "LRUCacheBenchmark.h"
+
+#include "IECore/LRUCache.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_reduce.h"
+
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+
+using namespace IECore;
+using namespace IECoreBenchmark;
+
+namespace
+{
+
+// A GetterFunction which does a significant amount of work in parallel.
+size_t getParallelSum( size_t key, size_t &cost )
+{
+	cost = 1;
+	return tbb::parallel_reduce(
+		tbb::blocked_range<size_t>( 0, 1000000 ), (size_t)0,
+		[key]( const tbb::blocked_range<size_t> &r, size_t sum ) {
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				sum += ( i * key ) % 7;
+			}
+			return sum;
+		},
+		std::plus<size_t>()
+	);
+}
+
+template<template <typename> class Policy>
+void runBenchmark( const Options &options, const std::string &policy, Results &results )
+{
+	const std::string benchmark = "LRUCache";
+	std::cerr << "Running " << benchmark << " " << policy << std::endl;
+
+	typedef LRUCache<size_t, size_t, Policy> Cache;
+	std::unique_ptr<Cache> cache;
+
+	// every thread requests all the items, so most requests
+	// are made while another thread is computing the item.
+	const size_t numItems = options.scaled( 64 );
+	const std::vector<size_t> threads = threadCounts( options );
+	for( std::vector<size_t>::const_iterator it = threads.begin(); it != threads.end(); ++it )
+	{
+		const double t = timeThreads(
+			options, *it,
+			[&] { cache.reset( new Cache( getParallelSum, numItems ) ); },
+			[&]( size_t threadIndex ) {
+				for( size_t i = 0; i < numItems; ++i )
+				{
+					cache->get( ( i + threadIndex ) % numItems );
+				}
+			}
+		);
+		results.add( benchmark, policy, "computeThroughput", numItems / t, "items/s", *it );
+	}
+}
+
+// Trace replay
+// ============
+//
+// These benchmarks compare the eviction policies on access traces
+// modelled on an interactive session repeatedly reading a working set
+// of objects, while a batch process traverses many other objects once
+// each, as happens when both share ObjectPool::defaultObjectPool().
+
+struct Trace
+{
+	// Keys of the requests, in order.
+	std::vector<size_t> keys;
+	// The cost of each key.
+	std::vector<size_t> costs;
+	// Index of the first request made after the traversal.
+	size_t afterScan;
+	// Total cost of the working set.
+	size_t workingSetCost;
+};
+
+Trace scanTrace( const Options &options )
+{
+	std::mt19937 generator( 42 );
+	std::uniform_int_distribution<size_t> costDistribution( 1, 64 );
+	std::uniform_real_distribution<double> uniform;
+
+	const size_t workingSetSize = options.scaled( 1000 );
+	const size_t scanSize = 10 * workingSetSize;
+
+	Trace result;
+	result.workingSetCost = 0;
+	for( size_t i = 0; i < workingSetSize + scanSize; ++i )
+	{
+		result.costs.push_back( costDistribution( generator ) );
+		if( i < workingSetSize )
+		{
+			result.workingSetCost += result.costs.back();
+		}
+	}
+
+	// Some objects in the working set are used much more
+	// than others.
+	auto workingSetKey = [&] {
+		const double u = uniform( generator );
+		return (size_t)( u * u * workingSetSize );
+	};
+
+	for( size_t i = 0; i < 5 * workingSetSize; ++i )
+	{
+		result.keys.push_back( workingSetKey() );
+	}
+
+	// The session carries on while the traversal happens.
+	for( size_t i = 0; i < scanSize; ++i )
+	{
+		result.keys.push_back( workingSetSize + i );
+		if( i % 3 == 2 )
+		{
+			result.keys.push_back( workingSetKey() );
+		}
+	}
+
+	result.afterScan = result.keys.size();
+	for( size_t i = 0; i < 5 * workingSetSize; ++i )
+	{
+		result.keys.push_back( workingSetKey() );
+	}
+
+	return result;
+}
+
+// Replays the requests as made by the SceneCache data caches, with
+// a GetterFunction computing the missing items.
+template<typename Cache>
+struct GetReplay
+{
+	static Cache *create( const Trace &trace, size_t maxCost )
+	{
+		const std::vector<size_t> &costs = trace.costs;
+		return new Cache(
+			[&costs]( size_t key, size_t &cost ) { cost = costs[key]; return key + 1; },
+			maxCost
+		);
+	}
+
+	static bool request( Cache &cache, const Trace &, size_t key )
+	{
+		const size_t misses = cache.statistics().misses;
+		cache.get( key );
+		return cache.statistics().misses == misses;
+	}
+};
+
+// Replays the requests as made to ObjectPool::store(), which looks
+// the object up and stores it with `set()` if it is missing. As in the
+// ObjectPool, the GetterFunction returns null for missing items.
+template<typename Cache>
+struct StoreReplay
+{
+	static Cache *create( const Trace &, size_t maxCost )
+	{
+		return new Cache(
+			[]( size_t, size_t &cost ) { cost = 0; return (size_t)0; },
+			maxCost
+		);
+	}
+
+	static bool request( Cache &cache, const Trace &trace, size_t key )
+	{
+		if( cache.get( key ) )
+		{
+			return true;
+		}
+		cache.set( key, key + 1, trace.costs[key] );
+		return false;
+	}
+};
+
+template<template <typename> class Policy, template <typename> class Replay>
+void runTraceBenchmark( const Options &options, const Trace &trace, const std::string &policy, const std::string &traceName, Results &results )
+{
+	const std::string benchmark = "LRUCache";
+	const std::string dataset = policy + "/" + traceName;
+	std::cerr << "Running " << benchmark << " " << dataset << std::endl;
+
+	typedef LRUCache<size_t, size_t, Policy> Cache;
+	typedef Replay<Cache> R;
+	std::unique_ptr<Cache> cache;
+
+	// Big enough for the working set, but not for
+	// the working set and the traversal.
+	const size_t maxCost = trace.workingSetCost + trace.workingSetCost / 4;
+
+	cache.reset( R::create( trace, maxCost ) );
+	size_t hits = 0;
+	size_t hitsAfterScan = 0;
+	for( size_t i = 0; i < trace.keys.size(); ++i )
+	{
+		if( R::request( *cache, trace, trace.keys[i] ) )
+		{
+			++hits;
+			hitsAfterScan += i >= trace.afterScan;
+		}
+	}
+	results.add( benchmark, dataset, "hitRatio", (double)hits / trace.keys.size(), "ratio" );
+	results.add( benchmark, dataset, "hitRatioAfterScan", (double)hitsAfterScan / ( trace.keys.size() - trace.afterScan ), "ratio" );
+
+	// Each thread replays an interleaved part of the trace.
+	const std::vector<size_t> threads = threadCounts( options );
+	for( std::vector<size_t>::const_iterator it = threads.begin(); it != threads.end(); ++it )
+	{
+		const size_t numThreads = *it;
+		const double t = timeThreads(
+			options, numThreads,
+			[&] { cache.reset( R::create( trace, maxCost ) ); },
+			[&]( size_t threadIndex ) {
+				for( size_t i = threadIndex; i < trace.keys.size(); i += numThreads )
+				{
+					R::request( *cache, trace, trace.keys[i] );
+				}
+			}
+		);
+		results.add( benchmark, dataset, "replayThroughput", trace.keys.size() / t, "requests/s", numThreads );
+	}
+}
+
+} // namespace
+
+void IECoreBenchmark::runLRUCacheBenchmarks( const Options &options, Results &results )
+{
+	if( !options.enabled( "LRUCache" ) )
+	{
+		return;
+	}
+
+	runBenchmark<LRUCachePolicy::Parallel>( options, "Parallel", results );
+	runBenchmark<LRUCachePolicy::TaskParallel>( options, "TaskParallel", results );
+
+	const Trace trace = scanTrace( options );
+	runTraceBenchmark<LRUCachePolicy::Parallel, GetReplay>( options, trace, "Parallel", "sceneCacheTrace", results );
+	runTraceBenchmark<LRUCachePolicy::ScanResistant, GetReplay>( options, trace, "ScanResistant", "sceneCacheTrace", results );
+	runTraceBenchmark<LRUCachePolicy::Parallel, StoreReplay>( options, trace, "Parallel", "objectPoolTrace", results );
+	runTraceBenchmark<LRUCachePolicy::ScanResistant, StoreReplay>( options, trace, "ScanResistant", "objectPoolTrace", results );
+}
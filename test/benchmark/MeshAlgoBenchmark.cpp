@@ -0,0 +1,109 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "MeshAlgoBenchmark.h"
+
+#include "IECoreScene/MeshAlgo.h"
+#include "IECoreScene/MeshPrimitive.h"
+#include "IECoreScene/MeshTopology.h"
+
+#include "IECore/VectorTypedData.h"
+
+#include "tbb/task_arena.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using namespace Imath;
+using namespace IECore;
+using namespace IECoreScene;
+using namespace IECoreBenchmark;
+
+namespace
+{
+
+void runBenchmark( const Options &options, const MeshPrimitive *mesh, PrimitiveVariable::Interpolation from, PrimitiveVariable::Interpolation to, const std::string &dataset, bool cached, Results &results )
+{
+	std::cerr << "Running MeshAlgo " << dataset << ( cached ? "" : "/uncached" ) << std::endl;
+
+	FloatVectorDataPtr data = new FloatVectorData;
+	data->writable().resize( mesh->variableSize( from ), 1.0f );
+	const PrimitiveVariable primitiveVariable( from, data );
+
+	// Without a cache, every resampling pays for computing the
+	// MeshTopology, as happens for the first frame of a new mesh.
+	const size_t cacheMemoryLimit = MeshTopology::getCacheMemoryLimit();
+	MeshTopology::setCacheMemoryLimit( cached ? cacheMemoryLimit : 0 );
+
+	const std::vector<size_t> threads = threadCounts( options );
+	for( std::vector<size_t>::const_iterator it = threads.begin(); it != threads.end(); ++it )
+	{
+		tbb::task_arena arena( *it );
+		const double t = time(
+			options,
+			[&] {
+				arena.execute(
+					[&] {
+						PrimitiveVariable p = primitiveVariable;
+						MeshAlgo::resamplePrimitiveVariable( mesh, p, to );
+					}
+				);
+			}
+		);
+		results.add( "MeshAlgo", dataset + ( cached ? "" : "/uncached" ), "resampleThroughput", mesh->numFaces() / t, "faces/s", *it );
+	}
+
+	MeshTopology::setCacheMemoryLimit( cacheMemoryLimit );
+}
+
+} // namespace
+
+void IECoreBenchmark::runMeshAlgoBenchmarks( const Options &options, Results &results )
+{
+	if( !options.enabled( "MeshAlgo" ) )
+	{
+		return;
+	}
+
+	const int divisions = std::max( 1, (int)std::sqrt( (double)options.scaled( 4000000 ) ) );
+	ConstMeshPrimitivePtr mesh = MeshPrimitive::createPlane( Box2f( V2f( -1 ), V2f( 1 ) ), V2i( divisions ) );
+
+	for( int cached = 1; cached >= 0; --cached )
+	{
+		runBenchmark( options, mesh.get(), PrimitiveVariable::Vertex, PrimitiveVariable::Uniform, "vertexToUniform", cached, results );
+		runBenchmark( options, mesh.get(), PrimitiveVariable::FaceVarying, PrimitiveVariable::Uniform, "faceVaryingToUniform", cached, results );
+		runBenchmark( options, mesh.get(), PrimitiveVariable::Uniform, PrimitiveVariable::Vertex, "uniformToVertex", cached, results );
+	}
+}
@@ -0,0 +1,151 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "ObjectIOBenchmark.h"
+
+#include "IECore/CompoundData.h"
+#include "IECore/CompoundObject.h"
+#include "IECore/FileIndexedIO.h"
+#include "IECore/SimpleTypedData.h"
+#include "IECore/SmallObjectAllocator.h"
+#include "IECore/VectorTypedData.h"
+
+#include "boost/lexical_cast.hpp"
+
+#include <iostream>
+
+using namespace IECore;
+using namespace IECoreBenchmark;
+
+namespace
+{
+
+// Attributes as found at a location of a SceneCache, or
+// a block of parameter values.
+CompoundDataPtr attributes( size_t index )
+{
+	CompoundDataPtr result = new CompoundData;
+	CompoundDataMap &m = result->writable();
+	m["visible"] = new BoolData( index % 2 );
+	m["index"] = new IntData( index );
+	m["scale"] = new FloatData( index * 0.5f );
+	m["colour"] = new Color3fData( Imath::Color3f( index ) );
+	m["offset"] = new V3fData( Imath::V3f( index ) );
+	m["name"] = new StringData( "location" + boost::lexical_cast<std::string>( index ) );
+	m["transform"] = new M44fData( Imath::M44f().setScale( index ) );
+	m["tags"] = new StringVectorData( std::vector<std::string>( 3, "tag" ) );
+
+	CompoundDataPtr shader = new CompoundData;
+	for( size_t i = 0; i < 8; ++i )
+	{
+		shader->writable()["parameter" + boost::lexical_cast<std::string>( i )] = new FloatData( i );
+	}
+	m["shader"] = shader;
+
+	return result;
+}
+
+size_t numObjects( const Object *object )
+{
+	size_t result = 1;
+	if( const CompoundObject *c = runTimeCast<const CompoundObject>( object ) )
+	{
+		for( CompoundObject::ObjectMap::const_iterator it = c->members().begin(); it != c->members().end(); ++it )
+		{
+			result += numObjects( it->second.get() );
+		}
+	}
+	else if( const CompoundData *c = runTimeCast<const CompoundData>( object ) )
+	{
+		for( CompoundDataMap::const_iterator it = c->readable().begin(); it != c->readable().end(); ++it )
+		{
+			result += numObjects( it->second.get() );
+		}
+	}
+	return result;
+}
+
+} // namespace
+
+void IECoreBenchmark::runObjectIOBenchmarks( const Options &options, Results &results )
+{
+	if( !options.enabled( "ObjectIO" ) )
+	{
+		return;
+	}
+
+	const std::string benchmark = "ObjectIO";
+	const std::string dataset = "attributes";
+	std::cerr << "Running " << benchmark << " " << dataset << std::endl;
+
+	CompoundObjectPtr object = new CompoundObject;
+	const size_t numLocations = options.scaled( 10000 );
+	for( size_t i = 0; i < numLocations; ++i )
+	{
+		object->members()["location" + boost::lexical_cast<std::string>( i )] = attributes( i );
+	}
+	const size_t objects = numObjects( object.get() );
+
+	const std::string fileName = options.fileName( "objectIOBenchmark.fio" );
+	{
+		IndexedIOPtr io = new FileIndexedIO( fileName, IndexedIO::rootPath, IndexedIO::Write );
+		object->save( io, "object" );
+	}
+
+	ConstIndexedIOPtr io = new FileIndexedIO( fileName, IndexedIO::rootPath, IndexedIO::Read );
+	// Load once first, so that the measurements below don't include
+	// the growth of the pools and the interning of the names.
+	Object::load( io, "object" );
+
+	ObjectPtr loaded;
+	size_t allocations = 0;
+	size_t pageFaults = 0;
+	const double t = time(
+		options,
+		[&] { loaded = nullptr; },
+		[&] {
+			const size_t allocationsBefore = allocationCount();
+			const size_t pageFaultsBefore = minorPageFaults();
+			loaded = Object::load( io, "object" );
+			allocations = allocationCount() - allocationsBefore;
+			pageFaults = minorPageFaults() - pageFaultsBefore;
+		}
+	);
+
+	results.add( benchmark, dataset, "loadTime", t, "s" );
+	results.add( benchmark, dataset, "loadThroughput", objects / t, "objects/s" );
+	results.add( benchmark, dataset, "allocationsPerObject", (double)allocations / objects, "allocations" );
+	results.add( benchmark, dataset, "pageFaults", pageFaults, "faults" );
+	results.add( benchmark, dataset, "smallObjectMemory", SmallObjectAllocator::statistics().slabMemory, "bytes" );
+}
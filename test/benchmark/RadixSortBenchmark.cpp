@@ -0,0 +1,173 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "RadixSortBenchmark.h"
+
+#include "IECore/RadixSort.h"
+
+#include "tbb/task_arena.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+using namespace IECore;
+using namespace IECoreBenchmark;
+
+namespace
+{
+
+// Spreads the lower 21 bits of v so that there are two zero bits
+// between each of them.
+uint64_t spreadBits( uint64_t v )
+{
+	v &= 0x1fffff;
+	v = ( v | v << 32 ) & 0x1f00000000ffff;
+	v = ( v | v << 16 ) & 0x1f0000ff0000ff;
+	v = ( v | v << 8 ) & 0x100f00f00f00f00f;
+	v = ( v | v << 4 ) & 0x10c30c30c30c30c3;
+	v = ( v | v << 2 ) & 0x1249249249249249;
+	return v;
+}
+
+std::vector<float> depths( size_t size )
+{
+	std::mt19937 generator( 42 );
+	std::uniform_real_distribution<float> distribution( -1000.0f, 1000.0f );
+	std::vector<float> result( size );
+	for( std::vector<float>::iterator it = result.begin(); it != result.end(); ++it )
+	{
+		*it = distribution( generator );
+	}
+	return result;
+}
+
+// Morton codes of points clustered around a few centres, as for
+// the spatial binning of a particle simulation.
+std::vector<uint64_t> mortonCodes( size_t size )
+{
+	std::mt19937 generator( 42 );
+	std::uniform_int_distribution<int> centreDistribution( 0, 0x1fffff );
+	std::normal_distribution<double> offsetDistribution( 0, 0x3fff );
+	int centres[16][3];
+	for( size_t i = 0; i < 16; ++i )
+	{
+		for( size_t j = 0; j < 3; ++j )
+		{
+			centres[i][j] = centreDistribution( generator );
+		}
+	}
+
+	std::vector<uint64_t> result( size );
+	for( size_t i = 0; i < size; ++i )
+	{
+		uint64_t code = 0;
+		for( size_t j = 0; j < 3; ++j )
+		{
+			const double c = centres[i % 16][j] + offsetDistribution( generator );
+			code |= spreadBits( (uint64_t)std::max( 0.0, std::min( c, (double)0x1fffff ) ) ) << j;
+		}
+		result[i] = code;
+	}
+	return result;
+}
+
+template<typename T>
+void runBenchmark( const Options &options, const std::string &dataset, const std::vector<T> &keys, Results &results )
+{
+	std::cerr << "Running RadixSort " << dataset << std::endl;
+
+	const std::vector<size_t> threads = threadCounts( options );
+	for( std::vector<size_t>::const_iterator it = threads.begin(); it != threads.end(); ++it )
+	{
+		tbb::task_arena arena( *it );
+		const double t = time(
+			options,
+			[&] {
+				arena.execute(
+					[&] {
+						RadixSort sorter;
+						sorter( keys );
+					}
+				);
+			}
+		);
+		results.add( "RadixSort", dataset, "sortThroughput", keys.size() / t, "keys/s", *it );
+	}
+
+	// std::sort computing the same indices as RadixSort.
+	std::vector<unsigned int> indices( keys.size() );
+	const double t = time(
+		options,
+		[&] {
+			for( size_t i = 0; i < indices.size(); ++i )
+			{
+				indices[i] = i;
+			}
+		},
+		[&] {
+			std::sort( indices.begin(), indices.end(), [&keys]( unsigned int a, unsigned int b ) { return keys[a] < keys[b]; } );
+		}
+	);
+	results.add( "std::sort", dataset, "sortThroughput", keys.size() / t, "keys/s" );
+}
+
+} // namespace
+
+void IECoreBenchmark::runRadixSortBenchmarks( const Options &options, Results &results )
+{
+	if( !options.enabled( "RadixSort" ) )
+	{
+		return;
+	}
+
+	const size_t size = options.scaled( 10000000 );
+	runBenchmark( options, "depth", depths( size ), results );
+	runBenchmark( options, "morton", mortonCodes( size ), results );
+
+	// Inputs below the parallel threshold use the serial
+	// implementation, which is measured for comparison.
+	const std::vector<float> smallDepths = depths( 60000 );
+	const double t = time(
+		options,
+		[&] {
+			for( size_t i = 0; i < 100; ++i )
+			{
+				RadixSort sorter;
+				sorter( smallDepths );
+			}
+		}
+	);
+	results.add( "RadixSort", "depth/serial", "sortThroughput", 100 * smallDepths.size() / t, "keys/s" );
+}
@@ -0,0 +1,249 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "SceneCacheBenchmark.h"
+
+#include "IECoreScene/MeshPrimitive.h"
+#include "IECoreScene/SceneCache.h"
+
+#include "IECore/SimpleTypedData.h"
+
+#include "boost/lexical_cast.hpp"
+
+#include <iostream>
+
+using namespace Imath;
+using namespace IECore;
+using namespace IECoreScene;
+using namespace IECoreBenchmark;
+
+namespace
+{
+
+//////////////////////////////////////////////////////////////////////////
+// Synthetic scenes
+//////////////////////////////////////////////////////////////////////////
+
+SceneInterface::Name childName( const char *prefix, size_t i )
+{
+	return prefix + boost::lexical_cast<std::string>( i );
+}
+
+void writeTransform( SceneInterface *location, size_t i )
+{
+	for( int frame = 0; frame < 2; ++frame )
+	{
+		M44dDataPtr transform = new M44dData( M44d().translate( V3d( i, frame, 0 ) ) );
+		location->writeTransform( transform.get(), frame );
+	}
+}
+
+// A single chain of nested locations, each with an animated transform and an attribute.
+void writeDeepScene( const Options &options, SceneInterface *root )
+{
+	SceneInterfacePtr location = root;
+	for( size_t i = 0, depth = options.scaled( 200 ); i < depth; ++i )
+	{
+		location = location->createChild( childName( "d", i ) );
+		writeTransform( location.get(), i );
+		IntDataPtr attribute = new IntData( i );
+		location->writeAttribute( "index", attribute.get(), 0 );
+	}
+}
+
+// Many sibling locations, each with an animated transform and a small mesh.
+void writeWideScene( const Options &options, SceneInterface *root )
+{
+	MeshPrimitivePtr mesh = MeshPrimitive::createPlane( Box2f( V2f( -1 ), V2f( 1 ) ) );
+	for( size_t i = 0, width = options.scaled( 5000 ); i < width; ++i )
+	{
+		SceneInterfacePtr location = root->createChild( childName( "c", i ) );
+		writeTransform( location.get(), i );
+		location->writeObject( mesh.get(), 0 );
+	}
+}
+
+// A few locations holding meshes of several megabytes each.
+void writeLargeMeshScene( const Options &options, SceneInterface *root )
+{
+	const int divisions = options.scaled( 500 );
+	MeshPrimitivePtr mesh = MeshPrimitive::createPlane( Box2f( V2f( -1 ), V2f( 1 ) ), V2i( divisions ) );
+	for( size_t i = 0; i < 4; ++i )
+	{
+		SceneInterfacePtr location = root->createChild( childName( "m", i ) );
+		location->writeObject( mesh.get(), 0 );
+	}
+}
+
+// Locations each holding many small attributes.
+void writeSmallAttributesScene( const Options &options, SceneInterface *root )
+{
+	for( size_t i = 0, numLocations = options.scaled( 100 ); i < numLocations; ++i )
+	{
+		SceneInterfacePtr location = root->createChild( childName( "a", i ) );
+		for( size_t j = 0; j < 100; ++j )
+		{
+			IntDataPtr attribute = new IntData( j );
+			location->writeAttribute( childName( "attr", j ), attribute.get(), 0 );
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Measurements
+//////////////////////////////////////////////////////////////////////////
+
+// Reads everything stored at a location.
+void readLocation( const SceneInterface *location )
+{
+	location->readBound( 0.5 );
+	location->readTransformAsMatrix( 0.5 );
+
+	SceneInterface::NameList attributeNames;
+	location->attributeNames( attributeNames );
+	for( SceneInterface::NameList::const_iterator it = attributeNames.begin(); it != attributeNames.end(); ++it )
+	{
+		location->readAttribute( *it, 0.5 );
+	}
+
+	if( location->hasObject() )
+	{
+		location->readObject( 0.5 );
+	}
+}
+
+void readHierarchy( const SceneInterface *location )
+{
+	readLocation( location );
+
+	SceneInterface::NameList childNames;
+	location->childNames( childNames );
+	for( SceneInterface::NameList::const_iterator it = childNames.begin(); it != childNames.end(); ++it )
+	{
+		readHierarchy( location->child( *it ).get() );
+	}
+}
+
+void locationPaths( const SceneInterface *location, std::vector<SceneInterface::Path> &paths )
+{
+	paths.push_back( SceneInterface::Path() );
+	location->path( paths.back() );
+
+	SceneInterface::NameList childNames;
+	location->childNames( childNames );
+	for( SceneInterface::NameList::const_iterator it = childNames.begin(); it != childNames.end(); ++it )
+	{
+		locationPaths( location->child( *it ).get(), paths );
+	}
+}
+
+// Reads the locations with the given indices, starting at first and taking every stride-th one.
+void readLocations( const SceneInterface *root, const std::vector<SceneInterface::Path> &paths, const std::vector<size_t> &indices, size_t first, size_t stride )
+{
+	for( size_t i = first; i < indices.size(); i += stride )
+	{
+		readLocation( root->scene( paths[indices[i]] ).get() );
+	}
+}
+
+typedef void (*SceneWriter)( const Options &, SceneInterface * );
+
+void runBenchmark( const Options &options, const std::string &dataset, SceneWriter writer, Results &results )
+{
+	const std::string benchmark = "SceneCache";
+	std::cerr << "Running " << benchmark << " " << dataset << std::endl;
+
+	const std::string fileName = options.fileName( "IECoreBenchmark_" + dataset + ".scc" );
+
+	double t = time( options, [&] { SceneCachePtr root = new SceneCache( fileName, IndexedIO::Write ); writer( options, root.get() ); } );
+	const double megabytes = fileSize( fileName ) / ( 1024.0 * 1024.0 );
+	results.add( benchmark, dataset, "writeTime", t, "s" );
+	results.add( benchmark, dataset, "writeThroughput", megabytes / t, "MB/s" );
+	results.add( benchmark, dataset, "fileSize", fileSize( fileName ), "bytes" );
+
+	t = time( options, [&] { SceneCachePtr root = new SceneCache( fileName, IndexedIO::Read ); } );
+	results.add( benchmark, dataset, "openTime", t, "s" );
+
+	// each measurement opens the file again, so that the caches start out empty.
+	ConstSceneInterfacePtr root = new SceneCache( fileName, IndexedIO::Read );
+	std::vector<SceneInterface::Path> paths;
+	locationPaths( root.get(), paths );
+	const double numLocations = paths.size();
+	const std::vector<size_t> randomIndices = shuffledIndices( paths.size() );
+
+	t = time(
+		options,
+		[&] { root = new SceneCache( fileName, IndexedIO::Read ); },
+		[&] { readHierarchy( root.get() ); }
+	);
+	results.add( benchmark, dataset, "sequentialReadLatency", t / numLocations, "s" );
+
+	t = time(
+		options,
+		[&] { root = new SceneCache( fileName, IndexedIO::Read ); },
+		[&] { readLocations( root.get(), paths, randomIndices, 0, 1 ); }
+	);
+	results.add( benchmark, dataset, "randomReadLatency", t / numLocations, "s" );
+
+	// all the threads share the same scene, each reading a different part of it.
+	const std::vector<size_t> threads = threadCounts( options );
+	for( std::vector<size_t>::const_iterator it = threads.begin(); it != threads.end(); ++it )
+	{
+		const size_t numThreads = *it;
+		t = timeThreads(
+			options, numThreads,
+			[&] { root = new SceneCache( fileName, IndexedIO::Read ); },
+			[&]( size_t threadIndex ) { readLocations( root.get(), paths, randomIndices, threadIndex, numThreads ); }
+		);
+		results.add( benchmark, dataset, "readThroughput", numLocations / t, "locations/s", numThreads );
+	}
+
+	root = nullptr;
+	results.add( benchmark, dataset, "peakResidentSetSize", peakResidentSetSize(), "bytes" );
+}
+
+} // namespace
+
+void IECoreBenchmark::runSceneCacheBenchmarks( const Options &options, Results &results )
+{
+	if( !options.enabled( "SceneCache" ) )
+	{
+		return;
+	}
+
+	runBenchmark( options, "deep", writeDeepScene, results );
+	runBenchmark( options, "wide", writeWideScene, results );
+	runBenchmark( options, "largeMeshes", writeLargeMeshScene, results );
+	runBenchmark( options, "smallAttributes", writeSmallAttributesScene, results );
+}